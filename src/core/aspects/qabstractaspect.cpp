@@ -50,6 +50,8 @@
 #include <Qt3DCore/private/qnodevisitor_p.h>
 #include <Qt3DCore/private/qscene_p.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 namespace Qt3DCore {
@@ -171,6 +173,40 @@ void QAbstractAspectPrivate::sceneNodeRemoved(QSceneChangePtr &change)
     clearBackendNode(destructionChange);
 }
 
+namespace {
+
+QVector<QNodeCreatedChangeBasePtr> creationChanges(const QVector<QSceneChangePtr> &changes)
+{
+    QVector<QNodeCreatedChangeBasePtr> creationChanges;
+    creationChanges.reserve(changes.size());
+    for (const QSceneChangePtr &change : changes)
+        creationChanges.push_back(qSharedPointerCast<QNodeCreatedChangeBase>(change));
+    return creationChanges;
+}
+
+} // anonymous
+
+void QAbstractAspectPrivate::sceneNodesAdded(const QVector<QSceneChangePtr> &changes)
+{
+    const QVector<QNodeCreatedChangeBasePtr> nodeChanges = creationChanges(changes);
+    if (m_preparedNodeChanges == changes)
+        createBackendNodes(nodeChanges, m_preparedNodeBatches);
+    else
+        createBackendNodes(nodeChanges);
+    m_preparedNodeChanges.clear();
+    m_preparedNodeBatches.clear();
+}
+
+// Called from a job, only the resources of the backend nodes are allocated
+// here. Creating, registering and initializing them is left to
+// sceneNodesAdded() on the aspect thread
+void QAbstractAspectPrivate::sceneNodesAboutToBeAdded(const QVector<QSceneChangePtr> &changes)
+{
+    m_preparedNodeChanges = changes;
+    m_preparedNodeBatches = batchBackendNodes(creationChanges(changes));
+    acquireBackendNodes(m_preparedNodeBatches);
+}
+
 QVariant QAbstractAspect::executeCommand(const QStringList &args)
 {
     Q_UNUSED(args);
@@ -183,15 +219,20 @@ QVector<QAspectJobPtr> QAbstractAspect::jobsToExecute(qint64 time)
     return QVector<QAspectJobPtr>();
 }
 
-QBackendNode *QAbstractAspectPrivate::createBackendNode(const QNodeCreatedChangeBasePtr &change) const
+// Returns the mapper registered for the closest class of metaObj
+QBackendNodeMapperPtr QAbstractAspectPrivate::backendNodeMapperForType(const QMetaObject *metaObj) const
 {
-    const QMetaObject *metaObj = change->metaObject();
     QBackendNodeMapperPtr backendNodeMapper;
     while (metaObj != nullptr && backendNodeMapper.isNull()) {
         backendNodeMapper = m_backendCreatorFunctors.value(metaObj);
         metaObj = metaObj->superClass();
     }
+    return backendNodeMapper;
+}
 
+QBackendNode *QAbstractAspectPrivate::createBackendNode(const QNodeCreatedChangeBasePtr &change) const
+{
+    const QBackendNodeMapperPtr backendNodeMapper = backendNodeMapperForType(change->metaObject());
     if (!backendNodeMapper)
         return nullptr;
 
@@ -218,7 +259,7 @@ QBackendNode *QAbstractAspectPrivate::createBackendNode(const QNodeCreatedChange
     if (m_arbiter != nullptr) { // Unit tests may not have the arbiter registered
         qCDebug(Nodes) << q_func()->objectName() << "Creating backend node for node id"
                        << change->subjectId() << "of type" << change->metaObject()->className();
-        m_arbiter->registerObserver(backendPriv, backend->peerId(), AllChanges);
+        m_arbiter->registerObserver(backendPriv, backend->peerId(), AllChanges, q_func());
         if (backend->mode() == QBackendNode::ReadWrite)
             m_arbiter->scene()->addObservable(backendPriv, backend->peerId());
     }
@@ -228,21 +269,113 @@ QBackendNode *QAbstractAspectPrivate::createBackendNode(const QNodeCreatedChange
     return backend;
 }
 
+// Groups the changes by mapper, looking each node type up only once. Changes
+// whose backend node exists already are left out
+QVector<QAbstractAspectPrivate::BackendNodeBatch> QAbstractAspectPrivate::batchBackendNodes(const QVector<QNodeCreatedChangeBasePtr> &changes) const
+{
+    // Most of the changes share a few types
+    QHash<const QMetaObject *, int> batchIndexForType;
+    QVector<BackendNodeBatch> batches;
+    for (int i = 0, n = changes.size(); i < n; ++i) {
+        const QNodeCreatedChangeBasePtr &change = changes.at(i);
+        auto it = batchIndexForType.find(change->metaObject());
+        if (it == batchIndexForType.end()) {
+            const QBackendNodeMapperPtr mapper = backendNodeMapperForType(change->metaObject());
+            int batchIndex = -1;
+            if (mapper) {
+                const auto sameMapper = [&mapper] (const BackendNodeBatch &batch) { return batch.mapper == mapper; };
+                batchIndex = int(std::find_if(batches.cbegin(), batches.cend(), sameMapper) - batches.cbegin());
+                if (batchIndex == batches.size())
+                    batches.push_back({ mapper, {}, {} });
+            }
+            it = batchIndexForType.insert(change->metaObject(), batchIndex);
+        }
+        if (it.value() < 0)
+            continue;
+
+        BackendNodeBatch &batch = batches[it.value()];
+        if (batch.mapper->get(change->subjectId()) != nullptr)
+            continue;
+        batch.indices.push_back(i);
+        batch.changes.push_back(change);
+    }
+    return batches;
+}
+
+// Allocates the resources of the backend nodes of the QBackendNodeBulkMapper
+// batches at once, safe to call from a job
+void QAbstractAspectPrivate::acquireBackendNodes(const QVector<BackendNodeBatch> &batches) const
+{
+    for (const BackendNodeBatch &batch : batches) {
+        const auto bulkMapper = dynamic_cast<const QBackendNodeBulkMapper *>(batch.mapper.data());
+        if (bulkMapper != nullptr)
+            bulkMapper->acquireMany(batch.changes);
+    }
+}
+
+void QAbstractAspectPrivate::createBackendNodes(const QVector<QNodeCreatedChangeBasePtr> &changes) const
+{
+    createBackendNodes(changes, batchBackendNodes(changes));
+}
+
+// Same as calling createBackendNode for each change, except that the backend
+// nodes of a given mapper are created at once when it is a QBackendNodeBulkMapper
+// and that all the nodes are registered with the arbiter and the scene in a
+// single pass. All the nodes are created before the first one is initialized,
+// they are still initialized in the order of the changes
+void QAbstractAspectPrivate::createBackendNodes(const QVector<QNodeCreatedChangeBasePtr> &changes,
+                                                const QVector<BackendNodeBatch> &batches) const
+{
+    QVector<QBackendNode *> backends(changes.size(), nullptr);
+    for (const BackendNodeBatch &batch : batches) {
+        const auto bulkMapper = dynamic_cast<const QBackendNodeBulkMapper *>(batch.mapper.data());
+        if (bulkMapper != nullptr) {
+            const QVector<QBackendNode *> created = bulkMapper->createMany(batch.changes);
+            for (int j = 0, m = batch.indices.size(); j < m; ++j)
+                backends[batch.indices.at(j)] = created.at(j);
+        } else {
+            for (int j = 0, m = batch.indices.size(); j < m; ++j)
+                backends[batch.indices.at(j)] = batch.mapper->create(batch.changes.at(j));
+        }
+    }
+
+    QVector<QPair<QObserverInterface *, QNodeId>> observers;
+    QVector<QPair<QObservableInterface *, QNodeId>> observables;
+    observers.reserve(changes.size());
+    for (int i = 0, n = changes.size(); i < n; ++i) {
+        QBackendNode *backend = backends.at(i);
+        if (!backend)
+            continue;
+        const QNodeCreatedChangeBasePtr &change = changes.at(i);
+        backend->setPeerId(change->subjectId());
+        QBackendNodePrivate *backendPriv = QBackendNodePrivate::get(backend);
+        backendPriv->setEnabled(change->isNodeEnabled());
+        observers.push_back(qMakePair(static_cast<QObserverInterface *>(backendPriv), change->subjectId()));
+        if (backend->mode() == QBackendNode::ReadWrite)
+            observables.push_back(qMakePair(static_cast<QObservableInterface *>(backendPriv), change->subjectId()));
+    }
+
+    if (m_arbiter != nullptr) { // Unit tests may not have the arbiter registered
+        qCDebug(Nodes) << q_func()->objectName() << "Creating" << observers.size() << "backend nodes";
+        m_arbiter->registerObservers(observers, AllChanges, q_func());
+        if (!observables.isEmpty())
+            m_arbiter->scene()->addObservables(observables);
+    }
+
+    for (int i = 0, n = changes.size(); i < n; ++i) {
+        if (backends.at(i) != nullptr)
+            backends.at(i)->initializeFromPeer(changes.at(i));
+    }
+}
+
 void QAbstractAspectPrivate::clearBackendNode(const QNodeDestroyedChangePtr &change) const
 {
     // Each QNodeDestroyedChange may contain info about a whole sub-tree of nodes that
     // are being destroyed. Iterate over them and process each in turn
     const auto subTree = change->subtreeIdsAndTypes();
     for (const auto &idAndType : subTree) {
-        const QMetaObject *metaObj = idAndType.type;
-        QBackendNodeMapperPtr backendNodeMapper;
-
         // Find backend node mapper for this type
-        while (metaObj != nullptr && backendNodeMapper.isNull()) {
-            backendNodeMapper = m_backendCreatorFunctors.value(metaObj);
-            metaObj = metaObj->superClass();
-        }
-
+        const QBackendNodeMapperPtr backendNodeMapper = backendNodeMapperForType(idAndType.type);
         if (!backendNodeMapper)
             continue;
 
@@ -269,8 +402,7 @@ void QAbstractAspectPrivate::setRootAndCreateNodes(QEntity *rootObject, const QV
     m_root = rootObject;
     m_rootId = rootObject->id();
 
-    for (const auto &change : changes)
-        createBackendNode(change);
+    createBackendNodes(changes);
 }
 
 QServiceLocator *QAbstractAspectPrivate::services() const
@@ -119,11 +119,28 @@ public:
 
     QVector<QAspectJobPtr> jobsToExecute(qint64 time) override;
 
+    // The creation changes handled by a given mapper, indices refer to the
+    // changes the batch was made from
+    struct BackendNodeBatch
+    {
+        QBackendNodeMapperPtr mapper;
+        QVector<int> indices;
+        QVector<QNodeCreatedChangeBasePtr> changes;
+    };
+
     QBackendNode *createBackendNode(const QNodeCreatedChangeBasePtr &change) const override;
+    QVector<BackendNodeBatch> batchBackendNodes(const QVector<QNodeCreatedChangeBasePtr> &changes) const;
+    void acquireBackendNodes(const QVector<BackendNodeBatch> &batches) const;
+    void createBackendNodes(const QVector<QNodeCreatedChangeBasePtr> &changes) const;
+    void createBackendNodes(const QVector<QNodeCreatedChangeBasePtr> &changes,
+                            const QVector<BackendNodeBatch> &batches) const;
     void clearBackendNode(const QNodeDestroyedChangePtr &change) const;
+    QBackendNodeMapperPtr backendNodeMapperForType(const QMetaObject *metaObj) const;
 
     void sceneNodeAdded(Qt3DCore::QSceneChangePtr &e) override;
     void sceneNodeRemoved(Qt3DCore::QSceneChangePtr &e) override;
+    void sceneNodesAdded(const QVector<Qt3DCore::QSceneChangePtr> &changes) override;
+    void sceneNodesAboutToBeAdded(const QVector<Qt3DCore::QSceneChangePtr> &changes) override;
 
     virtual void onEngineAboutToShutdown();
 
@@ -142,6 +159,10 @@ public:
     QHash<const QMetaObject*, QBackendNodeMapperPtr> m_backendCreatorFunctors;
     QMutex m_singleShotMutex;
     QVector<QAspectJobPtr> m_singleShotJobs;
+    // Batches made by sceneNodesAboutToBeAdded(), used by sceneNodesAdded()
+    // when it receives the same changes
+    QVector<QSceneChangePtr> m_preparedNodeChanges;
+    QVector<BackendNodeBatch> m_preparedNodeBatches;
 
     static QAbstractAspectPrivate *get(QAbstractAspect *aspect);
 };
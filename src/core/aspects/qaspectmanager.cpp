@@ -308,6 +308,11 @@ void QAspectManager::exec()
             changeArbiterStats.endTime = QThreadPooler::m_jobsStatTimer.nsecsElapsed();
             QThreadPooler::addJobLogStatsEntry(changeArbiterStats);
 #endif
+#if defined(QT3D_CORE_JOB_TIMING)
+            const QChangeArbiter::SyncStatistics syncStatistics = m_changeArbiter->lastSyncStatistics();
+            qDebug() << "Sync took" << syncStatistics.syncTime / 1.0e6 << "for"
+                     << syncStatistics.processedChanges << "changes";
+#endif
 
             // For each Aspect
             // Ask them to launch set of jobs for the current frame
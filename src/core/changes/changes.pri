@@ -53,6 +53,7 @@ SOURCES += \
     $$PWD/qdynamicpropertyupdatedchange.cpp \
     $$PWD/qstaticpropertyupdatedchangebase.cpp \
     $$PWD/qpropertyupdatedchange.cpp \
+    $$PWD/qtypedpropertyupdatechange.cpp \
     $$PWD/qstaticpropertyvalueaddedchangebase.cpp \
     $$PWD/qstaticpropertyvalueremovedchangebase.cpp \
     $$PWD/qpropertynodeaddedchange.cpp \
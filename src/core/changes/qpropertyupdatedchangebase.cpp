@@ -47,6 +47,7 @@ namespace Qt3DCore {
 QPropertyUpdatedChangeBasePrivate::QPropertyUpdatedChangeBasePrivate()
     : QSceneChangePrivate()
     , m_isIntermediate(false)
+    , m_propertyId(0)
 {
 }
 
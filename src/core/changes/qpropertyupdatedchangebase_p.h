@@ -75,6 +75,10 @@ public:
     // will set this to true for animating properties apart from the final
     // frame's update.
     bool m_isIntermediate;
+
+    // Interned property name of the changes created by
+    // QTypedPropertyUpdatedChange<T>::create(), 0 for all the others
+    int m_propertyId;
 };
 
 } // namespace Qt3DCore
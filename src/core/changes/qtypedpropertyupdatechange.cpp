@@ -0,0 +1,151 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qtypedpropertyupdatechange_p.h"
+
+#include <Qt3DCore/private/qpropertyupdatedchangebase_p.h>
+#include <Qt3DCore/private/qstaticpropertyupdatedchangebase_p.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qreadwritelock.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DCore {
+
+namespace {
+
+struct PropertyIdRegistry
+{
+    QReadWriteLock lock;
+    QHash<QByteArray, int> ids;
+};
+
+Q_GLOBAL_STATIC(PropertyIdRegistry, propertyIdRegistry)
+
+} // anonymous
+
+QTypedPropertyUpdatedChangeBase::QTypedPropertyUpdatedChangeBase(QNodeId subjectId)
+    : QStaticPropertyUpdatedChangeBase(subjectId)
+{
+}
+
+QTypedPropertyUpdatedChangeBase::~QTypedPropertyUpdatedChangeBase()
+{
+}
+
+int QTypedPropertyUpdatedChangeBase::propertyId() const
+{
+    Q_D(const QStaticPropertyUpdatedChangeBase);
+    return d->m_propertyId;
+}
+
+const QTypedPropertyUpdatedChangeBase *QTypedPropertyUpdatedChangeBase::fromChange(const QSceneChangePtr &change)
+{
+    if (change.isNull() || change->type() != PropertyUpdated)
+        return nullptr;
+    QPropertyUpdatedChangeBase *propertyChange = static_cast<QPropertyUpdatedChangeBase *>(change.data());
+    if (QPropertyUpdatedChangeBasePrivate::get(propertyChange)->m_propertyId == 0)
+        return nullptr;
+    return static_cast<const QTypedPropertyUpdatedChangeBase *>(propertyChange);
+}
+
+int QTypedPropertyUpdatedChangeBase::propertyIdForName(const char *name)
+{
+    PropertyIdRegistry *registry = propertyIdRegistry();
+    const QByteArray key = QByteArray::fromRawData(name, int(qstrlen(name)));
+    {
+        QReadLocker locker(&registry->lock);
+        const auto it = registry->ids.constFind(key);
+        if (it != registry->ids.cend())
+            return it.value();
+    }
+    QWriteLocker locker(&registry->lock);
+    const auto it = registry->ids.constFind(key);
+    if (it != registry->ids.cend())
+        return it.value();
+    const int id = registry->ids.size() + 1;
+    registry->ids.insert(QByteArray(name), id);
+    return id;
+}
+
+void QTypedPropertyUpdatedChangeBase::reset(QNodeId subjectId, const char *propertyName, int propertyId)
+{
+    Q_D(QStaticPropertyUpdatedChangeBase);
+    d->m_subjectId = subjectId;
+    d->m_deliveryFlags = QSceneChange::BackendNodes;
+    d->m_isIntermediate = false;
+    d->m_propertyName = propertyName;
+    d->m_propertyId = propertyId;
+}
+
+QTypedPropertyUpdatedChangePool::QTypedPropertyUpdatedChangePool(int capacity)
+    : m_capacity(capacity)
+{
+    m_freeChanges.reserve(capacity);
+}
+
+QTypedPropertyUpdatedChangePool::~QTypedPropertyUpdatedChangePool()
+{
+    qDeleteAll(m_freeChanges);
+}
+
+QTypedPropertyUpdatedChangeBase *QTypedPropertyUpdatedChangePool::acquire()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_freeChanges.isEmpty())
+        return nullptr;
+    return m_freeChanges.takeLast();
+}
+
+void QTypedPropertyUpdatedChangePool::release(QTypedPropertyUpdatedChangeBase *change)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_freeChanges.size() < m_capacity) {
+            m_freeChanges.push_back(change);
+            return;
+        }
+    }
+    delete change;
+}
+
+} // namespace Qt3DCore
+
+QT_END_NAMESPACE
@@ -52,27 +52,109 @@
 //
 
 #include <Qt3DCore/qstaticpropertyupdatedchangebase.h>
+#include <Qt3DCore/private/qt3dcore_global_p.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qvector.h>
 
 QT_BEGIN_NAMESPACE
 
 namespace Qt3DCore {
 
+// Base class of the changes carrying a typed value rather than a QVariant.
+// Changes created through QTypedPropertyUpdatedChange<T>::create() also carry
+// an integer id for their property name, which lets the backend nodes
+// dispatch on it instead of comparing names. A property id always maps to the
+// same value type
+class QT3DCORE_PRIVATE_EXPORT QTypedPropertyUpdatedChangeBase : public QStaticPropertyUpdatedChangeBase
+{
+public:
+    ~QTypedPropertyUpdatedChangeBase();
+
+    int propertyId() const;
+
+    template<typename T>
+    const T &value() const;
+
+    // Returns the change as a typed change with a property id, nullptr otherwise
+    static const QTypedPropertyUpdatedChangeBase *fromChange(const QSceneChangePtr &change);
+
+    // Property ids are interned names, valid for the lifetime of the process
+    static int propertyIdForName(const char *name);
+
+protected:
+    explicit QTypedPropertyUpdatedChangeBase(QNodeId subjectId);
+
+    // Prepares a recycled change to be sent again
+    void reset(QNodeId subjectId, const char *propertyName, int propertyId);
+};
+
+// Keeps the changes released by the backend to hand them out again, so that
+// notifying a property doesn't require any allocation apart from the shared
+// pointer control block
+class QT3DCORE_PRIVATE_EXPORT QTypedPropertyUpdatedChangePool
+{
+public:
+    explicit QTypedPropertyUpdatedChangePool(int capacity = 1024);
+    ~QTypedPropertyUpdatedChangePool();
+
+    QTypedPropertyUpdatedChangeBase *acquire();
+    void release(QTypedPropertyUpdatedChangeBase *change);
+
+private:
+    QMutex m_mutex;
+    QVector<QTypedPropertyUpdatedChangeBase *> m_freeChanges;
+    const int m_capacity;
+};
+
 template<typename T>
-class QTypedPropertyUpdatedChange : public QStaticPropertyUpdatedChangeBase
+class QTypedPropertyUpdatedChange : public QTypedPropertyUpdatedChangeBase
 {
 public:
     explicit QTypedPropertyUpdatedChange(QNodeId _subjectId)
-        : QStaticPropertyUpdatedChangeBase(_subjectId)
+        : QTypedPropertyUpdatedChangeBase(_subjectId)
         , data()
     {
     }
 
+    static QSharedPointer<QTypedPropertyUpdatedChange<T>> create(QNodeId subjectId,
+                                                                 const char *propertyName,
+                                                                 int propertyId,
+                                                                 const T &value)
+    {
+        QTypedPropertyUpdatedChange<T> *change = static_cast<QTypedPropertyUpdatedChange<T> *>(pool()->acquire());
+        if (change == nullptr)
+            change = new QTypedPropertyUpdatedChange<T>(subjectId);
+        change->reset(subjectId, propertyName, propertyId);
+        change->data = value;
+        return QSharedPointer<QTypedPropertyUpdatedChange<T>>(change, &QTypedPropertyUpdatedChange<T>::recycle);
+    }
+
     T data;
+
+private:
+    static QTypedPropertyUpdatedChangePool *pool()
+    {
+        // Intentionally leaked, changes may be released during static destruction
+        static QTypedPropertyUpdatedChangePool *changePool = new QTypedPropertyUpdatedChangePool();
+        return changePool;
+    }
+
+    static void recycle(QTypedPropertyUpdatedChange<T> *change)
+    {
+        change->data = T();
+        pool()->release(change);
+    }
 };
 
 template<typename T>
 using QTypedPropertyUpdatedChangePtr = QSharedPointer<QTypedPropertyUpdatedChange<T>>;
 
+template<typename T>
+const T &QTypedPropertyUpdatedChangeBase::value() const
+{
+    return static_cast<const QTypedPropertyUpdatedChange<T> *>(this)->data;
+}
+
 } // namespace Qt3DCore
 
 QT_END_NAMESPACE
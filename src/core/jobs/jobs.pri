@@ -4,6 +4,7 @@ SOURCES += \
     $$PWD/qaspectjobmanager.cpp \
     $$PWD/qabstractaspectjobmanager.cpp \
     $$PWD/qthreadpooler.cpp \
+    $$PWD/qworkstealingscheduler.cpp \
     $$PWD/task.cpp
 
 HEADERS += \
@@ -13,7 +14,8 @@ HEADERS += \
     $$PWD/qaspectjobmanager_p.h \
     $$PWD/qabstractaspectjobmanager_p.h \
     $$PWD/task_p.h \
-    $$PWD/qthreadpooler_p.h
+    $$PWD/qthreadpooler_p.h \
+    $$PWD/qworkstealingscheduler_p.h
 
 INCLUDEPATH += $$PWD
 
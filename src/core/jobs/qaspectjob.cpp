@@ -53,9 +53,13 @@ bool isDependencyNull(const QWeakPointer<QAspectJob> &dep)
     return dep.isNull();
 }
 
+QBasicAtomicInteger<quint32> scheduleGeneration = Q_BASIC_ATOMIC_INITIALIZER(0);
+
 } // anonymous
 
 QAspectJobPrivate::QAspectJobPrivate()
+    : m_scheduledTask(nullptr)
+    , m_scheduleGeneration(0)
 {
 }
 
@@ -64,6 +68,13 @@ QAspectJobPrivate *QAspectJobPrivate::get(QAspectJob *job)
     return job->d_func();
 }
 
+// Shared by all job managers so that a job can never match a stale
+// generation left over by another scheduling pass
+quint32 QAspectJobPrivate::nextScheduleGeneration()
+{
+    return scheduleGeneration.fetchAndAddRelaxed(1) + 1;
+}
+
 QAspectJob::QAspectJob()
     : d_ptr(new QAspectJobPrivate)
 {
@@ -109,8 +109,14 @@ public:
     QAspectJobPrivate();
 
     static QAspectJobPrivate *get(QAspectJob *job);
+    static quint32 nextScheduleGeneration();
 
     QVector<QWeakPointer<QAspectJob> > m_dependencies;
+
+    // Scratch data used by the job managers to resolve dependencies without
+    // building a QAspectJob * -> task lookup table every frame
+    void *m_scheduledTask;
+    quint32 m_scheduleGeneration;
 #if QT_CONFIG(qt3d_profile_jobs)
     JobRunStats m_stats;
 #endif
@@ -43,23 +43,53 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDebug>
 #include <QtCore/QThread>
-#include <QtCore/QFuture>
 
+#include <Qt3DCore/private/qaspectjob_p.h>
 #include <Qt3DCore/private/qthreadpooler_p.h>
+#include <Qt3DCore/private/qworkstealingscheduler_p.h>
 #include <Qt3DCore/private/task_p.h>
 
 QT_BEGIN_NAMESPACE
 
 namespace Qt3DCore {
 
+namespace {
+
+// Jobs are assigned to the tasks of the pool in submission order, the task a
+// dependency is scheduled on therefore identifies it by its position in the
+// job queue, independently of the job instance
+inline quintptr scheduledDependee(QAspectJob *dependee, quint32 generation)
+{
+    if (!dependee)
+        return 0;
+    const QAspectJobPrivate *dependeeD = QAspectJobPrivate::get(dependee);
+    if (dependeeD->m_scheduleGeneration != generation)
+        return 0;
+    return quintptr(dependeeD->m_scheduledTask);
+}
+
+} // anonymous
+
 QAspectJobManager::QAspectJobManager(QObject *parent)
     : QAbstractAspectJobManager(parent)
-    , m_threadPooler(new QThreadPooler(this))
+    , m_threadPooler(nullptr)
+    , m_workStealingScheduler(nullptr)
+    , m_usedTaskCount(0)
 {
+    // QT3D_SCHEDULER=workstealing dispatches jobs over per thread queues
+    // instead of the QThreadPool based pooler
+    if (qgetenv("QT3D_SCHEDULER") == QByteArrayLiteral("workstealing"))
+        m_workStealingScheduler = new QWorkStealingScheduler();
+    else
+        m_threadPooler = new QThreadPooler(this);
 }
 
 QAspectJobManager::~QAspectJobManager()
 {
+    delete m_workStealingScheduler;
+    if (m_threadPooler)
+        m_threadPooler->waitForAllTasks();
+    qDeleteAll(m_taskPool);
 }
 
 void QAspectJobManager::initialize()
@@ -69,50 +99,146 @@ void QAspectJobManager::initialize()
 // Adds all Aspect Jobs to be processed for a frame
 void QAspectJobManager::enqueueJobs(const QVector<QAspectJobPtr> &jobQueue)
 {
-    // Convert QJobs to Tasks
-    QHash<QAspectJob *, AspectTaskRunnable *> tasksMap;
-    QVector<RunnableInterface *> taskList;
-    taskList.reserve(jobQueue.size());
-    for (const QAspectJobPtr &job : jobQueue) {
+    if (m_workStealingScheduler) {
+#if QT_CONFIG(qt3d_profile_jobs)
+        QThreadPooler::writeFrameJobLogStats();
+#endif
+        m_workStealingScheduler->schedule(jobQueue);
+        return;
+    }
+
+    // Tasks are taken from a pool which is only recycled once all the jobs
+    // of the frame have completed, so enqueueing several queues before
+    // waiting for them is fine
+    const int firstTaskIndex = m_usedTaskCount;
+    const int jobCount = jobQueue.size();
+    m_usedTaskCount += jobCount;
+    while (m_taskPool.size() < m_usedTaskCount) {
         AspectTaskRunnable *task = new AspectTaskRunnable();
-        task->m_job = job;
-        tasksMap.insert(job.data(), task);
+        task->setAutoDelete(false);
+        m_taskPool.push_back(task);
+    }
+
+    // Stamp the jobs with the task they are assigned to, instead of
+    // building a QAspectJob * -> AspectTaskRunnable * hash
+    const quint32 generation = QAspectJobPrivate::nextScheduleGeneration();
+    m_taskList.clear();
+    for (int i = 0; i < jobCount; ++i) {
+        AspectTaskRunnable *task = m_taskPool.at(firstTaskIndex + i);
+        task->m_job = jobQueue.at(i);
+        task->setReserved(false);
+        m_taskList.push_back(task);
+        QAspectJobPrivate *jobD = QAspectJobPrivate::get(jobQueue.at(i).data());
+        jobD->m_scheduledTask = task;
+        jobD->m_scheduleGeneration = generation;
+    }
+
+    // The graph of the previous frame is reused as is when the jobs submitted
+    // have the same dependencies between them, which is the common case even
+    // though some jobs, such as the RenderViewBuilder ones, are recreated
+    // every frame. Otherwise the dependencies are resolved again
+    if (firstTaskIndex == 0 && isCachedJobGraph(jobQueue, generation)) {
+        for (int i = 0; i < jobCount; ++i)
+            m_taskPool.at(i)->m_dependerCount = m_cachedDependerCounts.at(i);
+    } else {
+        resolveDependencies(jobQueue, firstTaskIndex, generation);
+    }
+
+#if QT_CONFIG(qt3d_profile_jobs)
+    QThreadPooler::writeFrameJobLogStats();
+#endif
+    m_threadPooler->mapDependables(m_taskList);
+}
 
-        taskList << task;
+// Compares the dependencies of the jobs against the flattened
+// [dependencyCount, dependeeTasks...] signature of the cached graph. Only
+// the structure is compared, not the job instances
+bool QAspectJobManager::isCachedJobGraph(const QVector<QAspectJobPtr> &jobQueue, quint32 generation) const
+{
+    if (jobQueue.size() != m_cachedDependerCounts.size())
+        return false;
+
+    int s = 0;
+    const int signatureSize = m_cachedGraphSignature.size();
+    for (const QAspectJobPtr &job : jobQueue) {
+        const QVector<QWeakPointer<QAspectJob> > &dependencies = QAspectJobPrivate::get(job.data())->m_dependencies;
+        if (s + 1 + dependencies.size() > signatureSize)
+            return false;
+        if (m_cachedGraphSignature.at(s++) != quintptr(dependencies.size()))
+            return false;
+        for (const QWeakPointer<QAspectJob> &dependency : dependencies) {
+            if (m_cachedGraphSignature.at(s++) != scheduledDependee(dependency.data(), generation))
+                return false;
+        }
     }
+    return s == signatureSize;
+}
+
+void QAspectJobManager::resolveDependencies(const QVector<QAspectJobPtr> &jobQueue, int firstTaskIndex, quint32 generation)
+{
+    const int jobCount = jobQueue.size();
+    for (int i = 0; i < jobCount; ++i) {
+        AspectTaskRunnable *task = m_taskPool.at(firstTaskIndex + i);
+        task->m_dependers.clear();
+        task->m_dependerCount = 0;
+    }
+
+    const bool cacheGraph = firstTaskIndex == 0;
+    if (cacheGraph) {
+        m_cachedGraphSignature.clear();
+        m_cachedDependerCounts.clear();
+    }
+
+    for (int i = 0; i < jobCount; ++i) {
+        QAspectJob *job = jobQueue.at(i).data();
+        const QVector<QWeakPointer<QAspectJob> > &deps = QAspectJobPrivate::get(job)->m_dependencies;
+        AspectTaskRunnable *taskDepender = m_taskPool.at(firstTaskIndex + i);
 
-    for (const QSharedPointer<QAspectJob> &job : jobQueue) {
-        const QVector<QWeakPointer<QAspectJob> > &deps = job->dependencies();
-        AspectTaskRunnable *taskDepender = tasksMap.value(job.data());
+        if (cacheGraph)
+            m_cachedGraphSignature.push_back(quintptr(deps.size()));
 
         int dependerCount = 0;
         for (const QWeakPointer<QAspectJob> &dep : deps) {
-            AspectTaskRunnable *taskDependee = tasksMap.value(dep.data());
             // The dependencies here are not hard requirements, i.e., the dependencies
             // not in the jobQueue should already have their data ready.
-            if (taskDependee) {
-                taskDependee->m_dependers.append(taskDepender);
+            const quintptr dependeeTask = scheduledDependee(dep.data(), generation);
+            if (cacheGraph)
+                m_cachedGraphSignature.push_back(dependeeTask);
+            if (dependeeTask) {
+                reinterpret_cast<AspectTaskRunnable *>(dependeeTask)->m_dependers.append(taskDepender);
                 ++dependerCount;
             }
         }
 
-        taskDepender->m_dependerCount += dependerCount;
+        taskDepender->m_dependerCount = dependerCount;
+        if (cacheGraph)
+            m_cachedDependerCounts.push_back(dependerCount);
     }
-
-#if QT_CONFIG(qt3d_profile_jobs)
-    QThreadPooler::writeFrameJobLogStats();
-#endif
-    m_threadPooler->mapDependables(taskList);
 }
 
 // Wait for all aspects jobs to be completed
 void QAspectJobManager::waitForAllJobs()
 {
-    m_threadPooler->future().waitForFinished();
+    if (m_workStealingScheduler) {
+        m_workStealingScheduler->waitForAllJobs();
+        return;
+    }
+    m_threadPooler->waitForAllTasks();
+
+    // Release the jobs, the tasks and their dependers stay around for the
+    // next frame
+    for (int i = 0; i < m_usedTaskCount; ++i)
+        m_taskPool.at(i)->m_job.reset();
+    m_usedTaskCount = 0;
 }
 
 void QAspectJobManager::waitForPerThreadFunction(JobFunction func, void *arg)
 {
+    if (m_workStealingScheduler) {
+        m_workStealingScheduler->runOnEachWorker(func, arg);
+        return;
+    }
+
     const int threadCount = m_threadPooler->maxThreadCount();
     QAtomicInt atomicCount(threadCount);
 
@@ -122,8 +248,8 @@ void QAspectJobManager::waitForPerThreadFunction(JobFunction func, void *arg)
         taskList << syncTask;
     }
 
-    QFuture<void> future = m_threadPooler->mapDependables(taskList);
-    future.waitForFinished();
+    m_threadPooler->mapDependables(taskList);
+    m_threadPooler->waitForAllTasks();
 }
 
 } // namespace Qt3DCore
@@ -61,7 +61,10 @@ QT_BEGIN_NAMESPACE
 
 namespace Qt3DCore {
 
+class AspectTaskRunnable;
 class QThreadPooler;
+class QWorkStealingScheduler;
+class RunnableInterface;
 class DependencyHandler;
 
 class QT3DCORE_PRIVATE_EXPORT QAspectJobManager : public QAbstractAspectJobManager
@@ -80,7 +83,18 @@ public:
     void waitForPerThreadFunction(JobFunction func, void *arg) override;
 
 private:
+    bool isCachedJobGraph(const QVector<QAspectJobPtr> &jobQueue, quint32 generation) const;
+    void resolveDependencies(const QVector<QAspectJobPtr> &jobQueue, int firstTaskIndex, quint32 generation);
+
     QThreadPooler *m_threadPooler;
+    QWorkStealingScheduler *m_workStealingScheduler;
+
+    // Persistent job graph reused from frame to frame
+    QVector<AspectTaskRunnable *> m_taskPool;
+    QVector<RunnableInterface *> m_taskList;
+    int m_usedTaskCount;
+    QVector<quintptr> m_cachedGraphSignature;
+    QVector<int> m_cachedDependerCounts;
 };
 
 } // namespace Qt3DCore
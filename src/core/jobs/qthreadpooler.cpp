@@ -63,7 +63,6 @@ QElapsedTimer QThreadPooler::m_jobsStatTimer;
 
 QThreadPooler::QThreadPooler(QObject *parent)
     : QObject(parent)
-    , m_futureInterface(nullptr)
     , m_mutex()
     , m_taskCount(0)
 {
@@ -131,38 +130,27 @@ void QThreadPooler::taskFinished(RunnableInterface *task)
         }
     }
 
-    if (currentCount() == 0) {
-        if (m_futureInterface) {
-            m_futureInterface->reportFinished();
-            delete m_futureInterface;
-        }
-        m_futureInterface = nullptr;
-    }
+    if (currentCount() == 0)
+        m_tasksFinishedCondition.wakeAll();
 }
 
-QFuture<void> QThreadPooler::mapDependables(QVector<RunnableInterface *> &taskQueue)
+void QThreadPooler::mapDependables(QVector<RunnableInterface *> &taskQueue)
 {
     const QMutexLocker locker(&m_mutex);
 
-    if (!m_futureInterface)
-        m_futureInterface = new QFutureInterface<void>();
-    if (!taskQueue.empty())
-        m_futureInterface->reportStarted();
-
     acquire(taskQueue.size());
     enqueueTasks(taskQueue);
-
-    return QFuture<void>(m_futureInterface);
 }
 
-QFuture<void> QThreadPooler::future()
+// Completion is tracked with a wait condition rather than a QFutureInterface,
+// a finished QFutureInterface cannot be started again so it would have to be
+// reallocated for every batch of tasks
+void QThreadPooler::waitForAllTasks()
 {
-    const QMutexLocker locker(&m_mutex);
+    QMutexLocker locker(&m_mutex);
 
-    if (!m_futureInterface)
-        return QFuture<void>();
-    else
-        return QFuture<void>(m_futureInterface);
+    while (currentCount() > 0)
+        m_tasksFinishedCondition.wait(&m_mutex);
 }
 
 void QThreadPooler::acquire(int add)
@@ -51,11 +51,11 @@
 // We mean it.
 //
 
-#include <QtCore/QFuture>
-#include <QtCore/QFutureInterface>
+#include <QtCore/QMutex>
 #include <QtCore/QObject>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QThreadPool>
+#include <QtCore/QWaitCondition>
 
 #include <Qt3DCore/private/qaspectjob_p.h>
 #include <Qt3DCore/private/task_p.h>
@@ -76,9 +76,9 @@ public:
     explicit QThreadPooler(QObject *parent = 0);
     ~QThreadPooler();
 
-    QFuture<void> mapDependables(QVector<RunnableInterface *> &taskQueue);
+    void mapDependables(QVector<RunnableInterface *> &taskQueue);
     void taskFinished(RunnableInterface *task);
-    QFuture<void> future();
+    void waitForAllTasks();
 
     int maxThreadCount() const;
 #if QT_CONFIG(qt3d_profile_jobs)
@@ -100,8 +100,8 @@ private:
     int currentCount() const;
 
 private:
-    QFutureInterface<void> *m_futureInterface;
     QMutex m_mutex;
+    QWaitCondition m_tasksFinishedCondition;
     QAtomicInt m_taskCount;
     QThreadPool m_threadPool;
 };
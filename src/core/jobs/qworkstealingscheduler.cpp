@@ -0,0 +1,411 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qworkstealingscheduler_p.h"
+
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThread>
+
+#include <Qt3DCore/private/qaspectjob_p.h>
+
+#if QT_CONFIG(qt3d_profile_jobs)
+#include <Qt3DCore/private/qthreadpooler_p.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DCore {
+
+namespace {
+
+const int TaskChunkSize = 256;
+const int InitialDequeCapacity = 64;
+// Number of unsuccessful steal rounds before a worker goes to sleep
+const int MaxIdleSpins = 64;
+
+} // anonymous
+
+/*!
+    \class Qt3DCore::QWorkStealingWorker
+    \internal
+
+    A worker thread owning a double ended queue of ready tasks. The owner
+    pushes and pops tasks at the back of its queue (LIFO, good cache locality
+    for dependent jobs) while other workers steal from the front (FIFO). The
+    lock of a queue is only ever shared between its owner and the thieves,
+    there is no global lock on the dispatch path.
+*/
+class QWorkStealingWorker : public QThread
+{
+public:
+    typedef QWorkStealingScheduler::Task Task;
+
+    QWorkStealingWorker(QWorkStealingScheduler *scheduler, int index)
+        : m_scheduler(scheduler)
+        , m_index(index)
+        , m_tasks(InitialDequeCapacity)
+        , m_head(0)
+        , m_tail(0)
+        , m_size(0)
+    {
+    }
+
+    void push(Task *task)
+    {
+        const QMutexLocker lock(&m_mutex);
+        const int capacity = m_tasks.size();
+        if (m_tail - m_head == capacity) {
+            // Grow and unwrap the ring buffer, capacity stays a power of 2
+            QVector<Task *> tasks(capacity * 2);
+            for (int i = 0; i < capacity; ++i)
+                tasks[i] = m_tasks.at((m_head + i) & (capacity - 1));
+            m_tasks.swap(tasks);
+            m_head = 0;
+            m_tail = capacity;
+        }
+        m_tasks[m_tail & (m_tasks.size() - 1)] = task;
+        ++m_tail;
+        m_size.storeRelease(m_tail - m_head);
+    }
+
+    Task *pop()
+    {
+        if (m_size.loadAcquire() == 0)
+            return nullptr;
+        const QMutexLocker lock(&m_mutex);
+        if (m_tail == m_head)
+            return nullptr;
+        --m_tail;
+        m_size.storeRelease(m_tail - m_head);
+        return m_tasks.at(m_tail & (m_tasks.size() - 1));
+    }
+
+    Task *steal()
+    {
+        if (m_size.loadAcquire() == 0)
+            return nullptr;
+        const QMutexLocker lock(&m_mutex);
+        if (m_tail == m_head)
+            return nullptr;
+        Task *task = m_tasks.at(m_head & (m_tasks.size() - 1));
+        ++m_head;
+        m_size.storeRelease(m_tail - m_head);
+        return task;
+    }
+
+protected:
+    void run() override
+    {
+        m_scheduler->workerLoop(m_index);
+    }
+
+private:
+    QWorkStealingScheduler *m_scheduler;
+    const int m_index;
+    QMutex m_mutex;
+    QVector<Task *> m_tasks;
+    int m_head;
+    int m_tail;
+    QAtomicInt m_size;
+};
+
+/*!
+    \class Qt3DCore::QWorkStealingScheduler
+    \internal
+
+    Alternative to QThreadPooler which dispatches aspect jobs over per worker
+    task queues. Dependencies are tracked with an atomic counter per task:
+    the worker completing the last dependency of a task enqueues it on its own
+    queue, or runs it directly as a continuation. Tasks are recycled from
+    frame to frame so that steady state scheduling does not allocate.
+
+    It is selected by setting the QT3D_SCHEDULER environment variable to
+    \c workstealing. QT3D_MAX_THREAD_COUNT is honored for the worker count.
+*/
+QWorkStealingScheduler::QWorkStealingScheduler(int workerCount)
+    : m_usedTaskCount(0)
+    , m_queuedTaskCount(0)
+    , m_remainingTaskCount(0)
+    , m_sleepingWorkerCount(0)
+    , m_quit(0)
+    , m_nextWorker(0)
+{
+    workerCount = qMax(1, workerCount);
+    m_workers.reserve(workerCount);
+    for (int i = 0; i < workerCount; ++i)
+        m_workers.push_back(new QWorkStealingWorker(this, i));
+    for (QWorkStealingWorker *worker : qAsConst(m_workers))
+        worker->start();
+#if QT_CONFIG(qt3d_profile_jobs)
+    QThreadPooler::m_jobsStatTimer.start();
+#endif
+}
+
+QWorkStealingScheduler::~QWorkStealingScheduler()
+{
+    waitForAllJobs();
+
+    m_quit.storeRelease(1);
+    {
+        const QMutexLocker lock(&m_sleepMutex);
+        m_workAvailable.wakeAll();
+    }
+    for (QWorkStealingWorker *worker : qAsConst(m_workers)) {
+        worker->wait();
+        delete worker;
+    }
+    for (Task *chunk : qAsConst(m_taskChunks))
+        delete [] chunk;
+}
+
+int QWorkStealingScheduler::defaultWorkerCount()
+{
+    const QByteArray maxThreadCount = qgetenv("QT3D_MAX_THREAD_COUNT");
+    if (!maxThreadCount.isEmpty()) {
+        bool conversionOK = false;
+        const int maxThreadCountValue = maxThreadCount.toInt(&conversionOK);
+        if (conversionOK)
+            return maxThreadCountValue;
+    }
+    return QThread::idealThreadCount();
+}
+
+// Called from the thread driving the frame (aspect thread)
+void QWorkStealingScheduler::schedule(const QVector<QAspectJobPtr> &jobQueue)
+{
+    if (jobQueue.isEmpty())
+        return;
+
+    // Jobs are stamped with the generation of the schedule call they belong
+    // to, this replaces a QAspectJob * -> Task * hash when resolving
+    // dependencies. As with QThreadPooler, dependencies on jobs which are not
+    // part of jobQueue are considered to be already satisfied.
+    const quint32 generation = QAspectJobPrivate::nextScheduleGeneration();
+    const int firstTaskIndex = m_usedTaskCount;
+    for (const QAspectJobPtr &job : jobQueue) {
+        Task *task = allocateTask();
+        task->job = job;
+        QAspectJobPrivate *jobD = QAspectJobPrivate::get(job.data());
+        jobD->m_scheduledTask = task;
+        jobD->m_scheduleGeneration = generation;
+    }
+
+    m_rootTasks.clear();
+    for (int i = firstTaskIndex, m = m_usedTaskCount; i < m; ++i) {
+        Task *task = taskAt(i);
+        const QVector<QWeakPointer<QAspectJob> > &dependencies = QAspectJobPrivate::get(task->job.data())->m_dependencies;
+        int dependencyCount = 0;
+        for (const QWeakPointer<QAspectJob> &dependency : dependencies) {
+            QAspectJob *dependee = dependency.data();
+            if (!dependee)
+                continue;
+            QAspectJobPrivate *dependeeD = QAspectJobPrivate::get(dependee);
+            if (dependeeD->m_scheduleGeneration == generation) {
+                static_cast<Task *>(dependeeD->m_scheduledTask)->dependers.push_back(task);
+                ++dependencyCount;
+            }
+        }
+        task->pendingDependencies.store(dependencyCount);
+        if (dependencyCount == 0)
+            m_rootTasks.push_back(task);
+    }
+
+    // Roots have to be collected before anything gets submitted, workers
+    // start decrementing the dependency counters right away
+    m_remainingTaskCount.fetchAndAddOrdered(m_usedTaskCount - firstTaskIndex);
+    for (Task *task : qAsConst(m_rootTasks))
+        submit(task, -1);
+}
+
+// Called from the thread driving the frame, runs func exactly once on each worker
+void QWorkStealingScheduler::runOnEachWorker(QAbstractAspectJobManager::JobFunction func, void *arg)
+{
+    const int workerCount = m_workers.size();
+    QAtomicInt barrier(workerCount);
+
+    m_remainingTaskCount.fetchAndAddOrdered(workerCount);
+    for (int i = 0; i < workerCount; ++i) {
+        Task *task = allocateTask();
+        task->func = func;
+        task->arg = arg;
+        task->barrier = &barrier;
+        submit(task, i);
+    }
+
+    // Each sync task blocks its worker until all of them have started, which
+    // guarantees that every worker ran func once
+    waitForAllJobs();
+}
+
+void QWorkStealingScheduler::waitForAllJobs()
+{
+    {
+        QMutexLocker lock(&m_doneMutex);
+        while (m_remainingTaskCount.loadAcquire() > 0)
+            m_allTasksDone.wait(&m_doneMutex);
+    }
+    recycleTasks();
+}
+
+QWorkStealingScheduler::Task *QWorkStealingScheduler::allocateTask()
+{
+    const int chunkIndex = m_usedTaskCount / TaskChunkSize;
+    if (chunkIndex == m_taskChunks.size())
+        m_taskChunks.push_back(new Task[TaskChunkSize]);
+    return taskAt(m_usedTaskCount++);
+}
+
+QWorkStealingScheduler::Task *QWorkStealingScheduler::taskAt(int index) const
+{
+    return &m_taskChunks.at(index / TaskChunkSize)[index % TaskChunkSize];
+}
+
+// Only called once no task is in flight, keeps the dependers capacity around
+void QWorkStealingScheduler::recycleTasks()
+{
+    for (int i = 0; i < m_usedTaskCount; ++i) {
+        Task *task = taskAt(i);
+        task->job.reset();
+        task->func = nullptr;
+        task->arg = nullptr;
+        task->barrier = nullptr;
+        task->dependers.clear();
+    }
+    m_usedTaskCount = 0;
+}
+
+// workerIndex is -1 when called from outside of the workers
+void QWorkStealingScheduler::submit(Task *task, int workerIndex)
+{
+    if (workerIndex < 0) {
+        workerIndex = m_nextWorker;
+        m_nextWorker = (m_nextWorker + 1) % m_workers.size();
+    }
+
+    // Incremented before the push so that a sleeping worker never misses it
+    m_queuedTaskCount.fetchAndAddOrdered(1);
+    m_workers.at(workerIndex)->push(task);
+
+    if (m_sleepingWorkerCount.loadAcquire() > 0) {
+        const QMutexLocker lock(&m_sleepMutex);
+        m_workAvailable.wakeOne();
+    }
+}
+
+QWorkStealingScheduler::Task *QWorkStealingScheduler::acquireTask(int workerIndex)
+{
+    Task *task = m_workers.at(workerIndex)->pop();
+    const int workerCount = m_workers.size();
+    for (int i = 1; !task && i < workerCount; ++i)
+        task = m_workers.at((workerIndex + i) % workerCount)->steal();
+    if (task)
+        m_queuedTaskCount.fetchAndAddOrdered(-1);
+    return task;
+}
+
+void QWorkStealingScheduler::execute(Task *task, int workerIndex)
+{
+    while (task) {
+        if (task->func) {
+            task->func(task->arg);
+            task->barrier->deref();
+            while (task->barrier->loadAcquire() > 0)
+                QThread::yieldCurrentThread();
+        } else {
+#if QT_CONFIG(qt3d_profile_jobs)
+            QAspectJobPrivate *jobD = QAspectJobPrivate::get(task->job.data());
+            jobD->m_stats.startTime = QThreadPooler::m_jobsStatTimer.nsecsElapsed();
+            jobD->m_stats.threadId = reinterpret_cast<quint64>(QThread::currentThreadId());
+#endif
+            task->job->run();
+#if QT_CONFIG(qt3d_profile_jobs)
+            jobD->m_stats.endTime = QThreadPooler::m_jobsStatTimer.nsecsElapsed();
+            QThreadPooler::addJobLogStatsEntry(jobD->m_stats);
+#endif
+        }
+
+        // Keep the first depender which became ready as a continuation,
+        // hand the others over to the queue where they can be stolen
+        Task *next = nullptr;
+        for (Task *depender : qAsConst(task->dependers)) {
+            if (!depender->pendingDependencies.deref()) {
+                if (next)
+                    submit(depender, workerIndex);
+                else
+                    next = depender;
+            }
+        }
+
+        // task must not be touched past this point, it might be recycled
+        if (!m_remainingTaskCount.deref()) {
+            const QMutexLocker lock(&m_doneMutex);
+            m_allTasksDone.wakeAll();
+        }
+        task = next;
+    }
+}
+
+void QWorkStealingScheduler::workerLoop(int workerIndex)
+{
+    int idleSpins = 0;
+    while (!m_quit.loadAcquire()) {
+        Task *task = acquireTask(workerIndex);
+        if (task) {
+            idleSpins = 0;
+            execute(task, workerIndex);
+            continue;
+        }
+
+        if (++idleSpins < MaxIdleSpins) {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+
+        idleSpins = 0;
+        QMutexLocker lock(&m_sleepMutex);
+        m_sleepingWorkerCount.fetchAndAddOrdered(1);
+        while (!m_quit.loadAcquire() && m_queuedTaskCount.loadAcquire() == 0)
+            m_workAvailable.wait(&m_sleepMutex);
+        m_sleepingWorkerCount.fetchAndAddOrdered(-1);
+    }
+}
+
+} // namespace Qt3DCore
+
+QT_END_NAMESPACE
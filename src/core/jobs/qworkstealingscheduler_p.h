@@ -0,0 +1,129 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QT3DCORE_QWORKSTEALINGSCHEDULER_P_H
+#define QT3DCORE_QWORKSTEALINGSCHEDULER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QMutex>
+#include <QtCore/QVarLengthArray>
+#include <QtCore/QVector>
+#include <QtCore/QWaitCondition>
+
+#include <Qt3DCore/qaspectjob.h>
+#include <Qt3DCore/private/qabstractaspectjobmanager_p.h>
+#include <Qt3DCore/private/qt3dcore_global_p.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DCore {
+
+class QWorkStealingWorker;
+
+class QT3DCORE_PRIVATE_EXPORT QWorkStealingScheduler
+{
+public:
+    struct Task
+    {
+        QAspectJobPtr job;
+        QAbstractAspectJobManager::JobFunction func = nullptr;
+        void *arg = nullptr;
+        QAtomicInt *barrier = nullptr;
+        QAtomicInt pendingDependencies;
+        QVarLengthArray<Task *, 4> dependers;
+    };
+
+    explicit QWorkStealingScheduler(int workerCount = defaultWorkerCount());
+    ~QWorkStealingScheduler();
+
+    static int defaultWorkerCount();
+
+    void schedule(const QVector<QAspectJobPtr> &jobQueue);
+    void runOnEachWorker(QAbstractAspectJobManager::JobFunction func, void *arg);
+    void waitForAllJobs();
+
+    int workerCount() const { return m_workers.size(); }
+
+private:
+    Task *allocateTask();
+    Task *taskAt(int index) const;
+    void recycleTasks();
+    void submit(Task *task, int workerIndex);
+    Task *acquireTask(int workerIndex);
+    void execute(Task *task, int workerIndex);
+    void workerLoop(int workerIndex);
+
+    QVector<QWorkStealingWorker *> m_workers;
+
+    // Task storage is recycled from frame to frame, chunks are never freed
+    // before destruction so that Task pointers stay valid while workers run
+    QVector<Task *> m_taskChunks;
+    int m_usedTaskCount;
+    QVector<Task *> m_rootTasks;
+
+    QAtomicInt m_queuedTaskCount;
+    QAtomicInt m_remainingTaskCount;
+    QAtomicInt m_sleepingWorkerCount;
+    QAtomicInt m_quit;
+    int m_nextWorker;
+
+    QMutex m_sleepMutex;
+    QWaitCondition m_workAvailable;
+    QMutex m_doneMutex;
+    QWaitCondition m_allTasksDone;
+
+    friend class QWorkStealingWorker;
+};
+
+} // namespace Qt3DCore
+
+QT_END_NAMESPACE
+
+#endif // QT3DCORE_QWORKSTEALINGSCHEDULER_P_H
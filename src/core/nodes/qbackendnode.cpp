@@ -95,6 +95,21 @@ QBackendNodePrivate *QBackendNodePrivate::get(QBackendNode *n)
     return n->d_func();
 }
 
+/*! \internal */
+QBackendNodeBulkMapper::~QBackendNodeBulkMapper()
+{
+}
+
+/*! \internal */
+QVector<QNodeId> QBackendNodeBulkMapper::subjectIds(const QVector<QNodeCreatedChangeBasePtr> &changes)
+{
+    QVector<QNodeId> ids;
+    ids.reserve(changes.size());
+    for (const QNodeCreatedChangeBasePtr &change : changes)
+        ids.push_back(change->subjectId());
+    return ids;
+}
+
 /*!
  * \class Qt3DCore::QBackendNodeMapper
  * \inheaderfile Qt3DCore/QBackendNodeMapper
@@ -52,7 +52,9 @@
 //
 
 #include <Qt3DCore/qbackendnode.h>
+#include <Qt3DCore/qnodecreatedchange.h>
 #include <Qt3DCore/qnodeid.h>
+#include <QtCore/QVector>
 
 #include <Qt3DCore/private/qlockableobserverinterface_p.h>
 #include <Qt3DCore/private/qobservableinterface_p.h>
@@ -89,6 +91,23 @@ private:
     Q_DISABLE_COPY(QBackendNodePrivate)
 };
 
+// Implemented by the QBackendNodeMapper subclasses which can create the
+// backend nodes of many creation changes at once, returning one backend
+// node per change
+class QT3DCORE_PRIVATE_EXPORT QBackendNodeBulkMapper
+{
+public:
+    virtual ~QBackendNodeBulkMapper();
+
+    // Only allocates the resources of the backend nodes, may be called from
+    // any thread before createMany() receives the same changes
+    virtual void acquireMany(const QVector<QNodeCreatedChangeBasePtr> &changes) const = 0;
+    virtual QVector<QBackendNode *> createMany(const QVector<QNodeCreatedChangeBasePtr> &changes) const = 0;
+
+protected:
+    static QVector<QNodeId> subjectIds(const QVector<QNodeCreatedChangeBasePtr> &changes);
+};
+
 } // Qt3D
 
 QT_END_NAMESPACE
@@ -389,6 +389,9 @@ void QNodePrivate::propertyChanged(int propertyIndex)
     if (m_blockNotifications)
         return;
 
+    if (sendTypedPropertyChange(propertyIndex))
+        return;
+
     const auto toBackendValue = [](const QVariant &data) -> QVariant
     {
         if (data.canConvert<QNode*>()) {
@@ -613,6 +616,12 @@ void QNodePrivate::notifyPropertyChange(const char *name, const QVariant &value)
     notifyObservers(e);
 }
 
+bool QNodePrivate::sendTypedPropertyChange(int propertyIndex)
+{
+    Q_UNUSED(propertyIndex);
+    return false;
+}
+
 void QNodePrivate::notifyDynamicPropertyChange(const QByteArray &name, const QVariant &value)
 {
     // Bail out early if we can to avoid operator new
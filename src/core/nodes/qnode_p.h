@@ -59,6 +59,7 @@
 #include <Qt3DCore/private/qchangearbiter_p.h>
 #include <Qt3DCore/private/qobservableinterface_p.h>
 #include <Qt3DCore/private/qt3dcore_global_p.h>
+#include <Qt3DCore/private/qtypedpropertyupdatechange_p.h>
 #include <QtCore/private/qobject_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -85,6 +86,20 @@ public:
     void notifyDynamicPropertyChange(const QByteArray &name, const QVariant &value);
     void notifyObservers(const QSceneChangePtr &change) override;
 
+    template<typename T>
+    void notifyTypedPropertyChange(const char *name, int propertyId, const T &value)
+    {
+        // Bail out early if we can to avoid acquiring a change
+        if (m_blockNotifications)
+            return;
+        notifyObservers(QTypedPropertyUpdatedChange<T>::create(m_id, name, propertyId, value));
+    }
+
+    // Lets nodes send typed changes for their frequently updated properties
+    // instead of going through the QVariant based notification. Returns true
+    // if a change was sent for the property
+    virtual bool sendTypedPropertyChange(int propertyIndex);
+
     void insertTree(QNode *treeRoot, int depth = 0);
     void updatePropertyTrackMode();
 
@@ -39,9 +39,13 @@
 
 #include "qchangearbiter_p.h"
 
+#include <Qt3DCore/qaspectjob.h>
 #include <Qt3DCore/qcomponent.h>
+#include <Qt3DCore/qpropertyupdatedchange.h>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QMutexLocker>
 #include <QtCore/QReadLocker>
+#include <QtCore/QSet>
 #include <QtCore/QThread>
 #include <QtCore/QWriteLocker>
 
@@ -51,10 +55,89 @@
 #include <Qt3DCore/private/qscene_p.h>
 #include <Qt3DCore/private/qsceneobserverinterface_p.h>
 
+#include <functional>
+
 QT_BEGIN_NAMESPACE
 
 namespace Qt3DCore {
 
+namespace {
+
+struct PropertyCoalescingRegistry
+{
+    QReadWriteLock lock;
+    QHash<QByteArray, QChangeArbiter::PropertyChangeMerger> mergers;
+    QSet<QByteArray> uncoalescedProperties;
+};
+
+Q_GLOBAL_STATIC(PropertyCoalescingRegistry, propertyCoalescingRegistry)
+
+// Below this many changes, delivering them serially is cheaper than
+// going through the job manager
+const size_t parallelDistributionThreshold = 256;
+
+struct ChangeDelivery
+{
+    QObserverInterface *observer;
+    const QSceneChangePtr *change;
+};
+
+// Delivers, in order, the changes targeting the observers of one aspect
+class ChangeDeliveryJob : public QAspectJob
+{
+public:
+    void run() override
+    {
+        for (const ChangeDelivery &delivery : qAsConst(m_deliveries))
+            delivery.observer->sceneChangeEvent(*delivery.change);
+    }
+
+    QVector<ChangeDelivery> m_deliveries;
+};
+
+typedef QSharedPointer<ChangeDeliveryJob> ChangeDeliveryJobPtr;
+
+// Lets a scene observer create the backend nodes of a run of node creations
+class NodeCreationJob : public QAspectJob
+{
+public:
+    explicit NodeCreationJob(const std::function<void ()> &createNodes)
+        : m_createNodes(createNodes)
+    {
+    }
+
+    void run() override
+    {
+        m_createNodes();
+    }
+
+private:
+    std::function<void ()> m_createNodes;
+};
+
+// Returns the end of the run of node creations starting at first
+size_t nodeCreationRunEnd(const std::vector<QSceneChangePtr> &queue, size_t first)
+{
+    size_t last = first;
+    while (last < queue.size() && !queue[last].isNull() && queue[last]->type() == NodeCreated)
+        ++last;
+    return last;
+}
+
+void takeQueueChanges(std::vector<QSceneChangePtr> *queue, std::vector<QSceneChangePtr> *changes)
+{
+    if (changes->empty()) {
+        changes->swap(*queue);
+    } else {
+        changes->insert(changes->end(),
+                        std::make_move_iterator(queue->begin()),
+                        std::make_move_iterator(queue->end()));
+        queue->clear();
+    }
+}
+
+} // anonymous
+
 /* !\internal
     \class Qt3DCore::QChangeArbiter
     \inmodule Qt3DCore
@@ -80,6 +163,8 @@ QChangeArbiter::QChangeArbiter(QObject *parent)
     , m_jobManager(nullptr)
     , m_postman(nullptr)
     , m_scene(nullptr)
+    , m_coalescingEnabled(!qEnvironmentVariableIsSet("QT3D_DISABLE_CHANGE_COALESCING"))
+    , m_parallelDistributionEnabled(!qEnvironmentVariableIsSet("QT3D_DISABLE_PARALLEL_CHANGE_DISTRIBUTION"))
 {
     // The QMutex has to be recursive to handle the case where :
     // 1) SyncChanges is called, mutex is locked
@@ -107,41 +192,262 @@ void QChangeArbiter::initialize(QAbstractAspectJobManager *jobManager)
     m_jobManager->waitForPerThreadFunction(QChangeArbiter::createThreadLocalChangeQueue, this);
 }
 
+void QChangeArbiter::distributeChange(const QSceneChangePtr &change)
+{
+    // Lookup which observers care about the subject this change came from
+    // and distribute the change to them
+    if (change.isNull())
+        return;
+
+    if (change->type() == NodeCreated) {
+        for (QSceneObserverInterface *observer : qAsConst(m_sceneObservers))
+            observer->sceneNodeAdded(change);
+    } else if (change->type() == NodeDeleted) {
+        for (QSceneObserverInterface *observer : qAsConst(m_sceneObservers))
+            observer->sceneNodeRemoved(change);
+    }
+
+    distributeChangeToObservers(change);
+}
+
+// Delivers a change to the observers of its subject and to the postman
+void QChangeArbiter::distributeChangeToObservers(const QSceneChangePtr &change)
+{
+    const QNodeId nodeId = change->subjectId();
+    const auto it = m_nodeObservations.constFind(nodeId);
+    if (it != m_nodeObservations.cend()) {
+        const QObserverList &observers = it.value();
+        for (const QObservation &observation : observers) {
+            if ((change->type() & observation.changeFlags) &&
+                    (change->deliveryFlags() & QSceneChange::BackendNodes))
+                observation.observer->sceneChangeEvent(change);
+        }
+        // Also send change to the postman
+        if (change->deliveryFlags() & QSceneChange::Nodes) {
+            // Check if QNode actually cares about the change
+            if (m_postman->shouldNotifyFrontend(change))
+                m_postman->sceneChangeEvent(change);
+        }
+    }
+}
+
+// Scene observers receive the whole run of node creations at once, which lets
+// them create and register the backend nodes in bulk. For large runs, one job
+// per scene observer first allocates the resources of its backend nodes. The
+// backend nodes are then created and initialized from this thread. The
+// observers of the new nodes get their creation change after the whole run
+int QChangeArbiter::distributeNodeCreations(const QChangeQueue &changeQueue, size_t first, size_t last,
+                                            QMutexLocker *locker)
+{
+    QVector<QSceneChangePtr> changes;
+    changes.reserve(int(last - first));
+    for (size_t i = first; i < last; ++i)
+        changes.push_back(changeQueue[i]);
+
+    int jobCount = 0;
+    if (locker != nullptr && m_sceneObservers.size() > 1 && last - first >= parallelDistributionThreshold) {
+        QVector<QAspectJobPtr> jobs;
+        jobs.reserve(m_sceneObservers.size());
+        for (QSceneObserverInterface *observer : qAsConst(m_sceneObservers))
+            jobs.push_back(QSharedPointer<NodeCreationJob>::create([observer, &changes] {
+                observer->sceneNodesAboutToBeAdded(changes);
+            }));
+
+        locker->unlock();
+        m_jobManager->enqueueJobs(jobs);
+        m_jobManager->waitForAllJobs();
+        locker->relock();
+        jobCount = jobs.size();
+    }
+
+    for (QSceneObserverInterface *observer : qAsConst(m_sceneObservers))
+        observer->sceneNodesAdded(changes);
+
+    for (size_t i = first; i < last; ++i)
+        distributeChangeToObservers(changeQueue[i]);
+    return jobCount;
+}
+
 void QChangeArbiter::distributeQueueChanges(QChangeQueue *changeQueue)
 {
-    for (int i = 0, n = int(changeQueue->size()); i < n; i++) {
-        QSceneChangePtr& change = (*changeQueue)[i];
-        // Lookup which observers care about the subject this change came from
-        // and distribute the change to them
-        if (change.isNull())
-            continue;
+    size_t i = 0;
+    const size_t n = changeQueue->size();
+    while (i < n) {
+        const size_t last = nodeCreationRunEnd(*changeQueue, i);
+        if (last > i) {
+            distributeNodeCreations(*changeQueue, i, last, nullptr);
+            i = last;
+        } else {
+            distributeChange((*changeQueue)[i++]);
+        }
+    }
+    changeQueue->clear();
+}
 
+// Node creations and destructions make the scene observers create or destroy
+// backend nodes, and register or unregister observers. They split the queue in
+// ranges of changes whose observers are all known upfront. Each range is then
+// delivered in parallel, one job per aspect, which preserves the order of the
+// changes for every backend node
+void QChangeArbiter::distributeQueueChangesInParallel(QChangeQueue *changeQueue, QMutexLocker *locker)
+{
+    int jobCount = 0;
+    size_t first = 0;
+    for (size_t i = 0, n = changeQueue->size(); i < n; ++i) {
+        const QSceneChangePtr &change = (*changeQueue)[i];
+        if (change.isNull() || (change->type() != NodeCreated && change->type() != NodeDeleted))
+            continue;
+        jobCount = qMax(jobCount, distributeChangeRangeInParallel(*changeQueue, first, i, locker));
         if (change->type() == NodeCreated) {
-            for (QSceneObserverInterface *observer : qAsConst(m_sceneObservers))
-                observer->sceneNodeAdded(change);
-        } else if (change->type() == NodeDeleted) {
-            for (QSceneObserverInterface *observer : qAsConst(m_sceneObservers))
-                observer->sceneNodeRemoved(change);
+            const size_t last = nodeCreationRunEnd(*changeQueue, i);
+            jobCount = qMax(jobCount, distributeNodeCreations(*changeQueue, i, last, locker));
+            i = last - 1;
+        } else {
+            distributeChange(change);
         }
+        first = i + 1;
+    }
+    jobCount = qMax(jobCount, distributeChangeRangeInParallel(*changeQueue, first, changeQueue->size(), locker));
+    m_lastSyncStatistics.parallelJobs = jobCount;
+    changeQueue->clear();
+}
+
+// Returns the number of jobs used, 0 when the range was delivered serially
+int QChangeArbiter::distributeChangeRangeInParallel(const QChangeQueue &changeQueue, size_t first, size_t last,
+                                                    QMutexLocker *locker)
+{
+    if (last - first < parallelDistributionThreshold) {
+        for (size_t i = first; i < last; ++i)
+            distributeChange(changeQueue[i]);
+        return 0;
+    }
 
-        const QNodeId nodeId = change->subjectId();
-        const auto it = m_nodeObservations.constFind(nodeId);
-        if (it != m_nodeObservations.cend()) {
-            const QObserverList &observers = it.value();
-            for (const QObserverPair &observer : observers) {
-                if ((change->type() & observer.first) &&
-                        (change->deliveryFlags() & QSceneChange::BackendNodes))
-                    observer.second->sceneChangeEvent(change);
+    QHash<const QAbstractAspect *, ChangeDeliveryJobPtr> aspectJobs;
+    // Observers outside of any aspect and the postman are delivered from
+    // this thread once the jobs are done
+    QVector<ChangeDelivery> localDeliveries;
+
+    for (size_t i = first; i < last; ++i) {
+        const QSceneChangePtr &change = changeQueue[i];
+        if (change.isNull())
+            continue;
+
+        const auto it = m_nodeObservations.constFind(change->subjectId());
+        if (it == m_nodeObservations.cend())
+            continue;
+
+        if (change->deliveryFlags() & QSceneChange::BackendNodes) {
+            for (const QObservation &observation : it.value()) {
+                if (!(change->type() & observation.changeFlags))
+                    continue;
+                const ChangeDelivery delivery = { observation.observer, &change };
+                if (observation.aspect == nullptr) {
+                    localDeliveries.push_back(delivery);
+                } else {
+                    ChangeDeliveryJobPtr &job = aspectJobs[observation.aspect];
+                    if (job.isNull())
+                        job.reset(new ChangeDeliveryJob);
+                    job->m_deliveries.push_back(delivery);
+                }
             }
-            // Also send change to the postman
-            if (change->deliveryFlags() & QSceneChange::Nodes) {
-                // Check if QNode actually cares about the change
-                if (m_postman->shouldNotifyFrontend(change))
-                    m_postman->sceneChangeEvent(change);
+        }
+        if ((change->deliveryFlags() & QSceneChange::Nodes) && m_postman->shouldNotifyFrontend(change)) {
+            const ChangeDelivery delivery = { m_postman, &change };
+            localDeliveries.push_back(delivery);
+        }
+    }
+
+    QVector<QAspectJobPtr> jobs;
+    jobs.reserve(aspectJobs.size());
+    for (const ChangeDeliveryJobPtr &job : qAsConst(aspectJobs))
+        jobs.push_back(job);
+
+    if (jobs.size() > 1) {
+        // Backend nodes may register observers while handling their changes,
+        // the observations of the range were looked up already
+        locker->unlock();
+        m_jobManager->enqueueJobs(jobs);
+        m_jobManager->waitForAllJobs();
+        locker->relock();
+    } else if (!jobs.isEmpty()) {
+        jobs.first()->run();
+    }
+
+    for (const ChangeDelivery &delivery : qAsConst(localDeliveries))
+        delivery.observer->sceneChangeEvent(*delivery.change);
+
+    return jobs.size() > 1 ? jobs.size() : 0;
+}
+
+// Only applied to the locking queues, which receive the changes the QPostman
+// batches from the frontend nodes. When a property of a node is updated several
+// times, only the last update gets delivered. Properties which have a merger
+// registered, such as Buffer updateData ranges, have the previous value merged
+// into the last one instead, as long as no other change of the node was made in
+// between. Properties whose updates are events are never coalesced
+void QChangeArbiter::coalesceQueueChanges(QChangeQueue *changeQueue)
+{
+    if (changeQueue->size() < 2)
+        return;
+
+    typedef QPair<QNodeId, QByteArray> PropertyKey;
+    QHash<PropertyKey, size_t> lastPropertyUpdates;
+    QHash<QNodeId, size_t> lastSubjectChanges;
+    quint64 droppedChanges = 0;
+    quint64 mergedChanges = 0;
+
+    PropertyCoalescingRegistry *registry = propertyCoalescingRegistry();
+    QReadLocker registryLocker(&registry->lock);
+
+    for (size_t i = 0, n = changeQueue->size(); i < n; ++i) {
+        const QSceneChangePtr &change = (*changeQueue)[i];
+        if (change.isNull())
+            continue;
+
+        const QNodeId subjectId = change->subjectId();
+        QStaticPropertyUpdatedChangeBase *update = change->type() == PropertyUpdated
+                ? dynamic_cast<QStaticPropertyUpdatedChangeBase *>(change.data())
+                : nullptr;
+
+        if (update != nullptr) {
+            const QByteArray propertyName = QByteArray::fromRawData(update->propertyName(),
+                                                                    int(qstrlen(update->propertyName())));
+            if (!registry->uncoalescedProperties.contains(propertyName)) {
+                const PropertyKey key(subjectId, propertyName);
+                const auto it = lastPropertyUpdates.find(key);
+                if (it != lastPropertyUpdates.end()) {
+                    QSceneChangePtr &previousChange = (*changeQueue)[it.value()];
+                    const PropertyChangeMerger merger = registry->mergers.value(propertyName);
+                    if (merger == nullptr) {
+                        previousChange.reset();
+                        ++droppedChanges;
+                    } else if (lastSubjectChanges.value(subjectId) == it.value()) {
+                        QPropertyUpdatedChange *previousUpdate = dynamic_cast<QPropertyUpdatedChange *>(previousChange.data());
+                        QPropertyUpdatedChange *valueUpdate = dynamic_cast<QPropertyUpdatedChange *>(update);
+                        if (previousUpdate != nullptr && valueUpdate != nullptr) {
+                            QVariant value = valueUpdate->value();
+                            if (merger(previousUpdate->value(), &value)) {
+                                valueUpdate->setValue(value);
+                                previousChange.reset();
+                                ++mergedChanges;
+                            }
+                        }
+                    }
+                    it.value() = i;
+                } else {
+                    lastPropertyUpdates.insert(key, i);
+                }
             }
         }
+        lastSubjectChanges.insert(subjectId, i);
+    }
+
+    if (droppedChanges + mergedChanges > 0) {
+        qCDebug(ChangeArbiter) << Q_FUNC_INFO << "Dropped" << droppedChanges
+                               << "and merged" << mergedChanges << "property updates";
+        m_coalescingStatistics.droppedChanges += droppedChanges;
+        m_coalescingStatistics.mergedChanges += mergedChanges;
     }
-    changeQueue->clear();
 }
 
 QThreadStorage<QChangeArbiter::QChangeQueue *> *QChangeArbiter::tlsChangeQueue()
@@ -175,12 +481,85 @@ void QChangeArbiter::removeLockingChangeQueue(QChangeArbiter::QChangeQueue *queu
 
 void QChangeArbiter::syncChanges()
 {
+    QElapsedTimer timer;
+    timer.start();
     QMutexLocker locker(&m_mutex);
+
+    // Changes sent while these are being delivered go to the now empty
+    // queues and will be delivered by the next sync
+    QChangeQueue changes;
     for (QChangeArbiter::QChangeQueue *changeQueue : qAsConst(m_changeQueues))
-        distributeQueueChanges(changeQueue);
+        takeQueueChanges(changeQueue, &changes);
+
+    for (QChangeQueue *changeQueue : qAsConst(m_lockingChangeQueues)) {
+        if (m_coalescingEnabled)
+            coalesceQueueChanges(changeQueue);
+        takeQueueChanges(changeQueue, &changes);
+    }
+
+    const quint64 changeCount = changes.size();
+    m_lastSyncStatistics.parallelJobs = 0;
+    if (m_parallelDistributionEnabled && m_jobManager != nullptr && changeCount >= parallelDistributionThreshold)
+        distributeQueueChangesInParallel(&changes, &locker);
+    else
+        distributeQueueChanges(&changes);
+
+    m_lastSyncStatistics.syncTime = timer.nsecsElapsed();
+    m_lastSyncStatistics.processedChanges = changeCount;
+    if (changeCount > 0)
+        qCDebug(ChangeArbiter) << Q_FUNC_INFO << "Delivered" << changeCount << "changes in"
+                               << m_lastSyncStatistics.syncTime / 1.0e6 << "ms using"
+                               << m_lastSyncStatistics.parallelJobs << "jobs";
+}
+
+void QChangeArbiter::registerPropertyChangeMerger(const QByteArray &propertyName, PropertyChangeMerger merger)
+{
+    PropertyCoalescingRegistry *registry = propertyCoalescingRegistry();
+    QWriteLocker locker(&registry->lock);
+    registry->mergers.insert(propertyName, merger);
+}
 
-    for (QChangeQueue *changeQueue : qAsConst(m_lockingChangeQueues))
-        distributeQueueChanges(changeQueue);
+void QChangeArbiter::registerUncoalescedProperty(const QByteArray &propertyName)
+{
+    PropertyCoalescingRegistry *registry = propertyCoalescingRegistry();
+    QWriteLocker locker(&registry->lock);
+    registry->uncoalescedProperties.insert(propertyName);
+}
+
+bool QChangeArbiter::isCoalescingEnabled() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_coalescingEnabled;
+}
+
+void QChangeArbiter::setCoalescingEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    m_coalescingEnabled = enabled;
+}
+
+QChangeArbiter::CoalescingStatistics QChangeArbiter::coalescingStatistics() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_coalescingStatistics;
+}
+
+bool QChangeArbiter::isParallelDistributionEnabled() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_parallelDistributionEnabled;
+}
+
+void QChangeArbiter::setParallelDistributionEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    m_parallelDistributionEnabled = enabled;
+}
+
+QChangeArbiter::SyncStatistics QChangeArbiter::lastSyncStatistics() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_lastSyncStatistics;
 }
 
 void QChangeArbiter::setScene(QScene *scene)
@@ -200,11 +579,25 @@ QScene *QChangeArbiter::scene() const
 
 void QChangeArbiter::registerObserver(QObserverInterface *observer,
                                       QNodeId nodeId,
-                                      ChangeFlags changeFlags)
+                                      ChangeFlags changeFlags,
+                                      const QAbstractAspect *aspect)
 {
     QMutexLocker locker(&m_mutex);
     QObserverList &observerList = m_nodeObservations[nodeId];
-    observerList.append(QObserverPair(changeFlags, observer));
+    const QObservation observation = { changeFlags, observer, aspect };
+    observerList.append(observation);
+}
+
+void QChangeArbiter::registerObservers(const QVector<QPair<QObserverInterface *, QNodeId>> &observers,
+                                       ChangeFlags changeFlags,
+                                       const QAbstractAspect *aspect)
+{
+    QMutexLocker locker(&m_mutex);
+    m_nodeObservations.reserve(m_nodeObservations.size() + observers.size());
+    for (const auto &observerAndId : observers) {
+        const QObservation observation = { changeFlags, observerAndId.first, aspect };
+        m_nodeObservations[observerAndId.second].append(observation);
+    }
 }
 
 // Called from the QAspectThread context, no need to lock
@@ -221,7 +614,7 @@ void QChangeArbiter::unregisterObserver(QObserverInterface *observer, QNodeId no
     if (it != m_nodeObservations.end()) {
         QObserverList &observers = it.value();
         for (int i = observers.count() - 1; i >= 0; i--) {
-            if (observers[i].second == observer)
+            if (observers[i].observer == observer)
                 observers.removeAt(i);
         }
         if (observers.isEmpty())
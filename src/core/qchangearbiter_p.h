@@ -71,6 +71,7 @@ namespace Qt3DCore {
 
 class QNode;
 class QObservableInterface;
+class QAbstractAspect;
 class QAbstractAspectJobManager;
 class QSceneObserverInterface;
 class QAbstractPostman;
@@ -98,7 +99,11 @@ public:
 
     void registerObserver(QObserverInterface *observer,
                           QNodeId nodeId,
-                          ChangeFlags changeFlags = AllChanges);
+                          ChangeFlags changeFlags = AllChanges,
+                          const QAbstractAspect *aspect = nullptr);
+    void registerObservers(const QVector<QPair<QObserverInterface *, QNodeId>> &observers,
+                           ChangeFlags changeFlags = AllChanges,
+                           const QAbstractAspect *aspect = nullptr);
     void unregisterObserver(QObserverInterface *observer,
                             QNodeId nodeId);
 
@@ -115,6 +120,34 @@ public:
     QAbstractPostman *postman() const final;
     QScene *scene() const;
 
+    // Merges the value of an update of a property into the value of a later
+    // update of the same property. Returns false when both need to be delivered
+    typedef bool (*PropertyChangeMerger)(const QVariant &previousValue, QVariant *value);
+
+    static void registerPropertyChangeMerger(const QByteArray &propertyName, PropertyChangeMerger merger);
+    static void registerUncoalescedProperty(const QByteArray &propertyName);
+
+    struct CoalescingStatistics
+    {
+        quint64 droppedChanges = 0;
+        quint64 mergedChanges = 0;
+    };
+
+    bool isCoalescingEnabled() const;
+    void setCoalescingEnabled(bool enabled);
+    CoalescingStatistics coalescingStatistics() const;
+
+    struct SyncStatistics
+    {
+        qint64 syncTime = 0; // in nanoseconds
+        quint64 processedChanges = 0;
+        int parallelJobs = 0; // 0 when all changes were delivered serially
+    };
+
+    bool isParallelDistributionEnabled() const;
+    void setParallelDistributionEnabled(bool enabled);
+    SyncStatistics lastSyncStatistics() const;
+
     static void createUnmanagedThreadLocalChangeQueue(void *changeArbiter);
     static void destroyUnmanagedThreadLocalChangeQueue(void *changeArbiter);
     static void createThreadLocalChangeQueue(void *changeArbiter);
@@ -122,10 +155,23 @@ public:
 
 protected:
     typedef std::vector<QSceneChangePtr> QChangeQueue;
-    typedef QPair<ChangeFlags, QObserverInterface *> QObserverPair;
-    typedef QVector<QObserverPair> QObserverList;
-
+    struct QObservation
+    {
+        ChangeFlags changeFlags;
+        QObserverInterface *observer;
+        const QAbstractAspect *aspect;
+    };
+    typedef QVector<QObservation> QObserverList;
+
+    void distributeChange(const QSceneChangePtr &change);
+    void distributeChangeToObservers(const QSceneChangePtr &change);
+    int distributeNodeCreations(const QChangeQueue &queue, size_t first, size_t last,
+                                QMutexLocker *locker);
     void distributeQueueChanges(QChangeQueue *queue);
+    void distributeQueueChangesInParallel(QChangeQueue *queue, QMutexLocker *locker);
+    int distributeChangeRangeInParallel(const QChangeQueue &queue, size_t first, size_t last,
+                                        QMutexLocker *locker);
+    void coalesceQueueChanges(QChangeQueue *queue);
 
     QThreadStorage<QChangeQueue *> *tlsChangeQueue();
     void appendChangeQueue(QChangeQueue *queue);
@@ -134,7 +180,7 @@ protected:
     void removeLockingChangeQueue(QChangeQueue *queue);
 
 private:
-    QMutex m_mutex;
+    mutable QMutex m_mutex;
     QAbstractAspectJobManager *m_jobManager;
 
     // The lists of observers indexed by observable (QNodeId).
@@ -152,6 +198,16 @@ private:
     QList<QChangeQueue *> m_lockingChangeQueues;
     QAbstractPostman *m_postman;
     QScene *m_scene;
+
+    // Frontend property updates superseded by a later update of the same
+    // property within a frame are never delivered
+    bool m_coalescingEnabled;
+    CoalescingStatistics m_coalescingStatistics;
+
+    // Large batches of changes are partitioned by the aspect of the observers
+    // and each aspect's share is delivered by a job
+    bool m_parallelDistributionEnabled;
+    SyncStatistics m_lastSyncStatistics;
 };
 
 } // namespace Qt3DCore
@@ -42,6 +42,7 @@
 
 #include <Qt3DCore/qnode.h>
 #include <Qt3DCore/qpropertyupdatedchange.h>
+#include <Qt3DCore/qstaticpropertyupdatedchangebase.h>
 
 #include <Qt3DCore/private/qlockableobserverinterface_p.h>
 #include <Qt3DCore/private/qnode_p.h>
@@ -74,17 +75,32 @@ void QPostman::setScene(QScene *scene)
     d->m_scene = scene;
 }
 
-static inline QMetaMethod notifyFrontendNodeMethod()
+static inline QMetaMethod submitFrontendChangeBatchMethod()
 {
-    int idx = QPostman::staticMetaObject.indexOfMethod("notifyFrontendNode(QSceneChangePtr)");
+    int idx = QPostman::staticMetaObject.indexOfMethod("submitFrontendChangeBatch()");
     Q_ASSERT(idx != -1);
     return QPostman::staticMetaObject.method(idx);
 }
 
+/*
+ * \internal
+ * Appends \a e to the batch of changes for the frontend nodes. Only the
+ * change starting a batch posts an event to the main thread, the changes
+ * sent until the main thread processes it are delivered along.
+ */
 void QPostman::sceneChangeEvent(const QSceneChangePtr &e)
 {
-    static const QMetaMethod notifyFrontendNode = notifyFrontendNodeMethod();
-    notifyFrontendNode.invoke(this, Q_ARG(QSceneChangePtr, e));
+    Q_D(QPostman);
+    bool startsBatch = false;
+    {
+        QMutexLocker locker(&d->m_frontendBatchMutex);
+        startsBatch = d->m_frontendBatch.empty();
+        d->m_frontendBatch.push_back(e);
+    }
+    if (startsBatch) {
+        static const QMetaMethod submitFrontendChangeBatch = submitFrontendChangeBatchMethod();
+        submitFrontendChangeBatch.invoke(this, Qt::QueuedConnection);
+    }
 }
 
 static inline QMetaMethod submitChangeBatchMethod()
@@ -118,33 +134,39 @@ void QPostman::notifyBackend(const QSceneChangePtr &change)
 bool QPostman::shouldNotifyFrontend(const QSceneChangePtr &e)
 {
     Q_D(QPostman);
-    const QPropertyUpdatedChangePtr propertyChange = qSharedPointerDynamicCast<QPropertyUpdatedChange>(e);
-    if (Q_LIKELY(d->m_scene != nullptr) && !propertyChange.isNull()) {
-        const QScene::NodePropertyTrackData propertyTrackData
-                = d->m_scene->lookupNodePropertyTrackData(e->subjectId());
-
-        const QNode::PropertyTrackingMode trackMode = propertyTrackData.trackedPropertiesOverrides.value(QLatin1String(propertyChange->propertyName()),
-                                                                                                      propertyTrackData.defaultTrackMode);
-
-        switch (trackMode) {
-        case QNode::TrackAllValues:
-            return true;
-
-        case QNode::DontTrackValues:
-            return false;
-
-        case QNode::TrackFinalValues: {
-            const bool isIntermediate
-                = QPropertyUpdatedChangeBasePrivate::get(propertyChange.data())->m_isIntermediate;
-            return !isIntermediate;
-        }
-
-        default:
-            Q_UNREACHABLE();
-            return false;
-        }
+    if (Q_UNLIKELY(d->m_scene == nullptr) || e->type() != PropertyUpdated)
+        return true;
+
+    QPropertyUpdatedChangeBase *propertyChange = static_cast<QPropertyUpdatedChangeBase *>(e.data());
+    const QScene::NodePropertyTrackData propertyTrackData
+            = d->m_scene->lookupNodePropertyTrackData(e->subjectId());
+
+    // Only look the property name up for the few nodes overriding the
+    // tracking of some of their properties
+    QNode::PropertyTrackingMode trackMode = propertyTrackData.defaultTrackMode;
+    if (Q_UNLIKELY(!propertyTrackData.trackedPropertiesOverrides.isEmpty())) {
+        if (const auto staticChange = dynamic_cast<QStaticPropertyUpdatedChangeBase *>(propertyChange))
+            trackMode = propertyTrackData.trackedPropertiesOverrides.value(QLatin1String(staticChange->propertyName()),
+                                                                           trackMode);
+    }
+
+    switch (trackMode) {
+    case QNode::TrackAllValues:
+        return true;
+
+    case QNode::DontTrackValues:
+        return false;
+
+    case QNode::TrackFinalValues: {
+        const bool isIntermediate
+            = QPropertyUpdatedChangeBasePrivate::get(propertyChange)->m_isIntermediate;
+        return !isIntermediate;
+    }
+
+    default:
+        Q_UNREACHABLE();
+        return false;
     }
-    return true;
 }
 
 // Main Thread
@@ -158,6 +180,19 @@ void QPostman::notifyFrontendNode(const QSceneChangePtr &e)
     }
 }
 
+// Main Thread
+void QPostman::submitFrontendChangeBatch()
+{
+    Q_D(QPostman);
+    std::vector<QSceneChangePtr> batch;
+    {
+        QMutexLocker locker(&d->m_frontendBatchMutex);
+        batch.swap(d->m_frontendBatch);
+    }
+    for (const QSceneChangePtr &change : batch)
+        notifyFrontendNode(change);
+}
+
 void QPostman::submitChangeBatch()
 {
     Q_D(QPostman);
@@ -88,7 +88,8 @@ public Q_SLOTS:
 
 private:
     Q_DECLARE_PRIVATE(QPostman)
-    Q_INVOKABLE void notifyFrontendNode(const QSceneChangePtr &e);
+    Q_INVOKABLE void submitFrontendChangeBatch();
+    void notifyFrontendNode(const QSceneChangePtr &e);
 
 };
 
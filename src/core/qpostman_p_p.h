@@ -52,6 +52,7 @@
 //
 
 #include <Qt3DCore/qscenechange.h>
+#include <QtCore/qmutex.h>
 #include <private/qobject_p.h>
 #include <Qt3DCore/private/qt3dcore_global_p.h>
 
@@ -76,6 +77,10 @@ public:
     Q_DECLARE_PUBLIC(QPostman)
     QScene *m_scene;
     std::vector<QSceneChangePtr> m_batch;
+
+    // Backend changes waiting to be delivered to the frontend nodes
+    QMutex m_frontendBatchMutex;
+    std::vector<QSceneChangePtr> m_frontendBatch;
 };
 
 } // Qt3DCore
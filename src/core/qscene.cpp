@@ -100,6 +100,21 @@ void QScene::addObservable(QObservableInterface *observable, QNodeId id)
         observable->setArbiter(d->m_arbiter);
 }
 
+// Called by any thread
+void QScene::addObservables(const QVector<QPair<QObservableInterface *, QNodeId>> &observables)
+{
+    Q_D(QScene);
+    QWriteLocker lock(&d->m_lock);
+    d->m_observablesLookupTable.reserve(d->m_observablesLookupTable.size() + observables.size());
+    d->m_observableToUuid.reserve(d->m_observableToUuid.size() + observables.size());
+    for (const auto &observableAndId : observables) {
+        d->m_observablesLookupTable.insert(observableAndId.second, observableAndId.first);
+        d->m_observableToUuid.insert(observableAndId.first, observableAndId.second);
+        if (d->m_arbiter != nullptr)
+            observableAndId.first->setArbiter(d->m_arbiter);
+    }
+}
+
 // Called by main thread only
 void QScene::addObservable(QNode *observable)
 {
@@ -51,6 +51,7 @@
 // We mean it.
 //
 
+#include <QtCore/QPair>
 #include <QtCore/QScopedPointer>
 
 #include <Qt3DCore/qnode.h>
@@ -76,6 +77,7 @@ public:
     QAspectEngine *engine() const;
 
     void addObservable(QObservableInterface *observable, QNodeId id);
+    void addObservables(const QVector<QPair<QObservableInterface *, QNodeId>> &observables);
     void addObservable(QNode *observable);
     void removeObservable(QObservableInterface *observable, QNodeId id);
     void removeObservable(QNode *observable);
@@ -47,6 +47,17 @@ QSceneObserverInterface::~QSceneObserverInterface()
 {
 }
 
+void QSceneObserverInterface::sceneNodesAdded(const QVector<QSceneChangePtr> &changes)
+{
+    for (QSceneChangePtr change : changes)
+        sceneNodeAdded(change);
+}
+
+void QSceneObserverInterface::sceneNodesAboutToBeAdded(const QVector<QSceneChangePtr> &changes)
+{
+    Q_UNUSED(changes);
+}
+
 } // Qt3D
 
 QT_END_NAMESPACE
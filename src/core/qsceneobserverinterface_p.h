@@ -52,6 +52,7 @@
 //
 
 #include <Qt3DCore/qscenechange.h>
+#include <QtCore/QVector>
 
 #include <Qt3DCore/private/qt3dcore_global_p.h>
 
@@ -69,6 +70,12 @@ public:
 private:
     virtual void sceneNodeAdded(QSceneChangePtr &e) = 0;
     virtual void sceneNodeRemoved(QSceneChangePtr &e) = 0;
+    // Receives runs of consecutive node creations, calls sceneNodeAdded for
+    // each of them unless overridden
+    virtual void sceneNodesAdded(const QVector<QSceneChangePtr> &changes);
+    // May be called from a job thread before sceneNodesAdded() receives the
+    // same changes, for the work which does not need the aspect thread
+    virtual void sceneNodesAboutToBeAdded(const QVector<QSceneChangePtr> &changes);
 
     friend class QChangeArbiter;
 };
@@ -59,6 +59,9 @@ QT_BEGIN_NAMESPACE
 
 namespace Qt3DCore {
 
+template <typename KeyType, typename ValueType>
+class QLockFreeHandleIndex;
+
 template <typename T>
 class QHandle
 {
@@ -101,6 +104,16 @@ public:
     bool operator==(const QHandle &other) const { return d == other.d && counter == other.counter; }
     bool operator!=(const QHandle &other) const { return !operator==(other); }
 private:
+    // Used to rebuild handles stored in a QLockFreeHandleIndex
+    QHandle(Data *d, quintptr counter)
+        : d(d),
+          counter(counter)
+    {
+    }
+
+    template <typename KeyType, typename ValueType>
+    friend class QLockFreeHandleIndex;
+
     Data *d;
     quintptr counter;
 };
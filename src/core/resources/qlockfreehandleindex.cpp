@@ -0,0 +1,185 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qlockfreehandleindex_p.h"
+
+#include <QtCore/QMutex>
+#include <QtCore/QThreadStorage>
+
+#include <atomic>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DCore {
+
+/* !\internal
+    \class Qt3DCore::QLockFreeHandleIndex
+    \inmodule Qt3DCore
+
+    \brief Maps keys to handles with lookups which never take a lock.
+
+    The index is an open addressing table where each slot points to an
+    immutable entry. The single writer publishes a new entry, or a removed
+    marker, with one atomic store so readers never wait on it. Replaced
+    entries and, when the table grows, the old table are retired until
+    QReadEpoch reports that no reader can still be using them.
+
+    It is used by QResourceManager for managers using the
+    ObjectLevelLockingPolicy.
+*/
+
+namespace {
+
+// Epoch 0 means that the thread is not reading
+struct EpochSlot
+{
+    EpochSlot();
+    ~EpochSlot();
+
+    QAtomicInteger<quint32> epoch;
+    int depth;
+};
+
+struct EpochRegistry
+{
+    QMutex mutex;
+    QVector<EpochSlot *> slots;
+    QAtomicInteger<quint32> globalEpoch;
+
+    EpochRegistry()
+        : globalEpoch(1)
+    {}
+};
+
+Q_GLOBAL_STATIC(EpochRegistry, epochRegistry)
+
+EpochSlot::EpochSlot()
+    : epoch(0)
+    , depth(0)
+{
+    EpochRegistry *registry = epochRegistry();
+    const QMutexLocker lock(&registry->mutex);
+    registry->slots.push_back(this);
+}
+
+EpochSlot::~EpochSlot()
+{
+    EpochRegistry *registry = epochRegistry();
+    if (!registry)
+        return;
+    const QMutexLocker lock(&registry->mutex);
+    registry->slots.removeOne(this);
+}
+
+// The slot of a thread is registered the first time it reads and
+// unregistered when it exits
+#ifdef Q_COMPILER_THREAD_LOCAL
+EpochSlot *currentEpochSlot()
+{
+    static thread_local EpochSlot slot;
+    return &slot;
+}
+#else
+Q_GLOBAL_STATIC(QThreadStorage<EpochSlot *>, threadEpochSlot)
+
+EpochSlot *currentEpochSlot()
+{
+    QThreadStorage<EpochSlot *> *storage = threadEpochSlot();
+    if (Q_UNLIKELY(!storage->hasLocalData()))
+        storage->setLocalData(new EpochSlot);
+    return storage->localData();
+}
+#endif
+
+} // anonymous
+
+QReadEpoch::Reader::Reader()
+{
+    EpochSlot *slot = currentEpochSlot();
+    m_slot = slot;
+    // Nested readers keep the epoch of the outermost one
+    if (slot->depth++ == 0) {
+        slot->epoch.store(epochRegistry()->globalEpoch.loadAcquire());
+        // Orders the epoch announcement before the reads of the published
+        // data, pairs with the fence in oldestReaderEpoch()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+QReadEpoch::Reader::~Reader()
+{
+    EpochSlot *slot = static_cast<EpochSlot *>(m_slot);
+    if (--slot->depth == 0)
+        slot->epoch.storeRelease(0);
+}
+
+quint32 QReadEpoch::retire()
+{
+    // Readers announcing this epoch or a later one are guaranteed to see
+    // whatever was published before the call
+    return epochRegistry()->globalEpoch.fetchAndAddOrdered(1) + 1;
+}
+
+bool QReadEpoch::canReclaim(quint32 retireEpoch)
+{
+    return retireEpoch <= oldestReaderEpoch();
+}
+
+quint32 QReadEpoch::oldestReaderEpoch()
+{
+    // Orders the unpublishing of the retired data before the reads of the
+    // reader epochs: a reader either announced its epoch before and is
+    // accounted for, or it will load the data published instead
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    EpochRegistry *registry = epochRegistry();
+    quint32 oldestEpoch = std::numeric_limits<quint32>::max();
+    const QMutexLocker lock(&registry->mutex);
+    for (const EpochSlot *slot : qAsConst(registry->slots)) {
+        const quint32 epoch = slot->epoch.load();
+        if (epoch != 0 && epoch < oldestEpoch)
+            oldestEpoch = epoch;
+    }
+    return oldestEpoch;
+}
+
+} // namespace Qt3DCore
+
+QT_END_NAMESPACE
@@ -0,0 +1,369 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QT3DCORE_QLOCKFREEHANDLEINDEX_P_H
+#define QT3DCORE_QLOCKFREEHANDLEINDEX_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QAtomicPointer>
+#include <QtCore/QVector>
+
+#include <Qt3DCore/qnodeid.h>
+#include <Qt3DCore/private/qhandle_p.h>
+#include <Qt3DCore/private/qt3dcore_global_p.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DCore {
+
+template <typename KeyType>
+inline quint64 qHandleIndexKey(const KeyType &key)
+{
+    return quint64(key);
+}
+
+inline quint64 qHandleIndexKey(QNodeId id)
+{
+    return id.id();
+}
+
+class QT3DCORE_PRIVATE_EXPORT QReadEpoch
+{
+public:
+    // Marks the calling thread as reading from tables which can be retired
+    // concurrently. Readers never wait on writers nor on each other.
+    class QT3DCORE_PRIVATE_EXPORT Reader
+    {
+    public:
+        Reader();
+        ~Reader();
+
+    private:
+        Q_DISABLE_COPY(Reader)
+        void *m_slot;
+    };
+
+    // Called by the writer once a table has been unpublished, returns the
+    // epoch to pass to canReclaim()
+    static quint32 retire();
+
+    // True once no reader can still be using data retired at retireEpoch
+    static bool canReclaim(quint32 retireEpoch);
+
+    // Data retired at an epoch lower or equal to the returned one can be
+    // reclaimed, saves calling canReclaim() for each retired item
+    static quint32 oldestReaderEpoch();
+};
+
+template <typename KeyType, typename ValueType>
+class QLockFreeHandleIndex
+{
+public:
+    typedef QHandle<ValueType> Handle;
+    typedef typename Handle::Data HandleData;
+
+    QLockFreeHandleIndex()
+        : m_table(nullptr)
+        , m_size(0)
+        , m_removedCount(0)
+    {
+    }
+
+    ~QLockFreeHandleIndex()
+    {
+        Table *table = m_table.load();
+        if (table) {
+            for (int i = 0; i < table->capacity; ++i) {
+                const Entry *entry = table->slots[i].load();
+                if (entry != &m_removedEntry)
+                    delete entry;
+            }
+            delete table;
+        }
+        for (const Retired &retired : qAsConst(m_retired)) {
+            delete retired.table;
+            delete retired.entry;
+        }
+    }
+
+    // Safe to call from any number of threads, concurrently with a writer.
+    // Never waits: a slot is read with a single load of its entry
+    Handle lookup(const KeyType &id) const
+    {
+        const QReadEpoch::Reader reader;
+        const Table *table = m_table.loadAcquire();
+        if (!table)
+            return Handle();
+
+        const quint64 key = qHandleIndexKey(id);
+        const int mask = table->capacity - 1;
+        int index = table->indexOf(key);
+        for (int probe = 0; probe < table->capacity; ++probe) {
+            const Entry *entry = table->slots[index].loadAcquire();
+            if (!entry)
+                break;
+            if (entry != &m_removedEntry && entry->key == key)
+                return Handle(entry->data, entry->counter);
+            index = (index + 1) & mask;
+        }
+        return Handle();
+    }
+
+    // Writers have to be serialized by the caller
+    void insert(const KeyType &id, const Handle &handle)
+    {
+        reserve(m_size + 1);
+        Table *table = m_table.load();
+        const quint64 key = qHandleIndexKey(id);
+        const int mask = table->capacity - 1;
+        int index = table->indexOf(key);
+        int firstRemoved = -1;
+        for (;;) {
+            Slot &slot = table->slots[index];
+            const Entry *entry = slot.load();
+            if (!entry)
+                break;
+            if (entry == &m_removedEntry) {
+                if (firstRemoved < 0)
+                    firstRemoved = index;
+            } else if (entry->key == key) {
+                replace(slot, newEntry(key, handle));
+                reclaimRetired();
+                return;
+            }
+            index = (index + 1) & mask;
+        }
+        if (firstRemoved >= 0) {
+            index = firstRemoved;
+            --m_removedCount;
+        }
+        table->slots[index].storeRelease(newEntry(key, handle));
+        ++m_size;
+    }
+
+    void remove(const KeyType &id)
+    {
+        Table *table = m_table.load();
+        if (!table)
+            return;
+        const quint64 key = qHandleIndexKey(id);
+        const int mask = table->capacity - 1;
+        int index = table->indexOf(key);
+        for (int probe = 0; probe < table->capacity; ++probe) {
+            Slot &slot = table->slots[index];
+            const Entry *entry = slot.load();
+            if (!entry)
+                return;
+            if (entry != &m_removedEntry && entry->key == key) {
+                replace(slot, &m_removedEntry);
+                --m_size;
+                ++m_removedCount;
+                reclaimRetired();
+                return;
+            }
+            index = (index + 1) & mask;
+        }
+    }
+
+    // Writers have to be serialized by the caller
+    void reserve(int size)
+    {
+        const Table *table = m_table.load();
+        const int capacity = table ? table->capacity : 0;
+        // Removed slots count towards the load factor as they lengthen probes
+        if ((size + m_removedCount) * 4 <= capacity * 3)
+            return;
+        int newCapacity = 16;
+        while (size * 2 > newCapacity)
+            newCapacity *= 2;
+        rehash(newCapacity);
+    }
+
+    int size() const { return m_size; }
+
+private:
+    // Entries are immutable once published, the writer replaces them instead
+    // of updating them in place so that readers can never observe a torn slot
+    struct Entry
+    {
+        Entry()
+            : key(0)
+            , data(nullptr)
+            , counter(0)
+        {}
+
+        Entry(quint64 k, HandleData *d, quintptr c)
+            : key(k)
+            , data(d)
+            , counter(c)
+        {}
+
+        const quint64 key;
+        HandleData *const data;
+        const quintptr counter;
+    };
+
+    // nullptr for an empty slot, &m_removedEntry for a removed one
+    typedef QAtomicPointer<const Entry> Slot;
+
+    struct Table
+    {
+        explicit Table(int c)
+            : capacity(c)
+            , shift(64)
+            , slots(new Slot[c])
+        {
+            while (c > 1) {
+                --shift;
+                c >>= 1;
+            }
+        }
+
+        ~Table()
+        {
+            delete [] slots;
+        }
+
+        int indexOf(quint64 key) const
+        {
+            // Fibonacci hashing, node ids are sequential
+            return shift == 64 ? 0 : int((key * Q_UINT64_C(0x9E3779B97F4A7C15)) >> shift);
+        }
+
+        const int capacity;
+        int shift;
+        Slot *slots;
+    };
+
+    // A table or an entry unpublished at epoch, freed once no reader can
+    // still be using it
+    struct Retired
+    {
+        Table *table;
+        const Entry *entry;
+        quint32 epoch;
+    };
+
+    static const Entry *newEntry(quint64 key, const Handle &handle)
+    {
+        return new Entry(key, handle.data_ptr(), handle.counter);
+    }
+
+    void replace(Slot &slot, const Entry *entry)
+    {
+        const Entry *oldEntry = slot.load();
+        slot.storeRelease(entry);
+        if (oldEntry != &m_removedEntry) {
+            const Retired retired = { nullptr, oldEntry, QReadEpoch::retire() };
+            m_retired.push_back(retired);
+        }
+    }
+
+    void rehash(int capacity)
+    {
+        // Entries are shared by the old and the new table, only the slots
+        // are retired
+        Table *table = new Table(capacity);
+        Table *oldTable = m_table.load();
+        if (oldTable) {
+            const int mask = capacity - 1;
+            for (int i = 0; i < oldTable->capacity; ++i) {
+                const Entry *entry = oldTable->slots[i].load();
+                if (!entry || entry == &m_removedEntry)
+                    continue;
+                int index = table->indexOf(entry->key);
+                while (table->slots[index].load())
+                    index = (index + 1) & mask;
+                table->slots[index].store(entry);
+            }
+        }
+        m_removedCount = 0;
+
+        // Publish the new table, the old one is only freed once no reader
+        // can still be probing it
+        m_table.storeRelease(table);
+        if (oldTable) {
+            const Retired retired = { oldTable, nullptr, QReadEpoch::retire() };
+            m_retired.push_back(retired);
+        }
+        reclaimRetired();
+    }
+
+    void reclaimRetired()
+    {
+        if (m_retired.isEmpty())
+            return;
+        const quint32 oldestEpoch = QReadEpoch::oldestReaderEpoch();
+        auto it = m_retired.begin();
+        while (it != m_retired.end()) {
+            if (it->epoch <= oldestEpoch) {
+                delete it->table;
+                delete it->entry;
+                it = m_retired.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    QAtomicPointer<Table> m_table;
+    int m_size;
+    int m_removedCount;
+    const Entry m_removedEntry;
+    QVector<Retired> m_retired;
+
+    Q_DISABLE_COPY(QLockFreeHandleIndex)
+};
+
+} // namespace Qt3DCore
+
+QT_END_NAMESPACE
+
+#endif // QT3DCORE_QLOCKFREEHANDLEINDEX_P_H
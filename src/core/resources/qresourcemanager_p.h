@@ -59,6 +59,7 @@
 #include <limits>
 
 #include <Qt3DCore/private/qhandle_p.h>
+#include <Qt3DCore/private/qlockfreehandleindex_p.h>
 #include <Qt3DCore/private/qt3dcore_global_p.h>
 
 // Silence complaints about unreferenced local variables in
@@ -76,6 +77,10 @@ namespace Qt3DCore {
 template <class Host>
 struct NonLockingPolicy
 {
+    enum {
+        LockFreeLookups = false
+    };
+
     struct ReadLocker
     {
         ReadLocker(const NonLockingPolicy*) {}
@@ -105,6 +110,11 @@ public :
     ObjectLevelLockingPolicy()
     {}
 
+    // Lookups go through a QLockFreeHandleIndex instead of taking the read lock
+    enum {
+        LockFreeLookups = true
+    };
+
     class ReadLocker
     {
     public:
@@ -225,6 +235,8 @@ class QHandleData : public QHandle<T>::Data
 {
 public:
     T data;
+    // Position of the handle in ArrayAllocatingPolicy::m_activeHandles
+    int activeIndex;
 };
 
 template<typename T>
@@ -262,19 +274,24 @@ public:
             allocateBucket();
         typename Handle::Data *d = freeList;
         freeList = freeList->nextFree;
+        --freeCount;
         d->counter = allocCounter;
         allocCounter += 2; // ensure this will never clash with a pointer in nextFree by keeping the lowest bit set
         Handle handle(d);
+        static_cast<HandleData *>(d)->activeIndex = m_activeHandles.size();
         m_activeHandles.push_back(handle);
         return handle;
     }
 
     void releaseResource(const Handle &handle)
     {
-        m_activeHandles.removeOne(handle);
+        // Releasing a handle twice would corrupt the free list
+        if (!removeActiveHandle(handle))
+            return;
         typename Handle::Data *d = handle.data_ptr();
         d->nextFree = freeList;
         freeList = d;
+        ++freeCount;
         performCleanup(&static_cast<QHandleData<T> *>(d)->data, Int2Type<QResourceInfo<T>::needsCleanup>());
     }
 
@@ -295,6 +312,17 @@ public:
         }
     }
 
+    // Allocates upfront the buckets and the active handle storage needed
+    // by the next count allocations
+    void reserveResources(int count)
+    {
+        const int size = m_activeHandles.size() + count;
+        if (size > m_activeHandles.capacity())
+            m_activeHandles.reserve(qMax(size, m_activeHandles.capacity() * 2));
+        while (freeCount < count)
+            allocateBucket();
+    }
+
     int count() const { return m_activeHandles.size(); }
     QVector<Handle> activeHandles() const { return m_activeHandles; }
 
@@ -316,11 +344,11 @@ private:
     Bucket *firstBucket = 0;
     QVector<Handle > m_activeHandles;
     typename Handle::Data *freeList = 0;
+    int freeCount = 0;
     int allocCounter = 1;
 
     void allocateBucket()
     {
-        // no free handle, allocate a new
         // allocate aligned memory
         Bucket *b = static_cast<Bucket *>(AlignedAllocator::allocate(sizeof(Bucket)));
 
@@ -332,8 +360,23 @@ private:
         for (int i = 0; i < Bucket::NumEntries - 1; ++i) {
             b->data[i].nextFree = &b->data[i + 1];
         }
-        b->data[Bucket::NumEntries - 1].nextFree = nullptr;
+        // The bucket can be reserved while free entries remain
+        b->data[Bucket::NumEntries - 1].nextFree = freeList;
         freeList = &b->data[0];
+        freeCount += Bucket::NumEntries;
+    }
+
+    // O(1) removal, the last active handle takes the place of the released one
+    bool removeActiveHandle(const Handle &handle)
+    {
+        const int index = static_cast<HandleData *>(handle.data_ptr())->activeIndex;
+        if (index < 0 || index >= m_activeHandles.size() || m_activeHandles.at(index) != handle)
+            return false;
+        const Handle last = m_activeHandles.last();
+        m_activeHandles[index] = last;
+        static_cast<HandleData *>(last.data_ptr())->activeIndex = index;
+        m_activeHandles.removeLast();
+        return true;
     }
 
     void deallocateBuckets()
@@ -409,63 +452,167 @@ public:
 
     bool contains(const KeyType &id) const
     {
-        typename LockingPolicy<QResourceManager>::ReadLocker lock(this);
-        return m_keyToHandleMap.contains(id);
+        return contains(id, Int2Type<UseLockFreeIndex>());
     }
 
     Handle getOrAcquireHandle(const KeyType &id)
     {
-        typename LockingPolicy<QResourceManager>::ReadLocker lock(this);
-        Handle handle = m_keyToHandleMap.value(id);
-        if (handle.isNull()) {
-            lock.unlock();
-            typename LockingPolicy<QResourceManager>::WriteLocker writeLock(this);
-            // Test that the handle hasn't been set (in the meantime between the read unlock and the write lock)
-            Handle &handleToSet = m_keyToHandleMap[id];
-            if (handleToSet.isNull()) {
-                handleToSet = Allocator::allocateResource();
-            }
-            return handleToSet;
+        if (UseLockFreeIndex) {
+            const Handle handle = lookupHandle(id);
+            if (!handle.isNull())
+                return handle;
+        } else {
+            typename LockingPolicy<QResourceManager>::ReadLocker lock(this);
+            const Handle handle = m_keyToHandleMap.value(id);
+            if (!handle.isNull())
+                return handle;
         }
-        return handle;
+
+        typename LockingPolicy<QResourceManager>::WriteLocker writeLock(this);
+        // Test that the handle hasn't been set (in the meantime between the read unlock and the write lock)
+        Handle &handleToSet = m_keyToHandleMap[id];
+        if (handleToSet.isNull()) {
+            handleToSet = Allocator::allocateResource();
+            indexHandle(id, handleToSet, Int2Type<UseLockFreeIndex>());
+        }
+        return handleToSet;
     }
 
     Handle lookupHandle(const KeyType &id)
     {
-        typename LockingPolicy<QResourceManager>::ReadLocker lock(this);
-        return m_keyToHandleMap.value(id);
+        return lookupHandle(id, Int2Type<UseLockFreeIndex>());
     }
 
     ValueType *lookupResource(const KeyType &id)
     {
         ValueType* ret = nullptr;
         {
-            typename LockingPolicy<QResourceManager>::ReadLocker lock(this);
-            Handle handle = m_keyToHandleMap.value(id);
+            const Handle handle = lookupHandle(id);
             if (!handle.isNull())
                 ret = Allocator::data(handle);
         }
         return ret;
     }
 
+    // Same as calling getOrAcquireHandle for each id, but the storage is
+    // sized once for all of them and the write lock is only taken once
+    QVector<Handle> getOrAcquireHandles(const QVector<KeyType> &ids)
+    {
+        QVector<Handle> handles;
+        handles.reserve(ids.size());
+
+        typename LockingPolicy<QResourceManager>::WriteLocker writeLock(this);
+        // Handles may have been acquired beforehand, only reserve for the
+        // missing ones
+        int missingCount = 0;
+        for (const KeyType &id : ids) {
+            if (!m_keyToHandleMap.contains(id))
+                ++missingCount;
+        }
+        if (missingCount > 0)
+            reserveHandles(missingCount, Int2Type<UseLockFreeIndex>());
+        for (const KeyType &id : ids) {
+            Handle &handleToSet = m_keyToHandleMap[id];
+            if (handleToSet.isNull()) {
+                handleToSet = Allocator::allocateResource();
+                indexHandle(id, handleToSet, Int2Type<UseLockFreeIndex>());
+            }
+            handles.push_back(handleToSet);
+        }
+        return handles;
+    }
+
     ValueType *getOrCreateResource(const KeyType &id)
     {
         const Handle handle = getOrAcquireHandle(id);
         return handle.operator->();
     }
 
+    QVector<ValueType *> getOrCreateResources(const QVector<KeyType> &ids)
+    {
+        const QVector<Handle> handles = getOrAcquireHandles(ids);
+        QVector<ValueType *> resources;
+        resources.reserve(handles.size());
+        for (const Handle &handle : handles)
+            resources.push_back(handle.operator->());
+        return resources;
+    }
+
+    // Pre-sizes the storage for count more resources
+    void reserve(int count)
+    {
+        typename LockingPolicy<QResourceManager>::WriteLocker writeLock(this);
+        reserveHandles(count, Int2Type<UseLockFreeIndex>());
+    }
+
     void releaseResource(const KeyType &id)
     {
         typename LockingPolicy<QResourceManager>::WriteLocker lock(this);
         Handle handle = m_keyToHandleMap.take(id);
-        if (!handle.isNull())
+        if (!handle.isNull()) {
+            unindexHandle(id, Int2Type<UseLockFreeIndex>());
             Allocator::releaseResource(handle);
+        }
     }
 
 protected:
     QHash<KeyType, Handle > m_keyToHandleMap;
 
 private:
+    enum {
+        UseLockFreeIndex = LockingPolicy<QResourceManager>::LockFreeLookups
+    };
+
+    bool contains(const KeyType &id, Int2Type<false>) const
+    {
+        typename LockingPolicy<QResourceManager>::ReadLocker lock(this);
+        return m_keyToHandleMap.contains(id);
+    }
+
+    bool contains(const KeyType &id, Int2Type<true>) const
+    {
+        return !m_lockFreeIndex.lookup(id).isNull();
+    }
+
+    Handle lookupHandle(const KeyType &id, Int2Type<false>)
+    {
+        typename LockingPolicy<QResourceManager>::ReadLocker lock(this);
+        return m_keyToHandleMap.value(id);
+    }
+
+    Handle lookupHandle(const KeyType &id, Int2Type<true>)
+    {
+        return m_lockFreeIndex.lookup(id);
+    }
+
+    // Called with the write lock held
+    void indexHandle(const KeyType &, const Handle &, Int2Type<false>) {}
+    void indexHandle(const KeyType &id, const Handle &handle, Int2Type<true>)
+    {
+        m_lockFreeIndex.insert(id, handle);
+    }
+
+    // Called with the write lock held
+    void reserveHandles(int count, Int2Type<false>)
+    {
+        m_keyToHandleMap.reserve(m_keyToHandleMap.size() + count);
+        Allocator::reserveResources(count);
+    }
+
+    void reserveHandles(int count, Int2Type<true>)
+    {
+        reserveHandles(count, Int2Type<false>());
+        m_lockFreeIndex.reserve(m_lockFreeIndex.size() + count);
+    }
+
+    void unindexHandle(const KeyType &, Int2Type<false>) {}
+    void unindexHandle(const KeyType &id, Int2Type<true>)
+    {
+        m_lockFreeIndex.remove(id);
+    }
+
+    QLockFreeHandleIndex<KeyType, ValueType> m_lockFreeIndex;
+
     friend QDebug operator<< <>(QDebug dbg, const QResourceManager<ValueType, KeyType, LockingPolicy> &manager);
 };
 
@@ -4,11 +4,13 @@ HEADERS += \
     $$PWD/qboundedcircularbuffer_p.h \
     $$PWD/qframeallocator_p.h \
     $$PWD/qframeallocator_p_p.h \
-    $$PWD/qhandle_p.h
+    $$PWD/qhandle_p.h \
+    $$PWD/qlockfreehandleindex_p.h
 
 SOURCES += \
     $$PWD/qresourcemanager.cpp \
-    $$PWD/qframeallocator.cpp
+    $$PWD/qframeallocator.cpp \
+    $$PWD/qlockfreehandleindex.cpp
 
 
 # Define proper SIMD flags for qresourcemanager.cpp
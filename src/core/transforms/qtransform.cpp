@@ -63,6 +63,26 @@ QTransformPrivate::~QTransformPrivate()
 {
 }
 
+bool QTransformPrivate::sendTypedPropertyChange(int propertyIndex)
+{
+    static const int scale3DIndex = QTransform::staticMetaObject.indexOfProperty("scale3D");
+    static const int rotationIndex = QTransform::staticMetaObject.indexOfProperty("rotation");
+    static const int translationIndex = QTransform::staticMetaObject.indexOfProperty("translation");
+    static const int scale3DId = QTypedPropertyUpdatedChangeBase::propertyIdForName("scale3D");
+    static const int rotationId = QTypedPropertyUpdatedChangeBase::propertyIdForName("rotation");
+    static const int translationId = QTypedPropertyUpdatedChangeBase::propertyIdForName("translation");
+
+    if (propertyIndex == scale3DIndex)
+        notifyTypedPropertyChange("scale3D", scale3DId, m_scale);
+    else if (propertyIndex == rotationIndex)
+        notifyTypedPropertyChange("rotation", rotationId, m_rotation);
+    else if (propertyIndex == translationIndex)
+        notifyTypedPropertyChange("translation", translationId, m_translation);
+    else
+        return false;
+    return true;
+}
+
 /*!
     \qmltype Transform
     \inqmlmodule Qt3D.Core
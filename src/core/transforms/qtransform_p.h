@@ -65,6 +65,8 @@ public:
     QTransformPrivate();
     ~QTransformPrivate();
 
+    bool sendTypedPropertyChange(int propertyIndex) override;
+
     // Stored in this order as QQuaternion is bigger than QVector3D
     // Operations are applied in the order of:
     // scale, rotation, translation
@@ -88,6 +88,7 @@
 #include <Qt3DInput/private/qinputdeviceintegration_p.h>
 #include <Qt3DInput/private/qinputdeviceintegrationfactory_p.h>
 #include <Qt3DInput/private/updateaxisactionjob_p.h>
+#include <Qt3DCore/private/qchangearbiter_p.h>
 #include <Qt3DCore/private/qeventfilterservice_p.h>
 #include <Qt3DCore/private/qservicelocator_p.h>
 
@@ -137,6 +138,10 @@ QInputAspect::QInputAspect(QInputAspectPrivate &dd, QObject *parent)
 
     qRegisterMetaType<Qt3DInput::QAbstractPhysicalDevice*>();
 
+    // Each of these updates is an input event, none of them may be dropped
+    Qt3DCore::QChangeArbiter::registerUncoalescedProperty(QByteArrayLiteral("axisEvent"));
+    Qt3DCore::QChangeArbiter::registerUncoalescedProperty(QByteArrayLiteral("buttonEvent"));
+
     registerBackendType<QKeyboardDevice>(QBackendNodeMapperPtr(new Input::KeyboardDeviceFunctor(this, d_func()->m_inputHandler.data())));
     registerBackendType<QKeyboardHandler>(QBackendNodeMapperPtr(new Input::KeyboardHandlerFunctor(d_func()->m_inputHandler.data())));
     registerBackendType<QMouseDevice>(QBackendNodeMapperPtr(new Input::MouseDeviceFunctor(this, d_func()->m_inputHandler.data())));
@@ -49,9 +49,16 @@ using namespace Qt3DCore;
 namespace Qt3DRender {
 namespace Render {
 
+namespace {
+
+QBasicAtomicInt lastRevision = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+} // anonymous
+
 BackendNode::BackendNode(Mode mode)
     : QBackendNode(mode)
     , m_renderer(nullptr)
+    , m_revision(0)
 {
 }
 
@@ -75,6 +82,16 @@ void BackendNode::markDirty(AbstractRenderer::BackendNodeDirtySet changes)
     m_renderer->markDirty(changes, this);
 }
 
+void BackendNode::updateRevision()
+{
+    m_revision = nextRevision();
+}
+
+uint BackendNode::nextRevision()
+{
+    return uint(lastRevision.fetchAndAddRelaxed(1) + 1);
+}
+
 QSharedPointer<RenderBackendResourceAccessor> BackendNode::resourceAccessor()
 {
     Render::Renderer *r = static_cast<Render::Renderer *>(renderer());
@@ -75,9 +75,17 @@ public:
 
     QSharedPointer<RenderBackendResourceAccessor> resourceAccessor();
 
+    // Only maintained by the nodes the material parameters are gathered from
+    // and the geometry nodes draw commands are built from. Each update gives
+    // the node a revision greater than all previous ones
+    uint revision() const { return m_revision; }
+
 protected:
     void markDirty(AbstractRenderer::BackendNodeDirtySet changes);
+    void updateRevision();
+    static uint nextRevision();
     AbstractRenderer *m_renderer;
+    uint m_revision;
 };
 
 } // namespace Render
@@ -0,0 +1,469 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "boundingvolumehierarchy_p.h"
+
+#include <Qt3DRender/private/entity_p.h>
+#include <Qt3DRender/private/qray3d_p.h>
+#include <Qt3DRender/private/renderview_p.h>
+#include <Qt3DRender/private/sphere_p.h>
+
+#include <QVarLengthArray>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+namespace {
+
+using BvhBuilder::BoundingBox;
+using BvhBuilder::clearBox;
+using BvhBuilder::expandBox;
+using BvhBuilder::halfSurfaceArea;
+
+const int MaxLeafSize = 4;
+// The tree is rebuilt once refitting made it this much more expensive to traverse
+const float RebuildCostRatio = 2.0f;
+// Number of incremental updates of the area sum before it is recomputed
+const int AreaSumRefitCount = 64;
+
+bool boxesAreEqual(const BoundingBox &a, const BoundingBox &b)
+{
+    for (int axis = 0; axis < 3; ++axis) {
+        if (a.lower[axis] != b.lower[axis] || a.upper[axis] != b.upper[axis])
+            return false;
+    }
+    return true;
+}
+
+void entityBounds(const Entity *entity, BoundingBox &box)
+{
+    const Sphere *sphere = entity->worldBoundingVolume();
+    const Vector3D center = sphere->center();
+    const float radius = sphere->radius();
+    const Vector3D childrenCenter = entity->worldBoundingVolumeWithChildren()->center();
+
+    for (int axis = 0; axis < 3; ++axis) {
+        box.lower[axis] = std::min(center[axis] - radius, childrenCenter[axis]);
+        box.upper[axis] = std::max(center[axis] + radius, childrenCenter[axis]);
+    }
+}
+
+enum PlaneSide {
+    Outside,
+    Intersecting,
+    Inside
+};
+
+PlaneSide classifyBox(const BoundingBox &box, const Plane *planes)
+{
+    PlaneSide side = Inside;
+    for (int p = 0; p < 6; ++p) {
+        const Vector3D &n = planes[p].normal;
+        float nearest = planes[p].d;
+        float farthest = planes[p].d;
+        for (int axis = 0; axis < 3; ++axis) {
+            const float lowerDistance = n[axis] * box.lower[axis];
+            const float upperDistance = n[axis] * box.upper[axis];
+            nearest += std::min(lowerDistance, upperDistance);
+            farthest += std::max(lowerDistance, upperDistance);
+        }
+        if (farthest < 0.0f)
+            return Outside;
+        if (nearest < 0.0f)
+            side = Intersecting;
+    }
+    return side;
+}
+
+// Same test as the one of FrustumCullingJob
+bool sphereIsCulled(const Sphere *sphere, const Plane *planes)
+{
+    const Vector3D center = sphere->center();
+    for (int p = 0; p < 6; ++p) {
+        if (Vector3D::dotProduct(center, planes[p].normal) + planes[p].d < -sphere->radius())
+            return true;
+    }
+    return false;
+}
+
+// The ray is a half-line starting at its origin, boxes behind the origin are
+// rejected as in the ray sphere intersection test. Its length is ignored
+bool rayIntersectsBox(const Vector3D &origin, const Vector3D &direction, const BoundingBox &box)
+{
+    float tMin = 0.0f;
+    float tMax = std::numeric_limits<float>::max();
+    for (int axis = 0; axis < 3; ++axis) {
+        if (qFuzzyIsNull(direction[axis])) {
+            if (origin[axis] < box.lower[axis] || origin[axis] > box.upper[axis])
+                return false;
+            continue;
+        }
+        const float inverse = 1.0f / direction[axis];
+        float t0 = (box.lower[axis] - origin[axis]) * inverse;
+        float t1 = (box.upper[axis] - origin[axis]) * inverse;
+        if (t0 > t1)
+            std::swap(t0, t1);
+        tMin = std::max(tMin, t0);
+        tMax = std::min(tMax, t1);
+        if (tMin > tMax)
+            return false;
+    }
+    return true;
+}
+
+float squaredDistanceToBox(const Vector3D &point, const BoundingBox &box)
+{
+    float squaredDistance = 0.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        const float v = point[axis];
+        if (v < box.lower[axis])
+            squaredDistance += (box.lower[axis] - v) * (box.lower[axis] - v);
+        else if (v > box.upper[axis])
+            squaredDistance += (v - box.upper[axis]) * (v - box.upper[axis]);
+    }
+    return squaredDistance;
+}
+
+} // anonymous
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy()
+    : m_root(nullptr)
+    , m_areaSum(0.0)
+    , m_refitsSinceAreaSum(0)
+    , m_builtCost(0.0f)
+{
+}
+
+// Indexes root and all its descendants, whether they are enabled or not
+void BoundingVolumeHierarchy::build(Entity *root)
+{
+    invalidate();
+    if (root == nullptr)
+        return;
+
+    m_root = root;
+    QVector<Entity *> worklist = { root };
+    while (!worklist.isEmpty()) {
+        Entity *entity = worklist.takeLast();
+        Primitive primitive;
+        primitive.entity = entity;
+        m_primitives.push_back(primitive);
+        const auto children = entity->children();
+        for (Entity *child : children)
+            worklist.push_back(child);
+    }
+
+    for (Primitive &primitive : m_primitives)
+        entityBounds(primitive.entity, primitive.box);
+
+    rebuild();
+}
+
+// Recomputes the box of every entity, only the nodes above the entities whose
+// box changed are refitted
+void BoundingVolumeHierarchy::refit()
+{
+    if (m_nodes.isEmpty())
+        return;
+
+    QVector<int> dirtyNodes;
+    for (int i = 0, m = m_primitives.size(); i < m; ++i) {
+        Primitive &primitive = m_primitives[i];
+        BoundingBox box;
+        entityBounds(primitive.entity, box);
+        if (boxesAreEqual(box, primitive.box))
+            continue;
+        primitive.box = box;
+        markDirtyPath(m_primitiveLeaves.at(i), dirtyNodes);
+    }
+    refitNodes(dirtyNodes);
+}
+
+// Only refits the boxes of the given entities and of the nodes above them
+void BoundingVolumeHierarchy::refit(const QVector<Entity *> &entities)
+{
+    if (m_nodes.isEmpty())
+        return;
+
+    QVector<int> dirtyNodes;
+    for (Entity *entity : entities) {
+        const int primitiveIndex = this->primitiveIndex(entity);
+        if (primitiveIndex < 0)
+            continue;
+        BoundingBox box;
+        entityBounds(entity, box);
+        if (boxesAreEqual(box, m_primitives.at(primitiveIndex).box))
+            continue;
+        m_primitives[primitiveIndex].box = box;
+        markDirtyPath(m_primitiveLeaves.at(primitiveIndex), dirtyNodes);
+    }
+    refitNodes(dirtyNodes);
+}
+
+// Drops all references to the entities, they may be destroyed afterwards
+void BoundingVolumeHierarchy::invalidate()
+{
+    m_root = nullptr;
+    m_primitives.clear();
+    m_primitiveLeaves.clear();
+    m_nodes.clear();
+    m_dirtyNodes.clear();
+    m_areaSum = 0.0;
+    m_refitsSinceAreaSum = 0;
+    m_builtCost = 0.0f;
+}
+
+int BoundingVolumeHierarchy::primitiveIndex(const Entity *entity) const
+{
+    // The index may be stale, when the entity was indexed by a previous tree
+    const int index = entity->boundingVolumeHierarchyIndex();
+    if (index < 0 || index >= m_primitives.size() || m_primitives.at(index).entity != entity)
+        return -1;
+    return index;
+}
+
+// Expected cost of a query relative to testing the root box
+float BoundingVolumeHierarchy::cost() const
+{
+    if (m_nodes.isEmpty())
+        return 0.0f;
+
+    const float rootArea = halfSurfaceArea(m_nodes.first().box);
+    if (rootArea <= 0.0f)
+        return float(m_primitives.size());
+    return float(m_areaSum / rootArea);
+}
+
+void BoundingVolumeHierarchy::frustumQuery(const Plane *planes, QVector<bool> &visiblePrimitives) const
+{
+    visiblePrimitives.fill(false, m_primitives.size());
+    if (m_nodes.isEmpty())
+        return;
+
+    QVarLengthArray<int, 64> stack;
+    stack.push_back(0);
+    while (!stack.isEmpty()) {
+        const Node &node = m_nodes.at(stack.last());
+        stack.removeLast();
+
+        const PlaneSide side = classifyBox(node.box, planes);
+        if (side == Outside)
+            continue;
+
+        // The bounding volumes of the whole subtree are inside of the frustum
+        if (side == Inside) {
+            std::fill(visiblePrimitives.begin() + node.firstPrimitive,
+                      visiblePrimitives.begin() + node.firstPrimitive + node.primitiveCount, true);
+            continue;
+        }
+
+        if (node.firstChild >= 0) {
+            stack.push_back(node.firstChild + 1);
+            stack.push_back(node.firstChild);
+            continue;
+        }
+
+        for (int i = node.firstPrimitive, end = i + node.primitiveCount; i < end; ++i)
+            visiblePrimitives[i] = !sphereIsCulled(m_primitives.at(i).entity->worldBoundingVolume(), planes);
+    }
+}
+
+QVector<Entity *> BoundingVolumeHierarchy::rayQuery(const RayCasting::QRay3D &ray) const
+{
+    QVector<Entity *> entities;
+    if (m_nodes.isEmpty())
+        return entities;
+
+    const Vector3D origin = ray.origin();
+    const Vector3D direction = ray.direction();
+    QVarLengthArray<int, 64> stack;
+    stack.push_back(0);
+    while (!stack.isEmpty()) {
+        const Node &node = m_nodes.at(stack.last());
+        stack.removeLast();
+
+        if (!rayIntersectsBox(origin, direction, node.box))
+            continue;
+
+        if (node.firstChild >= 0) {
+            stack.push_back(node.firstChild + 1);
+            stack.push_back(node.firstChild);
+            continue;
+        }
+
+        for (int i = node.firstPrimitive, end = i + node.primitiveCount; i < end; ++i) {
+            const Primitive &primitive = m_primitives.at(i);
+            if (rayIntersectsBox(origin, direction, primitive.box))
+                entities.push_back(primitive.entity);
+        }
+    }
+    return entities;
+}
+
+QVector<Entity *> BoundingVolumeHierarchy::proximityQuery(const Vector3D &center, float distance) const
+{
+    QVector<Entity *> entities;
+    if (m_nodes.isEmpty())
+        return entities;
+
+    const float squaredDistance = distance * distance;
+    QVarLengthArray<int, 64> stack;
+    stack.push_back(0);
+    while (!stack.isEmpty()) {
+        const Node &node = m_nodes.at(stack.last());
+        stack.removeLast();
+
+        if (squaredDistanceToBox(center, node.box) > squaredDistance)
+            continue;
+
+        if (node.firstChild >= 0) {
+            stack.push_back(node.firstChild + 1);
+            stack.push_back(node.firstChild);
+            continue;
+        }
+
+        for (int i = node.firstPrimitive, end = i + node.primitiveCount; i < end; ++i) {
+            const Primitive &primitive = m_primitives.at(i);
+            if (squaredDistanceToBox(center, primitive.box) <= squaredDistance)
+                entities.push_back(primitive.entity);
+        }
+    }
+    return entities;
+}
+
+// Binned SAH build over the current primitive boxes. Children are always
+// stored after their parent, which refitNodes() relies on
+void BoundingVolumeHierarchy::rebuild()
+{
+    const int primitiveCount = m_primitives.size();
+    BvhBuilder::build(m_primitives, [] (const Primitive &primitive) -> const BoundingBox & {
+        return primitive.box;
+    }, MaxLeafSize, m_nodes);
+
+    m_primitiveLeaves.resize(primitiveCount);
+    m_areaSum = 0.0;
+    m_refitsSinceAreaSum = 0;
+    if (primitiveCount == 0) {
+        m_dirtyNodes.clear();
+        m_builtCost = 0.0f;
+        return;
+    }
+
+    for (int nodeIndex = 0, m = m_nodes.size(); nodeIndex < m; ++nodeIndex) {
+        const Node &node = m_nodes.at(nodeIndex);
+        if (node.firstChild >= 0)
+            continue;
+        for (int i = node.firstPrimitive, end = i + node.primitiveCount; i < end; ++i)
+            m_primitiveLeaves[i] = nodeIndex;
+    }
+
+    for (int i = 0; i < primitiveCount; ++i)
+        m_primitives.at(i).entity->setBoundingVolumeHierarchyIndex(i);
+
+    m_dirtyNodes.fill(false, m_nodes.size());
+    computeAreaSum();
+    m_builtCost = cost();
+}
+
+// Marks node and its ancestors, stops at the first one already marked
+void BoundingVolumeHierarchy::markDirtyPath(int node, QVector<int> &dirtyNodes)
+{
+    for (; node >= 0 && !m_dirtyNodes.at(node); node = m_nodes.at(node).parent) {
+        m_dirtyNodes[node] = true;
+        dirtyNodes.push_back(node);
+    }
+}
+
+void BoundingVolumeHierarchy::refitNodes(QVector<int> &dirtyNodes)
+{
+    if (dirtyNodes.isEmpty())
+        return;
+
+    // Children being stored after their parent, they are refitted first
+    std::sort(dirtyNodes.begin(), dirtyNodes.end(), std::greater<int>());
+    for (const int i : qAsConst(dirtyNodes)) {
+        m_dirtyNodes[i] = false;
+
+        Node &node = m_nodes[i];
+        m_areaSum -= nodeCost(node);
+        if (node.firstChild >= 0) {
+            node.box = m_nodes.at(node.firstChild).box;
+            expandBox(node.box, m_nodes.at(node.firstChild + 1).box);
+        } else {
+            clearBox(node.box);
+            for (int p = node.firstPrimitive, end = p + node.primitiveCount; p < end; ++p)
+                expandBox(node.box, m_primitives.at(p).box);
+        }
+        m_areaSum += nodeCost(node);
+    }
+
+    if (++m_refitsSinceAreaSum >= AreaSumRefitCount)
+        computeAreaSum();
+
+    if (cost() > RebuildCostRatio * m_builtCost)
+        rebuild();
+}
+
+void BoundingVolumeHierarchy::computeAreaSum()
+{
+    m_areaSum = 0.0;
+    for (const Node &node : qAsConst(m_nodes))
+        m_areaSum += nodeCost(node);
+    m_refitsSinceAreaSum = 0;
+}
+
+float BoundingVolumeHierarchy::nodeCost(const Node &node) const
+{
+    const float area = halfSurfaceArea(node.box);
+    return node.firstChild < 0 ? area * node.primitiveCount : area;
+}
+
+} // Render
+
+} // Qt3DRender
+
+QT_END_NAMESPACE
@@ -0,0 +1,144 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QT3DRENDER_RENDER_BOUNDINGVOLUMEHIERARCHY_P_H
+#define QT3DRENDER_RENDER_BOUNDINGVOLUMEHIERARCHY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <Qt3DRender/private/qt3drender_global_p.h>
+#include <Qt3DRender/private/bvhbuilder_p.h>
+#include <Qt3DCore/private/vector3d_p.h>
+
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace RayCasting {
+class QRay3D;
+}
+
+namespace Render {
+
+class Entity;
+struct Plane;
+
+// Spatial index over the entities of a scene. Each entity is bound by a box
+// containing its world bounding volume and the center of its world bounding
+// volume with children, the tree is built using the surface area heuristic.
+// Transform changes only refit the boxes, the tree is rebuilt when the entity
+// hierarchy changed or when refitting degraded it too much.
+class QT3DRENDERSHARED_PRIVATE_EXPORT BoundingVolumeHierarchy
+{
+public:
+    typedef BvhBuilder::BoundingBox BoundingBox;
+
+    BoundingVolumeHierarchy();
+
+    void build(Entity *root);
+    void refit();
+    void refit(const QVector<Entity *> &entities);
+    void invalidate();
+
+    inline bool isValid() const Q_DECL_NOTHROW { return m_root != nullptr; }
+    inline Entity *root() const Q_DECL_NOTHROW { return m_root; }
+    inline int entityCount() const Q_DECL_NOTHROW { return m_primitives.size(); }
+    inline int nodeCount() const Q_DECL_NOTHROW { return m_nodes.size(); }
+    float cost() const;
+
+    // Index stored on the entity when the tree was built, -1 if the entity
+    // is not indexed by this hierarchy. An entity can only be indexed by the
+    // last hierarchy built over it
+    int primitiveIndex(const Entity *entity) const;
+
+    // Flags, indexed by primitiveIndex(), the entities whose world bounding
+    // volume is not entirely behind one of the 6 planes
+    void frustumQuery(const Plane *planes, QVector<bool> &visiblePrimitives) const;
+    // Entities whose box is crossed by the ray, their bounding volumes still need to be tested
+    QVector<Entity *> rayQuery(const RayCasting::QRay3D &ray) const;
+    // Entities whose box is closer than distance to center, to be refined by the caller
+    QVector<Entity *> proximityQuery(const Vector3D &center, float distance) const;
+
+private:
+    struct Primitive
+    {
+        Entity *entity;
+        BoundingBox box;
+    };
+
+    typedef BvhBuilder::Node Node;
+
+    void rebuild();
+    void markDirtyPath(int node, QVector<int> &dirtyNodes);
+    void refitNodes(QVector<int> &dirtyNodes);
+    void computeAreaSum();
+    float nodeCost(const Node &node) const;
+
+    Entity *m_root;
+    // Ordered so that the primitives of any node are contiguous
+    QVector<Primitive> m_primitives;
+    QVector<int> m_primitiveLeaves;
+    QVector<Node> m_nodes;
+    QVector<bool> m_dirtyNodes;
+    // Surface areas weighted by primitive counts, updated when refitting and
+    // recomputed every few refits so that rounding errors can't accumulate
+    double m_areaSum;
+    int m_refitsSinceAreaSum;
+    float m_builtCost;
+};
+
+} // Render
+
+} // Qt3DRender
+
+QT_END_NAMESPACE
+
+#endif // QT3DRENDER_RENDER_BOUNDINGVOLUMEHIERARCHY_P_H
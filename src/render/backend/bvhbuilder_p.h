@@ -0,0 +1,265 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QT3DRENDER_RENDER_BVHBUILDER_P_H
+#define QT3DRENDER_RENDER_BVHBUILDER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtGlobal>
+#include <QVarLengthArray>
+#include <QVector>
+
+#include <algorithm>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+// Binned surface area heuristic builder shared by the bounding volume
+// hierarchies of the entities and of the triangles
+namespace BvhBuilder {
+
+struct BoundingBox
+{
+    float lower[3];
+    float upper[3];
+};
+
+struct Node
+{
+    BoundingBox box;
+    int parent;
+    int firstChild; // -1 for leaves, the second child follows the first one
+    int firstPrimitive;
+    int primitiveCount;
+};
+
+const int BinCount = 12;
+
+inline void clearBox(BoundingBox &box)
+{
+    for (int axis = 0; axis < 3; ++axis) {
+        box.lower[axis] = std::numeric_limits<float>::max();
+        box.upper[axis] = -std::numeric_limits<float>::max();
+    }
+}
+
+inline void expandBox(BoundingBox &box, const BoundingBox &other)
+{
+    for (int axis = 0; axis < 3; ++axis) {
+        box.lower[axis] = std::min(box.lower[axis], other.lower[axis]);
+        box.upper[axis] = std::max(box.upper[axis], other.upper[axis]);
+    }
+}
+
+inline float halfSurfaceArea(const BoundingBox &box)
+{
+    const float dx = box.upper[0] - box.lower[0];
+    const float dy = box.upper[1] - box.lower[1];
+    const float dz = box.upper[2] - box.lower[2];
+    if (dx < 0.0f || dy < 0.0f || dz < 0.0f)
+        return 0.0f;
+    return dx * dy + dy * dz + dz * dx;
+}
+
+inline float centroid(const BoundingBox &box, int axis)
+{
+    return 0.5f * (box.lower[axis] + box.upper[axis]);
+}
+
+// Builds the nodes over primitives, reordering them so that the primitives
+// of any node are contiguous. boxOf(primitive) returns the BoundingBox of a
+// primitive. Children are always stored after their parent. Nodes holding
+// more than maxLeafSize primitives are always split, smaller ones only when
+// splitting them pays off
+template<typename Primitive, typename BoxAccessor>
+void build(QVector<Primitive> &primitives, BoxAccessor boxOf, int maxLeafSize, QVector<Node> &nodes)
+{
+    const int primitiveCount = primitives.size();
+    nodes.clear();
+    if (primitiveCount == 0)
+        return;
+
+    nodes.reserve(2 * primitiveCount - 1);
+    Node rootNode;
+    rootNode.parent = -1;
+    rootNode.firstChild = -1;
+    rootNode.firstPrimitive = 0;
+    rootNode.primitiveCount = primitiveCount;
+    nodes.push_back(rootNode);
+
+    QVarLengthArray<int, 64> stack;
+    stack.push_back(0);
+    while (!stack.isEmpty()) {
+        const int nodeIndex = stack.last();
+        stack.removeLast();
+
+        const int first = nodes.at(nodeIndex).firstPrimitive;
+        const int count = nodes.at(nodeIndex).primitiveCount;
+        const auto begin = primitives.begin() + first;
+        const auto end = begin + count;
+
+        BoundingBox box;
+        BoundingBox centroidBox;
+        clearBox(box);
+        clearBox(centroidBox);
+        for (auto it = begin; it != end; ++it) {
+            const BoundingBox &primitiveBox = boxOf(*it);
+            expandBox(box, primitiveBox);
+            for (int axis = 0; axis < 3; ++axis) {
+                const float c = centroid(primitiveBox, axis);
+                centroidBox.lower[axis] = std::min(centroidBox.lower[axis], c);
+                centroidBox.upper[axis] = std::max(centroidBox.upper[axis], c);
+            }
+        }
+        nodes[nodeIndex].box = box;
+
+        int split = -1;
+        if (count > 1) {
+            int axis = 0;
+            for (int a = 1; a < 3; ++a) {
+                if (centroidBox.upper[a] - centroidBox.lower[a] > centroidBox.upper[axis] - centroidBox.lower[axis])
+                    axis = a;
+            }
+            const float extent = centroidBox.upper[axis] - centroidBox.lower[axis];
+
+            if (extent > 0.0f) {
+                const float binScale = BinCount / extent;
+                const float axisLower = centroidBox.lower[axis];
+                auto binIndex = [&] (const Primitive &primitive) {
+                    return std::min(BinCount - 1, int((centroid(boxOf(primitive), axis) - axisLower) * binScale));
+                };
+
+                BoundingBox binBoxes[BinCount];
+                int binCounts[BinCount] = {};
+                for (int b = 0; b < BinCount; ++b)
+                    clearBox(binBoxes[b]);
+                for (auto it = begin; it != end; ++it) {
+                    const int b = binIndex(*it);
+                    expandBox(binBoxes[b], boxOf(*it));
+                    ++binCounts[b];
+                }
+
+                // Cost of splitting after each bin, right side swept first
+                float rightCosts[BinCount];
+                BoundingBox sweepBox;
+                clearBox(sweepBox);
+                int sweepCount = 0;
+                for (int b = BinCount - 1; b > 0; --b) {
+                    expandBox(sweepBox, binBoxes[b]);
+                    sweepCount += binCounts[b];
+                    rightCosts[b - 1] = halfSurfaceArea(sweepBox) * sweepCount;
+                }
+
+                float bestCost = std::numeric_limits<float>::max();
+                int bestBin = -1;
+                clearBox(sweepBox);
+                sweepCount = 0;
+                for (int b = 0; b < BinCount - 1; ++b) {
+                    expandBox(sweepBox, binBoxes[b]);
+                    sweepCount += binCounts[b];
+                    if (sweepCount == 0 || sweepCount == count)
+                        continue;
+                    const float splitCost = halfSurfaceArea(sweepBox) * sweepCount + rightCosts[b];
+                    if (splitCost < bestCost) {
+                        bestCost = splitCost;
+                        bestBin = b;
+                    }
+                }
+
+                // Keep small nodes as leaves when splitting them would not pay off
+                const float area = halfSurfaceArea(box);
+                const bool splitPaysOff = area <= 0.0f || 1.0f + bestCost / area < float(count);
+                if (bestBin >= 0 && (count > maxLeafSize || splitPaysOff)) {
+                    const auto middle = std::partition(begin, end, [&] (const Primitive &primitive) {
+                        return binIndex(primitive) <= bestBin;
+                    });
+                    split = first + int(middle - begin);
+                }
+            }
+
+            // All centroids are the same, only split to keep the leaves small
+            if (split < 0 && count > maxLeafSize)
+                split = first + count / 2;
+        }
+
+        if (split < 0)
+            continue;
+
+        const int firstChild = nodes.size();
+        nodes[nodeIndex].firstChild = firstChild;
+
+        Node child;
+        child.parent = nodeIndex;
+        child.firstChild = -1;
+        child.firstPrimitive = first;
+        child.primitiveCount = split - first;
+        nodes.push_back(child);
+        child.firstPrimitive = split;
+        child.primitiveCount = first + count - split;
+        nodes.push_back(child);
+
+        stack.push_back(firstChild + 1);
+        stack.push_back(firstChild);
+    }
+}
+
+} // BvhBuilder
+
+} // Render
+
+} // Qt3DRender
+
+QT_END_NAMESPACE
+
+#endif // QT3DRENDER_RENDER_BVHBUILDER_P_H
@@ -49,6 +49,7 @@
 #include <Qt3DRender/private/computefilteredboundingvolumejob_p.h>
 #include <Qt3DCore/qentity.h>
 #include <Qt3DCore/qpropertyupdatedchange.h>
+#include <Qt3DCore/private/qtypedpropertyupdatechange_p.h>
 #include <Qt3DCore/qtransform.h>
 
 QT_BEGIN_NAMESPACE
@@ -174,8 +175,20 @@ void CameraLens::setExposure(float exposure)
 
 void CameraLens::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
 {
+    static const int projectionMatrixId = QTypedPropertyUpdatedChangeBase::propertyIdForName("projectionMatrix");
+    static const int exposureId = QTypedPropertyUpdatedChangeBase::propertyIdForName("exposure");
+
     switch (e->type()) {
     case PropertyUpdated: {
+        if (const QTypedPropertyUpdatedChangeBase *typedChange = QTypedPropertyUpdatedChangeBase::fromChange(e)) {
+            if (typedChange->propertyId() == projectionMatrixId)
+                m_projection = Matrix4x4(typedChange->value<QMatrix4x4>());
+            else if (typedChange->propertyId() == exposureId)
+                setExposure(typedChange->value<float>());
+            markDirty(AbstractRenderer::AllDirty);
+            break;
+        }
+
         QPropertyUpdatedChangePtr propertyChange = qSharedPointerCast<QPropertyUpdatedChange>(e);
 
         if (propertyChange->propertyName() == QByteArrayLiteral("projectionMatrix")) {
@@ -84,6 +84,8 @@ Entity::Entity()
     , m_nodeManagers(nullptr)
     , m_boundingDirty(false)
     , m_treeEnabled(true)
+    , m_boundingVolumeHierarchyIndex(-1)
+    , m_treeIndex(-1)
 {
 }
 
@@ -126,6 +128,8 @@ void Entity::cleanup()
     m_worldBoundingVolume.reset();
     m_worldBoundingVolumeWithChildren.reset();
     m_boundingDirty = false;
+    m_boundingVolumeHierarchyIndex = -1;
+    m_treeIndex = -1;
     QBackendNode::setEnabled(false);
 }
 
@@ -191,6 +195,8 @@ void Entity::initializeFromPeer(const QNodeCreatedChangeBasePtr &change)
         setParentHandle(m_nodeManagers->renderNodesManager()->lookupHandle(parentEntityId));
     else
         qCDebug(Render::RenderNodes) << Q_FUNC_INFO << "No parent entity found for Entity" << peerId();
+
+    m_nodeManagers->transformManager()->markEntityHierarchyDirty();
 }
 
 void Entity::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
@@ -203,6 +209,7 @@ void Entity::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
         addComponent(componentIdAndType);
         qCDebug(Render::RenderNodes) << Q_FUNC_INFO << "Component Added. Id =" << change->componentId();
         markDirty(AbstractRenderer::AllDirty);
+        m_nodeManagers->transformManager()->markEntityHierarchyDirty();
         break;
     }
 
@@ -211,6 +218,7 @@ void Entity::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
         removeComponent(change->componentId());
         qCDebug(Render::RenderNodes) << Q_FUNC_INFO << "Component Removed. Id =" << change->componentId();
         markDirty(AbstractRenderer::AllDirty);
+        m_nodeManagers->transformManager()->markEntityHierarchyDirty();
         break;
     }
 
@@ -219,6 +227,7 @@ void Entity::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
         if (change->metaObject()->inherits(&QEntity::staticMetaObject)) {
             appendChildHandle(m_nodeManagers->renderNodesManager()->lookupHandle(change->addedNodeId()));
             markDirty(AbstractRenderer::AllDirty);
+            m_nodeManagers->transformManager()->markEntityHierarchyDirty();
         }
         break;
     }
@@ -228,6 +237,7 @@ void Entity::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
         if (change->metaObject()->inherits(&QEntity::staticMetaObject)) {
             removeChildHandle(m_nodeManagers->renderNodesManager()->lookupHandle(change->removedNodeId()));
             markDirty(AbstractRenderer::AllDirty);
+            m_nodeManagers->transformManager()->markEntityHierarchyDirty();
         }
         break;
     }
@@ -423,6 +433,27 @@ Qt3DCore::QBackendNode *RenderEntityFunctor::create(const Qt3DCore::QNodeCreated
     return entity;
 }
 
+void RenderEntityFunctor::acquireMany(const QVector<Qt3DCore::QNodeCreatedChangeBasePtr> &changes) const
+{
+    m_nodeManagers->renderNodesManager()->getOrAcquireHandles(subjectIds(changes));
+}
+
+QVector<Qt3DCore::QBackendNode *> RenderEntityFunctor::createMany(const QVector<Qt3DCore::QNodeCreatedChangeBasePtr> &changes) const
+{
+    EntityManager *entityManager = m_nodeManagers->renderNodesManager();
+    const QVector<HEntity> handles = entityManager->getOrAcquireHandles(subjectIds(changes));
+    QVector<Qt3DCore::QBackendNode *> entities;
+    entities.reserve(handles.size());
+    for (const HEntity &handle : handles) {
+        Entity *entity = entityManager->data(handle);
+        entity->setNodeManagers(m_nodeManagers);
+        entity->setHandle(handle);
+        entity->setRenderer(m_renderer);
+        entities.push_back(entity);
+    }
+    return entities;
+}
+
 Qt3DCore::QBackendNode *RenderEntityFunctor::get(Qt3DCore::QNodeId id) const
 {
     return m_nodeManagers->renderNodesManager()->lookupResource(id);
@@ -431,6 +462,7 @@ Qt3DCore::QBackendNode *RenderEntityFunctor::get(Qt3DCore::QNodeId id) const
 void RenderEntityFunctor::destroy(Qt3DCore::QNodeId id) const
 {
     m_nodeManagers->renderNodesManager()->releaseResource(id);
+    m_nodeManagers->transformManager()->markEntityHierarchyDirty();
 }
 
 } // namespace Render
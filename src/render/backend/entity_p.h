@@ -56,6 +56,7 @@
 #include <Qt3DRender/private/renderer_p.h>
 #include <Qt3DRender/private/handle_types_p.h>
 #include <Qt3DCore/qnodecreatedchange.h>
+#include <Qt3DCore/private/qbackendnode_p.h>
 #include <Qt3DCore/private/qentity_p.h>
 #include <Qt3DCore/private/qhandle_p.h>
 #include <QVector>
@@ -119,6 +120,23 @@ public:
     void setTreeEnabled(bool enabled) { m_treeEnabled = enabled; }
     bool isTreeEnabled() const { return m_treeEnabled; }
 
+    // Position in the BoundingVolumeHierarchy of the scene, -1 if not indexed
+    void setBoundingVolumeHierarchyIndex(int index) { m_boundingVolumeHierarchyIndex = index; }
+    int boundingVolumeHierarchyIndex() const { return m_boundingVolumeHierarchyIndex; }
+
+    // Position in the FlattenedEntityTree of the scene, -1 if not indexed
+    void setTreeIndex(int index) { m_treeIndex = index; }
+    int treeIndex() const { return m_treeIndex; }
+
+    // Order of the entity lists intersected by the RenderViewBuilder, the one
+    // of the flattened tree. Entities that aren't indexed come first, sorted
+    // by address, which is also the order used when there is no tree
+    static bool treeOrderLessThan(const Entity *lhs, const Entity *rhs)
+    {
+        return lhs->m_treeIndex < rhs->m_treeIndex
+                || (lhs->m_treeIndex == rhs->m_treeIndex && lhs < rhs);
+    }
+
     Qt3DCore::QNodeIdVector layerIds() const { return m_layerComponents + m_recursiveLayerComponents; }
     void addRecursiveLayerId(const Qt3DCore::QNodeId layerId);
     void removeRecursiveLayerId(const Qt3DCore::QNodeId layerId);
@@ -209,6 +227,8 @@ private:
     bool m_boundingDirty;
     // true only if this and all parent nodes are enabled
     bool m_treeEnabled;
+    int m_boundingVolumeHierarchyIndex;
+    int m_treeIndex;
 };
 
 #define ENTITY_COMPONENT_TEMPLATE_SPECIALIZATION(Type, Handle) \
@@ -298,11 +318,13 @@ ENTITY_COMPONENT_LIST_TEMPLATE_SPECIALIZATION(ShaderData, HShaderData)
 ENTITY_COMPONENT_LIST_TEMPLATE_SPECIALIZATION(Light, HLight)
 ENTITY_COMPONENT_LIST_TEMPLATE_SPECIALIZATION(EnvironmentLight, HEnvironmentLight)
 
-class RenderEntityFunctor : public Qt3DCore::QBackendNodeMapper
+class RenderEntityFunctor : public Qt3DCore::QBackendNodeMapper, public Qt3DCore::QBackendNodeBulkMapper
 {
 public:
     explicit RenderEntityFunctor(AbstractRenderer *renderer, NodeManagers *manager);
     Qt3DCore::QBackendNode *create(const Qt3DCore::QNodeCreatedChangeBasePtr &change) const override;
+    void acquireMany(const QVector<Qt3DCore::QNodeCreatedChangeBasePtr> &changes) const override;
+    QVector<Qt3DCore::QBackendNode *> createMany(const QVector<Qt3DCore::QNodeCreatedChangeBasePtr> &changes) const override;
     Qt3DCore::QBackendNode *get(Qt3DCore::QNodeId id) const override;
     void destroy(Qt3DCore::QNodeId id) const override;
 
@@ -0,0 +1,128 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "flattenedentitytree_p.h"
+
+#include <Qt3DRender/private/entity_p.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+FlattenedEntityTree::FlattenedEntityTree()
+{
+}
+
+void FlattenedEntityTree::build(Entity *root)
+{
+    clear();
+    if (root == nullptr)
+        return;
+
+    // Depth first with an explicit stack, children are pushed in reverse
+    // order so that they end up in the same order as in Entity::children()
+    QVector<QPair<Entity *, int>> stack;
+    stack.push_back(qMakePair(root, -1));
+    while (!stack.isEmpty()) {
+        const QPair<Entity *, int> current = stack.takeLast();
+        const int index = m_entities.size();
+        m_entities.push_back(current.first);
+        m_parentIndices.push_back(current.second);
+        m_indices.insert(current.first, index);
+
+        const QVector<Entity *> children = current.first->children();
+        for (auto it = children.crbegin(), end = children.crend(); it != end; ++it)
+            stack.push_back(qMakePair(*it, index));
+    }
+
+    // Children come after their parent, walking backwards propagates the end
+    // of each subtree up to its root
+    const int count = m_entities.size();
+    m_subtreeEnds.resize(count);
+    for (int i = 0; i < count; ++i)
+        m_subtreeEnds[i] = i + 1;
+    for (int i = count - 1; i > 0; --i) {
+        const int parentIndex = m_parentIndices.at(i);
+        m_subtreeEnds[parentIndex] = std::max(m_subtreeEnds.at(parentIndex), m_subtreeEnds.at(i));
+    }
+}
+
+void FlattenedEntityTree::clear()
+{
+    m_entities.clear();
+    m_parentIndices.clear();
+    m_subtreeEnds.clear();
+    m_indices.clear();
+}
+
+void FlattenedEntityTree::indexEntities() const
+{
+    for (int i = 0, m = m_entities.size(); i < m; ++i)
+        m_entities.at(i)->setTreeIndex(i);
+}
+
+// Returns -1 if the entity is not part of the tree
+int FlattenedEntityTree::indexOf(const Entity *entity) const
+{
+    return m_indices.value(entity, -1);
+}
+
+// Returns tree if it contains entity, otherwise flattens the subtree of entity
+// into fallback and returns it. This lets jobs run on their own, without the
+// renderer maintaining the tree of the scene, as they do in the unit tests.
+const FlattenedEntityTree *FlattenedEntityTree::treeContaining(const FlattenedEntityTree *tree,
+                                                               Entity *entity,
+                                                               FlattenedEntityTree *fallback)
+{
+    if (tree != nullptr && tree->indexOf(entity) >= 0)
+        return tree;
+    fallback->build(entity);
+    return fallback;
+}
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
@@ -0,0 +1,120 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QT3DRENDER_RENDER_FLATTENEDENTITYTREE_P_H
+#define QT3DRENDER_RENDER_FLATTENEDENTITYTREE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <Qt3DRender/private/qt3drender_global_p.h>
+
+#include <QHash>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+class Entity;
+
+// Entities of a scene laid out contiguously in pre-order: the descendants of
+// the entity at index i are at indices ]i, subtreeEnd(i)[ and every parent
+// comes before its children. This allows the jobs that used to recurse
+// through Entity::children() to iterate linearly and to split the scene
+// into independent ranges.
+//
+// The tree is a snapshot of the hierarchy, it must be rebuilt whenever
+// entities are added, removed or reparented.
+class QT3DRENDERSHARED_PRIVATE_EXPORT FlattenedEntityTree
+{
+public:
+    FlattenedEntityTree();
+
+    void build(Entity *root);
+    void clear();
+
+    // Stores the index of each entity on it, only the tree of the whole scene
+    // does so, not the ones the jobs build over subtrees
+    void indexEntities() const;
+
+    inline bool isEmpty() const Q_DECL_NOTHROW { return m_entities.isEmpty(); }
+    inline int size() const Q_DECL_NOTHROW { return m_entities.size(); }
+    inline Entity *root() const Q_DECL_NOTHROW { return m_entities.isEmpty() ? nullptr : m_entities.first(); }
+
+    inline Entity *entity(int index) const Q_DECL_NOTHROW { return m_entities.at(index); }
+    inline int parentIndex(int index) const Q_DECL_NOTHROW { return m_parentIndices.at(index); }
+    inline int subtreeEnd(int index) const Q_DECL_NOTHROW { return m_subtreeEnds.at(index); }
+    inline bool isLeaf(int index) const Q_DECL_NOTHROW { return m_subtreeEnds.at(index) == index + 1; }
+
+    inline const QVector<Entity *> &entities() const Q_DECL_NOTHROW { return m_entities; }
+    inline const QVector<int> &parentIndices() const Q_DECL_NOTHROW { return m_parentIndices; }
+    inline const QVector<int> &subtreeEnds() const Q_DECL_NOTHROW { return m_subtreeEnds; }
+
+    int indexOf(const Entity *entity) const;
+
+    static const FlattenedEntityTree *treeContaining(const FlattenedEntityTree *tree,
+                                                     Entity *entity,
+                                                     FlattenedEntityTree *fallback);
+
+private:
+    QVector<Entity *> m_entities;
+    QVector<int> m_parentIndices;
+    QVector<int> m_subtreeEnds;
+    QHash<const Entity *, int> m_indices;
+};
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
+
+#endif // QT3DRENDER_RENDER_FLATTENEDENTITYTREE_P_H
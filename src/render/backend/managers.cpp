@@ -41,11 +41,86 @@
 
 #include <Qt3DRender/private/framegraphnode_p.h>
 
+#include <QSet>
+
 QT_BEGIN_NAMESPACE
 
 namespace Qt3DRender {
 namespace Render {
 
+TransformManager::TransformManager()
+    : m_entityHierarchyDirty(true)
+    , m_entityLookupDirty(true)
+{
+}
+
+void TransformManager::addDirtyTransform(Qt3DCore::QNodeId transformId)
+{
+    m_dirtyTransforms.push_back(transformId);
+}
+
+// Called whenever entities are added, removed, reparented or have their
+// components changed. The next transform update then covers the whole scene
+void TransformManager::markEntityHierarchyDirty()
+{
+    m_entityHierarchyDirty = true;
+}
+
+// Returns the topmost entities referencing a transform that changed since the
+// last call. If the entity hierarchy changed in the meantime, entityHierarchyDirty
+// is set to true and no roots are returned, the whole scene has to be updated.
+QVector<Entity *> TransformManager::takeDirtySubtreeRoots(EntityManager *entityManager,
+                                                          bool *entityHierarchyDirty)
+{
+    const QVector<Qt3DCore::QNodeId> dirtyTransforms = std::move(m_dirtyTransforms);
+    m_dirtyTransforms.clear();
+
+    *entityHierarchyDirty = m_entityHierarchyDirty;
+    if (m_entityHierarchyDirty) {
+        m_entityHierarchyDirty = false;
+        m_entityLookupDirty = true;
+        return QVector<Entity *>();
+    }
+
+    if (dirtyTransforms.isEmpty())
+        return QVector<Entity *>();
+
+    // Transforms can be shared between entities, the reverse lookup is only
+    // rebuilt the first time it is needed after the hierarchy changed
+    if (m_entityLookupDirty) {
+        m_entitiesForTransform.clear();
+        const QVector<HEntity> handles = entityManager->activeHandles();
+        for (const HEntity &handle : handles) {
+            const Qt3DCore::QNodeId transformId = entityManager->data(handle)->componentUuid<Transform>();
+            if (!transformId.isNull())
+                m_entitiesForTransform[transformId].push_back(handle);
+        }
+        m_entityLookupDirty = false;
+    }
+
+    QSet<Entity *> dirtyEntities;
+    for (const Qt3DCore::QNodeId transformId : dirtyTransforms) {
+        const QVector<HEntity> handles = m_entitiesForTransform.value(transformId);
+        for (const HEntity &handle : handles) {
+            Entity *entity = entityManager->data(handle);
+            if (entity != nullptr)
+                dirtyEntities.insert(entity);
+        }
+    }
+
+    // Entities nested in another dirty subtree are updated along with it
+    QVector<Entity *> dirtySubtreeRoots;
+    dirtySubtreeRoots.reserve(dirtyEntities.size());
+    for (Entity *entity : qAsConst(dirtyEntities)) {
+        bool nested = false;
+        for (Entity *parent = entity->parent(); parent != nullptr && !nested; parent = parent->parent())
+            nested = dirtyEntities.contains(parent);
+        if (!nested)
+            dirtySubtreeRoots.push_back(entity);
+    }
+    return dirtySubtreeRoots;
+}
+
 FrameGraphManager::~FrameGraphManager()
 {
     qDeleteAll(m_nodes);
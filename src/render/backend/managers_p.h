@@ -255,13 +255,23 @@ private:
     QVector<Qt3DCore::QNodeId> m_textureIdsToCleanup;
 };
 
-class TransformManager : public Qt3DCore::QResourceManager<
+class Q_AUTOTEST_EXPORT TransformManager : public Qt3DCore::QResourceManager<
         Transform,
         Qt3DCore::QNodeId,
         Qt3DCore::NonLockingPolicy>
 {
 public:
-    TransformManager() {}
+    TransformManager();
+
+    void addDirtyTransform(Qt3DCore::QNodeId transformId);
+    void markEntityHierarchyDirty();
+    QVector<Entity *> takeDirtySubtreeRoots(EntityManager *entityManager, bool *entityHierarchyDirty);
+
+private:
+    QVector<Qt3DCore::QNodeId> m_dirtyTransforms;
+    QHash<Qt3DCore::QNodeId, QVector<HEntity>> m_entitiesForTransform;
+    bool m_entityHierarchyDirty;
+    bool m_entityLookupDirty;
 };
 
 class VAOManager : public Qt3DCore::QResourceManager<
@@ -52,6 +52,7 @@
 //
 
 #include <Qt3DCore/qnode.h>
+#include <Qt3DCore/private/qbackendnode_p.h>
 #include <Qt3DRender/private/backendnode_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -63,7 +64,7 @@ namespace Render {
 class AbstractRenderer;
 
 template<class Backend, class Manager>
-class NodeFunctor : public Qt3DCore::QBackendNodeMapper
+class NodeFunctor : public Qt3DCore::QBackendNodeMapper, public Qt3DCore::QBackendNodeBulkMapper
 {
 public:
     explicit NodeFunctor(AbstractRenderer *renderer)
@@ -79,6 +80,23 @@ public:
         return backend;
     }
 
+    void acquireMany(const QVector<Qt3DCore::QNodeCreatedChangeBasePtr> &changes) const final
+    {
+        m_manager->getOrAcquireHandles(subjectIds(changes));
+    }
+
+    QVector<Qt3DCore::QBackendNode *> createMany(const QVector<Qt3DCore::QNodeCreatedChangeBasePtr> &changes) const final
+    {
+        const QVector<Backend *> backends = m_manager->getOrCreateResources(subjectIds(changes));
+        QVector<Qt3DCore::QBackendNode *> nodes;
+        nodes.reserve(backends.size());
+        for (Backend *backend : backends) {
+            backend->setRenderer(m_renderer);
+            nodes.push_back(backend);
+        }
+        return nodes;
+    }
+
     Qt3DCore::QBackendNode *get(Qt3DCore::QNodeId id) const final
     {
         return m_manager->lookupResource(id);
@@ -48,6 +48,8 @@
 #include <Qt3DRender/private/techniquemanager_p.h>
 #include <Qt3DRender/private/armature_p.h>
 #include <Qt3DRender/private/skeleton_p.h>
+#include <Qt3DRender/private/boundingvolumehierarchy_p.h>
+#include <Qt3DRender/private/flattenedentitytree_p.h>
 #include <private/resourceaccessor_p.h>
 
 #include <QOpenGLVertexArrayObject>
@@ -99,6 +101,8 @@ NodeManagers::NodeManagers()
     , m_armatureManager(new ArmatureManager())
     , m_skeletonManager(new SkeletonManager())
     , m_jointManager(new JointManager())
+    , m_boundingVolumeHierarchy(new BoundingVolumeHierarchy())
+    , m_flattenedEntityTree(new FlattenedEntityTree())
     , m_resourceAccessor(new ResourceAccessor(this))
 {
 }
@@ -148,6 +152,8 @@ NodeManagers::~NodeManagers()
     delete m_armatureManager;
     delete m_skeletonManager;
     delete m_jointManager;
+    delete m_boundingVolumeHierarchy;
+    delete m_flattenedEntityTree;
 }
 
 QSharedPointer<ResourceAccessor> NodeManagers::resourceAccessor()
@@ -104,6 +104,8 @@ class RenderStateManager;
 class ArmatureManager;
 class SkeletonManager;
 class JointManager;
+class BoundingVolumeHierarchy;
+class FlattenedEntityTree;
 
 class FrameGraphNode;
 class Entity;
@@ -225,6 +227,8 @@ public:
     inline ArmatureManager *armatureManager() const Q_DECL_NOEXCEPT { return m_armatureManager; }
     inline SkeletonManager *skeletonManager() const Q_DECL_NOEXCEPT { return m_skeletonManager; }
     inline JointManager *jointManager() const Q_DECL_NOEXCEPT { return m_jointManager; }
+    inline BoundingVolumeHierarchy *boundingVolumeHierarchy() const Q_DECL_NOEXCEPT { return m_boundingVolumeHierarchy; }
+    inline FlattenedEntityTree *flattenedEntityTree() const Q_DECL_NOEXCEPT { return m_flattenedEntityTree; }
 
     QSharedPointer<ResourceAccessor> resourceAccessor();
 
@@ -269,6 +273,8 @@ private:
     ArmatureManager *m_armatureManager;
     SkeletonManager *m_skeletonManager;
     JointManager *m_jointManager;
+    BoundingVolumeHierarchy *m_boundingVolumeHierarchy;
+    FlattenedEntityTree *m_flattenedEntityTree;
 
     QSharedPointer<ResourceAccessor> m_resourceAccessor;
 };
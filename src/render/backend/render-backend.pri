@@ -34,7 +34,11 @@ HEADERS += \
     $$PWD/resourceaccessor_p.h \
     $$PWD/visitorutils_p.h \
     $$PWD/segmentsvisitor_p.h \
-    $$PWD/pointsvisitor_p.h
+    $$PWD/pointsvisitor_p.h \
+    $$PWD/boundingvolumehierarchy_p.h \
+    $$PWD/triangleboundingvolumehierarchy_p.h \
+    $$PWD/bvhbuilder_p.h \
+    $$PWD/flattenedentitytree_p.h
 
 SOURCES += \
     $$PWD/renderthread.cpp \
@@ -62,7 +66,10 @@ SOURCES += \
     $$PWD/offscreensurfacehelper.cpp \
     $$PWD/resourceaccessor.cpp \
     $$PWD/segmentsvisitor.cpp \
-    $$PWD/pointsvisitor.cpp
+    $$PWD/pointsvisitor.cpp \
+    $$PWD/boundingvolumehierarchy.cpp \
+    $$PWD/triangleboundingvolumehierarchy.cpp \
+    $$PWD/flattenedentitytree.cpp
 
 include($$QT3D_BUILD_ROOT/src/core/qt3dcore-config.pri)
 QT_FOR_CONFIG += 3dcore-private
@@ -58,6 +58,9 @@ RenderSettings::RenderSettings()
     , m_pickResultMode(QPickingSettings::NearestPick)
     , m_faceOrientationPickingMode(QPickingSettings::FrontFace)
     , m_pickWorldSpaceTolerance(.1f)
+    , m_automaticInstancing(false)
+    , m_uploadByteBudget(0)
+    , m_uploadTimeBudget(0)
     , m_activeFrameGraph()
 {
 }
@@ -72,6 +75,9 @@ void RenderSettings::initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePt
     m_pickResultMode = data.pickResultMode;
     m_pickWorldSpaceTolerance = data.pickWorldSpaceTolerance;
     m_faceOrientationPickingMode = data.faceOrientationPickingMode;
+    m_automaticInstancing = data.automaticInstancing;
+    m_uploadByteBudget = data.uploadByteBudget;
+    m_uploadTimeBudget = data.uploadTimeBudget;
 }
 
 void RenderSettings::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
@@ -90,6 +96,12 @@ void RenderSettings::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
             m_activeFrameGraph = propertyChange->value().value<QNodeId>();
         else if (propertyChange->propertyName() == QByteArrayLiteral("renderPolicy"))
             m_renderPolicy = propertyChange->value().value<QRenderSettings::RenderPolicy>();
+        else if (propertyChange->propertyName() == QByteArrayLiteral("automaticInstancing"))
+            m_automaticInstancing = propertyChange->value().toBool();
+        else if (propertyChange->propertyName() == QByteArrayLiteral("uploadByteBudget"))
+            m_uploadByteBudget = propertyChange->value().toInt();
+        else if (propertyChange->propertyName() == QByteArrayLiteral("uploadTimeBudget"))
+            m_uploadTimeBudget = propertyChange->value().toInt();
         markDirty(AbstractRenderer::AllDirty);
     }
 
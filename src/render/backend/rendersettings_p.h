@@ -75,6 +75,9 @@ public:
     QPickingSettings::PickResultMode pickResultMode() const { return m_pickResultMode; }
     QPickingSettings::FaceOrientationPickingMode faceOrientationPickingMode() const { return m_faceOrientationPickingMode; }
     float pickWorldSpaceTolerance() const { return m_pickWorldSpaceTolerance; }
+    bool automaticInstancing() const { return m_automaticInstancing; }
+    int uploadByteBudget() const { return m_uploadByteBudget; }
+    int uploadTimeBudget() const { return m_uploadTimeBudget; }
 
     // For unit test purposes
     void setActiveFrameGraphId(Qt3DCore::QNodeId frameGraphNodeId) { m_activeFrameGraph = frameGraphNodeId; }
@@ -87,6 +90,9 @@ private:
     QPickingSettings::PickResultMode m_pickResultMode;
     QPickingSettings::FaceOrientationPickingMode m_faceOrientationPickingMode;
     float m_pickWorldSpaceTolerance;
+    bool m_automaticInstancing;
+    int m_uploadByteBudget;
+    int m_uploadTimeBudget;
     Qt3DCore::QNodeId m_activeFrameGraph;
 };
 
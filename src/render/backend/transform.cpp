@@ -43,6 +43,9 @@
 #include <Qt3DCore/private/qchangearbiter_p.h>
 #include <Qt3DCore/qtransform.h>
 #include <Qt3DCore/private/qtransform_p.h>
+#include <Qt3DCore/private/qtypedpropertyupdatechange_p.h>
+#include <Qt3DRender/private/managers_p.h>
+#include <Qt3DRender/private/nodemanagers_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -101,7 +104,23 @@ QVector3D Transform::translation() const
 void Transform::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
 {
     // TODO: Flag the matrix as dirty and update all matrices batched in a job
-    if (e->type() == PropertyUpdated) {
+    static const int scale3DId = QTypedPropertyUpdatedChangeBase::propertyIdForName("scale3D");
+    static const int rotationId = QTypedPropertyUpdatedChangeBase::propertyIdForName("rotation");
+    static const int translationId = QTypedPropertyUpdatedChangeBase::propertyIdForName("translation");
+
+    if (const QTypedPropertyUpdatedChangeBase *typedChange = QTypedPropertyUpdatedChangeBase::fromChange(e)) {
+        const int propertyId = typedChange->propertyId();
+        if (propertyId == scale3DId) {
+            m_scale = typedChange->value<QVector3D>();
+            updateMatrix();
+        } else if (propertyId == rotationId) {
+            m_rotation = typedChange->value<QQuaternion>();
+            updateMatrix();
+        } else if (propertyId == translationId) {
+            m_translation = typedChange->value<QVector3D>();
+            updateMatrix();
+        }
+    } else if (e->type() == PropertyUpdated) {
         const QPropertyUpdatedChangePtr &propertyChange = qSharedPointerCast<QPropertyUpdatedChange>(e);
         if (propertyChange->propertyName() == QByteArrayLiteral("scale3D")) {
             m_scale = propertyChange->value().value<QVector3D>();
@@ -116,6 +135,12 @@ void Transform::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
     }
     markDirty(AbstractRenderer::TransformDirty);
 
+    // Only the entities referencing this transform and their children need
+    // their world transforms to be recomputed
+    NodeManagers *managers = renderer()->nodeManagers();
+    if (managers != nullptr)
+        managers->transformManager()->addDirtyTransform(peerId());
+
     BackendNode::sceneChangeEvent(e);
 }
 
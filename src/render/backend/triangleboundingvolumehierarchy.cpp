@@ -0,0 +1,210 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "triangleboundingvolumehierarchy_p.h"
+
+#include <Qt3DRender/private/trianglesvisitor_p.h>
+
+#include <QVarLengthArray>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+namespace {
+
+typedef TriangleBoundingVolumeHierarchy::Triangle Triangle;
+
+typedef BvhBuilder::BoundingBox BoundingBox;
+
+const int MaxLeafSize = 4;
+
+struct BuildPrimitive
+{
+    BoundingBox box;
+    int triangle;
+};
+
+// Segment going from start to start + direction
+bool segmentIntersectsBox(const float *start, const float *direction,
+                          const float *lower, const float *upper)
+{
+    float tMin = 0.0f;
+    float tMax = 1.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (direction[axis] == 0.0f) {
+            if (start[axis] < lower[axis] || start[axis] > upper[axis])
+                return false;
+            continue;
+        }
+        const float inverse = 1.0f / direction[axis];
+        float t0 = (lower[axis] - start[axis]) * inverse;
+        float t1 = (upper[axis] - start[axis]) * inverse;
+        if (t0 > t1)
+            std::swap(t0, t1);
+        tMin = std::max(tMin, t0);
+        tMax = std::min(tMax, t1);
+        if (tMin > tMax)
+            return false;
+    }
+    return true;
+}
+
+class TriangleGatherer : public TrianglesVisitor
+{
+public:
+    explicit TriangleGatherer(NodeManagers *manager)
+        : TrianglesVisitor(manager)
+    {
+    }
+
+    QVector<Triangle> triangles;
+
+private:
+    void visit(uint andx, const Vector3D &a,
+               uint bndx, const Vector3D &b,
+               uint cndx, const Vector3D &c) override
+    {
+        Triangle triangle;
+        for (int axis = 0; axis < 3; ++axis) {
+            triangle.vertices[0][axis] = a[axis];
+            triangle.vertices[1][axis] = b[axis];
+            triangle.vertices[2][axis] = c[axis];
+        }
+        triangle.vertexIndices[0] = andx;
+        triangle.vertexIndices[1] = bndx;
+        triangle.vertexIndices[2] = cndx;
+        triangles.push_back(triangle);
+    }
+};
+
+} // anonymous
+
+TriangleBoundingVolumeHierarchy::TriangleBoundingVolumeHierarchy()
+{
+}
+
+void TriangleBoundingVolumeHierarchy::build(const GeometryRenderer *renderer, const Qt3DCore::QNodeId id, NodeManagers *manager)
+{
+    TriangleGatherer gatherer(manager);
+    gatherer.apply(renderer, id);
+    build(std::move(gatherer.triangles));
+}
+
+// The triangles are expected in the order of the geometry
+void TriangleBoundingVolumeHierarchy::build(QVector<Triangle> triangles)
+{
+    m_triangles = std::move(triangles);
+    rebuild();
+}
+
+QVector<int> TriangleBoundingVolumeHierarchy::segmentQuery(const Vector3D &start, const Vector3D &end) const
+{
+    QVector<int> triangles;
+    if (m_nodes.isEmpty())
+        return triangles;
+
+    const float origin[3] = { start.x(), start.y(), start.z() };
+    const float direction[3] = { end.x() - start.x(), end.y() - start.y(), end.z() - start.z() };
+    QVarLengthArray<int, 64> stack;
+    stack.push_back(0);
+    while (!stack.isEmpty()) {
+        const Node &node = m_nodes.at(stack.last());
+        stack.removeLast();
+
+        if (!segmentIntersectsBox(origin, direction, node.box.lower, node.box.upper))
+            continue;
+
+        if (node.firstChild >= 0) {
+            stack.push_back(node.firstChild + 1);
+            stack.push_back(node.firstChild);
+            continue;
+        }
+
+        for (int i = node.firstPrimitive, end = i + node.primitiveCount; i < end; ++i)
+            triangles.push_back(i);
+    }
+    return triangles;
+}
+
+// Binned SAH build, leaves hold at most MaxLeafSize triangles
+void TriangleBoundingVolumeHierarchy::rebuild()
+{
+    const int triangleCount = m_triangles.size();
+    QVector<BuildPrimitive> primitives(triangleCount);
+    for (int i = 0; i < triangleCount; ++i) {
+        const Triangle &triangle = m_triangles.at(i);
+        BuildPrimitive &primitive = primitives[i];
+        BvhBuilder::clearBox(primitive.box);
+        for (int v = 0; v < 3; ++v) {
+            for (int axis = 0; axis < 3; ++axis) {
+                primitive.box.lower[axis] = std::min(primitive.box.lower[axis], triangle.vertices[v][axis]);
+                primitive.box.upper[axis] = std::max(primitive.box.upper[axis], triangle.vertices[v][axis]);
+            }
+        }
+        primitive.triangle = i;
+    }
+
+    BvhBuilder::build(primitives, [] (const BuildPrimitive &primitive) -> const BoundingBox & {
+        return primitive.box;
+    }, MaxLeafSize, m_nodes);
+
+    // Store the triangles in leaf order
+    QVector<Triangle> triangles;
+    triangles.reserve(triangleCount);
+    m_triangleIndices.clear();
+    m_triangleIndices.reserve(triangleCount);
+    for (const BuildPrimitive &primitive : qAsConst(primitives)) {
+        triangles.push_back(m_triangles.at(primitive.triangle));
+        m_triangleIndices.push_back(uint(primitive.triangle));
+    }
+    m_triangles = std::move(triangles);
+    m_nodes.squeeze();
+}
+
+} // Render
+
+} // Qt3DRender
+
+QT_END_NAMESPACE
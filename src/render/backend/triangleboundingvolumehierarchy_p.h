@@ -0,0 +1,118 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QT3DRENDER_RENDER_TRIANGLEBOUNDINGVOLUMEHIERARCHY_P_H
+#define QT3DRENDER_RENDER_TRIANGLEBOUNDINGVOLUMEHIERARCHY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <Qt3DRender/private/qt3drender_global_p.h>
+#include <Qt3DRender/private/bvhbuilder_p.h>
+#include <Qt3DCore/qnodeid.h>
+#include <Qt3DCore/private/vector3d_p.h>
+
+#include <QSharedPointer>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+class GeometryRenderer;
+class NodeManagers;
+
+// Spatial index over the triangles of a geometry renderer, in model space.
+// It is built once per geometry change and shared by all the entities using
+// the geometry renderer, rays are transformed into model space to query it.
+class QT3DRENDERSHARED_PRIVATE_EXPORT TriangleBoundingVolumeHierarchy
+{
+public:
+    struct Triangle
+    {
+        float vertices[3][3];
+        uint vertexIndices[3];
+    };
+
+    TriangleBoundingVolumeHierarchy();
+
+    void build(const GeometryRenderer *renderer, const Qt3DCore::QNodeId id, NodeManagers *manager);
+    void build(QVector<Triangle> triangles);
+
+    inline int triangleCount() const Q_DECL_NOTHROW { return m_triangles.size(); }
+    inline int nodeCount() const Q_DECL_NOTHROW { return m_nodes.size(); }
+    inline const Triangle &triangle(int i) const { return m_triangles.at(i); }
+    // Position in the geometry of the i-th triangle of the hierarchy
+    inline uint triangleIndex(int i) const { return m_triangleIndices.at(i); }
+
+    // Triangles whose box is crossed by the segment going from start to end
+    QVector<int> segmentQuery(const Vector3D &start, const Vector3D &end) const;
+
+private:
+    typedef BvhBuilder::Node Node;
+
+    void rebuild();
+
+    // Ordered so that the triangles of any node are contiguous, the indices
+    // are only read for hits and are kept out of the traversed triangles
+    QVector<Triangle> m_triangles;
+    QVector<uint> m_triangleIndices;
+    QVector<Node> m_nodes;
+};
+
+typedef QSharedPointer<const TriangleBoundingVolumeHierarchy> TriangleBoundingVolumeHierarchyPtr;
+
+} // Render
+
+} // Qt3DRender
+
+QT_END_NAMESPACE
+
+#endif // QT3DRENDER_RENDER_TRIANGLEBOUNDINGVOLUMEHIERARCHY_P_H
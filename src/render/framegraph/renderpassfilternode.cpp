@@ -66,6 +66,7 @@ void RenderPassFilter::initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBase
     m_filters = data.matchIds;
     m_parameterPack.clear();
     m_parameterPack.setParameters(data.parameterIds);
+    updateRevision();
 }
 
 QVector<Qt3DCore::QNodeId> RenderPassFilter::filters() const
@@ -120,6 +121,7 @@ void RenderPassFilter::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
     default:
         break;
     }
+    updateRevision();
     FrameGraphNode::sceneChangeEvent(e);
 }
 
@@ -66,6 +66,7 @@ void TechniqueFilter::initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBaseP
     const auto &data = typedChange->data;
     m_filters = data.matchIds;
     m_parameterPack.setParameters(data.parameterIds);
+    updateRevision();
 }
 
 QVector<Qt3DCore::QNodeId> TechniqueFilter::parameters() const
@@ -119,6 +120,7 @@ void TechniqueFilter::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
     default:
         break;
     }
+    updateRevision();
     FrameGraphNode::sceneChangeEvent(e);
 }
 
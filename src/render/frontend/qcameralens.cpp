@@ -228,6 +228,22 @@ QCameraLensPrivate::QCameraLensPrivate()
 {
 }
 
+bool QCameraLensPrivate::sendTypedPropertyChange(int propertyIndex)
+{
+    static const int projectionMatrixIndex = QCameraLens::staticMetaObject.indexOfProperty("projectionMatrix");
+    static const int exposureIndex = QCameraLens::staticMetaObject.indexOfProperty("exposure");
+    static const int projectionMatrixId = Qt3DCore::QTypedPropertyUpdatedChangeBase::propertyIdForName("projectionMatrix");
+    static const int exposureId = Qt3DCore::QTypedPropertyUpdatedChangeBase::propertyIdForName("exposure");
+
+    if (propertyIndex == projectionMatrixIndex)
+        notifyTypedPropertyChange("projectionMatrix", projectionMatrixId, m_projectionMatrix);
+    else if (propertyIndex == exposureIndex)
+        notifyTypedPropertyChange("exposure", exposureId, m_exposure);
+    else
+        return false;
+    return true;
+}
+
 void QCameraLens::viewAll(Qt3DCore::QNodeId cameraId)
 {
     Q_D(QCameraLens);
@@ -70,6 +70,8 @@ class QT3DRENDERSHARED_PRIVATE_EXPORT QCameraLensPrivate : public Qt3DCore::QCom
 public:
     QCameraLensPrivate();
 
+    bool sendTypedPropertyChange(int propertyIndex) override;
+
     inline void updateProjectionMatrix()
     {
         switch (m_projectionType) {
@@ -130,6 +130,7 @@
 #include <Qt3DRender/private/loadgeometryjob_p.h>
 #include <Qt3DRender/private/qsceneimportfactory_p.h>
 #include <Qt3DRender/private/qsceneimporter_p.h>
+#include <Qt3DRender/private/qbuffer_p.h>
 #include <Qt3DRender/private/frustumculling_p.h>
 #include <Qt3DRender/private/light_p.h>
 #include <Qt3DRender/private/environmentlight_p.h>
@@ -159,6 +160,7 @@
 
 #include <Qt3DCore/qnode.h>
 #include <Qt3DCore/QAspectEngine>
+#include <Qt3DCore/private/qchangearbiter_p.h>
 #include <Qt3DCore/private/qservicelocator_p.h>
 
 #include <QDebug>
@@ -229,6 +231,10 @@ void QRenderAspectPrivate::registerBackendTypes()
     qRegisterMetaType<Qt3DRender::QShaderProgram*>();
     qRegisterMetaType<Qt3DCore::QJoint*>();
 
+    Qt3DCore::QChangeArbiter::registerPropertyChangeMerger(QByteArrayLiteral("updateData"),
+                                                           QBufferPrivate::mergeDataUpdates);
+    Qt3DCore::QChangeArbiter::registerUncoalescedProperty(QByteArrayLiteral("renderCaptureRequest"));
+
     q->registerBackendType<Qt3DCore::QEntity>(QSharedPointer<Render::RenderEntityFunctor>::create(m_renderer, m_nodeManagers));
     q->registerBackendType<Qt3DCore::QTransform>(QSharedPointer<Render::NodeFunctor<Render::Transform, Render::TransformManager> >::create(m_renderer));
 
@@ -79,6 +79,9 @@ QRenderSettingsPrivate::QRenderSettingsPrivate()
     : Qt3DCore::QComponentPrivate()
     , m_activeFrameGraph(nullptr)
     , m_renderPolicy(QRenderSettings::Always)
+    , m_automaticInstancing(false)
+    , m_uploadByteBudget(0)
+    , m_uploadTimeBudget(0)
 {
 }
 
@@ -207,6 +210,106 @@ QRenderSettings::RenderPolicy QRenderSettings::renderPolicy() const
     return d->m_renderPolicy;
 }
 
+/*!
+    \qmlproperty bool RenderSettings::automaticInstancing
+    \since 5.11
+
+    Holds whether consecutive draws of the same geometry with the same material
+    are merged into a single instanced draw call. Defaults to false.
+
+    Only the shaders declaring a \c mat4 \c instanceModelMatrix attribute are
+    affected. That attribute is fed with the model matrix of each entity and
+    should be used instead of the \c modelMatrix, \c modelView and \c mvp
+    uniforms, which only hold the values of the first entity of a merged draw.
+    Entities are only merged when all their other uniforms, textures, buffers
+    and render states are the same. Merging requires support for instanced
+    arrays (OpenGL 3.3 or OpenGL ES 3.0).
+*/
+/*!
+    \property QRenderSettings::automaticInstancing
+    \since 5.11
+
+    Holds whether consecutive draws of the same geometry with the same material
+    are merged into a single instanced draw call. Defaults to false.
+
+    Only the shaders declaring a \c mat4 \c instanceModelMatrix attribute are
+    affected. That attribute is fed with the model matrix of each entity and
+    should be used instead of the \c modelMatrix, \c modelView and \c mvp
+    uniforms, which only hold the values of the first entity of a merged draw.
+    Entities are only merged when all their other uniforms, textures, buffers
+    and render states are the same. Merging requires support for instanced
+    arrays (OpenGL 3.3 or OpenGL ES 3.0).
+*/
+bool QRenderSettings::automaticInstancing() const
+{
+    Q_D(const QRenderSettings);
+    return d->m_automaticInstancing;
+}
+
+/*!
+    \qmlproperty int RenderSettings::uploadByteBudget
+    \since 5.11
+
+    Holds the number of bytes of buffer and texture data which can be uploaded
+    to the GPU per frame. Defaults to 0, meaning no limit.
+
+    Resources used by the frame being rendered are always uploaded. The other
+    pending uploads are spread over the following frames once the budget is
+    exhausted. A single resource is never split, which means a frame can exceed
+    the budget by the size of the last resource uploaded.
+
+    \sa uploadTimeBudget
+*/
+/*!
+    \property QRenderSettings::uploadByteBudget
+    \since 5.11
+
+    Holds the number of bytes of buffer and texture data which can be uploaded
+    to the GPU per frame. Defaults to 0, meaning no limit.
+
+    Resources used by the frame being rendered are always uploaded. The other
+    pending uploads are spread over the following frames once the budget is
+    exhausted. A single resource is never split, which means a frame can exceed
+    the budget by the size of the last resource uploaded.
+
+    \sa uploadTimeBudget
+*/
+int QRenderSettings::uploadByteBudget() const
+{
+    Q_D(const QRenderSettings);
+    return d->m_uploadByteBudget;
+}
+
+/*!
+    \qmlproperty int RenderSettings::uploadTimeBudget
+    \since 5.11
+
+    Holds the time in milliseconds which can be spent per frame uploading
+    buffers and textures and compiling shaders. Defaults to 0, meaning no
+    limit.
+
+    As with \l uploadByteBudget, resources used by the frame being rendered
+    are always uploaded and the other ones are postponed once the budget is
+    exhausted.
+*/
+/*!
+    \property QRenderSettings::uploadTimeBudget
+    \since 5.11
+
+    Holds the time in milliseconds which can be spent per frame uploading
+    buffers and textures and compiling shaders. Defaults to 0, meaning no
+    limit.
+
+    As with \l uploadByteBudget, resources used by the frame being rendered
+    are always uploaded and the other ones are postponed once the budget is
+    exhausted.
+*/
+int QRenderSettings::uploadTimeBudget() const
+{
+    Q_D(const QRenderSettings);
+    return d->m_uploadTimeBudget;
+}
+
 void QRenderSettings::setActiveFrameGraph(QFrameGraphNode *activeFrameGraph)
 {
     Q_D(QRenderSettings);
@@ -249,6 +352,36 @@ void QRenderSettings::setRenderPolicy(QRenderSettings::RenderPolicy renderPolicy
     emit renderPolicyChanged(renderPolicy);
 }
 
+void QRenderSettings::setAutomaticInstancing(bool automaticInstancing)
+{
+    Q_D(QRenderSettings);
+    if (d->m_automaticInstancing == automaticInstancing)
+        return;
+
+    d->m_automaticInstancing = automaticInstancing;
+    emit automaticInstancingChanged(automaticInstancing);
+}
+
+void QRenderSettings::setUploadByteBudget(int uploadByteBudget)
+{
+    Q_D(QRenderSettings);
+    if (d->m_uploadByteBudget == uploadByteBudget)
+        return;
+
+    d->m_uploadByteBudget = uploadByteBudget;
+    emit uploadByteBudgetChanged(uploadByteBudget);
+}
+
+void QRenderSettings::setUploadTimeBudget(int uploadTimeBudget)
+{
+    Q_D(QRenderSettings);
+    if (d->m_uploadTimeBudget == uploadTimeBudget)
+        return;
+
+    d->m_uploadTimeBudget = uploadTimeBudget;
+    emit uploadTimeBudgetChanged(uploadTimeBudget);
+}
+
 Qt3DCore::QNodeCreatedChangeBasePtr QRenderSettings::createNodeCreationChange() const
 {
     auto creationChange = Qt3DCore::QNodeCreatedChangePtr<QRenderSettingsData>::create(this);
@@ -260,6 +393,9 @@ Qt3DCore::QNodeCreatedChangeBasePtr QRenderSettings::createNodeCreationChange()
     data.pickResultMode = d->m_pickingSettings.pickResultMode();
     data.faceOrientationPickingMode = d->m_pickingSettings.faceOrientationPickingMode();
     data.pickWorldSpaceTolerance = d->m_pickingSettings.worldSpaceTolerance();
+    data.automaticInstancing = d->m_automaticInstancing;
+    data.uploadByteBudget = d->m_uploadByteBudget;
+    data.uploadTimeBudget = d->m_uploadTimeBudget;
     return creationChange;
 }
 
@@ -58,6 +58,9 @@ class QT3DRENDERSHARED_EXPORT QRenderSettings : public Qt3DCore::QComponent
     Q_PROPERTY(Qt3DRender::QPickingSettings* pickingSettings READ pickingSettings CONSTANT)
     Q_PROPERTY(RenderPolicy renderPolicy READ renderPolicy WRITE setRenderPolicy NOTIFY renderPolicyChanged)
     Q_PROPERTY(Qt3DRender::QFrameGraphNode *activeFrameGraph READ activeFrameGraph WRITE setActiveFrameGraph NOTIFY activeFrameGraphChanged)
+    Q_PROPERTY(bool automaticInstancing READ automaticInstancing WRITE setAutomaticInstancing NOTIFY automaticInstancingChanged REVISION 11)
+    Q_PROPERTY(int uploadByteBudget READ uploadByteBudget WRITE setUploadByteBudget NOTIFY uploadByteBudgetChanged REVISION 11)
+    Q_PROPERTY(int uploadTimeBudget READ uploadTimeBudget WRITE setUploadTimeBudget NOTIFY uploadTimeBudgetChanged REVISION 11)
     Q_CLASSINFO("DefaultProperty", "activeFrameGraph")
 
 public:
@@ -73,14 +76,23 @@ public:
     QPickingSettings* pickingSettings();
     QFrameGraphNode *activeFrameGraph() const;
     RenderPolicy renderPolicy() const;
+    bool automaticInstancing() const;
+    int uploadByteBudget() const;
+    int uploadTimeBudget() const;
 
 public Q_SLOTS:
     void setActiveFrameGraph(QFrameGraphNode *activeFrameGraph);
     void setRenderPolicy(RenderPolicy renderPolicy);
+    void setAutomaticInstancing(bool automaticInstancing);
+    void setUploadByteBudget(int uploadByteBudget);
+    void setUploadTimeBudget(int uploadTimeBudget);
 
 Q_SIGNALS:
     void activeFrameGraphChanged(QFrameGraphNode *activeFrameGraph);
     void renderPolicyChanged(RenderPolicy renderPolicy);
+    void automaticInstancingChanged(bool automaticInstancing);
+    void uploadByteBudgetChanged(int uploadByteBudget);
+    void uploadTimeBudgetChanged(int uploadTimeBudget);
 
 protected:
     Q_DECLARE_PRIVATE(QRenderSettings)
@@ -70,6 +70,9 @@ public:
     QPickingSettings m_pickingSettings;
     QFrameGraphNode *m_activeFrameGraph;
     QRenderSettings::RenderPolicy m_renderPolicy;
+    bool m_automaticInstancing;
+    int m_uploadByteBudget;
+    int m_uploadTimeBudget;
 
     void _q_onPickingMethodChanged(QPickingSettings::PickMethod pickMethod);
     void _q_onPickResultModeChanged(QPickingSettings::PickResultMode pickResultMode);
@@ -87,6 +90,9 @@ struct QRenderSettingsData
     QPickingSettings::PickResultMode pickResultMode;
     QPickingSettings::FaceOrientationPickingMode faceOrientationPickingMode;
     float pickWorldSpaceTolerance;
+    bool automaticInstancing;
+    int uploadByteBudget;
+    int uploadTimeBudget;
 };
 
 } // namespace Qt3Drender
@@ -136,6 +136,7 @@ void Attribute::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
             m_bufferId = propertyChange->value().value<QNodeId>();
             m_attributeDirty = true;
         }
+        updateRevision();
         markDirty(AbstractRenderer::AllDirty);
         break;
     }
@@ -39,6 +39,7 @@
 
 #include "buffer_p.h"
 #include <Qt3DCore/qpropertyupdatedchange.h>
+#include <Qt3DCore/private/qtypedpropertyupdatechange_p.h>
 #include <Qt3DRender/private/buffermanager_p.h>
 #include <Qt3DRender/private/qbuffer_p.h>
 
@@ -145,18 +146,28 @@ void Buffer::forceDataUpload()
     m_bufferUpdates.push_back(updateNewData);
 }
 
+void Buffer::setData(const QByteArray &data)
+{
+    const bool dirty = m_data != data;
+    m_bufferDirty |= dirty;
+    m_data = data;
+    if (dirty)
+        forceDataUpload();
+}
+
 void Buffer::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
 {
-    if (e->type() == PropertyUpdated) {
+    static const int dataId = QTypedPropertyUpdatedChangeBase::propertyIdForName("data");
+
+    if (const QTypedPropertyUpdatedChangeBase *typedChange = QTypedPropertyUpdatedChangeBase::fromChange(e)) {
+        if (typedChange->propertyId() == dataId)
+            setData(typedChange->value<QByteArray>());
+        markDirty(AbstractRenderer::BuffersDirty);
+    } else if (e->type() == PropertyUpdated) {
         QPropertyUpdatedChangePtr propertyChange = qSharedPointerCast<QPropertyUpdatedChange>(e);
         QByteArray propertyName = propertyChange->propertyName();
         if (propertyName == QByteArrayLiteral("data")) {
-            QByteArray newData = propertyChange->value().toByteArray();
-            bool dirty = m_data != newData;
-            m_bufferDirty |= dirty;
-            m_data = newData;
-            if (dirty)
-                forceDataUpload();
+            setData(propertyChange->value().toByteArray());
         } else if (propertyName == QByteArrayLiteral("updateData")) {
             Qt3DRender::QBufferUpdate updateData = propertyChange->value().value<Qt3DRender::QBufferUpdate>();
             m_bufferUpdates.push_back(updateData);
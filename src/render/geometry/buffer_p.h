@@ -90,6 +90,7 @@ public:
 private:
     void initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &change) final;
     void forceDataUpload();
+    void setData(const QByteArray &data);
 
     QBuffer::UsageType m_usage;
     QByteArray m_data;
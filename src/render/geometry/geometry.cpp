@@ -113,6 +113,7 @@ void Geometry::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
     default:
         break;
     }
+    updateRevision();
     markDirty(AbstractRenderer::GeometryDirty);
     BackendNode::sceneChangeEvent(e);
 }
@@ -39,7 +39,6 @@
 
 #include "geometryrenderer_p.h"
 #include <Qt3DRender/private/geometryrenderermanager_p.h>
-#include <Qt3DRender/private/qboundingvolume_p.h>
 #include <Qt3DRender/private/qgeometryrenderer_p.h>
 #include <Qt3DRender/private/qmesh_p.h>
 #include <Qt3DCore/qpropertyupdatedchange.h>
@@ -96,8 +95,7 @@ void GeometryRenderer::cleanup()
     m_geometryId = Qt3DCore::QNodeId();
     m_dirty = false;
     m_geometryFactory.reset();
-    qDeleteAll(m_triangleVolumes);
-    m_triangleVolumes.clear();
+    m_triangleHierarchy.reset();
 }
 
 void GeometryRenderer::setManager(GeometryRendererManager *manager)
@@ -189,6 +187,7 @@ void GeometryRenderer::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
         break;
     }
 
+    updateRevision();
     markDirty(AbstractRenderer::GeometryDirty);
 
     BackendNode::sceneChangeEvent(e);
@@ -252,15 +251,14 @@ void GeometryRenderer::unsetDirty()
 }
 
 
-void GeometryRenderer::setTriangleVolumes(const QVector<RayCasting::QBoundingVolume *> &volumes)
+void GeometryRenderer::setTriangleHierarchy(const TriangleBoundingVolumeHierarchyPtr &hierarchy)
 {
-    qDeleteAll(m_triangleVolumes);
-    m_triangleVolumes = volumes;
+    m_triangleHierarchy = hierarchy;
 }
 
-QVector<RayCasting::QBoundingVolume *> GeometryRenderer::triangleData() const
+TriangleBoundingVolumeHierarchyPtr GeometryRenderer::triangleHierarchy() const
 {
-    return m_triangleVolumes;
+    return m_triangleHierarchy;
 }
 
 GeometryRendererFunctor::GeometryRendererFunctor(AbstractRenderer *renderer, GeometryRendererManager *manager)
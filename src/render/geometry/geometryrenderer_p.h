@@ -52,16 +52,13 @@
 //
 
 #include <Qt3DRender/private/backendnode_p.h>
+#include <Qt3DRender/private/triangleboundingvolumehierarchy_p.h>
 #include <Qt3DRender/qgeometryrenderer.h>
 #include <Qt3DRender/qgeometryfactory.h>
 
 QT_BEGIN_NAMESPACE
 
 namespace Qt3DRender {
-namespace RayCasting {
-class QBoundingVolume;
-}
-
 namespace Render {
 
 class GeometryRendererManager;
@@ -93,9 +90,9 @@ public:
     void unsetDirty();
 
     // Build triangle data Job thread
-    void setTriangleVolumes(const  QVector<RayCasting::QBoundingVolume *> &volumes);
+    void setTriangleHierarchy(const TriangleBoundingVolumeHierarchyPtr &hierarchy);
     // Pick volumes job
-    QVector<RayCasting::QBoundingVolume *> triangleData() const;
+    TriangleBoundingVolumeHierarchyPtr triangleHierarchy() const;
 
 private:
     void initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &change) final;
@@ -114,7 +111,7 @@ private:
     bool m_dirty;
     QGeometryFactoryPtr m_geometryFactory;
     GeometryRendererManager *m_manager;
-    QVector<RayCasting::QBoundingVolume *> m_triangleVolumes;
+    TriangleBoundingVolumeHierarchyPtr m_triangleHierarchy;
 };
 
 class GeometryRendererFunctor : public Qt3DCore::QBackendNodeMapper
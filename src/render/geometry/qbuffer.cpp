@@ -58,6 +58,30 @@ QBufferPrivate::QBufferPrivate()
 {
 }
 
+bool QBufferPrivate::mergeDataUpdates(const QVariant &previousValue, QVariant *value)
+{
+    if (previousValue.userType() != qMetaTypeId<QBufferUpdate>() ||
+            value->userType() != qMetaTypeId<QBufferUpdate>())
+        return false;
+
+    const QBufferUpdate previous = previousValue.value<QBufferUpdate>();
+    const QBufferUpdate update = value->value<QBufferUpdate>();
+    const int previousEnd = previous.offset + previous.data.size();
+    const int updateEnd = update.offset + update.data.size();
+    if (previous.offset < 0 || update.offset < 0 ||
+            update.offset > previousEnd || previous.offset > updateEnd)
+        return false;
+
+    // The later update overwrites the range they have in common
+    QBufferUpdate merged;
+    merged.offset = qMin(previous.offset, update.offset);
+    merged.data.resize(qMax(previousEnd, updateEnd) - merged.offset);
+    memcpy(merged.data.data() + previous.offset - merged.offset, previous.data.constData(), size_t(previous.data.size()));
+    memcpy(merged.data.data() + update.offset - merged.offset, update.data.constData(), size_t(update.data.size()));
+    *value = QVariant::fromValue(merged);
+    return true;
+}
+
 /*!
  * \qmltype Buffer
  * \instantiates Qt3DRender::QBuffer
@@ -311,8 +335,9 @@ void QBuffer::setData(const QByteArray &bytes)
 {
     Q_D(QBuffer);
     if (bytes != d->m_data) {
+        static const int dataId = Qt3DCore::QTypedPropertyUpdatedChangeBase::propertyIdForName("data");
         d->m_data = bytes;
-        Qt3DCore::QNodePrivate::get(this)->notifyPropertyChange("data", QVariant::fromValue(d->m_data));
+        d->notifyTypedPropertyChange("data", dataId, d->m_data);
         emit dataChanged(bytes);
     }
 }
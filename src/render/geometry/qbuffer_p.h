@@ -69,6 +69,9 @@ public:
 
     QBufferPrivate();
 
+    // Merges consecutive updateData changes when their ranges overlap or touch
+    static bool mergeDataUpdates(const QVariant &previousValue, QVariant *value);
+
     QByteArray m_data;
     QBuffer::BufferType m_type;
     QBuffer::UsageType m_usage;
@@ -42,6 +42,7 @@
 
 #include <Qt3DRender/private/nodemanagers_p.h>
 #include <Qt3DRender/private/entity_p.h>
+#include <Qt3DRender/private/flattenedentitytree_p.h>
 #include <Qt3DRender/private/renderlogging_p.h>
 #include <Qt3DRender/private/managers_p.h>
 #include <Qt3DRender/private/geometryrenderer_p.h>
@@ -194,7 +195,8 @@ private:
 void calculateLocalBoundingVolume(NodeManagers *manager, Entity *node)
 {
     // The Bounding volume will only be computed if the position Buffer
-    // isDirty
+    // isDirty. Only this entity is processed, the job iterates over the
+    // flattened scene.
 
     if (!node->isTreeEnabled())
         return;
@@ -291,20 +293,6 @@ void calculateLocalBoundingVolume(NodeManagers *manager, Entity *node)
             }
         }
     }
-
-#if QT_CONFIG(concurrent)
-    const QVector<Qt3DRender::Render::Entity *> children = node->children();
-    if (children.size() > 1) {
-        UpdateBoundFunctor functor;
-        functor.manager = manager;
-        QtConcurrent::blockingMap(children, functor);
-    } else
-#endif
-    {
-        const auto children = node->children();
-        for (Entity *child : children)
-            calculateLocalBoundingVolume(manager, child);
-    }
 }
 
 } // anonymous
@@ -318,7 +306,23 @@ CalculateBoundingVolumeJob::CalculateBoundingVolumeJob()
 
 void CalculateBoundingVolumeJob::run()
 {
-    calculateLocalBoundingVolume(m_manager, m_node);
+    FlattenedEntityTree localTree;
+    const FlattenedEntityTree *tree = FlattenedEntityTree::treeContaining(m_manager->flattenedEntityTree(), m_node, &localTree);
+    const int rootIndex = tree->indexOf(m_node);
+    const auto begin = tree->entities().cbegin() + rootIndex;
+    const auto end = tree->entities().cbegin() + tree->subtreeEnd(rootIndex);
+
+#if QT_CONFIG(concurrent)
+    if (end - begin > 1) {
+        UpdateBoundFunctor functor;
+        functor.manager = m_manager;
+        QtConcurrent::blockingMap(begin, end, functor);
+    } else
+#endif
+    {
+        for (auto it = begin; it != end; ++it)
+            calculateLocalBoundingVolume(m_manager, *it);
+    }
 }
 
 void CalculateBoundingVolumeJob::setRoot(Entity *node)
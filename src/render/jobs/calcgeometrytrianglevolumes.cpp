@@ -38,7 +38,7 @@
 ****************************************************************************/
 
 #include "calcgeometrytrianglevolumes_p.h"
-#include <Qt3DRender/private/trianglesextractor_p.h>
+#include <Qt3DRender/private/triangleboundingvolumehierarchy_p.h>
 #include <Qt3DRender/private/nodemanagers_p.h>
 #include <Qt3DRender/private/geometryrenderermanager_p.h>
 #include <Qt3DRender/private/job_common_p.h>
@@ -60,8 +60,9 @@ void CalcGeometryTriangleVolumes::run()
 {
     GeometryRenderer *renderer = m_manager->geometryRendererManager()->lookupResource(m_geometryRendererId);
     if (renderer != nullptr) {
-        TrianglesExtractor extractor(renderer, m_manager);
-        renderer->setTriangleVolumes(extractor.extract(m_geometryRendererId));
+        QSharedPointer<TriangleBoundingVolumeHierarchy> hierarchy = QSharedPointer<TriangleBoundingVolumeHierarchy>::create();
+        hierarchy->build(renderer, m_geometryRendererId, m_manager);
+        renderer->setTriangleHierarchy(hierarchy);
     }
 }
 
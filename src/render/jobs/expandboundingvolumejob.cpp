@@ -44,9 +44,13 @@
 #include <Qt3DRender/private/renderlogging_p.h>
 #include <Qt3DRender/private/sphere_p.h>
 #include <Qt3DRender/private/job_common_p.h>
+#include <Qt3DRender/private/boundingvolumehierarchy_p.h>
 
+#include <QHash>
 #include <QThread>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 namespace Qt3DRender {
@@ -70,17 +74,58 @@ void expandWorldBoundingVolume(Qt3DRender::Render::Entity *node)
     }
 }
 
+// Recomputes the bounding volume with children of node from the current ones
+// of its children
+void reexpandWorldBoundingVolume(Qt3DRender::Render::Entity *node)
+{
+    Qt3DRender::Render::Sphere *boundingVolume = node->worldBoundingVolumeWithChildren();
+    *boundingVolume = *node->worldBoundingVolume();
+    const auto children = node->children();
+    for (Entity *c : children)
+        boundingVolume->expandToContain(*c->worldBoundingVolumeWithChildren());
+}
+
+int entityDepth(Qt3DRender::Render::Entity *node)
+{
+    int depth = 0;
+    for (Entity *parent = node->parent(); parent != nullptr; parent = parent->parent())
+        ++depth;
+    return depth;
+}
+
+void gatherSubtree(Qt3DRender::Render::Entity *node, QVector<Entity *> &entities)
+{
+    entities.push_back(node);
+    const auto children = node->children();
+    for (Entity *c : children)
+        gatherSubtree(c, entities);
+}
+
 }
 
 ExpandBoundingVolumeJob::ExpandBoundingVolumeJob()
-    : m_node(nullptr)
+    : m_boundingVolumeHierarchy(nullptr)
 {
     SET_JOB_RUN_STAT_TYPE(this, JobTypes::ExpandBoundingVolume, 0);
 }
 
 void ExpandBoundingVolumeJob::setRoot(Entity *root)
 {
-    m_node = root;
+    m_dirtySubtreeRoots = { root };
+}
+
+// Restricts the expansion to the given subtrees and their ancestors. None of
+// the roots may be nested in another. setRoot() resets this to the whole scene
+void ExpandBoundingVolumeJob::setDirtySubtreeRoots(const QVector<Entity *> &roots)
+{
+    m_dirtySubtreeRoots = roots;
+}
+
+// The hierarchy is refitted once the bounding volumes are expanded. It is
+// rebuilt if it was invalidated or indexes another scene
+void ExpandBoundingVolumeJob::setBoundingVolumeHierarchy(BoundingVolumeHierarchy *hierarchy)
+{
+    m_boundingVolumeHierarchy = hierarchy;
 }
 
 void ExpandBoundingVolumeJob::run()
@@ -90,10 +135,61 @@ void ExpandBoundingVolumeJob::run()
 
     // TODO: Implement this using a parallel_for
     qCDebug(Jobs) << "Entering" << Q_FUNC_INFO << QThread::currentThread();
-    expandWorldBoundingVolume(m_node);
+    for (Entity *root : qAsConst(m_dirtySubtreeRoots))
+        expandWorldBoundingVolume(root);
+
+    // The ancestors of the dirty subtrees are then recomputed deepest first,
+    // their other children still hold valid bounding volumes
+    QHash<Entity *, int> ancestorDepths;
+    for (Entity *root : qAsConst(m_dirtySubtreeRoots)) {
+        int depth = entityDepth(root);
+        for (Entity *parent = root->parent(); parent != nullptr; parent = parent->parent()) {
+            --depth;
+            if (ancestorDepths.contains(parent))
+                break;
+            ancestorDepths.insert(parent, depth);
+        }
+    }
+
+    if (!ancestorDepths.isEmpty()) {
+        QVector<QPair<int, Entity *>> ancestors;
+        ancestors.reserve(ancestorDepths.size());
+        for (auto it = ancestorDepths.cbegin(), end = ancestorDepths.cend(); it != end; ++it)
+            ancestors.push_back(qMakePair(it.value(), it.key()));
+        std::sort(ancestors.begin(), ancestors.end(),
+                  [] (const QPair<int, Entity *> &a, const QPair<int, Entity *> &b) {
+            return a.first > b.first;
+        });
+        for (const auto &ancestor : qAsConst(ancestors))
+            reexpandWorldBoundingVolume(ancestor.second);
+    }
+
+    if (m_boundingVolumeHierarchy != nullptr && !m_dirtySubtreeRoots.isEmpty())
+        updateBoundingVolumeHierarchy(ancestorDepths.keys().toVector());
     qCDebug(Jobs) << "Exiting" << Q_FUNC_INFO << QThread::currentThread();
 }
 
+void ExpandBoundingVolumeJob::updateBoundingVolumeHierarchy(QVector<Entity *> dirtyAncestors)
+{
+    Entity *sceneRoot = m_dirtySubtreeRoots.first();
+    while (sceneRoot->parent() != nullptr)
+        sceneRoot = sceneRoot->parent();
+
+    if (!m_boundingVolumeHierarchy->isValid() || m_boundingVolumeHierarchy->root() != sceneRoot) {
+        m_boundingVolumeHierarchy->build(sceneRoot);
+    } else if (m_dirtySubtreeRoots.first() == sceneRoot) {
+        // Any entity may have moved, only the ones whose box changed and
+        // their ancestors in the hierarchy are refitted
+        m_boundingVolumeHierarchy->refit();
+    } else {
+        // The bounding volumes with children of the ancestors changed too,
+        // the entities of the dirty subtrees are appended to them
+        for (Entity *root : qAsConst(m_dirtySubtreeRoots))
+            gatherSubtree(root, dirtyAncestors);
+        m_boundingVolumeHierarchy->refit(dirtyAncestors);
+    }
+}
+
 } // namespace Render
 } // namespace Qt3DRender
 
@@ -55,6 +55,7 @@
 #include <Qt3DRender/private/qt3drender_global_p.h>
 
 #include <QSharedPointer>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
 
@@ -62,6 +63,7 @@ namespace Qt3DRender {
 namespace Render {
 
 class Entity;
+class BoundingVolumeHierarchy;
 
 class QT3DRENDERSHARED_PRIVATE_EXPORT ExpandBoundingVolumeJob : public Qt3DCore::QAspectJob
 {
@@ -69,10 +71,15 @@ public:
     ExpandBoundingVolumeJob();
 
     void setRoot(Entity *root);
+    void setDirtySubtreeRoots(const QVector<Entity *> &roots);
+    void setBoundingVolumeHierarchy(BoundingVolumeHierarchy *hierarchy);
     void run() override;
 
 private:
-    Entity *m_node;
+    void updateBoundingVolumeHierarchy(QVector<Entity *> dirtyAncestors);
+
+    QVector<Entity *> m_dirtySubtreeRoots;
+    BoundingVolumeHierarchy *m_boundingVolumeHierarchy;
 };
 
 typedef QSharedPointer<ExpandBoundingVolumeJob> ExpandBoundingVolumeJobPtr;
@@ -55,8 +55,11 @@
 #include <Qt3DCore/qnodeid.h>
 #include <Qt3DRender/private/managers_p.h>
 #include <Qt3DRender/private/entity_p.h>
+#include <Qt3DRender/private/flattenedentitytree_p.h>
 #include <Qt3DRender/private/job_common_p.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 namespace Qt3DRender {
@@ -73,16 +76,31 @@ public:
     FilterEntityByComponentJob()
         : Qt3DCore::QAspectJob()
         , m_manager(nullptr)
+        , m_entityTree(nullptr)
     {
         SET_JOB_RUN_STAT_TYPE(this, JobTypes::EntityComponentTypeFiltering, 0);
     }
 
     inline void setManager(EntityManager *manager) Q_DECL_NOTHROW { m_manager = manager; }
+    inline void setEntityTree(const FlattenedEntityTree *tree) Q_DECL_NOTHROW { m_entityTree = tree; }
     inline QVector<Entity *> &filteredEntities() Q_DECL_NOTHROW { return m_filteredEntities; }
 
     void run() final
     {
         m_filteredEntities.clear();
+
+        // The flattened tree of the scene is already laid out in the order in
+        // which entity lists are intersected by the RenderViewBuilder
+        if (m_entityTree != nullptr && !m_entityTree->isEmpty()) {
+            const QVector<Entity *> &entities = m_entityTree->entities();
+            m_filteredEntities.reserve(entities.size());
+            for (Entity *e : entities) {
+                if (e->containsComponentsOfType<T, Ts...>())
+                    m_filteredEntities.push_back(e);
+            }
+            return;
+        }
+
         const QVector<HEntity> handles = m_manager->activeHandles();
         m_filteredEntities.reserve(handles.size());
         for (const HEntity handle : handles) {
@@ -90,10 +108,12 @@ public:
             if (e->containsComponentsOfType<T, Ts...>())
                 m_filteredEntities.push_back(e);
         }
+        std::sort(m_filteredEntities.begin(), m_filteredEntities.end(), &Entity::treeOrderLessThan);
     }
 
 private:
     EntityManager *m_manager;
+    const FlattenedEntityTree *m_entityTree;
     QVector<Entity *> m_filteredEntities;
 };
 
@@ -72,7 +72,7 @@ void FilterLayerEntityJob::run()
         selectAllEntities();
 
     // sort needed for set_intersection in RenderViewBuilder
-    std::sort(m_filteredEntities.begin(), m_filteredEntities.end());
+    std::sort(m_filteredEntities.begin(), m_filteredEntities.end(), &Entity::treeOrderLessThan);
 }
 
 // We accept the entity if it contains any of the layers that are in the layer filter
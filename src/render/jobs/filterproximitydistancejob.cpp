@@ -33,6 +33,7 @@
 #include <Qt3DRender/private/proximityfilter_p.h>
 #include <Qt3DRender/private/job_common_p.h>
 #include <Qt3DRender/private/sphere_p.h>
+#include <Qt3DRender/private/boundingvolumehierarchy_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -52,10 +53,15 @@ void FilterProximityDistanceJob::run()
     Q_ASSERT(m_manager != nullptr);
     m_filteredEntities.clear();
 
+    const BoundingVolumeHierarchy *hierarchy = m_manager->boundingVolumeHierarchy();
+    bool queryHierarchy = hierarchy != nullptr && hierarchy->isValid() && hasProximityFilter();
+
     // Fill m_filteredEntities
     // If no filtering needs to be done, this will be the output value
-    // otherwise it will be used as the base list of entities to filter
-    selectAllEntities();
+    // otherwise it will be used as the base list of entities to filter,
+    // unless the hierarchy provides the candidates of the first filter
+    if (!queryHierarchy)
+        selectAllEntities();
 
     if (hasProximityFilter()) {
         QVector<Entity *> entitiesToFilter = std::move(m_filteredEntities);
@@ -73,6 +79,12 @@ void FilterProximityDistanceJob::run()
                 m_filteredEntities.clear();
                 return;
             }
+            if (queryHierarchy) {
+                const Vector3D targetCenter = m_targetEntity->worldBoundingVolumeWithChildren()->center();
+                entitiesToFilter = hierarchy->proximityQuery(targetCenter, proximityFilter->distanceThreshold());
+                queryHierarchy = false;
+            }
+
             // Otherwise we filter
             filterEntities(entitiesToFilter);
 
@@ -84,7 +96,7 @@ void FilterProximityDistanceJob::run()
     }
 
     // sort needed for set_intersection in RenderViewBuilder
-    std::sort(m_filteredEntities.begin(), m_filteredEntities.end());
+    std::sort(m_filteredEntities.begin(), m_filteredEntities.end(), &Entity::treeOrderLessThan);
 }
 
 void FilterProximityDistanceJob::selectAllEntities()
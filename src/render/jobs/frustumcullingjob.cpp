@@ -43,6 +43,9 @@
 #include <Qt3DRender/private/entity_p.h>
 #include <Qt3DRender/private/renderview_p.h>
 #include <Qt3DRender/private/sphere_p.h>
+#include <Qt3DRender/private/boundingvolumehierarchy_p.h>
+
+#include <QtCore/qalgorithms.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -50,9 +53,29 @@ namespace Qt3DRender {
 
 namespace Render {
 
+#if QT_CONFIG(qt3d_simd_avx2) && defined(__AVX2__) && defined(QT_COMPILER_SUPPORTS_AVX2)
+# define QT3D_FRUSTUM_CULLING_AVX2
+#elif QT_CONFIG(qt3d_simd_sse2) && defined(__SSE2__) && defined(QT_COMPILER_SUPPORTS_SSE2)
+# define QT3D_FRUSTUM_CULLING_SSE2
+#endif
+
+namespace {
+
+// Number of spheres tested per iteration, the arrays are padded accordingly
+#if defined(QT3D_FRUSTUM_CULLING_AVX2)
+const int SpheresPerPacket = 8;
+#elif defined(QT3D_FRUSTUM_CULLING_SSE2)
+const int SpheresPerPacket = 4;
+#else
+const int SpheresPerPacket = 1;
+#endif
+
+} // anonymous
+
 FrustumCullingJob::FrustumCullingJob()
     : Qt3DCore::QAspectJob()
-    , m_root(nullptr)
+    , m_boundingVolumeHierarchy(nullptr)
+    , m_paddedCount(0)
     , m_active(false)
 {
     SET_JOB_RUN_STAT_TYPE(this, JobTypes::FrustumCulling, 0);
@@ -75,35 +98,145 @@ void FrustumCullingJob::run()
         Plane(m_viewProjection.row(3) - m_viewProjection.row(2)), // Back
     };
 
-    cullScene(m_root, planes);
+    if (m_boundingVolumeHierarchy != nullptr && m_boundingVolumeHierarchy->isValid()) {
+        queryBoundingVolumeHierarchy(planes);
+        return;
+    }
 
-    // sort needed for set_intersection in RenderViewBuilder
-    std::sort(m_visibleEntities.begin(), m_visibleEntities.end());
+    gatherBoundingSpheres();
+    // m_entities being in tree order, so is m_visibleEntities as needed for
+    // set_intersection in RenderViewBuilder
+    cullBoundingSpheres(planes);
 }
 
-void FrustumCullingJob::cullScene(Entity *e, const Plane *planes)
+// Only the parts of the scene overlapping the frustum are visited, the flags
+// of the visible entities are then read in the order of m_entities through
+// the index each entity holds in the hierarchy
+void FrustumCullingJob::queryBoundingVolumeHierarchy(const Plane *planes)
 {
-    const Sphere *s = e->worldBoundingVolumeWithChildren();
-
-    // Unrolled loop
-    if (Vector3D::dotProduct(s->center(), planes[0].normal) + planes[0].d < -s->radius())
-        return;
-    if (Vector3D::dotProduct(s->center(), planes[1].normal) + planes[1].d < -s->radius())
-        return;
-    if (Vector3D::dotProduct(s->center(), planes[2].normal) + planes[2].d < -s->radius())
-        return;
-    if (Vector3D::dotProduct(s->center(), planes[3].normal) + planes[3].d < -s->radius())
-        return;
-    if (Vector3D::dotProduct(s->center(), planes[4].normal) + planes[4].d < -s->radius())
-        return;
-    if (Vector3D::dotProduct(s->center(), planes[5].normal) + planes[5].d < -s->radius())
-        return;
+    m_boundingVolumeHierarchy->frustumQuery(planes, m_visiblePrimitives);
+    m_visibleEntities.reserve(m_entities.size());
+    for (Entity *entity : qAsConst(m_entities)) {
+        const int primitiveIndex = m_boundingVolumeHierarchy->primitiveIndex(entity);
+        if (primitiveIndex >= 0 && m_visiblePrimitives.at(primitiveIndex))
+            m_visibleEntities.push_back(entity);
+    }
+}
 
-    m_visibleEntities.push_back(e);
+void FrustumCullingJob::gatherBoundingSpheres()
+{
+    const int count = m_entities.size();
+    m_paddedCount = (count + SpheresPerPacket - 1) / SpheresPerPacket * SpheresPerPacket;
+    m_boundingSpheres.resize(4 * m_paddedCount);
+
+    float *xs = m_boundingSpheres.data();
+    float *ys = xs + m_paddedCount;
+    float *zs = ys + m_paddedCount;
+    float *radii = zs + m_paddedCount;
+
+    for (int i = 0; i < count; ++i) {
+        const Sphere *s = m_entities.at(i)->worldBoundingVolume();
+        const Vector3D center = s->center();
+        xs[i] = center.x();
+        ys[i] = center.y();
+        zs[i] = center.z();
+        radii[i] = s->radius();
+    }
+
+    // Padding lanes are tested as well but never reported
+    for (int i = count; i < m_paddedCount; ++i) {
+        xs[i] = ys[i] = zs[i] = 0.0f;
+        radii[i] = 0.0f;
+    }
+}
 
-    const QVector<Entity *> children = e->children();
-    for (Entity *c : children)
-        cullScene(c, planes);
+// A sphere is culled as soon as it lies entirely behind one of the planes,
+// exactly like the previous per entity test but for a whole packet at once
+void FrustumCullingJob::cullBoundingSpheres(const Plane *planes)
+{
+    const int count = m_entities.size();
+    const float *xs = m_boundingSpheres.constData();
+    const float *ys = xs + m_paddedCount;
+    const float *zs = ys + m_paddedCount;
+    const float *radii = zs + m_paddedCount;
+
+    m_visibleEntities.reserve(count);
+
+#if defined(QT3D_FRUSTUM_CULLING_AVX2)
+    __m256 nx[6], ny[6], nz[6], d[6];
+    for (int p = 0; p < 6; ++p) {
+        nx[p] = _mm256_set1_ps(planes[p].normal.x());
+        ny[p] = _mm256_set1_ps(planes[p].normal.y());
+        nz[p] = _mm256_set1_ps(planes[p].normal.z());
+        d[p] = _mm256_set1_ps(planes[p].d);
+    }
+
+    for (int i = 0; i < m_paddedCount; i += SpheresPerPacket) {
+        const __m256 x = _mm256_loadu_ps(xs + i);
+        const __m256 y = _mm256_loadu_ps(ys + i);
+        const __m256 z = _mm256_loadu_ps(zs + i);
+        const __m256 negRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(radii + i));
+
+        __m256 culled = _mm256_setzero_ps();
+        for (int p = 0; p < 6; ++p) {
+            const __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, nx[p]),
+                                                                             _mm256_mul_ps(y, ny[p])),
+                                                               _mm256_mul_ps(z, nz[p])),
+                                                 d[p]);
+            culled = _mm256_or_ps(culled, _mm256_cmp_ps(distance, negRadius, _CMP_LT_OQ));
+        }
+
+        uint visible = ~uint(_mm256_movemask_ps(culled)) & 0xffu;
+        while (visible) {
+            const int index = i + qCountTrailingZeroBits(visible);
+            if (index < count)
+                m_visibleEntities.push_back(m_entities.at(index));
+            visible &= visible - 1;
+        }
+    }
+#elif defined(QT3D_FRUSTUM_CULLING_SSE2)
+    __m128 nx[6], ny[6], nz[6], d[6];
+    for (int p = 0; p < 6; ++p) {
+        nx[p] = _mm_set1_ps(planes[p].normal.x());
+        ny[p] = _mm_set1_ps(planes[p].normal.y());
+        nz[p] = _mm_set1_ps(planes[p].normal.z());
+        d[p] = _mm_set1_ps(planes[p].d);
+    }
+
+    for (int i = 0; i < m_paddedCount; i += SpheresPerPacket) {
+        const __m128 x = _mm_loadu_ps(xs + i);
+        const __m128 y = _mm_loadu_ps(ys + i);
+        const __m128 z = _mm_loadu_ps(zs + i);
+        const __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radii + i));
+
+        __m128 culled = _mm_setzero_ps();
+        for (int p = 0; p < 6; ++p) {
+            const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, nx[p]),
+                                                                     _mm_mul_ps(y, ny[p])),
+                                                          _mm_mul_ps(z, nz[p])),
+                                               d[p]);
+            culled = _mm_or_ps(culled, _mm_cmplt_ps(distance, negRadius));
+        }
+
+        uint visible = ~uint(_mm_movemask_ps(culled)) & 0xfu;
+        while (visible) {
+            const int index = i + qCountTrailingZeroBits(visible);
+            if (index < count)
+                m_visibleEntities.push_back(m_entities.at(index));
+            visible &= visible - 1;
+        }
+    }
+#else
+    for (int i = 0; i < count; ++i) {
+        bool culled = false;
+        for (int p = 0; p < 6 && !culled; ++p) {
+            const Vector3D &n = planes[p].normal;
+            culled = xs[i] * n.x() + ys[i] * n.y() + zs[i] * n.z() + planes[p].d < -radii[i];
+        }
+        if (!culled)
+            m_visibleEntities.push_back(m_entities.at(i));
+    }
+#endif
 }
 
 } // Render
@@ -43,6 +43,8 @@
 #include <Qt3DCore/qaspectjob.h>
 #include <Qt3DCore/private/matrix4x4_p.h>
 #include <Qt3DRender/private/aligned_malloc_p.h>
+#include <Qt3DRender/private/qt3drender_global_p.h>
+#include <QVector>
 
 //
 //  W A R N I N G
@@ -63,16 +65,20 @@ namespace Render {
 
 class Entity;
 class EntityManager;
+class BoundingVolumeHierarchy;
 struct Plane;
 
-class FrustumCullingJob : public Qt3DCore::QAspectJob
+class QT3DRENDERSHARED_PRIVATE_EXPORT FrustumCullingJob : public Qt3DCore::QAspectJob
 {
 public:
     FrustumCullingJob();
 
     QT3D_ALIGNED_MALLOC_AND_FREE()
 
-    inline void setRoot(Entity *root) Q_DECL_NOTHROW { m_root = root; }
+    // visibleEntities() preserves the order of the entities, see Entity::treeOrderLessThan
+    inline void setEntities(const QVector<Entity *> &entities) Q_DECL_NOTHROW { m_entities = entities; }
+    // When valid, the hierarchy is queried instead of testing every entity
+    inline void setBoundingVolumeHierarchy(const BoundingVolumeHierarchy *hierarchy) Q_DECL_NOTHROW { m_boundingVolumeHierarchy = hierarchy; }
     inline void setActive(bool active) Q_DECL_NOTHROW { m_active = active; }
     inline bool isActive() const Q_DECL_NOTHROW { return m_active; }
     inline void setViewProjection(const Matrix4x4 &viewProjection) Q_DECL_NOTHROW { m_viewProjection = viewProjection; }
@@ -83,10 +89,20 @@ public:
     void run() final;
 
 private:
-    void cullScene(Entity *e, const Plane *planes);
+    void gatherBoundingSpheres();
+    void cullBoundingSpheres(const Plane *planes);
+    void queryBoundingVolumeHierarchy(const Plane *planes);
+
     Matrix4x4 m_viewProjection;
-    Entity *m_root;
+    const BoundingVolumeHierarchy *m_boundingVolumeHierarchy;
+    QVector<Entity *> m_entities;
     QVector<Entity *> m_visibleEntities;
+    // Structure of arrays copy of the world bounding spheres of m_entities:
+    // all x, then all y, all z and all radii, each padded to m_paddedCount
+    QVector<float> m_boundingSpheres;
+    // Visibility of the primitives of m_boundingVolumeHierarchy
+    QVector<bool> m_visiblePrimitives;
+    int m_paddedCount;
     bool m_active;
 };
 
@@ -52,6 +52,9 @@
 #include <Qt3DRender/private/segmentsvisitor_p.h>
 #include <Qt3DRender/private/pointsvisitor_p.h>
 #include <Qt3DRender/private/layer_p.h>
+#include <Qt3DRender/private/boundingvolumehierarchy_p.h>
+#include <Qt3DRender/private/triangleboundingvolumehierarchy_p.h>
+#include <Qt3DRender/private/geometryrenderermanager_p.h>
 
 #include <vector>
 #include <algorithm>
@@ -227,6 +230,69 @@ bool TriangleCollisionVisitor::intersectsSegmentTriangle(uint andx, const Vector
     return intersected;
 }
 
+namespace {
+
+// Gives the same hits as TriangleCollisionVisitor, but the ray is moved into
+// model space rather than all the triangles into world space
+HitList triangleHierarchyHits(const TriangleBoundingVolumeHierarchy &hierarchy, const Entity *entity,
+                              const QRay3D &ray, bool frontFaceRequested, bool backFaceRequested)
+{
+    HitList hits;
+
+    const Matrix4x4 &mat = *entity->worldTransform();
+    const Vector3D xAxis = mat.mapVector(Vector3D(1.0f, 0.0f, 0.0f));
+    const Vector3D yAxis = mat.mapVector(Vector3D(0.0f, 1.0f, 0.0f));
+    const Vector3D zAxis = mat.mapVector(Vector3D(0.0f, 0.0f, 1.0f));
+    const float determinant = Vector3D::dotProduct(xAxis, Vector3D::crossProduct(yAxis, zAxis));
+    // All the triangles are degenerate once in world space
+    if (determinant == 0.0f)
+        return hits;
+
+    // The segment parameter of an intersection doesn't depend on the space
+    // it is computed in, but a mirroring transform flips the triangles winding
+    const Matrix4x4 inverse = mat.inverted();
+    const QRay3D modelRay(inverse * ray.origin(), inverse.mapVector(ray.direction()), ray.distance());
+    const bool mirrored = determinant < 0.0f;
+
+    const QVector<int> candidates = hierarchy.segmentQuery(modelRay.origin(), modelRay.point(modelRay.distance()));
+    for (const int candidate : candidates) {
+        const TriangleBoundingVolumeHierarchy::Triangle &triangle = hierarchy.triangle(candidate);
+        Vector3D vertices[3];
+        for (int v = 0; v < 3; ++v)
+            vertices[v] = Vector3D(triangle.vertices[v][0], triangle.vertices[v][1], triangle.vertices[v][2]);
+
+        float t = 0.0f;
+        Vector3D uvw;
+        auto intersects = [&] (int first, int second, int third) {
+            if (!mirrored)
+                return intersectsSegmentTriangle(modelRay, vertices[first], vertices[second], vertices[third], uvw, t);
+            if (!intersectsSegmentTriangle(modelRay, vertices[third], vertices[second], vertices[first], uvw, t))
+                return false;
+            uvw = Vector3D(uvw.z(), uvw.y(), uvw.x());
+            return true;
+        };
+
+        const bool frontFacing = frontFaceRequested && intersects(2, 1, 0);
+        const bool backFacing = !frontFacing && backFaceRequested && intersects(0, 1, 2);
+        if (!frontFacing && !backFacing)
+            continue;
+
+        QCollisionQueryResult::Hit queryResult;
+        queryResult.m_type = QCollisionQueryResult::Hit::Triangle;
+        queryResult.m_entityId = entity->peerId();
+        queryResult.m_primitiveIndex = hierarchy.triangleIndex(candidate);
+        for (int v = 0; v < 3; ++v)
+            queryResult.m_vertexIndex[v] = triangle.vertexIndices[frontFacing ? 2 - v : v];
+        queryResult.m_uvw = uvw;
+        queryResult.m_intersection = ray.point(t * ray.distance());
+        queryResult.m_distance = ray.projectedDistance(queryResult.m_intersection);
+        hits.push_back(queryResult);
+    }
+    return hits;
+}
+
+} // anonymous
+
 class LineCollisionVisitor : public SegmentsVisitor
 {
 public:
@@ -543,9 +609,15 @@ HitList TriangleCollisionGathererFunctor::pick(const Entity *entity) const
         return result;
 
     if (rayHitsEntity(entity)) {
-        TriangleCollisionVisitor visitor(m_manager, entity, m_ray, m_frontFaceRequested, m_backFaceRequested);
-        visitor.apply(gRenderer, entity->peerId());
-        result = visitor.hits;
+        // The hierarchy is outdated while the geometry renderer waits for a triangle data refresh
+        const TriangleBoundingVolumeHierarchyPtr hierarchy = gRenderer->triangleHierarchy();
+        if (hierarchy && !m_manager->geometryRendererManager()->isGeometryRendererScheduledForTriangleDataRefresh(gRenderer->peerId())) {
+            result = triangleHierarchyHits(*hierarchy, entity, m_ray, m_frontFaceRequested, m_backFaceRequested);
+        } else {
+            TriangleCollisionVisitor visitor(m_manager, entity, m_ray, m_frontFaceRequested, m_backFaceRequested);
+            visitor.apply(gRenderer, entity->peerId());
+            result = visitor.hits;
+        }
 
         sortHits(result);
     }
@@ -642,6 +714,13 @@ bool HierarchicalEntityPicker::collectHits(NodeManagers *manager, Entity *root)
     m_hits.clear();
     m_entities.clear();
 
+    // The hierarchy is only used when it indexes the same scene
+    const BoundingVolumeHierarchy *hierarchy = manager->boundingVolumeHierarchy();
+    if (hierarchy != nullptr && hierarchy->isValid() && hierarchy->root() == root) {
+        collectHitsFromHierarchy(manager, hierarchy);
+        return !m_hits.empty();
+    }
+
     QRayCastingService rayCasting;
     struct EntityData {
         Entity* entity;
@@ -658,46 +737,8 @@ bool HierarchicalEntityPicker::collectHits(NodeManagers *manager, Entity *root)
         worklist.pop_back();
 
         bool accepted = true;
-        if (m_layerIds.size()) {
-            // TODO investigate reusing logic from LayerFilter job
-            Qt3DCore::QNodeIdVector filterLayers = current.recursiveLayers + current.entity->componentsUuid<Layer>();
-
-            // remove disabled layers
-            filterLayers.erase(std::remove_if(filterLayers.begin(), filterLayers.end(),
-                                              [layerManager](const Qt3DCore::QNodeId layerId) {
-                Layer *layer = layerManager->lookupResource(layerId);
-                return !layer || !layer->isEnabled();
-            }), filterLayers.end());
-
-            std::sort(filterLayers.begin(), filterLayers.end());
-
-            Qt3DCore::QNodeIdVector commonIds;
-            std::set_intersection(m_layerIds.cbegin(), m_layerIds.cend(),
-                                  filterLayers.cbegin(), filterLayers.cend(),
-                                  std::back_inserter(commonIds));
-
-            switch (m_filterMode) {
-            case QAbstractRayCaster::AcceptAnyMatchingLayers: {
-                accepted = !commonIds.empty();
-                break;
-            }
-            case QAbstractRayCaster::AcceptAllMatchingLayers: {
-                accepted = commonIds == m_layerIds;
-                break;
-            }
-            case QAbstractRayCaster::DiscardAnyMatchingLayers: {
-                accepted = commonIds.empty();
-                break;
-            }
-            case QAbstractRayCaster::DiscardAllMatchingLayers: {
-                accepted = !(commonIds == m_layerIds);
-                break;
-            }
-            default:
-                Q_UNREACHABLE();
-                break;
-            }
-        }
+        if (m_layerIds.size())
+            accepted = layersAccepted(layerManager, current.recursiveLayers + current.entity->componentsUuid<Layer>());
 
         // first pick entry sub-scene-graph
         QCollisionQueryResult::Hit queryResult =
@@ -730,6 +771,80 @@ bool HierarchicalEntityPicker::collectHits(NodeManagers *manager, Entity *root)
     return !m_hits.empty();
 }
 
+// Same selection as the scene graph traversal, object pickers and recursive
+// layers being looked up on the ancestors of the candidates instead
+void HierarchicalEntityPicker::collectHitsFromHierarchy(NodeManagers *manager, const BoundingVolumeHierarchy *hierarchy)
+{
+    QRayCastingService rayCasting;
+    LayerManager *layerManager = manager->layerManager();
+
+    const QVector<Entity *> candidates = hierarchy->rayQuery(m_ray);
+    for (Entity *entity : candidates) {
+        const QCollisionQueryResult::Hit queryResult = rayCasting.query(m_ray, entity->worldBoundingVolume());
+        if (queryResult.m_distance < 0.f)
+            continue;
+
+        bool hasObjectPicker = !entity->componentHandle<ObjectPicker>().isNull();
+        Qt3DCore::QNodeIdVector filterLayers;
+        if (m_layerIds.size())
+            filterLayers = entity->componentsUuid<Layer>();
+
+        for (Entity *parent = entity->parent(); parent != nullptr; parent = parent->parent()) {
+            hasObjectPicker |= !parent->componentHandle<ObjectPicker>().isNull();
+            if (m_layerIds.size()) {
+                const Qt3DCore::QNodeIdVector parentLayers = parent->componentsUuid<Layer>();
+                for (const Qt3DCore::QNodeId layerId : parentLayers) {
+                    Layer *layer = layerManager->lookupResource(layerId);
+                    if (layer && layer->recursive())
+                        filterLayers << layerId;
+                }
+            }
+        }
+
+        if (!hasObjectPicker && m_objectPickersRequired)
+            continue;
+        if (m_layerIds.size() && !layersAccepted(layerManager, filterLayers))
+            continue;
+
+        m_entities.push_back(entity);
+        m_hits.push_back(queryResult);
+    }
+}
+
+bool HierarchicalEntityPicker::layersAccepted(LayerManager *layerManager, Qt3DCore::QNodeIdVector filterLayers) const
+{
+    // TODO investigate reusing logic from LayerFilter job
+
+    // remove disabled layers
+    filterLayers.erase(std::remove_if(filterLayers.begin(), filterLayers.end(),
+                                      [layerManager](const Qt3DCore::QNodeId layerId) {
+        Layer *layer = layerManager->lookupResource(layerId);
+        return !layer || !layer->isEnabled();
+    }), filterLayers.end());
+
+    std::sort(filterLayers.begin(), filterLayers.end());
+
+    Qt3DCore::QNodeIdVector commonIds;
+    std::set_intersection(m_layerIds.cbegin(), m_layerIds.cend(),
+                          filterLayers.cbegin(), filterLayers.cend(),
+                          std::back_inserter(commonIds));
+
+    switch (m_filterMode) {
+    case QAbstractRayCaster::AcceptAnyMatchingLayers:
+        return !commonIds.empty();
+    case QAbstractRayCaster::AcceptAllMatchingLayers:
+        return commonIds == m_layerIds;
+    case QAbstractRayCaster::DiscardAnyMatchingLayers:
+        return commonIds.empty();
+    case QAbstractRayCaster::DiscardAllMatchingLayers:
+        return !(commonIds == m_layerIds);
+    default:
+        Q_UNREACHABLE();
+        break;
+    }
+    return true;
+}
+
 } // PickingUtils
 
 } // Render
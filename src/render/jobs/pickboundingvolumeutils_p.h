@@ -72,6 +72,8 @@ class Entity;
 class Renderer;
 class FrameGraphNode;
 class NodeManagers;
+class LayerManager;
+class BoundingVolumeHierarchy;
 
 namespace PickingUtils {
 
@@ -126,6 +128,9 @@ public:
     inline QVector<Entity *> entities() const { return m_entities; }
 
 private:
+    void collectHitsFromHierarchy(NodeManagers *manager, const BoundingVolumeHierarchy *hierarchy);
+    bool layersAccepted(LayerManager *layerManager, Qt3DCore::QNodeIdVector filterLayers) const;
+
     RayCasting::QRay3D m_ray;
     HitList m_hits;
     QVector<Entity *> m_entities;
@@ -42,6 +42,7 @@
 #include <Qt3DRender/private/job_common_p.h>
 #include <Qt3DRender/private/nodemanagers_p.h>
 #include <Qt3DRender/private/managers_p.h>
+#include <Qt3DRender/private/flattenedentitytree_p.h>
 #include <Qt3DRender/private/sphere_p.h>
 #include <Qt3DRender/private/pickboundingvolumeutils_p.h>
 
@@ -93,7 +94,20 @@ void UpdateLevelOfDetailJob::setFrameGraphRoot(FrameGraphNode *frameGraphRoot)
 void UpdateLevelOfDetailJob::run()
 {
     Q_ASSERT(m_frameGraphRoot && m_root && m_manager);
-    updateEntityLod(m_root);
+
+    FlattenedEntityTree localTree;
+    const FlattenedEntityTree *tree = FlattenedEntityTree::treeContaining(m_manager->flattenedEntityTree(), m_root, &localTree);
+    const int rootIndex = tree->indexOf(m_root);
+    for (int i = rootIndex, end = tree->subtreeEnd(rootIndex); i < end;) {
+        Entity *entity = tree->entity(i);
+        if (!entity->isEnabled()) {
+            // skip disabled sub-trees, since their bounding box is probably not valid anyway
+            i = tree->subtreeEnd(i);
+            continue;
+        }
+        updateEntityLod(entity);
+        ++i;
+    }
 }
 
 QRect UpdateLevelOfDetailJob::windowViewport(const QSize &area, const QRectF &relativeViewport) const
@@ -111,9 +125,6 @@ QRect UpdateLevelOfDetailJob::windowViewport(const QSize &area, const QRectF &re
 
 void UpdateLevelOfDetailJob::updateEntityLod(Entity *entity)
 {
-    if (!entity->isEnabled())
-        return; // skip disabled sub-trees, since their bounding box is probably not valid anyway
-
     QVector<LevelOfDetail *> lods = entity->renderComponents<LevelOfDetail>();
     if (!lods.empty()) {
         LevelOfDetail* lod = lods.front();  // other lods are ignored
@@ -132,10 +143,6 @@ void UpdateLevelOfDetailJob::updateEntityLod(Entity *entity)
             }
         }
     }
-
-    const auto children = entity->children();
-    for (Qt3DRender::Render::Entity *child : children)
-        updateEntityLod(child);
 }
 
 void UpdateLevelOfDetailJob::updateEntityLodByDistance(Entity *entity, LevelOfDetail *lod)
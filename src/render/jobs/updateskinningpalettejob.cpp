@@ -38,6 +38,7 @@
 #include <Qt3DRender/private/nodemanagers_p.h>
 #include <Qt3DRender/private/managers_p.h>
 #include <Qt3DRender/private/handle_types_p.h>
+#include <Qt3DRender/private/flattenedentitytree_p.h>
 #include <Qt3DRender/private/job_common_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -100,13 +101,14 @@ void UpdateSkinningPaletteJob::findDirtyArmatures(Entity *entity,
     // TODO: Be smarter about limiting which armatures we update. For e.g. only
     // those with skeletons that have changed and only those that are within view
     // of one or more renderviews.
-    const auto armatureHandle = entity->componentHandle<Armature>();
-    if (!armatureHandle.isNull() && !armatures.contains(armatureHandle))
-        armatures.push_back(armatureHandle);
-
-    const auto children = entity->children();
-    for (const auto child : children)
-        findDirtyArmatures(child, armatures);
+    FlattenedEntityTree localTree;
+    const FlattenedEntityTree *tree = FlattenedEntityTree::treeContaining(m_nodeManagers->flattenedEntityTree(), entity, &localTree);
+    const int rootIndex = tree->indexOf(entity);
+    for (int i = rootIndex, end = tree->subtreeEnd(rootIndex); i < end; ++i) {
+        const auto armatureHandle = tree->entity(i)->componentHandle<Armature>();
+        if (!armatureHandle.isNull() && !armatures.contains(armatureHandle))
+            armatures.push_back(armatureHandle);
+    }
 }
 
 } // namespace Render
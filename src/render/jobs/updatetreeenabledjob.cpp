@@ -40,6 +40,7 @@
 #include "updatetreeenabledjob_p.h"
 
 #include <Qt3DRender/private/entity_p.h>
+#include <Qt3DRender/private/flattenedentitytree_p.h>
 #include <Qt3DRender/private/job_common_p.h>
 
 #include <QThread>
@@ -49,23 +50,10 @@ QT_BEGIN_NAMESPACE
 namespace Qt3DRender {
 namespace Render {
 
-namespace {
-
-void updateTreeEnabled(Entity *node, bool parentEnabled)
-{
-    const bool treeEnabled = node->isEnabled() && parentEnabled;
-    node->setTreeEnabled(treeEnabled);
-
-    const QVector<Entity*> children = node->children();
-    for (Entity *child : children)
-        updateTreeEnabled(child, treeEnabled);
-}
-
-}
-
 UpdateTreeEnabledJob::UpdateTreeEnabledJob()
     : Qt3DCore::QAspectJob()
     , m_node(nullptr)
+    , m_entityTree(nullptr)
 {
     SET_JOB_RUN_STAT_TYPE(this, JobTypes::UpdateTreeEnabled, 0);
 }
@@ -75,10 +63,32 @@ void UpdateTreeEnabledJob::setRoot(Entity *root)
     m_node = root;
 }
 
+void UpdateTreeEnabledJob::setEntityTree(const FlattenedEntityTree *tree)
+{
+    m_entityTree = tree;
+}
+
 void UpdateTreeEnabledJob::run()
 {
-    if (m_node)
-        updateTreeEnabled(m_node, true);
+    if (!m_node)
+        return;
+
+    FlattenedEntityTree localTree;
+    const FlattenedEntityTree *tree = FlattenedEntityTree::treeContaining(m_entityTree, m_node, &localTree);
+    const int begin = tree->indexOf(m_node);
+    const int end = tree->subtreeEnd(begin);
+
+    // Parents come first, their tree enabled state is always known when
+    // reaching their children
+    m_treeEnabled.resize(end - begin);
+    m_treeEnabled[0] = m_node->isEnabled();
+    m_node->setTreeEnabled(m_treeEnabled[0]);
+    for (int i = begin + 1; i < end; ++i) {
+        Entity *node = tree->entity(i);
+        const bool treeEnabled = node->isEnabled() && m_treeEnabled.at(tree->parentIndex(i) - begin);
+        m_treeEnabled[i - begin] = treeEnabled;
+        node->setTreeEnabled(treeEnabled);
+    }
 }
 
 } // namespace Render
@@ -55,6 +55,7 @@
 #include <Qt3DRender/private/qt3drender_global_p.h>
 
 #include <QSharedPointer>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
 
@@ -62,6 +63,7 @@ namespace Qt3DRender {
 namespace Render {
 
 class Entity;
+class FlattenedEntityTree;
 
 class QT3DRENDERSHARED_PRIVATE_EXPORT UpdateTreeEnabledJob : public Qt3DCore::QAspectJob
 {
@@ -69,10 +71,13 @@ public:
     UpdateTreeEnabledJob();
 
     void setRoot(Entity *root);
+    void setEntityTree(const FlattenedEntityTree *tree);
     void run() override;
 
 private:
     Entity *m_node;
+    const FlattenedEntityTree *m_entityTree;
+    QVector<bool> m_treeEnabled;
 };
 
 typedef QSharedPointer<UpdateTreeEnabledJob> UpdateTreeEnabledJobPtr;
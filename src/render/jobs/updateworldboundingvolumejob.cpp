@@ -48,22 +48,52 @@ QT_BEGIN_NAMESPACE
 namespace Qt3DRender {
 namespace Render {
 
+namespace {
+
+void updateWorldBoundingVolume(Entity *node)
+{
+    *(node->worldBoundingVolume()) = node->localBoundingVolume()->transformed(*(node->worldTransform()));
+    *(node->worldBoundingVolumeWithChildren()) = *(node->worldBoundingVolume()); // expanded in UpdateBoundingVolumeJob
+}
+
+void updateSubtreeWorldBoundingVolumes(Entity *node)
+{
+    updateWorldBoundingVolume(node);
+    const auto children = node->children();
+    for (Entity *child : children)
+        updateSubtreeWorldBoundingVolumes(child);
+}
+
+} // anonymous
+
 UpdateWorldBoundingVolumeJob::UpdateWorldBoundingVolumeJob()
     : Qt3DCore::QAspectJob()
     , m_manager(nullptr)
+    , m_updateAllEntities(true)
 {
     SET_JOB_RUN_STAT_TYPE(this, JobTypes::UpdateWorldBoundingVolume, 0);
 }
 
+// Restricts the update to the given subtrees, by default the bounding volumes
+// of all entities are updated
+void UpdateWorldBoundingVolumeJob::setDirtySubtreeRoots(const QVector<Entity *> &roots)
+{
+    m_dirtySubtreeRoots = roots;
+    m_updateAllEntities = false;
+}
+
 void UpdateWorldBoundingVolumeJob::run()
 {
+    if (!m_updateAllEntities) {
+        for (Entity *root : qAsConst(m_dirtySubtreeRoots))
+            updateSubtreeWorldBoundingVolumes(root);
+        return;
+    }
+
     const QVector<HEntity> handles = m_manager->activeHandles();
 
-    for (const HEntity &handle : handles) {
-        Entity *node = m_manager->data(handle);
-        *(node->worldBoundingVolume()) = node->localBoundingVolume()->transformed(*(node->worldTransform()));
-        *(node->worldBoundingVolumeWithChildren()) = *(node->worldBoundingVolume()); // expanded in UpdateBoundingVolumeJob
-    }
+    for (const HEntity &handle : handles)
+        updateWorldBoundingVolume(m_manager->data(handle));
 }
 
 } // namespace Render
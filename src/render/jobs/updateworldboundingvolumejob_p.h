@@ -54,12 +54,14 @@
 #include <Qt3DCore/qaspectjob.h>
 #include <Qt3DRender/private/qt3drender_global_p.h>
 #include <QSharedPointer>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
 
 namespace Qt3DRender {
 namespace Render {
 
+class Entity;
 class EntityManager;
 
 class QT3DRENDERSHARED_PRIVATE_EXPORT UpdateWorldBoundingVolumeJob : public Qt3DCore::QAspectJob
@@ -68,10 +70,13 @@ public:
     UpdateWorldBoundingVolumeJob();
 
     inline void setManager(EntityManager *manager) Q_DECL_NOTHROW { m_manager = manager; }
+    void setDirtySubtreeRoots(const QVector<Entity *> &roots);
     void run() override;
 
 private:
     EntityManager *m_manager;
+    QVector<Entity *> m_dirtySubtreeRoots;
+    bool m_updateAllEntities;
 };
 
 typedef QSharedPointer<UpdateWorldBoundingVolumeJob> UpdateWorldBoundingVolumeJobPtr;
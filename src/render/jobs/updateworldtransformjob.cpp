@@ -41,11 +41,15 @@
 
 #include <Qt3DRender/private/renderer_p.h>
 #include <Qt3DRender/private/entity_p.h>
+#include <Qt3DRender/private/flattenedentitytree_p.h>
 #include <Qt3DRender/private/transform_p.h>
 #include <Qt3DRender/private/renderlogging_p.h>
 #include <Qt3DRender/private/job_common_p.h>
 
 #include <QThread>
+#if QT_CONFIG(concurrent)
+#include <QtConcurrent/QtConcurrent>
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -54,7 +58,14 @@ namespace Render {
 
 namespace {
 
-void updateWorldTransformAndBounds(Qt3DRender::Render::Entity *node, const Matrix4x4 &parentTransform)
+// Below that many subtrees, the hierarchy keeps being expanded level by
+// level on the job thread before the subtrees are processed in parallel
+const int MinSubtreesPerThread = 4;
+// Narrow or deep hierarchies stop being expanded after that many levels,
+// whatever subtrees were found are then processed in parallel
+const int MaxExpandedLevels = 4;
+
+void updateWorldTransform(Qt3DRender::Render::Entity *node, const Matrix4x4 &parentTransform)
 {
     Matrix4x4 worldTransform(parentTransform);
     Transform *nodeTransform = node->renderComponent<Transform>();
@@ -63,42 +74,128 @@ void updateWorldTransformAndBounds(Qt3DRender::Render::Entity *node, const Matri
         worldTransform = worldTransform * nodeTransform->transformMatrix();
 
     *(node->worldTransform()) = worldTransform;
+}
+
+Matrix4x4 parentWorldTransform(Qt3DRender::Render::Entity *node)
+{
+    Qt3DRender::Render::Entity *parent = node->parent();
+    if (parent != nullptr)
+        return *(parent->worldTransform());
+    return Matrix4x4();
+}
+
+const Matrix4x4 &parentWorldTransform(const FlattenedEntityTree *tree, int index)
+{
+    return *(tree->entity(tree->parentIndex(index))->worldTransform());
+}
+
+// Parents are stored before their children, a single forward pass over the
+// subtree range updates every world transform after the one of its parent
+void updateSubtreeWorldTransforms(const FlattenedEntityTree *tree, int rootIndex)
+{
+    Entity *root = tree->entity(rootIndex);
+    updateWorldTransform(root, parentWorldTransform(root));
 
-    const auto children = node->children();
-    for (Qt3DRender::Render::Entity *child : children)
-        updateWorldTransformAndBounds(child, worldTransform);
+    const int end = tree->subtreeEnd(rootIndex);
+    for (int i = rootIndex + 1; i < end; ++i)
+        updateWorldTransform(tree->entity(i), parentWorldTransform(tree, i));
 }
 
+#if QT_CONFIG(concurrent)
+struct Subtree {
+    const FlattenedEntityTree *tree;
+    int rootIndex;
+};
+
+void appendChildSubtrees(const Subtree &subtree, QVector<Subtree> &subtrees)
+{
+    const int end = subtree.tree->subtreeEnd(subtree.rootIndex);
+    for (int i = subtree.rootIndex + 1; i < end; i = subtree.tree->subtreeEnd(i))
+        subtrees.push_back({ subtree.tree, i });
 }
 
+struct UpdateSubtreeFunctor {
+    // Subtree roots always have a parent whose world transform is up to date
+    void operator ()(const Subtree &subtree)
+    {
+        updateSubtreeWorldTransforms(subtree.tree, subtree.rootIndex);
+    }
+};
+#endif
+
+} // anonymous
+
 UpdateWorldTransformJob::UpdateWorldTransformJob()
     : Qt3DCore::QAspectJob()
-    , m_node(nullptr)
+    , m_entityTree(nullptr)
 {
     SET_JOB_RUN_STAT_TYPE(this, JobTypes::UpdateTransform, 0);
 }
 
 void UpdateWorldTransformJob::setRoot(Entity *root)
 {
-    m_node = root;
+    m_dirtySubtreeRoots = { root };
 }
 
-void UpdateWorldTransformJob::run()
+// Restricts the update to the given subtrees, none of which may be nested in
+// another. setRoot() resets this to the whole scene
+void UpdateWorldTransformJob::setDirtySubtreeRoots(const QVector<Entity *> &roots)
 {
-    // Iterate over each level of hierarchy in our scene
-    // and update each node's world transform from its
-    // local transform and its parent's world transform
+    m_dirtySubtreeRoots = roots;
+}
 
-    // TODO: Parallelise this on each level using a parallel_for
-    // implementation.
+// The tree is used for the subtrees it contains, the others are flattened when
+// the job runs
+void UpdateWorldTransformJob::setEntityTree(const FlattenedEntityTree *tree)
+{
+    m_entityTree = tree;
+}
 
+void UpdateWorldTransformJob::run()
+{
     qCDebug(Jobs) << "Entering" << Q_FUNC_INFO << QThread::currentThread();
 
-    Matrix4x4 parentTransform;
-    Entity *parent = m_node->parent();
-    if (parent != nullptr)
-        parentTransform = *(parent->worldTransform());
-    updateWorldTransformAndBounds(m_node, parentTransform);
+    // Subtrees missing from m_entityTree are flattened into local trees
+    QVector<FlattenedEntityTree> localTrees(m_dirtySubtreeRoots.size());
+    QVector<const FlattenedEntityTree *> trees;
+    trees.reserve(m_dirtySubtreeRoots.size());
+    for (int i = 0, m = m_dirtySubtreeRoots.size(); i < m; ++i)
+        trees.push_back(FlattenedEntityTree::treeContaining(m_entityTree, m_dirtySubtreeRoots.at(i), &localTrees[i]));
+
+#if QT_CONFIG(concurrent)
+    // Walk the top of the hierarchy breadth first until there are enough
+    // independent subtrees to keep all threads busy or MaxExpandedLevels
+    // levels were expanded, then update those subtrees in parallel. Each node
+    // still computes parent * local from the same values, results are
+    // identical to the serial traversal
+    const int minSubtreeCount = MinSubtreesPerThread * QThread::idealThreadCount();
+    QVector<Subtree> subtrees;
+    for (int i = 0, m = m_dirtySubtreeRoots.size(); i < m; ++i) {
+        Entity *root = m_dirtySubtreeRoots.at(i);
+        updateWorldTransform(root, parentWorldTransform(root));
+        appendChildSubtrees({ trees.at(i), trees.at(i)->indexOf(root) }, subtrees);
+    }
+    QVector<Subtree> nextLevel;
+    for (int level = 0; level < MaxExpandedLevels && !subtrees.isEmpty() && subtrees.size() < minSubtreeCount; ++level) {
+        nextLevel.clear();
+        for (const Subtree &subtree : qAsConst(subtrees)) {
+            updateWorldTransform(subtree.tree->entity(subtree.rootIndex),
+                                 parentWorldTransform(subtree.tree, subtree.rootIndex));
+            appendChildSubtrees(subtree, nextLevel);
+        }
+        subtrees.swap(nextLevel);
+    }
+
+    if (subtrees.size() > 1) {
+        QtConcurrent::blockingMap(subtrees, UpdateSubtreeFunctor());
+    } else {
+        for (const Subtree &subtree : qAsConst(subtrees))
+            updateSubtreeWorldTransforms(subtree.tree, subtree.rootIndex);
+    }
+#else
+    for (int i = 0, m = m_dirtySubtreeRoots.size(); i < m; ++i)
+        updateSubtreeWorldTransforms(trees.at(i), trees.at(i)->indexOf(m_dirtySubtreeRoots.at(i)));
+#endif
 
     qCDebug(Jobs) << "Exiting" << Q_FUNC_INFO << QThread::currentThread();
 }
@@ -55,6 +55,7 @@
 #include <Qt3DRender/private/qt3drender_global_p.h>
 
 #include <QSharedPointer>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
 
@@ -62,6 +63,7 @@ namespace Qt3DRender {
 namespace Render {
 
 class Entity;
+class FlattenedEntityTree;
 
 class QT3DRENDERSHARED_PRIVATE_EXPORT UpdateWorldTransformJob : public Qt3DCore::QAspectJob
 {
@@ -69,10 +71,13 @@ public:
     UpdateWorldTransformJob();
 
     void setRoot(Entity *root);
+    void setDirtySubtreeRoots(const QVector<Entity *> &roots);
+    void setEntityTree(const FlattenedEntityTree *tree);
     void run() override;
 
 private:
-    Entity *m_node;
+    QVector<Entity *> m_dirtySubtreeRoots;
+    const FlattenedEntityTree *m_entityTree;
 };
 
 typedef QSharedPointer<UpdateWorldTransformJob> UpdateWorldTransformJobPtr;
@@ -0,0 +1,224 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "lightgrid_p.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+LightGrid::LightGrid()
+{
+    clear();
+}
+
+void LightGrid::clear()
+{
+    m_positions.clear();
+    m_cellOffsets.clear();
+    m_cellLights.clear();
+    for (int axis = 0; axis < 3; ++axis) {
+        m_min[axis] = 0.0f;
+        m_cellSize[axis] = 0.0f;
+        m_inverseCellSize[axis] = 0.0f;
+        m_resolution[axis] = 1;
+    }
+}
+
+void LightGrid::build(const QVector<Vector3D> &positions)
+{
+    clear();
+    m_positions = positions;
+    const int lightCount = m_positions.size();
+    if (lightCount == 0)
+        return;
+
+    float max[3];
+    for (int axis = 0; axis < 3; ++axis)
+        m_min[axis] = max[axis] = m_positions.first()[axis];
+    for (const Vector3D &position : qAsConst(m_positions)) {
+        for (int axis = 0; axis < 3; ++axis) {
+            m_min[axis] = std::min(m_min[axis], position[axis]);
+            max[axis] = std::max(max[axis], position[axis]);
+        }
+    }
+
+    // Pick a cell size giving about LightsPerCell lights per cell, ignoring
+    // the axes along which all the lights are aligned
+    float extent[3];
+    float volume = 1.0f;
+    int dimensions = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        extent[axis] = max[axis] - m_min[axis];
+        if (extent[axis] > 0.0f) {
+            volume *= extent[axis];
+            ++dimensions;
+        }
+    }
+    if (dimensions > 0) {
+        const float targetCellCount = std::max(1.0f, float(lightCount) / float(LightsPerCell));
+        const float cellSize = std::pow(volume / targetCellCount, 1.0f / float(dimensions));
+        for (int axis = 0; axis < 3; ++axis) {
+            if (extent[axis] <= 0.0f)
+                continue;
+            const float resolution = cellSize > 0.0f ? std::ceil(extent[axis] / cellSize) : 1.0f;
+            m_resolution[axis] = int(qBound(1.0f, resolution, float(MaxResolution)));
+            m_cellSize[axis] = extent[axis] / float(m_resolution[axis]);
+            m_inverseCellSize[axis] = 1.0f / m_cellSize[axis];
+        }
+    }
+
+    // Bucket the lights per cell (counting sort)
+    const int cellCount = m_resolution[0] * m_resolution[1] * m_resolution[2];
+    QVector<int> lightCells(lightCount);
+    m_cellOffsets.fill(0, cellCount + 1);
+    for (int i = 0; i < lightCount; ++i) {
+        const Vector3D &position = m_positions.at(i);
+        const int cell = cellIndex(cellCoordinate(position, 0),
+                                   cellCoordinate(position, 1),
+                                   cellCoordinate(position, 2));
+        lightCells[i] = cell;
+        ++m_cellOffsets[cell + 1];
+    }
+    for (int cell = 0; cell < cellCount; ++cell)
+        m_cellOffsets[cell + 1] += m_cellOffsets[cell];
+
+    QVector<int> insertionOffsets = m_cellOffsets;
+    m_cellLights.resize(lightCount);
+    for (int i = 0; i < lightCount; ++i)
+        m_cellLights[insertionOffsets[lightCells.at(i)]++] = i;
+}
+
+int LightGrid::cellCoordinate(const Vector3D &point, int axis) const
+{
+    const float coordinate = (point[axis] - m_min[axis]) * m_inverseCellSize[axis];
+    return int(qBound(0.0f, coordinate, float(m_resolution[axis] - 1)));
+}
+
+void LightGrid::nearestLights(const Vector3D &point, int count, LightIndices *indices) const
+{
+    indices->clear();
+    count = std::min(count, m_positions.size());
+    if (count <= 0)
+        return;
+
+    // Kept sorted by increasing distance
+    QVarLengthArray<float, MaxNearestLights> squaredDistances;
+
+    int center[3];
+    int ringCount = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        center[axis] = cellCoordinate(point, axis);
+        ringCount = std::max(ringCount, std::max(center[axis], m_resolution[axis] - 1 - center[axis]));
+    }
+
+    // Visit the cells ring by ring around the cell containing the point
+    for (int ring = 0; ring <= ringCount; ++ring) {
+        int lower[3];
+        int upper[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            lower[axis] = std::max(0, center[axis] - ring);
+            upper[axis] = std::min(m_resolution[axis] - 1, center[axis] + ring);
+        }
+
+        for (int z = lower[2]; z <= upper[2]; ++z) {
+            for (int y = lower[1]; y <= upper[1]; ++y) {
+                for (int x = lower[0]; x <= upper[0]; ++x) {
+                    // Inner cells were visited by the previous rings
+                    if (std::max(std::abs(x - center[0]),
+                                 std::max(std::abs(y - center[1]), std::abs(z - center[2]))) != ring)
+                        continue;
+
+                    const int cell = cellIndex(x, y, z);
+                    for (int i = m_cellOffsets.at(cell), m = m_cellOffsets.at(cell + 1); i < m; ++i) {
+                        const int lightIndex = m_cellLights.at(i);
+                        const float squaredDistance = (m_positions.at(lightIndex) - point).lengthSquared();
+
+                        int position = squaredDistances.size();
+                        while (position > 0
+                               && (squaredDistance < squaredDistances.at(position - 1)
+                                   || (squaredDistance == squaredDistances.at(position - 1)
+                                       && lightIndex < indices->at(position - 1))))
+                            --position;
+                        if (position >= count)
+                            continue;
+
+                        if (squaredDistances.size() < count) {
+                            squaredDistances.append(0.0f);
+                            indices->append(0);
+                        }
+                        for (int j = squaredDistances.size() - 1; j > position; --j) {
+                            squaredDistances[j] = squaredDistances.at(j - 1);
+                            (*indices)[j] = indices->at(j - 1);
+                        }
+                        squaredDistances[position] = squaredDistance;
+                        (*indices)[position] = lightIndex;
+                    }
+                }
+            }
+        }
+
+        if (indices->size() < count)
+            continue;
+
+        // Cells which haven't been visited yet are at least as far as the
+        // closest face of the visited block which isn't on the grid border
+        float exitDistance = std::numeric_limits<float>::max();
+        for (int axis = 0; axis < 3; ++axis) {
+            if (lower[axis] > 0)
+                exitDistance = std::min(exitDistance, point[axis] - (m_min[axis] + float(lower[axis]) * m_cellSize[axis]));
+            if (upper[axis] < m_resolution[axis] - 1)
+                exitDistance = std::min(exitDistance, m_min[axis] + float(upper[axis] + 1) * m_cellSize[axis] - point[axis]);
+        }
+        if (exitDistance >= 0.0f && exitDistance * exitDistance >= squaredDistances.last())
+            break;
+    }
+}
+
+} // Render
+
+} // Qt3DRender
+
+QT_END_NAMESPACE
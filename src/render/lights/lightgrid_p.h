@@ -0,0 +1,113 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QT3DRENDER_RENDER_LIGHTGRID_P_H
+#define QT3DRENDER_RENDER_LIGHTGRID_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <Qt3DRender/qt3drender_global.h>
+#include <Qt3DCore/private/vector3d_p.h>
+#include <QVarLengthArray>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+// Uniform grid bucketing the light positions of a RenderView so that the
+// closest lights of every entity can be found without sorting all of them
+class Q_AUTOTEST_EXPORT LightGrid
+{
+public:
+    enum {
+        MaxNearestLights = 8,
+        LightsPerCell = 2,
+        MaxResolution = 32
+    };
+
+    typedef QVarLengthArray<int, MaxNearestLights> LightIndices;
+
+    LightGrid();
+
+    void build(const QVector<Vector3D> &positions);
+    void clear();
+
+    int lightCount() const { return m_positions.size(); }
+    int resolution(int axis) const { return m_resolution[axis]; }
+
+    // Returns the indices of the count closest lights ordered by increasing
+    // distance, equidistant lights are ordered by increasing index
+    void nearestLights(const Vector3D &point, int count, LightIndices *indices) const;
+
+private:
+    int cellCoordinate(const Vector3D &point, int axis) const;
+    int cellIndex(int x, int y, int z) const
+    {
+        return (z * m_resolution[1] + y) * m_resolution[0] + x;
+    }
+
+    QVector<Vector3D> m_positions;
+    // Lights of cell i are m_cellLights[m_cellOffsets[i]] to m_cellLights[m_cellOffsets[i + 1] - 1]
+    QVector<int> m_cellOffsets;
+    QVector<int> m_cellLights;
+    float m_min[3];
+    float m_cellSize[3];
+    float m_inverseCellSize[3];
+    int m_resolution[3];
+};
+
+} // Render
+
+} // Qt3DRender
+
+QT_END_NAMESPACE
+
+#endif // QT3DRENDER_RENDER_LIGHTGRID_P_H
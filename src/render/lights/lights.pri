@@ -13,7 +13,8 @@ HEADERS += \
     $$PWD/qspotlight_p.h \
     $$PWD/environmentlight_p.h \
     $$PWD/light_p.h \
-    $$PWD/lightsource_p.h
+    $$PWD/lightsource_p.h \
+    $$PWD/lightgrid_p.h
 
 SOURCES += \
     $$PWD/qabstractlight.cpp \
@@ -23,4 +24,5 @@ SOURCES += \
     $$PWD/qspotlight.cpp \
     $$PWD/environmentlight.cpp \
     $$PWD/light.cpp \
-    $$PWD/lightsource.cpp
+    $$PWD/lightsource.cpp \
+    $$PWD/lightgrid.cpp
@@ -79,6 +79,7 @@ void Effect::initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &chang
     const auto &data = typedChange->data;
     m_techniques = data.techniqueIds;
     m_parameterPack.setParameters(data.parameterIds);
+    updateRevision();
 }
 
 void Effect::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
@@ -106,6 +107,7 @@ void Effect::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
         break;
     }
 
+    updateRevision();
     markDirty(AbstractRenderer::AllDirty);
     BackendNode::sceneChangeEvent(e);
 }
@@ -71,6 +71,7 @@ void FilterKey::initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &ch
     const auto &data = typedChange->data;
     m_name = data.name;
     m_value = data.value;
+    updateRevision();
 }
 
 void FilterKey::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
@@ -83,6 +84,7 @@ void FilterKey::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
         else if (propertyChange->propertyName() == QByteArrayLiteral("name"))
             m_name = propertyChange->value().toString();
 
+        updateRevision();
         markDirty(AbstractRenderer::AllDirty);
     }
 
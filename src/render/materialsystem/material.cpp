@@ -49,6 +49,7 @@
 #include <Qt3DCore/qpropertyupdatedchange.h>
 #include <Qt3DCore/qpropertynodeaddedchange.h>
 #include <Qt3DCore/qpropertynoderemovedchange.h>
+#include <Qt3DCore/private/qtypedpropertyupdatechange_p.h>
 
 using namespace Qt3DCore;
 
@@ -79,13 +80,21 @@ void Material::initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &cha
     const auto &data = typedChange->data;
     m_effectUuid = data.effectId;
     m_parameterPack.setParameters(data.parameterIds);
+    updateRevision();
 }
 
 void Material::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
 {
 
+    static const int effectId = QTypedPropertyUpdatedChangeBase::propertyIdForName("effect");
+
     switch (e->type()) {
     case PropertyUpdated: {
+        if (const QTypedPropertyUpdatedChangeBase *typedChange = QTypedPropertyUpdatedChangeBase::fromChange(e)) {
+            if (typedChange->propertyId() == effectId)
+                m_effectUuid = typedChange->value<QNodeId>();
+            break;
+        }
         const auto change = qSharedPointerCast<QPropertyUpdatedChange>(e);
         if (change->propertyName() == QByteArrayLiteral("effect"))
             m_effectUuid = change->value().value<QNodeId>();
@@ -109,6 +118,7 @@ void Material::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
     default:
         break;
     }
+    updateRevision();
     markDirty(AbstractRenderer::AllDirty);
 
     BackendNode::sceneChangeEvent(e);
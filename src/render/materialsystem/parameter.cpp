@@ -39,6 +39,7 @@
 
 #include "parameter_p.h"
 #include <Qt3DCore/qpropertyupdatedchange.h>
+#include <Qt3DCore/private/qtypedpropertyupdatechange_p.h>
 #include <Qt3DRender/qparameter.h>
 #include <Qt3DRender/private/qparameter_p.h>
 #include <Qt3DRender/qtexture.h>
@@ -59,6 +60,7 @@ namespace Render {
 Parameter::Parameter()
     : BackendNode()
     , m_nameId(-1)
+    , m_valueRevision(0)
 {
 }
 
@@ -68,6 +70,7 @@ void Parameter::cleanup()
     m_nameId = -1;
     m_name.clear();
     m_uniformValue = UniformValue();
+    m_valueRevision = 0;
 }
 
 void Parameter::initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &change)
@@ -77,21 +80,38 @@ void Parameter::initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &ch
     m_name = data.name;
     m_nameId = StringToInt::lookupId(m_name);
     m_uniformValue = UniformValue::fromVariant(data.backendValue);
+    updateRevision();
+    m_valueRevision = m_revision;
 }
 
 void Parameter::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
 {
+    static const int valueId = QTypedPropertyUpdatedChangeBase::propertyIdForName("value");
+
+    if (const QTypedPropertyUpdatedChangeBase *typedChange = QTypedPropertyUpdatedChangeBase::fromChange(e)) {
+        if (typedChange->propertyId() == valueId) {
+            m_uniformValue = typedChange->value<UniformValue>();
+            m_valueRevision = nextRevision();
+            markDirty(AbstractRenderer::ParameterDirty);
+        }
+        BackendNode::sceneChangeEvent(e);
+        return;
+    }
+
     QPropertyUpdatedChangePtr propertyChange = qSharedPointerCast<QPropertyUpdatedChange>(e);
 
     if (e->type() == PropertyUpdated) {
         if (propertyChange->propertyName() == QByteArrayLiteral("name")) {
             m_name = propertyChange->value().toString();
             m_nameId = StringToInt::lookupId(m_name);
+            updateRevision();
             markDirty(AbstractRenderer::MaterialDirty | AbstractRenderer::ParameterDirty);
         } else if (propertyChange->propertyName() == QByteArrayLiteral("value")) {
             m_uniformValue = UniformValue::fromVariant(propertyChange->value());
+            m_valueRevision = nextRevision();
             markDirty(AbstractRenderer::ParameterDirty);
         } else if (propertyChange->propertyName() == QByteArrayLiteral("enabled")) {
+            updateRevision();
             markDirty(AbstractRenderer::MaterialDirty | AbstractRenderer::ParameterDirty);
         }
     }
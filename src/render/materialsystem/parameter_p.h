@@ -76,6 +76,9 @@ public:
     QString name() const;
     int nameId() const Q_DECL_NOTHROW { return m_nameId; }
     const UniformValue &uniformValue() const { return m_uniformValue; }
+    // Greater than revision() and all previous value revisions
+    // each time the value changes
+    uint valueRevision() const Q_DECL_NOTHROW { return m_valueRevision; }
 
 private:
     void initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &change) final;
@@ -83,6 +86,7 @@ private:
     QString m_name;
     UniformValue m_uniformValue;
     int m_nameId;
+    uint m_valueRevision;
 };
 
 } // namespace Render
@@ -194,6 +194,22 @@ QMaterialPrivate::~QMaterialPrivate()
 {
 }
 
+bool QMaterialPrivate::sendTypedPropertyChange(int propertyIndex)
+{
+    static const int effectIndex = QMaterial::staticMetaObject.indexOfProperty("effect");
+    static const int effectId = Qt3DCore::QTypedPropertyUpdatedChangeBase::propertyIdForName("effect");
+
+    if (propertyIndex != effectIndex)
+        return false;
+
+    // Make sure the effect's creation change is sent before we reference it
+    if (m_effect)
+        Qt3DCore::QNodePrivate::get(m_effect)->_q_postConstructorInit();
+
+    notifyTypedPropertyChange("effect", effectId, Qt3DCore::qIdForNode(m_effect));
+    return true;
+}
+
 QMaterial::QMaterial(QNode *parent)
     : QComponent(*new QMaterialPrivate, parent)
 {
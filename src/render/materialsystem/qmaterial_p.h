@@ -67,6 +67,8 @@ public:
     QMaterialPrivate();
     ~QMaterialPrivate();
 
+    bool sendTypedPropertyChange(int propertyIndex) override;
+
     Q_DECLARE_PUBLIC(QMaterial)
     QVector<QParameter *> m_parameters;
     QEffect *m_effect;
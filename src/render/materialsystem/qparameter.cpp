@@ -40,6 +40,7 @@
 #include "qparameter.h"
 #include "qparameter_p.h"
 #include <Qt3DRender/private/renderlogging_p.h>
+#include <Qt3DRender/private/uniform_p.h>
 #include <Qt3DCore/qpropertyupdatedchange.h>
 #include <Qt3DRender/qtexture.h>
 
@@ -206,6 +207,25 @@ void QParameterPrivate::setValue(const QVariant &v)
     m_value = v;
 }
 
+bool QParameterPrivate::sendTypedPropertyChange(int propertyIndex)
+{
+    static const int valueIndex = QParameter::staticMetaObject.indexOfProperty("value");
+    static const int valueId = QTypedPropertyUpdatedChangeBase::propertyIdForName("value");
+
+    if (propertyIndex != valueIndex)
+        return false;
+
+    // Node values need their creation change to be issued first, leave
+    // those to the generic path
+    if (m_value.type() == QVariant::List || m_value.value<QNode *>() != nullptr)
+        return false;
+
+    // The value is converted here so that the backend receives it ready to
+    // be uploaded, without a QVariant in between
+    notifyTypedPropertyChange("value", valueId, Render::UniformValue::fromVariant(m_backendValue));
+    return true;
+}
+
 /*! \internal */
 QParameter::QParameter(QParameterPrivate &dd, QNode *parent)
     : QNode(dd, parent)
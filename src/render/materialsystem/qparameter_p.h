@@ -68,6 +68,7 @@ public:
     Q_DECLARE_PUBLIC(QParameter)
 
     virtual void setValue(const QVariant &v);
+    bool sendTypedPropertyChange(int propertyIndex) override;
 
     QString m_name;
     QVariant m_value;
@@ -86,6 +86,7 @@ void RenderPass::initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &c
     for (const auto &renderStateId : qAsConst(data.renderStateIds))
         addRenderState(renderStateId);
     m_shaderUuid = data.shaderId;
+    updateRevision();
 }
 
 void RenderPass::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
@@ -129,6 +130,7 @@ void RenderPass::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
     }
 
     BackendNode::sceneChangeEvent(e);
+    updateRevision();
     markDirty(AbstractRenderer::AllDirty);
 }
 
@@ -173,6 +173,7 @@ private:
     void setStatus(QShaderProgram::Status status);
 
     friend class GraphicsContext;
+    friend class tst_RenderViews;
 };
 
 #ifndef QT_NO_DEBUG_STREAM
@@ -36,13 +36,31 @@
 
 #include "shadercache_p.h"
 
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
 #include <QtCore/QMutexLocker>
+#include <QtCore/QSaveFile>
 
 QT_BEGIN_NAMESPACE
 
 namespace Qt3DRender {
 namespace Render {
 
+namespace {
+
+const quint32 ProgramBinaryMagic = 0x51334450; // Q3DP
+const quint32 ProgramBinaryVersion = 2;
+
+// The data is handed as is to glProgramBinary, a corrupted entry must be detected
+QByteArray programBinaryChecksum(const QByteArray &data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+}
+
+} // anonymous
+
 /*!
  * \internal
  *
@@ -73,6 +91,8 @@ QOpenGLShaderProgram *ShaderCache::getShaderProgramAndAddRef(ProgramDNA dna, Qt3
         *wasPresent = shaderProgram != m_programHash.constEnd();
 
     if (shaderProgram != m_programHash.constEnd()) {
+        m_hits.fetchAndAddRelaxed(1);
+
         // Ensure we store the fact that shaderPeerId references this shader
         QMutexLocker lock(&m_refsMutex);
         QVector<Qt3DCore::QNodeId> &programRefs = m_programRefs[dna];
@@ -85,6 +105,7 @@ QOpenGLShaderProgram *ShaderCache::getShaderProgramAndAddRef(ProgramDNA dna, Qt3
         return *shaderProgram;
     }
 
+    m_misses.fetchAndAddRelaxed(1);
     return nullptr;
 }
 
@@ -168,6 +189,136 @@ QVector<Qt3DCore::QNodeId> ShaderCache::shaderIdsForProgram(ProgramDNA dna) cons
     return m_programRefs.value(dna);
 }
 
+/*!
+ * \internal
+ *
+ * Enables the on disk layer of the cache, storing program binaries in the
+ * directory \a path. An empty \a path disables it.
+ */
+void ShaderCache::setDiskCachePath(const QString &path)
+{
+    m_diskCachePath = path;
+}
+
+/*!
+ * \internal
+ *
+ * Reads the program binary stored for \a dna by a previous run. The entry is
+ * only accepted when it was produced by the driver identified by \a driverKey
+ * from sources matching \a sourceDigest and when its content is intact.
+ *
+ * \return true and fills \a binary on success. The caller is still expected to
+ * call rejectProgramBinary if the driver refuses the binary.
+ */
+bool ShaderCache::loadProgramBinary(ProgramDNA dna, const QByteArray &driverKey,
+                                    const QByteArray &sourceDigest, ProgramBinary *binary)
+{
+    Q_ASSERT(binary);
+    if (!isDiskCacheEnabled())
+        return false;
+
+    QFile file(programBinaryFilePath(dna, driverKey));
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_diskMisses.fetchAndAddRelaxed(1);
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 storedDNA = 0;
+    QByteArray storedDriverKey;
+    QByteArray storedSourceDigest;
+    quint32 format = 0;
+    QByteArray data;
+    QByteArray checksum;
+    stream >> magic >> version;
+    if (magic == ProgramBinaryMagic && version == ProgramBinaryVersion)
+        stream >> storedDNA >> storedDriverKey >> storedSourceDigest >> format >> data >> checksum;
+
+    const bool valid = stream.status() == QDataStream::Ok
+            && magic == ProgramBinaryMagic
+            && version == ProgramBinaryVersion
+            && storedDNA == dna
+            && storedDriverKey == driverKey
+            && storedSourceDigest == sourceDigest
+            && !data.isEmpty()
+            && checksum == programBinaryChecksum(data);
+    file.close();
+
+    if (!valid) {
+        // Stale or corrupted entry, it will be replaced once the program is linked
+        file.remove();
+        m_diskMisses.fetchAndAddRelaxed(1);
+        return false;
+    }
+
+    binary->format = format;
+    binary->data = data;
+    m_diskHits.fetchAndAddRelaxed(1);
+    return true;
+}
+
+/*!
+ * \internal
+ *
+ * Stores \a binary for \a dna so that following runs using the driver
+ * identified by \a driverKey can skip compiling and linking the program.
+ */
+bool ShaderCache::saveProgramBinary(ProgramDNA dna, const QByteArray &driverKey,
+                                    const QByteArray &sourceDigest, const ProgramBinary &binary)
+{
+    if (!isDiskCacheEnabled() || binary.data.isEmpty())
+        return false;
+
+    if (!QDir().mkpath(m_diskCachePath))
+        return false;
+
+    QSaveFile file(programBinaryFilePath(dna, driverKey));
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << ProgramBinaryMagic << ProgramBinaryVersion
+           << quint32(dna) << driverKey << sourceDigest
+           << quint32(binary.format) << binary.data
+           << programBinaryChecksum(binary.data);
+
+    return stream.status() == QDataStream::Ok && file.commit();
+}
+
+/*!
+ * \internal
+ *
+ * Removes the program binary stored for \a dna after the driver refused it.
+ */
+void ShaderCache::rejectProgramBinary(ProgramDNA dna, const QByteArray &driverKey)
+{
+    QFile::remove(programBinaryFilePath(dna, driverKey));
+    m_diskRejects.fetchAndAddRelaxed(1);
+}
+
+ShaderCache::Statistics ShaderCache::statistics() const
+{
+    Statistics statistics;
+    statistics.hits = m_hits.load();
+    statistics.misses = m_misses.load();
+    statistics.diskHits = m_diskHits.load();
+    statistics.diskMisses = m_diskMisses.load();
+    statistics.diskRejects = m_diskRejects.load();
+    return statistics;
+}
+
+QString ShaderCache::programBinaryFilePath(ProgramDNA dna, const QByteArray &driverKey) const
+{
+    const QByteArray driverHash = QCryptographicHash::hash(driverKey, QCryptographicHash::Sha1).toHex().left(16);
+    return m_diskCachePath + QLatin1Char('/')
+            + QString::number(dna, 16) + QLatin1Char('-') + QString::fromLatin1(driverHash)
+            + QLatin1String(".bin");
+}
+
 } // namespace Render
 } // namespace Qt3DRender
 
@@ -51,8 +51,11 @@
 #include <Qt3DRender/private/qt3drender_global_p.h>
 #include <Qt3DRender/private/shader_p.h>
 
+#include <QtCore/qatomic.h>
+#include <QtCore/qbytearray.h>
 #include <QtCore/qhash.h>
 #include <QtCore/qmutex.h>
+#include <QtCore/qstring.h>
 #include <QtCore/qvector.h>
 
 QT_BEGIN_NAMESPACE
@@ -69,6 +72,21 @@ class tst_ShaderCache;
 class QT3DRENDERSHARED_PRIVATE_EXPORT ShaderCache
 {
 public:
+    struct ProgramBinary
+    {
+        uint format = 0;
+        QByteArray data;
+    };
+
+    struct Statistics
+    {
+        int hits = 0;
+        int misses = 0;
+        int diskHits = 0;
+        int diskMisses = 0;
+        int diskRejects = 0;
+    };
+
     ~ShaderCache();
 
     QOpenGLShaderProgram *getShaderProgramAndAddRef(ProgramDNA dna, Qt3DCore::QNodeId shaderPeerId, bool *wasPresent = nullptr);
@@ -79,9 +97,25 @@ public:
 
     // Only ever used from the OpenGL submission thread
     QOpenGLShaderProgram *getShaderProgramForDNA(ProgramDNA dna) const;
+    bool hasShaderProgram(ProgramDNA dna) const { return m_programHash.contains(dna); }
     QVector<Qt3DCore::QNodeId> shaderIdsForProgram(ProgramDNA dna) const;
 
+    // Optional on disk layer storing linked program binaries
+    void setDiskCachePath(const QString &path);
+    QString diskCachePath() const { return m_diskCachePath; }
+    bool isDiskCacheEnabled() const { return !m_diskCachePath.isEmpty(); }
+
+    bool loadProgramBinary(ProgramDNA dna, const QByteArray &driverKey,
+                           const QByteArray &sourceDigest, ProgramBinary *binary);
+    bool saveProgramBinary(ProgramDNA dna, const QByteArray &driverKey,
+                           const QByteArray &sourceDigest, const ProgramBinary &binary);
+    void rejectProgramBinary(ProgramDNA dna, const QByteArray &driverKey);
+
+    Statistics statistics() const;
+
 private:
+    QString programBinaryFilePath(ProgramDNA dna, const QByteArray &driverKey) const;
+
     // Only ever used from the OpenGL submission thread
     QHash<ProgramDNA, QOpenGLShaderProgram *> m_programHash;
 
@@ -90,6 +124,14 @@ private:
     QVector<ProgramDNA> m_pendingRemoval;
     QMutex m_refsMutex;
 
+    QString m_diskCachePath;
+
+    QAtomicInt m_hits;
+    QAtomicInt m_misses;
+    QAtomicInt m_diskHits;
+    QAtomicInt m_diskMisses;
+    QAtomicInt m_diskRejects;
+
 #if defined(QT_BUILD_INTERNAL)
     friend class tst_ShaderCache;
 #endif
@@ -95,6 +95,7 @@ void Technique::initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &ch
     m_parameterPack.setParameters(data.parameterIds);
     m_renderPasses = data.renderPassIds;
     m_nodeManager->techniqueManager()->addDirtyTechnique(peerId());
+    updateRevision();
 }
 
 void Technique::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
@@ -149,6 +150,7 @@ void Technique::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
     default:
         break;
     }
+    updateRevision();
     BackendNode::sceneChangeEvent(e);
 }
 
@@ -190,6 +192,8 @@ bool Technique::isCompatibleWithRenderer() const
 
 void Technique::setCompatibleWithRenderer(bool compatible)
 {
+    if (compatible != m_isCompatibleWithRenderer)
+        updateRevision();
     m_isCompatibleWithRenderer = compatible;
 }
 
@@ -81,6 +81,9 @@
 #include <QWindow>
 #include <QOpenGLTexture>
 #include <QOpenGLDebugLogger>
+#include <QOpenGLExtraFunctions>
+#include <QCryptographicHash>
+#include <QVarLengthArray>
 
 QT_BEGIN_NAMESPACE
 
@@ -92,6 +95,38 @@ QT_BEGIN_NAMESPACE
 #define GL_DRAW_FRAMEBUFFER 0x8CA9
 #endif
 
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+#ifndef GL_TESS_CONTROL_SHADER
+#define GL_TESS_CONTROL_SHADER 0x8E88
+#endif
+
+#ifndef GL_TESS_EVALUATION_SHADER
+#define GL_TESS_EVALUATION_SHADER 0x8E87
+#endif
+
+#ifndef GL_GEOMETRY_SHADER
+#define GL_GEOMETRY_SHADER 0x8DD9
+#endif
+
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#endif
+
 namespace {
 
 QOpenGLShader::ShaderType shaderType(Qt3DRender::QShaderProgram::ShaderType type)
@@ -119,6 +154,56 @@ void logOpenGLDebugMessage(const QOpenGLDebugMessage &debugMessage)
     qDebug() << "OpenGL debug message:" << debugMessage;
 }
 
+// Identifies the sources a program binary was linked from, the ProgramDNA
+// alone being a 32 bit hash
+QByteArray programSourceDigest(const ShaderProgramSource &source)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (const QByteArray &code : source.shaderCode) {
+        hash.addData(code);
+        hash.addData("\0", 1);
+    }
+
+    QStringList outputNames = source.fragOutputs.keys();
+    outputNames.sort();
+    for (const QString &name : qAsConst(outputNames)) {
+        hash.addData(name.toUtf8());
+        hash.addData(QByteArray::number(source.fragOutputs.value(name)));
+    }
+    return hash.result();
+}
+
+GLenum glShaderType(QShaderProgram::ShaderType type)
+{
+    switch (type) {
+    case QShaderProgram::Vertex: return GL_VERTEX_SHADER;
+    case QShaderProgram::TessellationControl: return GL_TESS_CONTROL_SHADER;
+    case QShaderProgram::TessellationEvaluation: return GL_TESS_EVALUATION_SHADER;
+    case QShaderProgram::Geometry: return GL_GEOMETRY_SHADER;
+    case QShaderProgram::Fragment: return GL_FRAGMENT_SHADER;
+    case QShaderProgram::Compute: return GL_COMPUTE_SHADER;
+    default: Q_UNREACHABLE();
+    }
+}
+
+// QOpenGLShader defines the precision qualifiers away on desktop OpenGL,
+// shaders compiled without it need the same treatment
+QByteArray withPrecisionQualifierDefines(const QByteArray &code)
+{
+    static const QByteArray qualifierDefines = QByteArrayLiteral("#define lowp\n#define mediump\n#define highp\n");
+
+    QByteArray result = code;
+    int insertPosition = 0;
+    const int versionPosition = code.indexOf("#version");
+    if (versionPosition >= 0 && code.left(versionPosition).trimmed().isEmpty()) {
+        const int lineEnd = code.indexOf('\n', versionPosition);
+        if (lineEnd < 0)
+            result.append('\n');
+        insertPosition = lineEnd >= 0 ? lineEnd + 1 : result.size();
+    }
+    return result.insert(insertPosition, qualifierDefines);
+}
+
 } // anonymous
 
 GraphicsContext::GraphicsContext()
@@ -129,6 +214,10 @@ GraphicsContext::GraphicsContext()
     , m_gl(nullptr)
     , m_glHelper(nullptr)
     , m_shaderCache(nullptr)
+    , m_programBinarySupportResolved(false)
+    , m_supportsProgramBinary(false)
+    , m_parallelShaderCompileSupportResolved(false)
+    , m_supportsParallelShaderCompile(false)
     , m_debugLogger(nullptr)
 {
 }
@@ -217,20 +306,51 @@ void GraphicsContext::doneCurrent()
     m_glHelper = nullptr;
 }
 
+ShaderProgramSource GraphicsContext::shaderProgramSource(Shader *shaderNode)
+{
+    ShaderProgramSource source;
+    source.dna = shaderNode->dna();
+    source.shaderCode = shaderNode->shaderCode();
+    source.fragOutputs = shaderNode->fragOutputs();
+    return source;
+}
+
 // Called by GL Command Thread
 QOpenGLShaderProgram *GraphicsContext::createShaderProgram(Shader *shaderNode)
 {
+    QString logs;
+    QOpenGLShaderProgram *shaderProgram = buildShaderProgram(shaderProgramSource(shaderNode), &logs);
+    shaderNode->setLog(logs);
+    shaderNode->setStatus(shaderProgram != nullptr ? QShaderProgram::Ready : QShaderProgram::Error);
+    return shaderProgram;
+}
+
+// Called by GL Command Thread or by the compile thread of the AsyncShaderCompiler
+QOpenGLShaderProgram *GraphicsContext::buildShaderProgram(const ShaderProgramSource &source, QString *log)
+{
+    Q_ASSERT(log);
     QScopedPointer<QOpenGLShaderProgram> shaderProgram(new QOpenGLShaderProgram);
 
+    const bool useProgramBinaryCache = m_shaderCache->isDiskCacheEnabled() && supportsProgramBinary();
+    QByteArray sourceDigest;
+    if (useProgramBinaryCache) {
+        sourceDigest = programSourceDigest(source);
+        if (loadProgramBinary(source.dna, sourceDigest, shaderProgram.data())) {
+            log->clear();
+            return shaderProgram.take();
+        }
+        // Start from a clean program object if the driver refused the binary
+        shaderProgram.reset(new QOpenGLShaderProgram);
+    }
+
     // Compile shaders
-    const auto shaderCode = shaderNode->shaderCode();
     QString logs;
     for (int i = QShaderProgram::Vertex; i <= QShaderProgram::Compute; ++i) {
         const QShaderProgram::ShaderType type = static_cast<const QShaderProgram::ShaderType>(i);
-        if (!shaderCode.at(i).isEmpty()) {
+        if (!source.shaderCode.at(i).isEmpty()) {
             // Note: logs only return the error but not all the shader code
             // we could append it
-            if (!shaderProgram->addCacheableShaderFromSourceCode(shaderType(type), shaderCode.at(i)))
+            if (!shaderProgram->addCacheableShaderFromSourceCode(shaderType(type), source.shaderCode.at(i)))
                 logs += shaderProgram->log();
         }
     }
@@ -238,20 +358,218 @@ QOpenGLShaderProgram *GraphicsContext::createShaderProgram(Shader *shaderNode)
     // Call glBindFragDataLocation and link the program
     // Since we are sharing shaders in the backend, we assume that if using custom
     // fragOutputs, they should all be the same for a given shader
-    bindFragOutputs(shaderProgram->programId(), shaderNode->fragOutputs());
+    bindFragOutputs(shaderProgram->programId(), source.fragOutputs);
+
+    if (useProgramBinaryCache)
+        m_gl->extraFunctions()->glProgramParameteri(shaderProgram->programId(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 
     const bool linkSucceeded = shaderProgram->link();
     logs += shaderProgram->log();
-    shaderNode->setLog(logs);
-    shaderNode->setStatus(linkSucceeded ? QShaderProgram::Ready : QShaderProgram::Error);
+    *log = logs;
 
     if (!linkSucceeded)
         return nullptr;
 
+    if (useProgramBinaryCache)
+        saveProgramBinary(source.dna, sourceDigest, shaderProgram.data());
+
     // take from scoped-pointer so it doesn't get deleted
     return shaderProgram.take();
 }
 
+bool GraphicsContext::supportsParallelShaderCompile()
+{
+    if (m_parallelShaderCompileSupportResolved)
+        return m_supportsParallelShaderCompile;
+
+    m_parallelShaderCompileSupportResolved = true;
+    const bool hasKHRExtension = m_gl->hasExtension(QByteArrayLiteral("GL_KHR_parallel_shader_compile"));
+    const bool hasARBExtension = m_gl->hasExtension(QByteArrayLiteral("GL_ARB_parallel_shader_compile"));
+    m_supportsParallelShaderCompile = hasKHRExtension || hasARBExtension;
+
+    if (m_supportsParallelShaderCompile) {
+        // Let the driver pick how many threads it uses
+        typedef void (QOPENGLF_APIENTRYP MaxShaderCompilerThreadsProc)(GLuint count);
+        const MaxShaderCompilerThreadsProc maxShaderCompilerThreads = reinterpret_cast<MaxShaderCompilerThreadsProc>(
+                    m_gl->getProcAddress(hasKHRExtension ? "glMaxShaderCompilerThreadsKHR" : "glMaxShaderCompilerThreadsARB"));
+        if (maxShaderCompilerThreads != nullptr)
+            maxShaderCompilerThreads(0xFFFFFFFF);
+    }
+
+    qCDebug(Shaders) << "Parallel shader compile supported =" << m_supportsParallelShaderCompile;
+    return m_supportsParallelShaderCompile;
+}
+
+// Called by the submission thread, only when supportsParallelShaderCompile()
+// Issues the compile and link of the program without waiting on their
+// completion, finishShaderProgramBuild must be called once
+// isShaderProgramBuildComplete returns true
+QOpenGLShaderProgram *GraphicsContext::startShaderProgramBuild(const ShaderProgramSource &source)
+{
+    QScopedPointer<QOpenGLShaderProgram> shaderProgram(new QOpenGLShaderProgram);
+
+    if (m_shaderCache->isDiskCacheEnabled() && supportsProgramBinary()) {
+        if (loadProgramBinary(source.dna, programSourceDigest(source), shaderProgram.data()))
+            return shaderProgram.take();
+        shaderProgram.reset(new QOpenGLShaderProgram);
+    }
+
+    // QOpenGLShader queries the compile status right away, which would block
+    // until the driver is done. The shaders are created directly instead and
+    // QOpenGLShaderProgram::link() only checks the status of the linked program
+    QOpenGLFunctions *f = m_gl->functions();
+    const GLuint programId = shaderProgram->programId();
+    for (int i = QShaderProgram::Vertex; i <= QShaderProgram::Compute; ++i) {
+        const QShaderProgram::ShaderType type = static_cast<const QShaderProgram::ShaderType>(i);
+        if (source.shaderCode.at(i).isEmpty())
+            continue;
+        const QByteArray code = m_gl->isOpenGLES()
+                ? source.shaderCode.at(i)
+                : withPrecisionQualifierDefines(source.shaderCode.at(i));
+        const char *codeData = code.constData();
+        const GLuint shaderId = f->glCreateShader(glShaderType(type));
+        f->glShaderSource(shaderId, 1, &codeData, nullptr);
+        f->glCompileShader(shaderId);
+        f->glAttachShader(programId, shaderId);
+        // Only released once detached from the program
+        f->glDeleteShader(shaderId);
+    }
+
+    bindFragOutputs(programId, source.fragOutputs);
+    if (m_shaderCache->isDiskCacheEnabled() && supportsProgramBinary())
+        m_gl->extraFunctions()->glProgramParameteri(programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    f->glLinkProgram(programId);
+
+    return shaderProgram.take();
+}
+
+bool GraphicsContext::isShaderProgramBuildComplete(QOpenGLShaderProgram *shaderProgram)
+{
+    GLint completed = GL_FALSE;
+    m_gl->functions()->glGetProgramiv(shaderProgram->programId(), GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
+}
+
+// Takes ownership of shaderProgram, returns nullptr if the build failed
+QOpenGLShaderProgram *GraphicsContext::finishShaderProgramBuild(const ShaderProgramSource &source,
+                                                                QOpenGLShaderProgram *shaderProgram,
+                                                                QString *log)
+{
+    Q_ASSERT(log);
+    QScopedPointer<QOpenGLShaderProgram> program(shaderProgram);
+    QOpenGLFunctions *f = m_gl->functions();
+    const GLuint programId = program->programId();
+
+    GLint shaderCount = 0;
+    f->glGetProgramiv(programId, GL_ATTACHED_SHADERS, &shaderCount);
+    QVarLengthArray<GLuint, QShaderProgram::Compute + 1> shaderIds(shaderCount);
+    if (shaderCount > 0)
+        f->glGetAttachedShaders(programId, shaderCount, nullptr, shaderIds.data());
+
+    // Program binaries have no shader attached
+    QString logs;
+    const bool linkSucceeded = program->link();
+    if (!linkSucceeded) {
+        for (const GLuint shaderId : qAsConst(shaderIds)) {
+            GLint logLength = 0;
+            f->glGetShaderiv(shaderId, GL_INFO_LOG_LENGTH, &logLength);
+            if (logLength > 1) {
+                QByteArray shaderLog(logLength, '\0');
+                f->glGetShaderInfoLog(shaderId, logLength, nullptr, shaderLog.data());
+                logs += QString::fromLocal8Bit(shaderLog.constData());
+            }
+        }
+    }
+    logs += program->log();
+    *log = logs;
+
+    for (const GLuint shaderId : qAsConst(shaderIds))
+        f->glDetachShader(programId, shaderId);
+
+    if (!linkSucceeded)
+        return nullptr;
+
+    if (shaderCount > 0 && m_shaderCache->isDiskCacheEnabled() && supportsProgramBinary())
+        saveProgramBinary(source.dna, programSourceDigest(source), program.data());
+
+    return program.take();
+}
+
+// Called by GL Command Thread
+bool GraphicsContext::supportsProgramBinary()
+{
+    if (m_programBinarySupportResolved)
+        return m_supportsProgramBinary;
+
+    m_programBinarySupportResolved = true;
+    const QPair<int, int> version = m_gl->format().version();
+    if (m_gl->isOpenGLES())
+        m_supportsProgramBinary = version >= qMakePair(3, 0);
+    else
+        m_supportsProgramBinary = version >= qMakePair(4, 1)
+                || m_gl->hasExtension(QByteArrayLiteral("GL_ARB_get_program_binary"));
+
+    if (m_supportsProgramBinary) {
+        GLint formatCount = 0;
+        m_gl->functions()->glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        m_supportsProgramBinary = formatCount > 0;
+    }
+
+    if (m_supportsProgramBinary) {
+        // Binaries are only valid for the exact driver they were produced by
+        QOpenGLFunctions *f = m_gl->functions();
+        m_programBinaryDriverKey = QByteArray(reinterpret_cast<const char *>(f->glGetString(GL_VENDOR)))
+                + '\n' + QByteArray(reinterpret_cast<const char *>(f->glGetString(GL_RENDERER)))
+                + '\n' + QByteArray(reinterpret_cast<const char *>(f->glGetString(GL_VERSION)))
+                + '\n' + QByteArray(qVersion());
+    }
+
+    qCDebug(Shaders) << "Program binary cache supported =" << m_supportsProgramBinary;
+    return m_supportsProgramBinary;
+}
+
+// Called by GL Command Thread
+bool GraphicsContext::loadProgramBinary(ProgramDNA dna, const QByteArray &sourceDigest,
+                                        QOpenGLShaderProgram *shaderProgram)
+{
+    ShaderCache::ProgramBinary binary;
+    if (!m_shaderCache->loadProgramBinary(dna, m_programBinaryDriverKey, sourceDigest, &binary))
+        return false;
+
+    m_gl->extraFunctions()->glProgramBinary(shaderProgram->programId(), binary.format,
+                                            binary.data.constData(), binary.data.size());
+
+    // No shader was added to the program, link() only checks the link status
+    // resulting from glProgramBinary
+    if (shaderProgram->link())
+        return true;
+
+    qCDebug(Shaders) << "Driver rejected the cached binary of program" << dna;
+    m_shaderCache->rejectProgramBinary(dna, m_programBinaryDriverKey);
+    return false;
+}
+
+// Called by GL Command Thread
+void GraphicsContext::saveProgramBinary(ProgramDNA dna, const QByteArray &sourceDigest,
+                                        QOpenGLShaderProgram *shaderProgram)
+{
+    const GLuint programId = shaderProgram->programId();
+    GLint length = 0;
+    m_gl->functions()->glGetProgramiv(programId, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    ShaderCache::ProgramBinary binary;
+    binary.data.resize(length);
+    GLenum format = 0;
+    m_gl->extraFunctions()->glGetProgramBinary(programId, length, &length, &format, binary.data.data());
+    binary.data.resize(length);
+    binary.format = format;
+
+    if (!m_shaderCache->saveProgramBinary(dna, m_programBinaryDriverKey, sourceDigest, binary))
+        qCDebug(Shaders) << "Failed to store the binary of program" << dna;
+}
+
 // Called by GL Command Thread (can't use global glHelpers)
 // That assumes that the shaderProgram in Shader stays the same
 void GraphicsContext::introspectShaderInterface(Shader *shader, QOpenGLShaderProgram *shaderProgram)
@@ -279,6 +597,20 @@ void GraphicsContext::loadShader(Shader *shader, ShaderManager *manager)
         m_shaderCache->insert(shader->dna(), shader->peerId(), shaderProgram);
     }
 
+    setUpShaderInterface(shader, shaderProgram, manager);
+}
+
+// Used when shaderProgram was built outside of the context (e.g asynchronously)
+// and isn't in the cache yet. Looking it up first would count a cache hit.
+void GraphicsContext::loadShader(Shader *shader, ShaderManager *manager, QOpenGLShaderProgram *shaderProgram)
+{
+    // Store in cache (even when failed and shaderProgram is null)
+    m_shaderCache->insert(shader->dna(), shader->peerId(), shaderProgram);
+    setUpShaderInterface(shader, shaderProgram, manager);
+}
+
+void GraphicsContext::setUpShaderInterface(Shader *shader, QOpenGLShaderProgram *shaderProgram, ShaderManager *manager)
+{
     // Ensure the Shader node knows about the program interface
     if (Q_LIKELY(shaderProgram != nullptr) && !shader->isLoaded()) {
 
@@ -91,6 +91,15 @@ class ShaderManager;
 
 typedef QPair<QString, int> NamedUniformLocation;
 
+// Sources of a shader program, copied from the Shader backend node so that
+// the program can be built while the aspect thread runs
+struct ShaderProgramSource
+{
+    ProgramDNA dna = 0;
+    QVector<QByteArray> shaderCode;
+    QHash<QString, int> fragOutputs;
+};
+
 class Q_AUTOTEST_EXPORT GraphicsContext
 {
 public:
@@ -108,10 +117,20 @@ public:
     bool isInitialized() const;
 
     // Shaders
+    static ShaderProgramSource shaderProgramSource(Shader *shaderNode);
     QOpenGLShaderProgram *createShaderProgram(Shader *shaderNode);
+    QOpenGLShaderProgram *buildShaderProgram(const ShaderProgramSource &source, QString *log);
+    bool supportsParallelShaderCompile();
+    QOpenGLShaderProgram *startShaderProgramBuild(const ShaderProgramSource &source);
+    bool isShaderProgramBuildComplete(QOpenGLShaderProgram *shaderProgram);
+    QOpenGLShaderProgram *finishShaderProgramBuild(const ShaderProgramSource &source,
+                                                   QOpenGLShaderProgram *shaderProgram,
+                                                   QString *log);
     void introspectShaderInterface(Shader *shader, QOpenGLShaderProgram *shaderProgram);
     void loadShader(Shader* shader, ShaderManager *manager);
+    void loadShader(Shader *shader, ShaderManager *manager, QOpenGLShaderProgram *shaderProgram);
     void removeShaderProgramReference(Shader *shaderNode);
+    bool supportsProgramBinary();
 
     GLuint defaultFBO() const { return m_defaultFBO; }
 
@@ -189,8 +208,17 @@ public:
     QHash<QSurface *, GraphicsHelperInterface*> m_glHelpers;
     GraphicsApiFilterData m_contextInfo;
     ShaderCache *m_shaderCache;
+    bool m_programBinarySupportResolved;
+    bool m_supportsProgramBinary;
+    QByteArray m_programBinaryDriverKey;
+    bool m_parallelShaderCompileSupportResolved;
+    bool m_supportsParallelShaderCompile;
     QScopedPointer<QOpenGLDebugLogger> m_debugLogger;
 
+    bool loadProgramBinary(ProgramDNA dna, const QByteArray &sourceDigest, QOpenGLShaderProgram *shaderProgram);
+    void saveProgramBinary(ProgramDNA dna, const QByteArray &sourceDigest, QOpenGLShaderProgram *shaderProgram);
+    void setUpShaderInterface(Shader *shader, QOpenGLShaderProgram *shaderProgram, ShaderManager *manager);
+
     friend class OpenGLVertexArrayObject;
     OpenGLVertexArrayObject *m_currentVAO;
 
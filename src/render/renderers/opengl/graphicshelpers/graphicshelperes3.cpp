@@ -307,6 +307,7 @@ bool GraphicsHelperES3::supportsFeature(GraphicsHelperInterface::Feature feature
     case BlitFramebuffer:
     case UniformBufferObject:
     case MapBuffer:
+    case InstancedArrays:
         return true;
     default:
         return false;
@@ -477,6 +477,7 @@ bool GraphicsHelperGL3_3::supportsFeature(GraphicsHelperInterface::Feature featu
     case TextureDimensionRetrieval:
     case BindableFragmentOutputs:
     case BlitFramebuffer:
+    case InstancedArrays:
         return true;
     case Tessellation:
         return !m_tessFuncs.isNull();
@@ -746,6 +746,7 @@ bool GraphicsHelperGL4::supportsFeature(GraphicsHelperInterface::Feature feature
     case DrawBuffersBlend:
     case BlitFramebuffer:
     case IndirectDrawing:
+    case InstancedArrays:
         return true;
     default:
         return false;
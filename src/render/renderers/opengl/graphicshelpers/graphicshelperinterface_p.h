@@ -82,7 +82,8 @@ public:
         DrawBuffersBlend,
         BlitFramebuffer,
         IndirectDrawing,
-        MapBuffer
+        MapBuffer,
+        InstancedArrays
     };
 
     enum FBOBindMode {
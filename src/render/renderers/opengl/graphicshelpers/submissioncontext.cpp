@@ -390,6 +390,7 @@ SubmissionContext::SubmissionContext()
     , m_material(nullptr)
     , m_activeFBO(0)
     , m_boundArrayBuffer(nullptr)
+    , m_instanceModelMatricesDirty(false)
     , m_stateSet(nullptr)
     , m_renderer(nullptr)
     , m_uboTempArray(QByteArray(1024, 0))
@@ -795,6 +796,9 @@ void SubmissionContext::releaseOpenGL()
 {
     m_shaderCache->clear();
     m_renderBufferHash.clear();
+    // The buffer goes away with the context
+    m_instanceBuffer = GLBuffer();
+    m_instanceModelMatricesDirty = !m_instanceModelMatrices.isEmpty();
 
     // Stop and destroy the OpenGL logger
     if (m_debugLogger) {
@@ -1423,6 +1427,52 @@ void SubmissionContext::specifyAttribute(const Attribute *attribute,
     }
 }
 
+bool SubmissionContext::supportsInstancedArrays() const
+{
+    return m_glHelper != nullptr && m_glHelper->supportsFeature(GraphicsHelperInterface::InstancedArrays);
+}
+
+// Column major 4x4 matrices of all the instanced commands of a frame, they
+// are uploaded all at once by the first call to specifyInstanceModelMatrices
+void SubmissionContext::setInstanceModelMatrices(const QVector<float> &matrices)
+{
+    m_instanceModelMatrices = matrices;
+    m_instanceModelMatricesDirty = !matrices.isEmpty();
+}
+
+// Note: needs to be called while VAO is bound
+// Binds the matrices starting at byteOffset in the instance buffer of the
+// frame to the 4 consecutive locations of a mat4 attribute
+void SubmissionContext::specifyInstanceModelMatrices(int location, int byteOffset, int divisor)
+{
+    if (!m_instanceBuffer.isCreated())
+        m_instanceBuffer.create(this);
+
+    bindGLBuffer(&m_instanceBuffer, GLBuffer::ArrayBuffer);
+    if (m_instanceModelMatricesDirty) {
+        // Reallocating orphans the storage the GPU may still be reading from,
+        // once per frame rather than once per command
+        m_instanceBuffer.allocate(this,
+                                  m_instanceModelMatrices.constData(),
+                                  uint(m_instanceModelMatrices.size() * sizeof(float)),
+                                  true);
+        m_instanceModelMatricesDirty = false;
+    }
+
+    const int columnByteSize = 4 * sizeof(float);
+    for (int i = 0; i < 4; ++i) {
+        m_glHelper->enableVertexAttributeArray(location + i);
+        m_glHelper->vertexAttributePointer(GL_FLOAT_MAT4,
+                                           location + i,
+                                           4,
+                                           GL_FLOAT,
+                                           GL_FALSE,
+                                           4 * columnByteSize,
+                                           reinterpret_cast<const void *>(qintptr(byteOffset + i * columnByteSize)));
+        m_glHelper->vertexAttribDivisor(location + i, divisor);
+    }
+}
+
 void SubmissionContext::specifyIndices(Buffer *buffer)
 {
     GLBuffer *buf = glBufferForRenderBuffer(buffer, GLBuffer::IndexBuffer);
@@ -135,6 +135,9 @@ public:
                           Buffer *buffer,
                           const ShaderAttribute *attributeDescription);
     void specifyIndices(Buffer *buffer);
+    bool supportsInstancedArrays() const;
+    void setInstanceModelMatrices(const QVector<float> &matrices);
+    void specifyInstanceModelMatrices(int location, int byteOffset, int divisor);
 
     // Buffer
     void updateBuffer(Buffer *buffer);
@@ -219,6 +222,9 @@ private:
     GLuint m_activeFBO;
 
     GLBuffer *m_boundArrayBuffer;
+    GLBuffer m_instanceBuffer;
+    QVector<float> m_instanceModelMatrices;
+    bool m_instanceModelMatricesDirty;
     RenderStateSet* m_stateSet;
     Renderer *m_renderer;
     QByteArray m_uboTempArray;
@@ -42,6 +42,7 @@
 #include <Qt3DRender/private/managers_p.h>
 #include <Qt3DRender/private/renderpassfilternode_p.h>
 #include <Qt3DRender/private/techniquefilternode_p.h>
+#include <Qt3DRender/private/techniquemanager_p.h>
 #include <Qt3DRender/private/job_common_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -55,6 +56,56 @@ namespace {
 int materialParameterGathererCounter = 0;
 const int likelyNumberOfParameters = 24;
 
+template<typename Manager>
+uint maxRevision(uint revision, Manager *manager, const QVector<Qt3DCore::QNodeId> &ids)
+{
+    for (const Qt3DCore::QNodeId id : ids) {
+        const auto node = manager->lookupResource(id);
+        if (node != nullptr)
+            revision = qMax(revision, node->revision());
+    }
+    return revision;
+}
+
+// Latest revision of the nodes the parameters of a material are gathered from
+uint materialRevision(NodeManagers *manager, Material *material)
+{
+    uint revision = maxRevision(material->revision(), manager->parameterManager(), material->parameters());
+
+    Effect *effect = manager->effectManager()->lookupResource(material->effect());
+    if (effect == nullptr)
+        return revision;
+    revision = maxRevision(qMax(revision, effect->revision()), manager->parameterManager(), effect->parameters());
+
+    const auto techniqueIds = effect->techniques();
+    for (const Qt3DCore::QNodeId techniqueId : techniqueIds) {
+        Technique *technique = manager->techniqueManager()->lookupResource(techniqueId);
+        if (technique == nullptr)
+            continue;
+        revision = maxRevision(qMax(revision, technique->revision()), manager->parameterManager(), technique->parameters());
+        revision = maxRevision(revision, manager->filterKeyManager(), technique->filterKeys());
+
+        const auto passIds = technique->renderPasses();
+        for (const Qt3DCore::QNodeId passId : passIds) {
+            RenderPass *pass = manager->renderPassManager()->lookupResource(passId);
+            if (pass == nullptr)
+                continue;
+            revision = maxRevision(qMax(revision, pass->revision()), manager->parameterManager(), pass->parameters());
+            revision = maxRevision(revision, manager->filterKeyManager(), pass->filterKeys());
+        }
+    }
+    return revision;
+}
+
+template<typename FilterNode>
+uint filterRevision(NodeManagers *manager, FilterNode *filter)
+{
+    if (filter == nullptr)
+        return 0;
+    const uint revision = maxRevision(filter->revision(), manager->parameterManager(), filter->parameters());
+    return maxRevision(revision, manager->filterKeyManager(), filter->filters());
+}
+
 } // anonymous
 
 MaterialParameterGathererJob::MaterialParameterGathererJob()
@@ -70,17 +121,33 @@ MaterialParameterGathererJob::MaterialParameterGathererJob()
 
 // Parameters from Material/Effect/Technique
 
-// Note: we could maybe improve that by having a smart update when we detect
-// that a parameter value has changed. That might require way more book keeping
-// which might make this solution a bit too complex
-
-// The fact that this can now be performed in parallel should already provide a big
-// improvement
+// Parameter values are looked up at RenderCommand building time, only changes
+// to the material graph require regathering. Every node of that graph carries a
+// revision, materials whose latest revision didn't change since they were last
+// gathered for the same filters are skipped and keep their previous parameters
 void MaterialParameterGathererJob::run()
 {
+    const uint filtersRevision = qMax(filterRevision(m_manager, m_techniqueFilter),
+                                      filterRevision(m_manager, m_renderPassFilter));
+    m_revisions.techniqueFilterId = m_techniqueFilter ? m_techniqueFilter->peerId() : Qt3DCore::QNodeId();
+    m_revisions.renderPassFilterId = m_renderPassFilter ? m_renderPassFilter->peerId() : Qt3DCore::QNodeId();
+    const bool sameFilters = m_revisions.techniqueFilterId == m_previousRevisions.techniqueFilterId &&
+            m_revisions.renderPassFilterId == m_previousRevisions.renderPassFilterId;
+
+    m_revisions.materials.reserve(m_handles.size());
     for (const HMaterial &materialHandle : qAsConst(m_handles)) {
         Material *material = m_manager->materialManager()->data(materialHandle);
 
+        const uint revision = qMax(materialRevision(m_manager, material), filtersRevision);
+        m_revisions.materials.insert(material->peerId(), revision);
+        if (sameFilters) {
+            const auto it = m_previousRevisions.materials.constFind(material->peerId());
+            if (it != m_previousRevisions.materials.cend() && it.value() == revision) {
+                m_unchangedMaterials.push_back(material->peerId());
+                continue;
+            }
+        }
+
         if (Q_UNLIKELY(!material->isEnabled()))
             continue;
 
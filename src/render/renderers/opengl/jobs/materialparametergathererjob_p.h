@@ -80,6 +80,9 @@ public:
     inline void setRenderPassFilter(RenderPassFilter *renderPassFilter) Q_DECL_NOTHROW { m_renderPassFilter = renderPassFilter; }
     inline const QHash<Qt3DCore::QNodeId, QVector<RenderPassParameterData>> &materialToPassAndParameter() Q_DECL_NOTHROW { return m_parameters; }
     inline void setHandles(const QVector<HMaterial> &handles) Q_DECL_NOTHROW { m_handles = handles; }
+    inline void setPreviousRevisions(const MaterialParameterGathererRevisions &revisions) Q_DECL_NOTHROW { m_previousRevisions = revisions; }
+    inline const MaterialParameterGathererRevisions &revisions() const Q_DECL_NOTHROW { return m_revisions; }
+    inline const QVector<Qt3DCore::QNodeId> &unchangedMaterials() const Q_DECL_NOTHROW { return m_unchangedMaterials; }
 
     inline TechniqueFilter *techniqueFilter() const Q_DECL_NOTHROW { return m_techniqueFilter; }
     inline RenderPassFilter *renderPassFilter() const Q_DECL_NOTHROW { return m_renderPassFilter; }
@@ -94,6 +97,12 @@ private:
     // Material id to array of RenderPasse with parameters
     MaterialParameterGathererData m_parameters;
     QVector<HMaterial> m_handles;
+
+    // Materials whose revision matches the one they were last gathered at
+    // keep their previous parameters and are not gathered again
+    MaterialParameterGathererRevisions m_previousRevisions;
+    MaterialParameterGathererRevisions m_revisions;
+    QVector<Qt3DCore::QNodeId> m_unchangedMaterials;
 };
 
 typedef QSharedPointer<MaterialParameterGathererJob> MaterialParameterGathererJobPtr;
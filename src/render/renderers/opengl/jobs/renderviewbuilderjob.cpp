@@ -54,11 +54,26 @@ int renderViewInstanceCounter = 0;
 
 RenderViewBuilderJob::RenderViewBuilderJob()
     : Qt3DCore::QAspectJob(),
-      m_renderView(nullptr)
+      m_renderView(nullptr),
+      m_commandArena(nullptr)
 {
     SET_JOB_RUN_STAT_TYPE(this, JobTypes::RenderViewBuilder, renderViewInstanceCounter++);
 }
 
+RenderViewBuilderJob::~RenderViewBuilderJob()
+{
+    // The commands were never handed over to the RenderView
+    if (m_commandArena != nullptr)
+        m_renderer->releaseCommandArenas({ m_commandArena });
+}
+
+RenderCommandArena *RenderViewBuilderJob::takeCommandArena() Q_DECL_NOTHROW
+{
+    RenderCommandArena *arena = m_commandArena;
+    m_commandArena = nullptr;
+    return arena;
+}
+
 void RenderViewBuilderJob::run()
 {
     // Build RenderCommand should perform the culling as we have no way to determine
@@ -68,10 +83,14 @@ void RenderViewBuilderJob::run()
         gatherLightsTime = timer.nsecsElapsed();
         timer.restart();
 #endif
-    if (!m_renderView->isCompute())
-        m_commands = m_renderView->buildDrawRenderCommands(m_renderables);
-    else
-        m_commands = m_renderView->buildComputeRenderCommands(m_renderables);
+    m_commandArena = m_renderer->acquireCommandArena();
+    if (!m_renderView->isCompute()) {
+        m_commands = m_renderView->buildDrawRenderCommands(m_renderables, m_commandArena,
+                                                           &m_retainedCommands, &m_rebuiltCommands);
+        // Release our reference so that the cache can be updated without a deep copy
+        m_retainedCommands = RetainedRenderCommands();
+    } else
+        m_commands = m_renderView->buildComputeRenderCommands(m_renderables, m_commandArena);
 #if defined(QT3D_RENDER_VIEW_JOB_TIMINGS)
         buildCommandsTime = timer.nsecsElapsed();
         timer.restart();
@@ -53,6 +53,7 @@
 
 #include <Qt3DCore/qaspectjob.h>
 #include <Qt3DRender/private/handle_types_p.h>
+#include <Qt3DRender/private/renderercache_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -63,17 +64,22 @@ namespace Render {
 class RenderView;
 class Renderer;
 class RenderCommand;
+class RenderCommandArena;
 
 class Q_AUTOTEST_EXPORT RenderViewBuilderJob : public Qt3DCore::QAspectJob
 {
 public:
     RenderViewBuilderJob();
+    ~RenderViewBuilderJob();
 
     inline void setRenderView(RenderView *rv) Q_DECL_NOTHROW { m_renderView = rv; }
     inline void setRenderer(Renderer *renderer) Q_DECL_NOTHROW { m_renderer = renderer; }
     inline void setIndex(int index) Q_DECL_NOTHROW { m_index = index; }
     inline void setRenderables(const QVector<Entity *> &renderables) Q_DECL_NOTHROW { m_renderables = renderables; }
     QVector<RenderCommand *> &commands() Q_DECL_NOTHROW { return m_commands; }
+    RenderCommandArena *takeCommandArena() Q_DECL_NOTHROW;
+    inline void setRetainedCommands(const RetainedRenderCommands &retainedCommands) Q_DECL_NOTHROW { m_retainedCommands = retainedCommands; }
+    RetainedRenderCommands &rebuiltCommands() Q_DECL_NOTHROW { return m_rebuiltCommands; }
 
     void run() final;
 
@@ -83,6 +89,9 @@ private:
     int m_index;
     QVector<Entity *> m_renderables;
     QVector<RenderCommand *> m_commands;
+    RenderCommandArena *m_commandArena;
+    RetainedRenderCommands m_retainedCommands;
+    RetainedRenderCommands m_rebuiltCommands;
 };
 
 typedef QSharedPointer<RenderViewBuilderJob> RenderViewBuilderJobPtr;
@@ -92,6 +92,7 @@ void RenderViewInitializerJob::run()
 
     // Populate the renderview's configuration from the framegraph
     setRenderViewConfigFromFrameGraphLeafNode(m_renderView, m_fgLeaf);
+    m_renderView->setAutomaticInstancing(m_renderer != nullptr && m_renderer->isAutomaticInstancingEnabled());
 #if defined(QT3D_RENDER_VIEW_JOB_TIMINGS)
     qint64 gatherStateTime = timer.nsecsElapsed();
     timer.restart();
@@ -130,6 +130,15 @@ QT3D_DECLARE_TYPEINFO_2(Qt3DRender, Render, RenderPassParameterData, Q_MOVABLE_T
 
 using MaterialParameterGathererData = QHash<Qt3DCore::QNodeId, QVector<RenderPassParameterData>>;
 
+// Revisions of the material graphs MaterialParameterGathererData was gathered
+// from, for the TechniqueFilter and RenderPassFilter of a given leaf node
+struct MaterialParameterGathererRevisions
+{
+    Qt3DCore::QNodeId techniqueFilterId;
+    Qt3DCore::QNodeId renderPassFilterId;
+    QHash<Qt3DCore::QNodeId, uint> materials;
+};
+
 Q_AUTOTEST_EXPORT void parametersFromMaterialEffectTechnique(ParameterInfoList *infoList,
                                                              ParameterManager *manager,
                                                              Material *material,
@@ -0,0 +1,161 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "asyncshadercompiler_p.h"
+#include <Qt3DRender/private/commandthread_p.h>
+#include <Qt3DRender/private/glcommands_p.h>
+#include <Qt3DRender/private/renderlogging_p.h>
+#include <Qt3DRender/private/shader_p.h>
+#include <QOpenGLShaderProgram>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+AsyncShaderCompiler::AsyncShaderCompiler(GraphicsContext *context, CommandThread *commandThread)
+    : m_context(context)
+    , m_commandThread(commandThread)
+    , m_mode(Unresolved)
+{
+    Q_ASSERT(m_context && m_commandThread);
+}
+
+AsyncShaderCompiler::~AsyncShaderCompiler()
+{
+    for (const Build &build : qAsConst(m_builds))
+        release(build);
+}
+
+// Starts building the program of shader unless a build is already
+// requested for its ProgramDNA
+void AsyncShaderCompiler::request(Shader *shader)
+{
+    const ProgramDNA dna = shader->dna();
+    if (m_builds.contains(dna))
+        return;
+
+    resolveMode();
+
+    Build build;
+    build.source = GraphicsContext::shaderProgramSource(shader);
+    if (m_mode == ParallelShaderCompile) {
+        build.shaderProgram = m_context->startShaderProgramBuild(build.source);
+    } else {
+        build.command = new CompileShaderCommand(build.source);
+        m_commandThread->enqueueCommand(build.command);
+    }
+    m_builds.insert(dna, build);
+}
+
+bool AsyncShaderCompiler::isCompleted(ProgramDNA dna)
+{
+    const auto it = m_builds.constFind(dna);
+    return it != m_builds.cend() && isCompleted(it.value());
+}
+
+// Only valid once isCompleted returns true for dna. Returns nullptr and the
+// errors in log if the build failed.
+QOpenGLShaderProgram *AsyncShaderCompiler::takeShaderProgram(ProgramDNA dna, QString *log)
+{
+    Q_ASSERT(isCompleted(dna));
+    const Build build = m_builds.take(dna);
+
+    if (build.command != nullptr) {
+        QOpenGLShaderProgram *shaderProgram = build.command->takeShaderProgram();
+        *log = build.command->log();
+        delete build.command;
+        return shaderProgram;
+    }
+    return m_context->finishShaderProgramBuild(build.source, build.shaderProgram, log);
+}
+
+// Drops the builds no Shader is waiting for anymore, which happens when their
+// code changes before the build completes
+void AsyncShaderCompiler::releaseUnrequested(const QSet<ProgramDNA> &requestedPrograms)
+{
+    auto it = m_builds.begin();
+    while (it != m_builds.end()) {
+        // Programs built by the CommandThread can only be released once
+        // their command has been executed
+        if (!requestedPrograms.contains(it.key())
+                && (it->command == nullptr || it->command->isCompleted())) {
+            release(it.value());
+            it = m_builds.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void AsyncShaderCompiler::resolveMode()
+{
+    if (m_mode != Unresolved)
+        return;
+    m_mode = m_context->supportsParallelShaderCompile() ? ParallelShaderCompile : CompileThread;
+    qCDebug(Shaders) << "Shader programs are built asynchronously"
+                     << (m_mode == ParallelShaderCompile ? "by the driver" : "on the command thread");
+}
+
+bool AsyncShaderCompiler::isCompleted(const Build &build)
+{
+    if (build.command != nullptr)
+        return build.command->isCompleted();
+    return m_context->isShaderProgramBuildComplete(build.shaderProgram);
+}
+
+void AsyncShaderCompiler::release(const Build &build)
+{
+    delete build.shaderProgram;
+
+    if (build.command != nullptr && !build.command->isCompleted()
+            && !m_commandThread->dequeueCommand(build.command)) {
+        // The CommandThread is executing it
+        m_commandThread->waitForCommand(build.command);
+    }
+    delete build.command;
+}
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
@@ -0,0 +1,123 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QT3DRENDER_RENDER_ASYNCSHADERCOMPILER_P_H
+#define QT3DRENDER_RENDER_ASYNCSHADERCOMPILER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <Qt3DRender/private/qt3drender_global_p.h>
+#include <Qt3DRender/private/graphicscontext_p.h>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+
+QT_BEGIN_NAMESPACE
+
+class QOpenGLShaderProgram;
+
+namespace Qt3DRender {
+
+namespace Render {
+
+class CommandThread;
+class CompileShaderCommand;
+class Shader;
+
+// Builds shader programs without blocking frame submission. The driver
+// compiles them in parallel when GL_KHR_parallel_shader_compile is available,
+// the CommandThread builds them with its shared context otherwise.
+// Builds are tracked per ProgramDNA.
+// Only ever used from the OpenGL submission thread
+class Q_AUTOTEST_EXPORT AsyncShaderCompiler
+{
+public:
+    enum Mode {
+        Unresolved,
+        ParallelShaderCompile,
+        CompileThread
+    };
+
+    AsyncShaderCompiler(GraphicsContext *context, CommandThread *commandThread);
+    ~AsyncShaderCompiler();
+
+    Mode mode() const { return m_mode; }
+
+    void request(Shader *shader);
+    bool isRequested(ProgramDNA dna) const { return m_builds.contains(dna); }
+    bool isCompleted(ProgramDNA dna);
+    QOpenGLShaderProgram *takeShaderProgram(ProgramDNA dna, QString *log);
+    void releaseUnrequested(const QSet<ProgramDNA> &requestedPrograms);
+
+    int pendingCount() const { return m_builds.size(); }
+
+private:
+    struct Build
+    {
+        ShaderProgramSource source;
+        QOpenGLShaderProgram *shaderProgram = nullptr; // ParallelShaderCompile
+        CompileShaderCommand *command = nullptr; // CompileThread
+    };
+
+    void resolveMode();
+    bool isCompleted(const Build &build);
+    void release(const Build &build);
+
+    GraphicsContext *m_context;
+    CommandThread *m_commandThread;
+    Mode m_mode;
+    QHash<ProgramDNA, Build> m_builds;
+};
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
+
+#endif // QT3DRENDER_RENDER_ASYNCSHADERCOMPILER_P_H
@@ -45,6 +45,7 @@
 #include <QOpenGLContext>
 #include <QOffscreenSurface>
 #include <QDebug>
+#include <QMutexLocker>
 
 QT_BEGIN_NAMESPACE
 
@@ -63,6 +64,7 @@ CommandThread::CommandThread(Renderer *renderer)
     , m_shaderCache(nullptr)
     , m_offsreenSurfaceHelper(nullptr)
     , m_currentCommand(nullptr)
+    , m_executingQueuedCommand(nullptr)
     , m_running(0)
 {
 }
@@ -125,6 +127,11 @@ void CommandThread::shutdown()
     m_commandRequestedSemaphore.acquire(m_commandRequestedSemaphore.available());
     m_commandExecutionSemaphore.acquire(m_commandExecutionSemaphore.available());
     m_localContext.reset();
+
+    // Queued commands which weren't executed are dropped, they remain owned
+    // by whoever enqueued them
+    QMutexLocker lock(&m_commandsMutex);
+    m_queuedCommands.clear();
 }
 
 // Any thread can call this, this is a blocking command
@@ -138,7 +145,10 @@ void CommandThread::executeCommand(GLCommand *command)
     m_blockingCallerMutex.lock();
 
     // Store command to be executed
-    m_currentCommand = command;
+    {
+        QMutexLocker lock(&m_commandsMutex);
+        m_currentCommand = command;
+    }
 
     // Allow thread to proceed and execute command
     m_commandRequestedSemaphore.release();
@@ -146,14 +156,44 @@ void CommandThread::executeCommand(GLCommand *command)
     // Wait for thread to be done
     m_commandExecutionSemaphore.acquire();
 
-    // Reset command
-    m_currentCommand = nullptr;
-
     // Unlock blocking semaphore so that other calls to executeCommand
     // can proceed
     m_blockingCallerMutex.unlock();
 }
 
+// Any thread can call this, the command is executed asynchronously after the
+// commands queued before it. The caller keeps ownership of the command and
+// must keep it alive until it has been executed or the thread shut down
+void CommandThread::enqueueCommand(GLCommand *command)
+{
+    if (!isRunning())
+        return;
+
+    {
+        QMutexLocker lock(&m_commandsMutex);
+        m_queuedCommands.push_back(command);
+    }
+
+    // Allow thread to proceed and execute command
+    m_commandRequestedSemaphore.release();
+}
+
+// Removes a command which hasn't started executing yet from the queue
+bool CommandThread::dequeueCommand(GLCommand *command)
+{
+    QMutexLocker lock(&m_commandsMutex);
+    return m_queuedCommands.removeOne(command);
+}
+
+// Blocks until command, if it is being executed by the thread, has completed.
+// Use after a failed dequeueCommand before destroying the command
+void CommandThread::waitForCommand(GLCommand *command)
+{
+    QMutexLocker lock(&m_commandsMutex);
+    while (m_executingQueuedCommand == command && command != nullptr)
+        m_queuedCommandExecutedCondition.wait(&m_commandsMutex);
+}
+
 void CommandThread::run()
 {
     // Allow initialize to proceed
@@ -190,10 +230,32 @@ void CommandThread::run()
             initialized = true;
         }
 
-        m_currentCommand->execute(m_renderer, m_graphicsContext.data());
+        // Blocking commands are executed before queued ones
+        GLCommand *command = nullptr;
+        bool isBlockingCommand = false;
+        {
+            QMutexLocker lock(&m_commandsMutex);
+            if (m_currentCommand != nullptr) {
+                command = m_currentCommand;
+                m_currentCommand = nullptr;
+                isBlockingCommand = true;
+            } else if (!m_queuedCommands.isEmpty()) {
+                command = m_queuedCommands.takeFirst();
+                m_executingQueuedCommand = command;
+            }
+        }
+
+        if (command != nullptr)
+            command->execute(m_renderer, m_graphicsContext.data());
 
         // Allow caller to proceed as we are done with the command
-        m_commandExecutionSemaphore.release();
+        if (isBlockingCommand) {
+            m_commandExecutionSemaphore.release();
+        } else if (command != nullptr) {
+            QMutexLocker lock(&m_commandsMutex);
+            m_executingQueuedCommand = nullptr;
+            m_queuedCommandExecutedCondition.wakeAll();
+        }
     }
 }
 
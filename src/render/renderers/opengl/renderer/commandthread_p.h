@@ -54,6 +54,8 @@
 #include <QtCore/QThread>
 #include <QtCore/QSemaphore>
 #include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+#include <QtCore/QVector>
 
 QT_BEGIN_NAMESPACE
 
@@ -85,6 +87,9 @@ public:
     void shutdown();
 
     void executeCommand(GLCommand *command);
+    void enqueueCommand(GLCommand *command);
+    bool dequeueCommand(GLCommand *command);
+    void waitForCommand(GLCommand *command);
 
 private:
     void run() override;
@@ -103,6 +108,10 @@ private:
     QScopedPointer<QOpenGLContext> m_localContext;
     QScopedPointer<GraphicsContext> m_graphicsContext;
     GLCommand *m_currentCommand;
+    QMutex m_commandsMutex;
+    QVector<GLCommand *> m_queuedCommands;
+    GLCommand *m_executingQueuedCommand;
+    QWaitCondition m_queuedCommandExecutedCondition;
     QAtomicInt m_running;
 };
 
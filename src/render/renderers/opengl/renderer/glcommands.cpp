@@ -41,6 +41,10 @@
 #include <Qt3DRender/private/renderer_p.h>
 #include <Qt3DRender/private/graphicscontext_p.h>
 #include <Qt3DRender/private/nodemanagers_p.h>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QThread>
 
 QT_BEGIN_NAMESPACE
 
@@ -60,6 +64,40 @@ void LoadShaderCommand::execute(Renderer *renderer, GraphicsContext *ctx)
     ctx->loadShader(m_shader, nodeManagers->shaderManager());
 }
 
+CompileShaderCommand::CompileShaderCommand(const ShaderProgramSource &source)
+    : m_source(source)
+    , m_requestingThread(QThread::currentThread())
+{
+}
+
+CompileShaderCommand::~CompileShaderCommand()
+{
+    delete m_shaderProgram;
+}
+
+// Executed in the command thread
+void CompileShaderCommand::execute(Renderer *renderer, GraphicsContext *ctx)
+{
+    Q_UNUSED(renderer);
+    m_shaderProgram = ctx->buildShaderProgram(m_source, &m_log);
+    if (m_shaderProgram != nullptr) {
+        // The program is used and destroyed by the thread that requested it
+        m_shaderProgram->moveToThread(m_requestingThread);
+        // Make sure the linked program is visible to the other contexts of
+        // the share group before reporting completion
+        ctx->openGLContext()->functions()->glFinish();
+    }
+    m_completed.storeRelease(1);
+}
+
+QOpenGLShaderProgram *CompileShaderCommand::takeShaderProgram()
+{
+    Q_ASSERT(isCompleted());
+    QOpenGLShaderProgram *shaderProgram = m_shaderProgram;
+    m_shaderProgram = nullptr;
+    return shaderProgram;
+}
+
 } // Render
 
 } // Qt3DRender
@@ -52,9 +52,13 @@
 //
 
 #include <Qt3DRender/qt3drender_global.h>
+#include <Qt3DRender/private/graphicscontext_p.h>
+#include <QtCore/qatomic.h>
 
 QT_BEGIN_NAMESPACE
 
+class QOpenGLShaderProgram;
+class QThread;
 
 namespace Qt3DRender {
 
@@ -67,6 +71,7 @@ class Shader;
 class GLCommand
 {
 public:
+    virtual ~GLCommand() {}
     virtual void execute(Renderer *renderer, GraphicsContext *ctx) = 0;
 };
 
@@ -80,6 +85,29 @@ public:
 private:
     Shader *m_shader = nullptr;
 };
+
+class Q_AUTOTEST_EXPORT CompileShaderCommand : public GLCommand
+{
+public:
+    explicit CompileShaderCommand(const ShaderProgramSource &source);
+    ~CompileShaderCommand();
+
+    const ShaderProgramSource &source() const { return m_source; }
+    void execute(Renderer *renderer, GraphicsContext *ctx) Q_DECL_OVERRIDE;
+
+    // Only valid once completed
+    bool isCompleted() const { return m_completed.loadAcquire(); }
+    QOpenGLShaderProgram *takeShaderProgram();
+    QString log() const { return m_log; }
+
+private:
+    ShaderProgramSource m_source;
+    QThread *m_requestingThread;
+    QOpenGLShaderProgram *m_shaderProgram = nullptr;
+    QString m_log;
+    QAtomicInt m_completed;
+};
+
 } // Render
 
 } // Qt3DRender
@@ -46,6 +46,8 @@ namespace Render {
 
 RenderCommand::RenderCommand()
     : m_stateSet(nullptr)
+    , m_instanceModelMatrixLocation(-1)
+    , m_instanceModelMatrixOffset(0)
     , m_depth(0.0f)
     , m_changeCost(0)
     , m_type(RenderCommand::Draw)
@@ -91,6 +91,13 @@ public:
     // This is a temporary fix in the meantime, to remove the hacked methods in Technique
     QVector<int> m_attributes;
 
+    // Column major model matrices fed to the instanceModelMatrix attribute
+    // of the shader, one per entity drawn by the command
+    QVector<float> m_instanceModelMatrices;
+    int m_instanceModelMatrixLocation;
+    // Byte offset of m_instanceModelMatrices in the instance buffer of the frame
+    int m_instanceModelMatrixOffset;
+
     float m_depth;
     int m_changeCost;
     uint m_shaderDna;
@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "rendercommandarena_p.h"
+#include <Qt3DRender/private/rendercommand_p.h>
+#include <Qt3DRender/private/renderstateset_p.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+namespace {
+
+const uint MaxObjectSize = std::max(sizeof(RenderCommand), sizeof(RenderStateSet));
+// Number of objects per memory page
+const uint PageSize = 128;
+
+} // anonymous
+
+RenderCommandArena::RenderCommandArena()
+    : m_allocator(MaxObjectSize, 16, PageSize)
+{
+}
+
+RenderCommandArena::~RenderCommandArena()
+{
+    clear();
+}
+
+RenderCommand *RenderCommandArena::allocateCommand()
+{
+    RenderCommand *command = m_allocator.allocate<RenderCommand>();
+    m_commands.push_back(command);
+    return command;
+}
+
+RenderStateSet *RenderCommandArena::allocateStateSet()
+{
+    RenderStateSet *stateSet = m_allocator.allocate<RenderStateSet>();
+    m_stateSets.push_back(stateSet);
+    return stateSet;
+}
+
+// Destroys all the objects, no pointer returned by the arena may be used afterwards
+void RenderCommandArena::clear()
+{
+    for (RenderCommand *command : qAsConst(m_commands))
+        command->~RenderCommand();
+    for (RenderStateSet *stateSet : qAsConst(m_stateSets))
+        stateSet->~RenderStateSet();
+    m_commands.clear();
+    m_stateSets.clear();
+    m_allocator.clear();
+}
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
@@ -0,0 +1,105 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QT3DRENDER_RENDER_RENDERCOMMANDARENA_P_H
+#define QT3DRENDER_RENDER_RENDERCOMMANDARENA_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <Qt3DCore/private/qframeallocator_p.h>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+class RenderCommand;
+class RenderStateSet;
+
+// Allocates the RenderCommands, and their RenderStateSets, built by a single
+// thread for a given frame. They are destroyed all at once by clear(), which
+// keeps the memory pages around for the commands of the following frames.
+// An arena is not thread safe, it must only be used by one thread at a time.
+//
+// The containers of the ShaderParameterPack of a command still allocate from
+// the heap. The RendererCache retains commands, packs included, from one
+// frame to the next while the arena is cleared with its RenderView, and the
+// Qt containers can't take an allocator. The retained packs are implicitly
+// shared copies, which only detach when a per frame uniform is refreshed.
+class Q_AUTOTEST_EXPORT RenderCommandArena
+{
+public:
+    RenderCommandArena();
+    ~RenderCommandArena();
+
+    RenderCommand *allocateCommand();
+    RenderStateSet *allocateStateSet();
+    void clear();
+
+    inline int commandCount() const Q_DECL_NOTHROW { return m_commands.size(); }
+    inline int stateSetCount() const Q_DECL_NOTHROW { return m_stateSets.size(); }
+    inline bool isEmpty() const Q_DECL_NOTHROW { return m_commands.isEmpty() && m_stateSets.isEmpty(); }
+
+private:
+    Q_DISABLE_COPY(RenderCommandArena)
+
+    Qt3DCore::QFrameAllocator m_allocator;
+    QVector<RenderCommand *> m_commands;
+    QVector<RenderStateSet *> m_stateSets;
+};
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
+
+#endif // QT3DRENDER_RENDER_RENDERCOMMANDARENA_P_H
@@ -0,0 +1,339 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "rendercommandsorter_p.h"
+#include <Qt3DRender/private/rendercommand_p.h>
+
+#include <QHash>
+#include <QThread>
+#if QT_CONFIG(concurrent)
+#include <QtConcurrent/QtConcurrent>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <numeric>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+namespace {
+
+const int RadixBits = 8;
+const int RadixSize = 1 << RadixBits;
+// Below that many commands per thread, keys are sorted on a single thread
+const int MinCommandsPerChunk = 16384;
+
+struct KeyField
+{
+    KeyField()
+        : bits(0)
+        , isDepth(false)
+    {}
+
+    QVector<quint32> values;
+    int bits;
+    bool isDepth;
+};
+
+int bitsForCount(int count)
+{
+    if (count <= 1)
+        return 0;
+    return 32 - qCountLeadingZeroBits(quint32(count - 1));
+}
+
+// Replaces the value of each command by its rank among the distinct values,
+// rank 0 going to the value ordered first by lessThan. Returns the number of
+// bits the ranks need
+template<typename T, typename Getter, typename LessThan>
+int rankValues(const QVector<RenderCommand *> &commands, Getter getter, LessThan lessThan,
+               QVector<quint32> &ranks)
+{
+    const int commandCount = commands.size();
+    ranks.resize(commandCount);
+
+    // Distinct values in order of appearance. Consecutive commands often share
+    // the same shader, material or cost, which saves most of the lookups
+    QHash<T, int> ids;
+    QVector<T> values;
+    T lastValue = T();
+    int lastId = -1;
+    for (int i = 0; i < commandCount; ++i) {
+        const T value = getter(commands.at(i));
+        if (lastId < 0 || !(value == lastValue)) {
+            auto it = ids.find(value);
+            if (it == ids.end()) {
+                it = ids.insert(value, values.size());
+                values.push_back(value);
+            }
+            lastId = it.value();
+            lastValue = value;
+        }
+        ranks[i] = lastId;
+    }
+
+    QVector<int> order(values.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&values, &lessThan] (int a, int b) {
+        return lessThan(values.at(a), values.at(b));
+    });
+    QVector<quint32> rankOfId(values.size());
+    for (int rank = 0, m = order.size(); rank < m; ++rank)
+        rankOfId[order.at(rank)] = rank;
+    for (int i = 0; i < commandCount; ++i)
+        ranks[i] = rankOfId.at(ranks.at(i));
+
+    return bitsForCount(values.size());
+}
+
+// Maps a float to an unsigned integer with the same ordering
+quint32 orderedDepthBits(float depth)
+{
+    if (depth == 0.0f)
+        depth = 0.0f; // -0.0f and 0.0f are equal
+    quint32 bits;
+    std::memcpy(&bits, &depth, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+template<typename Functor>
+void forEachChunk(int chunkCount, Functor functor)
+{
+#if QT_CONFIG(concurrent)
+    if (chunkCount > 1) {
+        QVector<int> chunks(chunkCount);
+        std::iota(chunks.begin(), chunks.end(), 0);
+        QtConcurrent::blockingMap(chunks, functor);
+        return;
+    }
+#endif
+    for (int chunk = 0; chunk < chunkCount; ++chunk)
+        functor(chunk);
+}
+
+} // anonymous
+
+RenderCommandSorter::RenderCommandSorter()
+    : m_keyBits(0)
+{
+}
+
+void RenderCommandSorter::sort(QVector<RenderCommand *> &commands,
+                               const QVector<QSortPolicy::SortType> &sortingTypes)
+{
+    if (commands.size() < 2 || sortingTypes.isEmpty())
+        return;
+
+    buildKeys(commands, sortingTypes);
+    sortKeys();
+
+    QVector<RenderCommand *> sortedCommands(commands.size());
+    for (int i = 0, m = m_indices.size(); i < m; ++i)
+        sortedCommands[i] = commands.at(m_indices.at(i));
+    commands.swap(sortedCommands);
+}
+
+void RenderCommandSorter::buildKeys(const QVector<RenderCommand *> &commands,
+                                    const QVector<QSortPolicy::SortType> &sortingTypes)
+{
+    const int commandCount = commands.size();
+
+    // A sort type only reorders commands that are equal for all the previous
+    // ones, repeating a sort type has no effect
+    QVector<KeyField> fields;
+    KeyField materialField;
+    bool hasStateChangeCost = false;
+    bool hasDepth = false;
+    bool hasMaterial = false;
+
+    for (const QSortPolicy::SortType sortType : sortingTypes) {
+        switch (sortType) {
+        case QSortPolicy::StateChangeCost: {
+            if (hasStateChangeCost)
+                break;
+            hasStateChangeCost = true;
+            KeyField field;
+            field.bits = rankValues<int>(commands,
+                                         [] (const RenderCommand *c) { return c->m_changeCost; },
+                                         std::greater<int>(), field.values);
+            fields.push_back(field);
+            break;
+        }
+        case QSortPolicy::BackToFront:
+        case QSortPolicy::FrontToBack: {
+            if (hasDepth)
+                break;
+            hasDepth = true;
+            const bool backToFront = sortType == QSortPolicy::BackToFront;
+            KeyField field;
+            field.bits = 32;
+            field.isDepth = true;
+            field.values.resize(commandCount);
+            for (int i = 0; i < commandCount; ++i) {
+                const quint32 depth = orderedDepthBits(commands.at(i)->m_depth);
+                field.values[i] = backToFront ? ~depth : depth;
+            }
+            fields.push_back(field);
+            break;
+        }
+        case QSortPolicy::Material: {
+            if (hasMaterial)
+                break;
+            hasMaterial = true;
+            KeyField field;
+            field.bits = rankValues<ProgramDNA>(commands,
+                                                [] (const RenderCommand *c) { return c->m_shaderDna; },
+                                                std::greater<ProgramDNA>(), field.values);
+            fields.push_back(field);
+            // Commands sharing a shader are grouped by material, this only
+            // matters for commands the following sort types consider equal
+            materialField.bits = rankValues<HMaterial>(commands,
+                                                       [] (const RenderCommand *c) { return c->m_material; },
+                                                       [] (const HMaterial &a, const HMaterial &b) { return a.handle() < b.handle(); },
+                                                       materialField.values);
+            break;
+        }
+        default:
+            Q_UNREACHABLE();
+        }
+    }
+    if (hasMaterial)
+        fields.push_back(materialField);
+
+    // The depth is quantized when the other fields leave it less than 32 bits
+    int otherBits = 0;
+    for (const KeyField &field : qAsConst(fields)) {
+        if (!field.isDepth)
+            otherBits += field.bits;
+    }
+    const int depthBits = qBound(0, 64 - otherBits, 32);
+
+    m_keys.resize(commandCount);
+    std::fill(m_keys.begin(), m_keys.end(), 0);
+    int remainingBits = 64;
+    for (const KeyField &field : qAsConst(fields)) {
+        const int allocatedBits = std::min(field.isDepth ? depthBits : field.bits, remainingBits);
+        if (allocatedBits == 0)
+            continue;
+        // Drops the least significant bits of values that don't fit
+        const int shift = field.bits - allocatedBits;
+        remainingBits -= allocatedBits;
+        quint64 *keys = m_keys.data();
+        const quint32 *values = field.values.constData();
+        for (int i = 0; i < commandCount; ++i)
+            keys[i] = (keys[i] << allocatedBits) | (values[i] >> shift);
+    }
+    m_keyBits = 64 - remainingBits;
+
+    m_indices.resize(commandCount);
+    std::iota(m_indices.begin(), m_indices.end(), 0);
+}
+
+// Stable LSD radix sort of the keys along with the indices, one pass per
+// byte of significant key bits. Each thread counts and scatters a contiguous
+// chunk of keys, the chunks being laid out in order within each bucket
+void RenderCommandSorter::sortKeys()
+{
+    const int count = m_keys.size();
+    const int chunkCount = qBound(1, count / MinCommandsPerChunk, QThread::idealThreadCount());
+    const auto chunkBegin = [count, chunkCount] (int chunk) {
+        return int(qint64(count) * chunk / chunkCount);
+    };
+
+    m_scratchKeys.resize(count);
+    m_scratchIndices.resize(count);
+    m_histograms.resize(chunkCount * RadixSize);
+
+    for (int shift = 0; shift < m_keyBits; shift += RadixBits) {
+        const quint64 *keys = m_keys.constData();
+        const int *indices = m_indices.constData();
+        quint64 *sortedKeys = m_scratchKeys.data();
+        int *sortedIndices = m_scratchIndices.data();
+        int *histograms = m_histograms.data();
+        std::fill(m_histograms.begin(), m_histograms.end(), 0);
+
+        forEachChunk(chunkCount, [=] (int chunk) {
+            int *histogram = histograms + chunk * RadixSize;
+            for (int i = chunkBegin(chunk), end = chunkBegin(chunk + 1); i < end; ++i)
+                ++histogram[(keys[i] >> shift) & (RadixSize - 1)];
+        });
+
+        // Turns the counts into the position of the first key of each chunk
+        // in each bucket
+        bool singleBucket = false;
+        int offset = 0;
+        for (int digit = 0; digit < RadixSize && !singleBucket; ++digit) {
+            int bucketSize = 0;
+            for (int chunk = 0; chunk < chunkCount; ++chunk) {
+                int &histogramEntry = histograms[chunk * RadixSize + digit];
+                const int chunkBucketSize = histogramEntry;
+                histogramEntry = offset + bucketSize;
+                bucketSize += chunkBucketSize;
+            }
+            singleBucket = bucketSize == count;
+            offset += bucketSize;
+        }
+        // All keys share the same digit, nothing to reorder
+        if (singleBucket)
+            continue;
+
+        forEachChunk(chunkCount, [=] (int chunk) {
+            int *histogram = histograms + chunk * RadixSize;
+            for (int i = chunkBegin(chunk), end = chunkBegin(chunk + 1); i < end; ++i) {
+                const int position = histogram[(keys[i] >> shift) & (RadixSize - 1)]++;
+                sortedKeys[position] = keys[i];
+                sortedIndices[position] = indices[i];
+            }
+        });
+
+        m_keys.swap(m_scratchKeys);
+        m_indices.swap(m_scratchIndices);
+    }
+}
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
@@ -0,0 +1,108 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QT3DRENDER_RENDER_RENDERCOMMANDSORTER_P_H
+#define QT3DRENDER_RENDER_RENDERCOMMANDSORTER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <Qt3DRender/qsortpolicy.h>
+#include <Qt3DRender/private/qt3drender_global_p.h>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+class RenderCommand;
+
+// Sorts RenderCommands according to a RenderView's sort policy.
+//
+// Each command gets a 64 bit key in which every sort type of the policy
+// owns a bit field, the first one taking the most significant bits:
+// - StateChangeCost: rank of the change cost, highest first
+// - Material: rank of the shader DNA, highest first. Commands sharing a shader
+//   are then grouped by material, which is the least significant field
+// - BackToFront / FrontToBack: depth, quantized when the other fields leave
+//   less than 32 bits
+// The keys and the commands' indices are then sorted with a stable LSD
+// radix sort, spread over several threads for large command lists. This
+// gives the same order as sorting the commands with one std::stable_sort per
+// sort type while only reading each command once.
+class Q_AUTOTEST_EXPORT RenderCommandSorter
+{
+public:
+    RenderCommandSorter();
+
+    void sort(QVector<RenderCommand *> &commands, const QVector<QSortPolicy::SortType> &sortingTypes);
+
+    void buildKeys(const QVector<RenderCommand *> &commands, const QVector<QSortPolicy::SortType> &sortingTypes);
+    void sortKeys();
+
+    inline const QVector<quint64> &keys() const Q_DECL_NOTHROW { return m_keys; }
+    inline const QVector<int> &indices() const Q_DECL_NOTHROW { return m_indices; }
+    inline int keyBits() const Q_DECL_NOTHROW { return m_keyBits; }
+
+private:
+    QVector<quint64> m_keys;
+    QVector<int> m_indices;
+    QVector<quint64> m_scratchKeys;
+    QVector<int> m_scratchIndices;
+    QVector<int> m_histograms;
+    int m_keyBits;
+};
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
+
+#endif // QT3DRENDER_RENDER_RENDERCOMMANDSORTER_P_H
@@ -84,6 +84,9 @@
 #include <Qt3DRender/private/openglvertexarrayobject_p.h>
 #include <Qt3DRender/private/platformsurfacefilter_p.h>
 #include <Qt3DRender/private/loadbufferjob_p.h>
+#include <Qt3DRender/private/calcgeometrytrianglevolumes_p.h>
+#include <Qt3DRender/private/rendercommandarena_p.h>
+#include <Qt3DRender/private/rendercommandsorter_p.h>
 #include <Qt3DRender/private/rendercapture_p.h>
 #include <Qt3DRender/private/updatelevelofdetailjob_p.h>
 #include <Qt3DRender/private/buffercapture_p.h>
@@ -91,6 +94,9 @@
 #include <Qt3DRender/private/renderviewbuilder_p.h>
 #include <Qt3DRender/private/commandthread_p.h>
 #include <Qt3DRender/private/glcommands_p.h>
+#include <Qt3DRender/private/asyncshadercompiler_p.h>
+#include <Qt3DRender/private/boundingvolumehierarchy_p.h>
+#include <Qt3DRender/private/flattenedentitytree_p.h>
 
 #include <Qt3DRender/qcameralens.h>
 #include <Qt3DCore/private/qeventfilterservice_p.h>
@@ -101,6 +107,7 @@
 #include <Qt3DCore/private/aspectcommanddebugger_p.h>
 #endif
 
+#include <QSet>
 #include <QStack>
 #include <QOffscreenSurface>
 #include <QSurface>
@@ -171,6 +178,8 @@ Renderer::Renderer(QRenderAspect::RenderType type)
     , m_pickEventFilter(new PickEventFilter())
     , m_exposed(0)
     , m_lastFrameCorrect(0)
+    , m_instancedArraysSupported(0)
+    , m_hasPendingUploads(0)
     , m_glContext(nullptr)
     , m_shareContext(nullptr)
     , m_shaderCache(new ShaderCache())
@@ -253,6 +262,8 @@ Renderer::~Renderer()
     delete m_renderQueue;
     delete m_defaultRenderStateSet;
     delete m_shaderCache;
+    qDeleteAll(m_commandArenas);
+    qDeleteAll(m_commandSorters);
 
     if (!m_ownedContext)
         QObject::disconnect(m_contextConnection);
@@ -295,6 +306,9 @@ void Renderer::setNodeManagers(NodeManagers *managers)
     m_pickBoundingVolumeJob->setManagers(m_nodesManager);
     m_rayCastingJob->setManagers(m_nodesManager);
     m_updateWorldBoundingVolumeJob->setManager(m_nodesManager->renderNodesManager());
+    m_worldTransformJob->setEntityTree(m_nodesManager->flattenedEntityTree());
+    m_updateTreeEnabledJob->setEntityTree(m_nodesManager->flattenedEntityTree());
+    m_expandBoundingVolumeJob->setBoundingVolumeHierarchy(m_nodesManager->boundingVolumeHierarchy());
     m_sendRenderCaptureJob->setManagers(m_nodesManager);
     m_updateLevelOfDetailJob->setManagers(m_nodesManager);
     m_updateSkinningPaletteJob->setManagers(m_nodesManager);
@@ -340,7 +354,7 @@ void Renderer::loadShader(Shader *shader, HShader shaderHandle)
     m_commandThread->executeCommand(&cmd);
 #else
     Q_UNUSED(shader);
-    m_dirtyShaders.push_back(shaderHandle);
+    m_dirtyShaders.enqueue(shaderHandle);
 #endif
 }
 
@@ -397,10 +411,20 @@ void Renderer::initialize()
             m_shareContext->create();
         }
 
+        // Program binaries are kept on disk between runs only when requested
+        const QString shaderCachePath = QString::fromLocal8Bit(qgetenv("QT3DRENDER_SHADER_CACHE_DIR"));
+        if (!shaderCachePath.isEmpty())
+            m_shaderCache->setDiskCachePath(shaderCachePath);
+
         // Set shader cache on submission context and command thread
         m_submissionContext->setShaderCache(m_shaderCache);
         m_commandThread->setShaderCache(m_shaderCache);
 
+        // Shader programs are built without blocking frame submission only
+        // when requested, commands using them are skipped until they are ready
+        if (qEnvironmentVariableIsSet("QT3DRENDER_ASYNC_SHADER_COMPILATION"))
+            m_asyncShaderCompiler.reset(new AsyncShaderCompiler(m_submissionContext.data(), m_commandThread.data()));
+
         // Note: we don't have a surface at this point
         // The context will be made current later on (at render time)
         m_submissionContext->setOpenGLContext(ctx);
@@ -489,6 +513,7 @@ void Renderer::releaseGraphicsResources()
     if (!offscreenSurface) {
         qWarning() << "Failed to make context current: OpenGL resources will not be destroyed";
         // We still need to delete the submission context
+        m_asyncShaderCompiler.reset();
         m_submissionContext.reset(nullptr);
         return;
     }
@@ -516,6 +541,9 @@ void Renderer::releaseGraphicsResources()
             vao->destroy();
         }
 
+        // Programs still being built
+        m_asyncShaderCompiler.reset();
+
         context->doneCurrent();
     } else {
         qWarning() << "Failed to make context current: OpenGL resources will not be destroyed";
@@ -526,6 +554,7 @@ void Renderer::releaseGraphicsResources()
     if (m_shareContext)
         delete m_shareContext;
 
+    m_asyncShaderCompiler.reset();
     m_submissionContext.reset(nullptr);
     qCDebug(Backend) << Q_FUNC_INFO << "Renderer properly shutdown";
 }
@@ -689,7 +718,7 @@ void Renderer::doRender(bool scene3dBlocking)
                     beganDrawing = m_submissionContext->beginDrawing(surface);
                     if (beganDrawing) {
                         // 1) Execute commands for buffer uploads, texture updates, shader loading first
-                        updateGLResources();
+                        updateGLResources(renderViews);
                         // 2) Update VAO and copy data into commands to allow concurrent submission
                         prepareCommandsSubmission(renderViews);
                         preprocessingComplete = true;
@@ -778,6 +807,54 @@ void Renderer::doRender(bool scene3dBlocking)
     }
 }
 
+// Called by the RenderViewBuilderJobs, each one building its commands in its own arena
+RenderCommandArena *Renderer::acquireCommandArena()
+{
+    QMutexLocker lock(&m_commandArenasMutex);
+    if (m_commandArenas.isEmpty())
+        return new RenderCommandArena();
+    return m_commandArenas.takeLast();
+}
+
+// Called when the RenderViews are destroyed, once their commands have been submitted
+void Renderer::releaseCommandArenas(const QVector<RenderCommandArena *> &arenas)
+{
+    for (RenderCommandArena *arena : arenas)
+        arena->clear();
+    QMutexLocker lock(&m_commandArenasMutex);
+    m_commandArenas += arenas;
+}
+
+// Called by the RenderViews when sorting their commands
+RenderCommandSorter *Renderer::acquireCommandSorter()
+{
+    QMutexLocker lock(&m_commandSortersMutex);
+    if (m_commandSorters.isEmpty())
+        return new RenderCommandSorter();
+    return m_commandSorters.takeLast();
+}
+
+void Renderer::releaseCommandSorter(RenderCommandSorter *sorter)
+{
+    QMutexLocker lock(&m_commandSortersMutex);
+    m_commandSorters.push_back(sorter);
+}
+
+// Called by the RenderViewInitializerJob
+bool Renderer::isAutomaticInstancingEnabled() const
+{
+    return m_settings != nullptr
+            && m_settings->automaticInstancing()
+            && m_instancedArraysSupported.load() != 0;
+}
+
+// Can be called from any thread
+UploadStatistics Renderer::uploadStatistics() const
+{
+    QMutexLocker lock(&m_uploadStatisticsMutex);
+    return m_uploadStatistics;
+}
+
 // Called by RenderViewJobs
 // When the frameQueue is complete and we are using a renderThread
 // we allow the render thread to proceed
@@ -992,6 +1069,10 @@ void Renderer::prepareCommandsSubmission(const QVector<RenderView *> &renderView
                     command->m_restartIndexValue = rGeometryRenderer->restartIndexValue();
                     command->m_firstInstance = rGeometryRenderer->firstInstance();
                     command->m_instanceCount = rGeometryRenderer->instanceCount();
+                    // Commands merged by RenderView::mergeInstancedCommands draw
+                    // the GeometryRenderer instances once per entity
+                    if (command->m_instanceModelMatrices.size() > 16)
+                        command->m_instanceCount *= command->m_instanceModelMatrices.size() / 16;
                     command->m_firstVertex = rGeometryRenderer->firstVertex();
                     command->m_indexOffset = rGeometryRenderer->indexOffset();
                     command->m_verticesPerPatch = rGeometryRenderer->verticesPerPatch();
@@ -1046,7 +1127,7 @@ void Renderer::lookForDirtyBuffers()
     for (const HBuffer &handle: activeBufferHandles) {
         Buffer *buffer = m_nodesManager->bufferManager()->data(handle);
         if (buffer->isDirty())
-            m_dirtyBuffers.push_back(handle);
+            m_dirtyBuffers.enqueue(handle);
     }
 }
 
@@ -1209,17 +1290,98 @@ void Renderer::sendTextureChangesToFrontend()
 // may contain destruction changes targeting resources. When the above
 // happens, this can result in the dirtyResource vectors containing handles of
 // objects that may already have been destroyed
-void Renderer::updateGLResources()
+namespace {
+
+// Number of bytes SubmissionContext::uploadDataToGLBuffer sends for a dirty buffer
+qint64 pendingUploadSize(Buffer *buffer)
+{
+    qint64 size = 0;
+    for (const QBufferUpdate &update : qAsConst(buffer->pendingBufferUpdates()))
+        size += update.offset >= 0 ? update.data.size() : buffer->data().size();
+    return size > 0 ? size : buffer->data().size();
+}
+
+// Resources referenced by the commands about to be submitted, which have
+// to be uploaded whatever the upload budget
+struct RequiredGLResources
 {
+    QSet<Qt3DCore::QNodeId> bufferIds;
+    QSet<HShader> shaders;
+    QSet<Qt3DCore::QNodeId> textureIds;
+
+    void collect(NodeManagers *managers, const QVector<RenderView *> &renderViews)
+    {
+        QSet<HGeometry> geometries;
+        for (const RenderView *renderView : renderViews) {
+            const QVector<RenderCommand *> commands = renderView->commands();
+            for (const RenderCommand *command : commands) {
+                shaders.insert(command->m_shader);
+
+                if (command->m_type == RenderCommand::Draw && !geometries.contains(command->m_geometry)) {
+                    geometries.insert(command->m_geometry);
+                    Geometry *geometry = managers->geometryManager()->data(command->m_geometry);
+                    if (geometry != nullptr) {
+                        const QVector<Qt3DCore::QNodeId> attributeIds = geometry->attributes();
+                        for (const Qt3DCore::QNodeId attributeId : attributeIds) {
+                            Attribute *attribute = managers->attributeManager()->lookupResource(attributeId);
+                            if (attribute != nullptr)
+                                bufferIds.insert(attribute->bufferId());
+                        }
+                    }
+                }
+
+                const ShaderParameterPack &parameterPack = command->m_parameterPack;
+                for (const BlockToUBO &uniformBuffer : parameterPack.uniformBuffers())
+                    bufferIds.insert(uniformBuffer.m_bufferID);
+                for (const BlockToSSBO &storageBuffer : parameterPack.shaderStorageBuffers())
+                    bufferIds.insert(storageBuffer.m_bufferID);
+                for (const ShaderParameterPack::NamedTexture &texture : parameterPack.textures())
+                    textureIds.insert(texture.texId);
+            }
+        }
+    }
+
+    bool containsAnyTexture(const Qt3DCore::QNodeIdVector &ids) const
+    {
+        for (const Qt3DCore::QNodeId id : ids) {
+            if (textureIds.contains(id))
+                return true;
+        }
+        return false;
+    }
+};
+
+} // anonymous
+
+// Uploads are limited by the RenderSettings upload budget, the resources
+// which aren't referenced by the current frame are postponed once the
+// budget is exhausted
+void Renderer::updateGLResources(const QVector<RenderView *> &renderViews)
+{
+    UploadBudget budget(m_settings != nullptr ? m_settings->uploadByteBudget() : 0,
+                        m_settings != nullptr ? m_settings->uploadTimeBudget() : 0);
+    budget.start();
+    UploadStatistics statistics;
+
+    RequiredGLResources requiredResources;
+    if (!budget.isUnlimited())
+        requiredResources.collect(m_nodesManager, renderViews);
+
     {
         Profiling::GLTimeRecorder recorder(Profiling::BufferUpload);
-        const QVector<HBuffer> dirtyBufferHandles = std::move(m_dirtyBuffers);
+        const QVector<HBuffer> dirtyBufferHandles = m_dirtyBuffers.takeHandles();
         for (const HBuffer &handle: dirtyBufferHandles) {
             Buffer *buffer = m_nodesManager->bufferManager()->data(handle);
 
             // Can be null when using Scene3D rendering
-            if (buffer == nullptr)
+            if (buffer == nullptr || !buffer->isDirty())
+                continue;
+
+            const qint64 uploadSize = pendingUploadSize(buffer);
+            if (budget.isExhausted() && !requiredResources.bufferIds.contains(buffer->peerId())) {
+                m_dirtyBuffers.postpone(handle, uploadSize);
                 continue;
+            }
 
             // Forces creation if it doesn't exit
             // Also note the binding point doesn't really matter here, we just upload data
@@ -1228,14 +1390,18 @@ void Renderer::updateGLResources()
             // Update the glBuffer data
             m_submissionContext->updateBuffer(buffer);
             buffer->unsetDirty();
+            budget.consume(uploadSize);
         }
+        statistics.pendingBuffers = m_dirtyBuffers.postponedCount();
+        statistics.pendingBufferBytes = m_dirtyBuffers.postponedBytes();
     }
 
 #ifndef SHADER_LOADING_IN_COMMAND_THREAD
     {
         Profiling::GLTimeRecorder recorder(Profiling::ShaderUpload);
-        const QVector<HShader> dirtyShaderHandles = std::move(m_dirtyShaders);
+        const QVector<HShader> dirtyShaderHandles = m_dirtyShaders.takeHandles();
         ShaderManager *shaderManager = m_nodesManager->shaderManager();
+        QSet<ProgramDNA> requestedPrograms;
         for (const HShader &handle: dirtyShaderHandles) {
             Shader *shader = shaderManager->data(handle);
 
@@ -1243,9 +1409,36 @@ void Renderer::updateGLResources()
             if (shader == nullptr)
                 continue;
 
+            requestedPrograms.insert(shader->dna());
+            if (budget.isExhausted() && !requiredResources.shaders.contains(handle)) {
+                m_dirtyShaders.postpone(handle);
+                continue;
+            }
+
+            if (m_asyncShaderCompiler && !m_shaderCache->hasShaderProgram(shader->dna())) {
+                const ProgramDNA dna = shader->dna();
+                m_asyncShaderCompiler->request(shader);
+                if (!m_asyncShaderCompiler->isCompleted(dna)) {
+                    // RenderViews skip the commands of shaders which aren't loaded
+                    m_dirtyShaders.postpone(handle);
+                    continue;
+                }
+
+                QString log;
+                QOpenGLShaderProgram *shaderProgram = m_asyncShaderCompiler->takeShaderProgram(dna, &log);
+                shader->setLog(log);
+                shader->setStatus(shaderProgram != nullptr ? QShaderProgram::Ready : QShaderProgram::Error);
+                m_submissionContext->loadShader(shader, shaderManager, shaderProgram);
+                continue;
+            }
+
             // Compile shader
             m_submissionContext->loadShader(shader, shaderManager);
         }
+        statistics.pendingShaders = m_dirtyShaders.postponedCount();
+
+        if (m_asyncShaderCompiler)
+            m_asyncShaderCompiler->releaseUnrequested(requestedPrograms);
     }
 #endif
 
@@ -1270,7 +1463,15 @@ void Renderer::updateGLResources()
             const QVector<GLTexture *> glTextures = glTextureManager->activeResources();
             // Upload texture data
             for (GLTexture *glTexture : glTextures) {
+                // Unique textures are render target attachments, they are never postponed
+                if (glTexture->isDirty() && budget.isExhausted() && !glTexture->isUnique()
+                        && !requiredResources.containsAnyTexture(glTextureManager->referencedTextureIds(glTexture))) {
+                    ++statistics.pendingTextures;
+                    continue;
+                }
+
                 const GLTexture::TextureUpdateInfo info = glTexture->createOrUpdateGLTexture();
+                budget.consume(info.uploadedBytes);
 
                 // GLTexture creation provides us width/height/format ... information
                 // for textures which had not initially specified these information (TargetAutomatic...)
@@ -1289,6 +1490,17 @@ void Renderer::updateGLResources()
     const QVector<Qt3DCore::QNodeId> cleanedUpTextureIds = m_nodesManager->textureManager()->takeTexturesIdsToCleanup();
     for (const Qt3DCore::QNodeId textureCleanedUpId: cleanedUpTextureIds)
         cleanupTexture(textureCleanedUpId);
+
+    statistics.uploadedBytes = budget.consumedBytes();
+    statistics.uploadTime = budget.elapsedTime();
+    if (statistics.hasPendingUploads())
+        qCDebug(Rendering) << "Upload budget exhausted, postponed" << statistics.pendingBuffers << "buffers ("
+                           << statistics.pendingBufferBytes << "bytes)," << statistics.pendingShaders << "shaders and"
+                           << statistics.pendingTextures << "textures";
+    // Make sure the following frames are rendered with the OnDemand render policy
+    m_hasPendingUploads.store(statistics.hasPendingUploads() ? 1 : 0);
+    QMutexLocker lock(&m_uploadStatisticsMutex);
+    m_uploadStatistics = statistics;
 }
 
 // Render Thread
@@ -1427,6 +1639,29 @@ Renderer::ViewSubmissionResultData Renderer::submitRenderViews(const QVector<Ren
     }
     QSurface *lastUsedSurface = nullptr;
 
+    // The model matrices of all the instanced commands of the frame share one
+    // instance buffer, each command reads its matrices at its own offset
+    int instanceModelMatrixCount = 0;
+    for (const Render::RenderView *rv : renderViews) {
+        const QVector<RenderCommand *> commands = rv->commands();
+        for (const RenderCommand *command : commands) {
+            if (command->m_instanceModelMatrixLocation >= 0)
+                instanceModelMatrixCount += command->m_instanceModelMatrices.size();
+        }
+    }
+    QVector<float> instanceModelMatrices;
+    instanceModelMatrices.reserve(instanceModelMatrixCount);
+    for (const Render::RenderView *rv : renderViews) {
+        const QVector<RenderCommand *> commands = rv->commands();
+        for (RenderCommand *command : commands) {
+            if (command->m_instanceModelMatrixLocation < 0)
+                continue;
+            command->m_instanceModelMatrixOffset = instanceModelMatrices.size() * int(sizeof(float));
+            instanceModelMatrices += command->m_instanceModelMatrices;
+        }
+    }
+    m_submissionContext->setInstanceModelMatrices(instanceModelMatrices);
+
     for (int i = 0; i < renderViewsCount; ++i) {
         // Initialize GraphicsContext for drawing
         // If the RenderView has a RenderStateSet defined
@@ -1467,6 +1702,9 @@ Renderer::ViewSubmissionResultData Renderer::submitRenderViews(const QVector<Ren
                 continue;
             }
 
+            // Read by the RenderView jobs, the GL helper is only known once drawing began
+            m_instancedArraysSupported.store(m_submissionContext->supportsInstancedArrays() ? 1 : 0);
+
             previousSurface = surface;
             lastBoundFBOId = m_submissionContext->boundFrameBufferObject();
         }
@@ -1570,7 +1808,7 @@ Renderer::ViewSubmissionResultData Renderer::submitRenderViews(const QVector<Ren
 
 
         frameElapsed = timer.elapsed() - frameElapsed;
-        qCDebug(Rendering) << Q_FUNC_INFO << "Submitted Renderview " << i + 1 << "/" << renderViewsCount  << "in " << frameElapsed << "ms";
+        qCDebug(Rendering) << Q_FUNC_INFO << "Submitted Renderview " << i + 1 << "/" << renderViewsCount  << "with" << renderView->commands().size() << "commands in " << frameElapsed << "ms";
         frameElapsed = timer.elapsed();
     }
 
@@ -1628,7 +1866,8 @@ bool Renderer::shouldRender()
     return (m_settings->renderPolicy() == QRenderSettings::Always
             || m_dirtyBits.marked != 0
             || m_dirtyBits.remaining != 0
-            || !m_lastFrameCorrect.load());
+            || !m_lastFrameCorrect.load()
+            || m_hasPendingUploads.load());
 }
 
 void Renderer::skipNextFrame()
@@ -1650,15 +1889,28 @@ QVector<Qt3DCore::QAspectJobPtr> Renderer::renderBinJobs()
 
     // Create the jobs to build the frame
     const QVector<QAspectJobPtr> bufferJobs = createRenderBufferJobs();
+    const QVector<QAspectJobPtr> triangleHierarchyJobs = createTriangleHierarchyJobs();
 
     // Remove previous dependencies
     m_calculateBoundingVolumeJob->removeDependency(QWeakPointer<QAspectJob>());
     m_cleanupJob->removeDependency(QWeakPointer<QAspectJob>());
+    m_pickBoundingVolumeJob->removeDependency(QWeakPointer<QAspectJob>());
+    m_rayCastingJob->removeDependency(QWeakPointer<QAspectJob>());
 
     // Set dependencies
     for (const QAspectJobPtr &bufferJob : bufferJobs)
         m_calculateBoundingVolumeJob->addDependency(bufferJob);
 
+    // m_pickBoundingVolumeJob and m_rayCastingJob keep their dependency on
+    // m_updateMeshTriangleListJob, only the expired job dependencies are removed
+    for (const QAspectJobPtr &triangleHierarchyJob : triangleHierarchyJobs) {
+        for (const QAspectJobPtr &bufferJob : bufferJobs)
+            triangleHierarchyJob->addDependency(bufferJob);
+        triangleHierarchyJob->addDependency(m_updateMeshTriangleListJob);
+        m_pickBoundingVolumeJob->addDependency(triangleHierarchyJob);
+        m_rayCastingJob->addDependency(triangleHierarchyJob);
+    }
+
     m_updateLevelOfDetailJob->setFrameGraphRoot(frameGraphRoot());
 
     const BackendNodeDirtySet dirtyBitsForFrame = m_dirtyBits.marked | m_dirtyBits.remaining;
@@ -1675,7 +1927,32 @@ QVector<Qt3DCore::QAspectJobPtr> Renderer::renderBinJobs()
         m_calculateBoundingVolumeJob->addDependency(m_updateTreeEnabledJob);
     }
 
+    // Only the subtrees whose transforms changed are updated, unless the entity
+    // hierarchy or the geometries changed, in which case the whole scene is updated
+    QVector<Entity *> dirtySubtreeRoots;
+    if (m_renderSceneRoot != nullptr)
+        dirtySubtreeRoots.push_back(m_renderSceneRoot);
+
+    bool entityTreeRebuilt = false;
     if (dirtyBitsForFrame & AbstractRenderer::TransformDirty) {
+        bool entityHierarchyDirty = false;
+        const QVector<Entity *> dirtyTransformRoots =
+                m_nodesManager->transformManager()->takeDirtySubtreeRoots(m_nodesManager->renderNodesManager(),
+                                                                           &entityHierarchyDirty);
+        if (!entityHierarchyDirty && !(dirtyBitsForFrame & AbstractRenderer::GeometryDirty))
+            dirtySubtreeRoots = dirtyTransformRoots;
+
+        if (entityHierarchyDirty) {
+            // Entities may have been destroyed, the hierarchy is rebuilt by m_expandBoundingVolumeJob
+            m_nodesManager->boundingVolumeHierarchy()->invalidate();
+            // No job is running yet, the scene can safely be flattened here
+            m_nodesManager->flattenedEntityTree()->build(m_renderSceneRoot);
+            m_nodesManager->flattenedEntityTree()->indexEntities();
+            entityTreeRebuilt = true;
+        }
+
+        m_worldTransformJob->setDirtySubtreeRoots(dirtySubtreeRoots);
+        m_updateWorldBoundingVolumeJob->setDirtySubtreeRoots(dirtySubtreeRoots);
         renderBinJobs.push_back(m_worldTransformJob);
         renderBinJobs.push_back(m_updateWorldBoundingVolumeJob);
         renderBinJobs.push_back(m_updateShaderDataTransformJob);
@@ -1688,6 +1965,7 @@ QVector<Qt3DCore::QAspectJobPtr> Renderer::renderBinJobs()
 
     if (dirtyBitsForFrame & AbstractRenderer::GeometryDirty ||
         dirtyBitsForFrame & AbstractRenderer::TransformDirty) {
+        m_expandBoundingVolumeJob->setDirtySubtreeRoots(dirtySubtreeRoots);
         renderBinJobs.push_back(m_expandBoundingVolumeJob);
     }
 
@@ -1708,6 +1986,7 @@ QVector<Qt3DCore::QAspectJobPtr> Renderer::renderBinJobs()
 
     renderBinJobs.push_back(m_sendBufferCaptureJob);
     renderBinJobs.append(bufferJobs);
+    renderBinJobs.append(triangleHierarchyJobs);
 
     // Jobs to prepare GL Resource upload
     renderBinJobs.push_back(m_vaoGathererJob);
@@ -1721,10 +2000,10 @@ QVector<Qt3DCore::QAspectJobPtr> Renderer::renderBinJobs()
     }
 
 
-    // Layer cache is dependent on layers, layer filters and the enabled flag
-    // on entities
+    // Layer cache is dependent on layers, layer filters, the enabled flag
+    // on entities and the order of the flattened entity tree
     const bool layersDirty = dirtyBitsForFrame & AbstractRenderer::LayersDirty;
-    const bool layersCacheNeedsToBeRebuilt = layersDirty || entitiesEnabledDirty;
+    const bool layersCacheNeedsToBeRebuilt = layersDirty || entitiesEnabledDirty || entityTreeRebuilt;
     const bool materialDirty = dirtyBitsForFrame & AbstractRenderer::MaterialDirty;
 
     // Rebuild Entity Layers list if layers are dirty
@@ -1994,6 +2273,15 @@ bool Renderer::executeCommandsSubmission(const RenderView *rv)
                 Profiling::GLTimeRecorder recorder(Profiling::VAOUpdate);
                 // Bind VAO
                 vao->bind();
+
+                // Per entity model matrices, each one used for all the
+                // instances requested by the GeometryRenderer of the entity
+                if (command->m_instanceModelMatrixLocation >= 0 && m_submissionContext->supportsInstancedArrays()) {
+                    const int entityCount = command->m_instanceModelMatrices.size() / 16;
+                    m_submissionContext->specifyInstanceModelMatrices(command->m_instanceModelMatrixLocation,
+                                                                      command->m_instanceModelMatrixOffset,
+                                                                      qMax(1, command->m_instanceCount / qMax(1, entityCount)));
+                }
             }
 
             {
@@ -2206,6 +2494,21 @@ QVector<Qt3DCore::QAspectJobPtr> Renderer::createRenderBufferJobs() const
     return dirtyBuffersJobs;
 }
 
+// Rebuilds the triangle hierarchies of the geometry renderers flagged by
+// m_updateMeshTriangleListJob, until then picking falls back to visiting
+// all the triangles of these geometry renderers
+QVector<Qt3DCore::QAspectJobPtr> Renderer::createTriangleHierarchyJobs() const
+{
+    const QVector<QNodeId> geometryRendererIds = m_nodesManager->geometryRendererManager()->geometryRenderersRequiringTriangleDataRefresh();
+    QVector<QAspectJobPtr> triangleHierarchyJobs;
+    triangleHierarchyJobs.reserve(geometryRendererIds.size());
+
+    for (const QNodeId geometryRendererId : geometryRendererIds)
+        triangleHierarchyJobs.push_back(Render::CalcGeometryTriangleVolumesPtr::create(geometryRendererId, m_nodesManager));
+
+    return triangleHierarchyJobs;
+}
+
 } // namespace Render
 } // namespace Qt3DRender
 
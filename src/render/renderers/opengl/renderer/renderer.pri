@@ -1,27 +1,35 @@
 INCLUDEPATH += $$PWD
 
 SOURCES += \
+    $$PWD/asyncshadercompiler.cpp \
     $$PWD/commandthread.cpp \
     $$PWD/glcommands.cpp \
     $$PWD/openglvertexarrayobject.cpp \
     $$PWD/rendercommand.cpp \
+    $$PWD/rendercommandarena.cpp \
+    $$PWD/rendercommandsorter.cpp \
     $$PWD/renderer.cpp \
     $$PWD/renderqueue.cpp \
     $$PWD/renderview.cpp \
     $$PWD/renderviewbuilder.cpp \
-    $$PWD/shaderparameterpack.cpp
+    $$PWD/shaderparameterpack.cpp \
+    $$PWD/uploadbudget.cpp
 
 HEADERS += \
+    $$PWD/asyncshadercompiler_p.h \
     $$PWD/commandthread_p.h \
     $$PWD/glcommands_p.h \
     $$PWD/openglvertexarrayobject_p.h \
     $$PWD/renderercache_p.h \
     $$PWD/rendercommand_p.h \
+    $$PWD/rendercommandarena_p.h \
+    $$PWD/rendercommandsorter_p.h \
     $$PWD/renderer_p.h \
     $$PWD/renderqueue_p.h \
     $$PWD/renderview_p.h \
     $$PWD/renderviewbuilder_p.h \
     $$PWD/shaderparameterpack_p.h \
-    $$PWD/shadervariables_p.h
+    $$PWD/shadervariables_p.h \
+    $$PWD/uploadbudget_p.h
 
 
@@ -80,6 +80,7 @@
 #include <Qt3DRender/private/updateentitylayersjob_p.h>
 #include <Qt3DRender/private/renderercache_p.h>
 #include <Qt3DRender/private/texture_p.h>
+#include <Qt3DRender/private/uploadbudget_p.h>
 
 #include <QHash>
 #include <QMatrix4x4>
@@ -136,10 +137,13 @@ class Entity;
 class RenderCommand;
 class RenderQueue;
 class RenderView;
+class RenderCommandArena;
+class RenderCommandSorter;
 class Effect;
 class RenderPass;
 class RenderThread;
 class CommandThread;
+class AsyncShaderCompiler;
 class RenderStateSet;
 class VSyncFrameAdvanceService;
 class PickEventFilter;
@@ -202,6 +206,7 @@ public:
     Qt3DCore::QAspectJobPtr expandBoundingVolumeJob() override;
 
     QVector<Qt3DCore::QAspectJobPtr> createRenderBufferJobs() const;
+    QVector<Qt3DCore::QAspectJobPtr> createTriangleHierarchyJobs() const;
 
     inline FrameCleanupJobPtr frameCleanupJob() const { return m_cleanupJob; }
     inline UpdateShaderDataTransformJobPtr updateShaderDataTransformJob() const { return m_updateShaderDataTransformJob; }
@@ -233,7 +238,7 @@ public:
     void loadShader(Shader *shader, Qt3DRender::Render::HShader shaderHandle) override;
 
 
-    void updateGLResources();
+    void updateGLResources(const QVector<Render::RenderView *> &renderViews);
     void updateTexture(Texture *texture);
     void cleanupTexture(Qt3DCore::QNodeId cleanedUpTextureId);
     void downloadGLBuffers();
@@ -268,6 +273,16 @@ public:
     void enqueueRenderView(RenderView *renderView, int submitOrder);
     bool isReadyToSubmit();
 
+    RenderCommandArena *acquireCommandArena();
+    void releaseCommandArenas(const QVector<RenderCommandArena *> &arenas);
+
+    RenderCommandSorter *acquireCommandSorter();
+    void releaseCommandSorter(RenderCommandSorter *sorter);
+
+    bool isAutomaticInstancingEnabled() const;
+
+    UploadStatistics uploadStatistics() const;
+
     QVariant executeCommand(const QStringList &args) override;
     void setOffscreenSurfaceHelper(OffscreenSurfaceHelper *helper) override;
     QSurfaceFormat format() override;
@@ -314,6 +329,7 @@ private:
     RenderQueue *m_renderQueue;
     QScopedPointer<RenderThread> m_renderThread;
     QScopedPointer<CommandThread> m_commandThread;
+    QScopedPointer<AsyncShaderCompiler> m_asyncShaderCompiler;
     QScopedPointer<VSyncFrameAdvanceService> m_vsyncFrameAdvanceService;
 
     QSemaphore m_submitRenderViewsSemaphore;
@@ -335,6 +351,10 @@ private:
     DirtyBits m_dirtyBits;
 
     QAtomicInt m_lastFrameCorrect;
+    QAtomicInt m_instancedArraysSupported;
+    QAtomicInt m_hasPendingUploads;
+    mutable QMutex m_uploadStatisticsMutex;
+    UploadStatistics m_uploadStatistics;
     QOpenGLContext *m_glContext;
     QOpenGLContext *m_shareContext;
     mutable QMutex m_shareContextMutex;
@@ -387,9 +407,17 @@ private:
     QMutex m_abandonedVaosMutex;
     QVector<HVao> m_abandonedVaos;
 
-    QVector<HBuffer> m_dirtyBuffers;
+    // Recycled by the RenderViews of the following frames
+    QMutex m_commandArenasMutex;
+    QVector<RenderCommandArena *> m_commandArenas;
+
+    // Sorters keep their key and scratch buffers between frames
+    QMutex m_commandSortersMutex;
+    QVector<RenderCommandSorter *> m_commandSorters;
+
+    UploadQueue<HBuffer> m_dirtyBuffers;
     QVector<HBuffer> m_downloadableBuffers;
-    QVector<HShader> m_dirtyShaders;
+    UploadQueue<HShader> m_dirtyShaders;
     QVector<HTexture> m_dirtyTextures;
     QVector<QPair<TextureProperties, Qt3DCore::QNodeIdVector>> m_updatedTextureProperties;
 
@@ -55,6 +55,7 @@
 
 #include <Qt3DRender/private/entity_p.h>
 #include <Qt3DRender/private/renderviewjobutils_p.h>
+#include <Qt3DRender/private/rendercommand_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -62,12 +63,35 @@ namespace Qt3DRender {
 
 namespace Render {
 
+// A RenderCommand kept from one frame to the next. Only the render states
+// of its pass are kept as the RenderStateSets are owned by the RenderView
+struct RetainedRenderCommand
+{
+    RenderCommand command;
+    QVector<Qt3DCore::QNodeId> renderStates;
+};
+
+// The RenderCommands built for an Entity, valid as long as the Entity
+// references the same GeometryRenderer and Material and none of the nodes
+// they were built from got a newer revision
+struct RetainedEntityCommands
+{
+    HGeometryRenderer geometryRenderer;
+    HMaterial material;
+    uint revision = 0;
+    QVector<RetainedRenderCommand> commands;
+};
+
+typedef QHash<Entity *, RetainedEntityCommands> RetainedRenderCommands;
+
 struct RendererCache
 {
     struct LeafNodeData
     {
         QVector<Entity *> filterEntitiesByLayer;
         MaterialParameterGathererData materialParameterGatherer;
+        MaterialParameterGathererRevisions materialParameterGathererRevisions;
+        RetainedRenderCommands retainedCommands;
     };
 
     QHash<FrameGraphNode *, LeafNodeData> leafNodeCache;
@@ -55,12 +55,17 @@
 #include <Qt3DRender/private/entity_p.h>
 #include <Qt3DRender/private/renderer_p.h>
 #include <Qt3DRender/private/nodemanagers_p.h>
+#include <Qt3DRender/private/managers_p.h>
+#include <Qt3DRender/private/attribute_p.h>
+#include <Qt3DRender/private/geometry_p.h>
 #include <Qt3DRender/private/layer_p.h>
 #include <Qt3DRender/private/renderlogging_p.h>
 #include <Qt3DRender/private/renderpassfilternode_p.h>
 #include <Qt3DRender/private/renderpass_p.h>
 #include <Qt3DRender/private/geometryrenderer_p.h>
 #include <Qt3DRender/private/renderstateset_p.h>
+#include <Qt3DRender/private/rendercommandarena_p.h>
+#include <Qt3DRender/private/rendercommandsorter_p.h>
 #include <Qt3DRender/private/techniquefilternode_p.h>
 #include <Qt3DRender/private/viewportnode_p.h>
 #include <Qt3DRender/private/buffermanager_p.h>
@@ -70,6 +75,7 @@
 #include <Qt3DRender/private/stringtoint_p.h>
 #include <Qt3DCore/qentity.h>
 #include <QtGui/qsurface.h>
+#include <QtCore/qvarlengtharray.h>
 #include <algorithm>
 
 #include <QDebug>
@@ -89,6 +95,7 @@ namespace  {
 const int Q_DECL_UNUSED qNodeIdTypeId = qMetaTypeId<Qt3DCore::QNodeId>();
 
 const int MAX_LIGHTS = 8;
+Q_STATIC_ASSERT_X(MAX_LIGHTS <= LightGrid::MaxNearestLights, "light indices would be heap allocated");
 
 #define LIGHT_POSITION_NAME  QLatin1String(".position")
 #define LIGHT_TYPE_NAME      QLatin1String(".type")
@@ -96,6 +103,7 @@ const int MAX_LIGHTS = 8;
 #define LIGHT_INTENSITY_NAME QLatin1String(".intensity")
 
 int LIGHT_COUNT_NAME_ID = 0;
+int INSTANCE_MODEL_MATRIX_NAME_ID = 0;
 int LIGHT_POSITION_NAMES[MAX_LIGHTS];
 int LIGHT_TYPE_NAMES[MAX_LIGHTS];
 int LIGHT_COLOR_NAMES[MAX_LIGHTS];
@@ -240,6 +248,7 @@ RenderView::RenderView()
     , m_noDraw(false)
     , m_compute(false)
     , m_frustumCulling(false)
+    , m_automaticInstancing(false)
     , m_memoryBarrier(QMemoryBarrier::None)
     , m_environmentLight(nullptr)
 {
@@ -253,6 +262,7 @@ RenderView::RenderView()
         wasInitialized = true;
         RenderView::ms_standardUniformSetters = RenderView::initializeStandardUniformSetters();
         LIGHT_COUNT_NAME_ID = StringToInt::lookupId(QLatin1String("lightCount"));
+        INSTANCE_MODEL_MATRIX_NAME_ID = StringToInt::lookupId(QLatin1String("instanceModelMatrix"));
         for (int i = 0; i < MAX_LIGHTS; ++i) {
             Q_STATIC_ASSERT_X(MAX_LIGHTS < 10, "can't use the QChar trick anymore");
             LIGHT_STRUCT_NAMES[i] = QLatin1String("lights[") + QLatin1Char(char('0' + i)) + QLatin1Char(']');
@@ -267,207 +277,28 @@ RenderView::RenderView()
 RenderView::~RenderView()
 {
     delete m_stateSet;
-    for (RenderCommand *command : qAsConst(m_commands)) {
-        delete command->m_stateSet;
-        delete command;
-    }
-}
-
-namespace {
-
-template<int SortType>
-struct AdjacentSubRangeFinder
-{
-    static bool adjacentSubRange(RenderCommand *, RenderCommand *)
-    {
-        Q_UNREACHABLE();
-        return false;
-    }
-};
-
-template<>
-struct AdjacentSubRangeFinder<QSortPolicy::StateChangeCost>
-{
-    static bool adjacentSubRange(RenderCommand *a, RenderCommand *b)
-    {
-        return a->m_changeCost == b->m_changeCost;
-    }
-};
-
-template<>
-struct AdjacentSubRangeFinder<QSortPolicy::BackToFront>
-{
-    static bool adjacentSubRange(RenderCommand *a, RenderCommand *b)
-    {
-        return a->m_depth == b->m_depth;
-    }
-};
-
-template<>
-struct AdjacentSubRangeFinder<QSortPolicy::Material>
-{
-    static bool adjacentSubRange(RenderCommand *a, RenderCommand *b)
-    {
-        return a->m_shaderDna == b->m_shaderDna;
-    }
-};
-
-template<>
-struct AdjacentSubRangeFinder<QSortPolicy::FrontToBack>
-{
-    static bool adjacentSubRange(RenderCommand *a, RenderCommand *b)
-    {
-        return a->m_depth == b->m_depth;
-    }
-};
-
-template<typename Predicate>
-int advanceUntilNonAdjacent(const QVector<RenderCommand *> &commands,
-                            const int beg, const int end, Predicate pred)
-{
-    int i = beg + 1;
-    while (i < end) {
-        if (!pred(*(commands.begin() + beg), *(commands.begin() + i)))
-            break;
-        ++i;
-    }
-    return i;
-}
-
-
-using CommandIt = QVector<RenderCommand *>::iterator;
-
-template<int SortType>
-struct SubRangeSorter
-{
-    static void sortSubRange(CommandIt begin, const CommandIt end)
-    {
-        Q_UNUSED(begin);
-        Q_UNUSED(end);
-        Q_UNREACHABLE();
-    }
-};
-
-template<>
-struct SubRangeSorter<QSortPolicy::StateChangeCost>
-{
-    static void sortSubRange(CommandIt begin, const CommandIt end)
-    {
-        std::stable_sort(begin, end, [] (RenderCommand *a, RenderCommand *b) {
-            return a->m_changeCost > b->m_changeCost;
-        });
-    }
-};
-
-template<>
-struct SubRangeSorter<QSortPolicy::BackToFront>
-{
-    static void sortSubRange(CommandIt begin, const CommandIt end)
-    {
-        std::stable_sort(begin, end, [] (RenderCommand *a, RenderCommand *b) {
-            return a->m_depth > b->m_depth;
-        });
-    }
-};
-
-template<>
-struct SubRangeSorter<QSortPolicy::Material>
-{
-    static void sortSubRange(CommandIt begin, const CommandIt end)
-    {
-        // First we sort by shaderDNA
-        std::stable_sort(begin, end, [] (RenderCommand *a, RenderCommand *b) {
-            return a->m_shaderDna > b->m_shaderDna;
-        });
-    }
-};
-
-template<>
-struct SubRangeSorter<QSortPolicy::FrontToBack>
-{
-    static void sortSubRange(CommandIt begin, const CommandIt end)
-    {
-        std::stable_sort(begin, end, [] (RenderCommand *a, RenderCommand *b) {
-            return a->m_depth < b->m_depth;
-        });
-    }
-};
-
-int findSubRange(const QVector<RenderCommand *> &commands,
-                 const int begin, const int end,
-                 const QSortPolicy::SortType sortType)
-{
-    switch (sortType) {
-    case QSortPolicy::StateChangeCost:
-        return advanceUntilNonAdjacent(commands, begin, end, AdjacentSubRangeFinder<QSortPolicy::StateChangeCost>::adjacentSubRange);
-    case QSortPolicy::BackToFront:
-        return advanceUntilNonAdjacent(commands, begin, end, AdjacentSubRangeFinder<QSortPolicy::BackToFront>::adjacentSubRange);
-    case QSortPolicy::Material:
-        return advanceUntilNonAdjacent(commands, begin, end, AdjacentSubRangeFinder<QSortPolicy::Material>::adjacentSubRange);
-    case QSortPolicy::FrontToBack:
-        return advanceUntilNonAdjacent(commands, begin, end, AdjacentSubRangeFinder<QSortPolicy::FrontToBack>::adjacentSubRange);
-    default:
-        Q_UNREACHABLE();
-        return end;
-    }
-}
-
-void sortByMaterial(QVector<RenderCommand *> &commands, int begin, const int end)
-{
-    // We try to arrange elements so that their rendering cost is minimized for a given shader
-    int rangeEnd = advanceUntilNonAdjacent(commands, begin, end, AdjacentSubRangeFinder<QSortPolicy::Material>::adjacentSubRange);
-    while (begin != end) {
-        if (begin + 1 < rangeEnd) {
-            std::stable_sort(commands.begin() + begin + 1, commands.begin() + rangeEnd, [] (RenderCommand *a, RenderCommand *b){
-                return a->m_material.handle() < b->m_material.handle();
-            });
-        }
-        begin = rangeEnd;
-        rangeEnd = advanceUntilNonAdjacent(commands, begin, end, AdjacentSubRangeFinder<QSortPolicy::Material>::adjacentSubRange);
-    }
+    for (const InternedStateSet &internedStateSet : qAsConst(m_internedStateSets))
+        delete internedStateSet.stateSet;
+    // Destroys the commands and their state sets
+    if (m_renderer != nullptr)
+        m_renderer->releaseCommandArenas(m_commandArenas);
+    else
+        qDeleteAll(m_commandArenas);
 }
 
-void sortCommandRange(QVector<RenderCommand *> &commands, int begin, const int end, const int level,
-                      const QVector<Qt3DRender::QSortPolicy::SortType> &sortingTypes)
+void RenderView::sort()
 {
-    if (level >= sortingTypes.size())
-        return;
-
-    switch (sortingTypes.at(level)) {
-    case QSortPolicy::StateChangeCost:
-        SubRangeSorter<QSortPolicy::StateChangeCost>::sortSubRange(commands.begin() + begin, commands.begin() + end);
-        break;
-    case QSortPolicy::BackToFront:
-        SubRangeSorter<QSortPolicy::BackToFront>::sortSubRange(commands.begin() + begin, commands.begin() + end);
-        break;
-    case QSortPolicy::Material:
-        // Groups all same shader DNA together
-        SubRangeSorter<QSortPolicy::Material>::sortSubRange(commands.begin() + begin, commands.begin() + end);
-        // Group all same material together (same parameters most likely)
-        sortByMaterial(commands, begin, end);
-        break;
-    case QSortPolicy::FrontToBack:
-        SubRangeSorter<QSortPolicy::FrontToBack>::sortSubRange(commands.begin() + begin, commands.begin() + end);
-        break;
-    default:
-        Q_UNREACHABLE();
-    }
-
-    // For all sub ranges of adjacent item for sortType[i]
-    // Perform filtering with sortType[i + 1]
-    int rangeEnd = findSubRange(commands, begin, end, sortingTypes.at(level));
-    while (begin != end) {
-        sortCommandRange(commands, begin, rangeEnd, level + 1, sortingTypes);
-        begin = rangeEnd;
-        rangeEnd = findSubRange(commands, begin, end, sortingTypes.at(level));
+    if (m_renderer != nullptr) {
+        RenderCommandSorter *sorter = m_renderer->acquireCommandSorter();
+        sorter->sort(m_commands, m_data.m_sortingTypes);
+        m_renderer->releaseCommandSorter(sorter);
+    } else {
+        RenderCommandSorter sorter;
+        sorter.sort(m_commands, m_data.m_sortingTypes);
     }
-}
 
-} // anonymous
-
-void RenderView::sort()
-{
-     sortCommandRange(m_commands, 0, m_commands.size(), 0, m_data.m_sortingTypes);
+    if (m_automaticInstancing)
+        mergeInstancedCommands();
 
     // For RenderCommand with the same shader
     // We compute the adjacent change cost
@@ -513,12 +344,220 @@ void RenderView::sort()
     }
 }
 
+// Merges consecutive commands which only differ by their standard uniforms into
+// a single instanced draw. Only the model matrices are preserved per instance.
+void RenderView::mergeInstancedCommands()
+{
+    int batchCount = 0;
+    for (int i = 0, m = m_commands.size(); i < m; ++i) {
+        RenderCommand *command = m_commands.at(i);
+        if (batchCount > 0) {
+            RenderCommand *batch = m_commands.at(batchCount - 1);
+            if (canBeDrawnInstanced(batch, command)) {
+                batch->m_instanceModelMatrices += command->m_instanceModelMatrices;
+                continue;
+            }
+        }
+        m_commands[batchCount++] = command;
+    }
+    m_commands.resize(batchCount);
+}
+
+bool RenderView::canBeDrawnInstanced(const RenderCommand *a, const RenderCommand *b)
+{
+    if (a->m_instanceModelMatrixLocation < 0
+            || a->m_type != RenderCommand::Draw
+            || b->m_type != RenderCommand::Draw
+            || !a->m_isValid
+            || !b->m_isValid
+            || a->m_drawIndirect
+            || b->m_drawIndirect)
+        return false;
+
+    if (a->m_shaderDna != b->m_shaderDna
+            || a->m_shader != b->m_shader
+            || a->m_geometry != b->m_geometry
+            || a->m_instanceModelMatrixLocation != b->m_instanceModelMatrixLocation
+            || a->m_primitiveType != b->m_primitiveType
+            || a->m_primitiveCount != b->m_primitiveCount
+            || a->m_drawIndexed != b->m_drawIndexed
+            || a->m_indexAttributeDataType != b->m_indexAttributeDataType
+            || a->m_indexAttributeByteOffset != b->m_indexAttributeByteOffset
+            || a->m_indexOffset != b->m_indexOffset
+            || a->m_firstVertex != b->m_firstVertex
+            || a->m_firstInstance != b->m_firstInstance
+            || a->m_instanceCount != b->m_instanceCount
+            || a->m_verticesPerPatch != b->m_verticesPerPatch
+            || a->m_primitiveRestartEnabled != b->m_primitiveRestartEnabled
+            || a->m_restartIndexValue != b->m_restartIndexValue)
+        return false;
+
+    if (a->m_stateSet != b->m_stateSet) {
+        if (a->m_stateSet == nullptr || b->m_stateSet == nullptr)
+            return false;
+        if (a->m_stateSet->states() != b->m_stateSet->states())
+            return false;
+    }
+
+    const ShaderParameterPack &packA = a->m_parameterPack;
+    const ShaderParameterPack &packB = b->m_parameterPack;
+
+    const QVector<ShaderParameterPack::NamedTexture> texturesA = packA.textures();
+    const QVector<ShaderParameterPack::NamedTexture> texturesB = packB.textures();
+    if (texturesA.size() != texturesB.size())
+        return false;
+    for (int i = 0, m = texturesA.size(); i < m; ++i) {
+        if (texturesA[i].glslNameId != texturesB[i].glslNameId
+                || texturesA[i].texId != texturesB[i].texId
+                || texturesA[i].uniformArrayIndex != texturesB[i].uniformArrayIndex)
+            return false;
+    }
+
+    const QVector<BlockToUBO> uniformBuffersA = packA.uniformBuffers();
+    const QVector<BlockToUBO> uniformBuffersB = packB.uniformBuffers();
+    if (uniformBuffersA.size() != uniformBuffersB.size())
+        return false;
+    for (int i = 0, m = uniformBuffersA.size(); i < m; ++i) {
+        if (uniformBuffersA[i].m_blockIndex != uniformBuffersB[i].m_blockIndex
+                || uniformBuffersA[i].m_bufferID != uniformBuffersB[i].m_bufferID)
+            return false;
+    }
+
+    const QVector<BlockToSSBO> storageBuffersA = packA.shaderStorageBuffers();
+    const QVector<BlockToSSBO> storageBuffersB = packB.shaderStorageBuffers();
+    if (storageBuffersA.size() != storageBuffersB.size())
+        return false;
+    for (int i = 0, m = storageBuffersA.size(); i < m; ++i) {
+        if (storageBuffersA[i].m_blockIndex != storageBuffersB[i].m_blockIndex
+                || storageBuffersA[i].m_bindingIndex != storageBuffersB[i].m_bindingIndex
+                || storageBuffersA[i].m_bufferID != storageBuffersB[i].m_bufferID)
+            return false;
+    }
+
+    // The standard uniforms which can be instanced are allowed to differ, the
+    // others have to match
+    const PackUniformHash &uniformsA = packA.uniforms();
+    const PackUniformHash &uniformsB = packB.uniforms();
+    if (uniformsA.size() != uniformsB.size())
+        return false;
+    for (auto it = uniformsA.cbegin(), end = uniformsA.cend(); it != end; ++it) {
+        const auto otherIt = uniformsB.constFind(it.key());
+        if (otherIt == uniformsB.cend())
+            return false;
+        const auto standardIt = ms_standardUniformSetters.constFind(it.key());
+        if (standardIt != ms_standardUniformSetters.cend()) {
+            if (!isInstanceableStandardUniform(standardIt.value()))
+                return false;
+            continue;
+        }
+        if (!(otherIt.value() == it.value()))
+            return false;
+    }
+    return true;
+}
+
+// The view uniforms are the same for all the commands of a RenderView and the
+// shader reads instanceModelMatrix instead of the model matrix, model view and
+// model view projection. Skinning palettes and the uniforms derived from the
+// inverse or normal model matrix can't be provided per instance.
+bool RenderView::isInstanceableStandardUniform(StandardUniform standardUniform)
+{
+    switch (standardUniform) {
+    case InverseModelMatrix:
+    case InverseModelViewMatrix:
+    case InverseModelViewProjectionMatrix:
+    case ModelNormalMatrix:
+    case ModelViewNormalMatrix:
+    case SkinningPalette:
+        return false;
+    default:
+        return true;
+    }
+}
+
 void RenderView::setRenderer(Renderer *renderer)
 {
     m_renderer = renderer;
     m_manager = renderer->nodeManagers();
 }
 
+void RenderView::setMaterialParameterTable(const MaterialParameterGathererData &parameters)
+{
+    m_parameters = parameters;
+
+    // Build the RenderStateSet of each distinct list of pass render states
+    // once, all the commands of these passes then share it
+    for (const InternedStateSet &internedStateSet : qAsConst(m_internedStateSets))
+        delete internedStateSet.stateSet;
+    m_internedStateSets.clear();
+
+    for (const QVector<RenderPassParameterData> &renderPassData : qAsConst(m_parameters)) {
+        for (const RenderPassParameterData &passData : renderPassData) {
+            if (!passData.pass->hasRenderStates())
+                continue;
+            const QVector<Qt3DCore::QNodeId> renderStates = passData.pass->renderStates();
+            if (m_internedStateSets.contains(renderStates))
+                continue;
+            InternedStateSet internedStateSet;
+            internedStateSet.stateSet = new RenderStateSet();
+            internedStateSet.changeCost = buildRenderStateSet(internedStateSet.stateSet, renderStates);
+            m_internedStateSets.insert(renderStates, internedStateSet);
+        }
+    }
+}
+
+// Returns the cost of changing from the default render states
+int RenderView::buildRenderStateSet(RenderStateSet *stateSet, const QVector<Qt3DCore::QNodeId> &renderStates) const
+{
+    addToRenderStateSet(stateSet, renderStates, m_manager->renderStateManager());
+
+    // Merge per pass stateset with global stateset
+    // so that the local stateset only overrides
+    if (m_stateSet != nullptr)
+        stateSet->merge(m_stateSet);
+    return m_renderer->defaultRenderState()->changeCost(stateSet);
+}
+
+void RenderView::setRenderStateSet(RenderCommand *command,
+                                   const QVector<Qt3DCore::QNodeId> &renderStates,
+                                   RenderCommandArena *arena) const
+{
+    const auto it = m_internedStateSets.constFind(renderStates);
+    if (it != m_internedStateSets.cend()) {
+        command->m_stateSet = it->stateSet;
+        command->m_changeCost = it->changeCost;
+        return;
+    }
+
+    // Passes which weren't known when the material parameters were gathered
+    command->m_stateSet = arena->allocateStateSet();
+    command->m_changeCost = buildRenderStateSet(command->m_stateSet, renderStates);
+}
+
+// Bucket the light positions once so that picking the closest lights of
+// each entity doesn't require sorting all the light sources. Sources without
+// any light setLightUniforms can use are left out of the grid, so that they
+// don't take the place of farther usable ones
+void RenderView::setLightSources(const QVector<LightSource> &lightSources)
+{
+    m_lightSources = lightSources;
+    m_gridLightSources.clear();
+
+    QVector<Vector3D> lightPositions;
+    lightPositions.reserve(m_lightSources.size());
+    for (int i = 0, m = m_lightSources.size(); i < m; ++i) {
+        const LightSource &lightSource = m_lightSources.at(i);
+        const bool hasUsableLight = std::any_of(lightSource.lights.cbegin(), lightSource.lights.cend(), [this] (Light *light) {
+            return light->isEnabled() && m_manager->shaderDataManager()->lookupResource(light->shaderData()) != nullptr;
+        });
+        if (!hasUsableLight)
+            continue;
+        m_gridLightSources.push_back(i);
+        lightPositions.push_back(lightSource.entity->worldBoundingVolume()->center());
+    }
+    m_lightGrid.build(lightPositions);
+}
+
 void RenderView::addClearBuffers(const ClearBuffers *cb) {
     QClearBuffers::BufferTypeFlags type = cb->type();
 
@@ -554,7 +593,9 @@ void RenderView::addClearBuffers(const ClearBuffers *cb) {
 }
 
 // If we are there, we know that entity had a GeometryRenderer + Material
-QVector<RenderCommand *> RenderView::buildDrawRenderCommands(const QVector<Entity *> &entities) const
+QVector<RenderCommand *> RenderView::buildDrawRenderCommands(const QVector<Entity *> &entities, RenderCommandArena *arena,
+                                                             const RetainedRenderCommands *retainedCommands,
+                                                             RetainedRenderCommands *rebuiltCommands) const
 {
     // Note: since many threads can be building render commands
     // we need to ensure that the UniformBlockValueBuilder they are using
@@ -581,11 +622,44 @@ QVector<RenderCommand *> RenderView::buildDrawRenderCommands(const QVector<Entit
             const  QVector<RenderPassParameterData> renderPassData = m_parameters.value(materialComponentId);
             HGeometry geometryHandle = m_manager->lookupHandle<Geometry, GeometryManager, HGeometry>(geometryRenderer->geometryId());
             Geometry *geometry = m_manager->data<Geometry, GeometryManager>(geometryHandle);
+            const uint revision = rebuiltCommands != nullptr
+                    ? drawCommandsRevision(materialComponentId, renderPassData, geometryRenderer, geometry)
+                    : 0;
+
+            // Reuse the commands built on a previous frame if nothing they
+            // were built from changed since, only the values depending on the
+            // camera, the transforms and the lights have to be updated
+            if (retainedCommands != nullptr) {
+                const auto retainedIt = retainedCommands->constFind(entity);
+                if (retainedIt != retainedCommands->cend()
+                        && retainedIt->geometryRenderer == geometryRendererHandle
+                        && retainedIt->material == materialHandle
+                        && retainedIt->revision == revision
+                        && canReuseRetainedCommands(retainedIt.value())) {
+                    for (const RetainedRenderCommand &retainedCommand : retainedIt->commands) {
+                        RenderCommand *command = arena->allocateCommand();
+                        *command = retainedCommand.command;
+                        if (!retainedCommand.renderStates.isEmpty())
+                            setRenderStateSet(command, retainedCommand.renderStates, arena);
+                        refreshRetainedRenderCommand(command, entity);
+                        commands.append(command);
+                    }
+                    continue;
+                }
+            }
+
+            const int firstEntityCommand = commands.size();
+            bool canBeRetained = rebuiltCommands != nullptr;
+            // The parameter packs of the commands before the light uniforms
+            // are set, the lights are set again each time they are reused
+            QVarLengthArray<ShaderParameterPack, 4> unlitParameterPacks;
+            if (canBeRetained)
+                unlitParameterPacks.resize(renderPassData.size());
 
             // 1 RenderCommand per RenderPass pass on an Entity with a Mesh
             for (const RenderPassParameterData &passData : renderPassData) {
                 // Add the RenderPass Parameters
-                RenderCommand *command = new RenderCommand();
+                RenderCommand *command = arena->allocateCommand();
 
                 // Project the camera-to-object-center vector onto the camera
                 // view vector. This gives a depth value suitable as the key
@@ -600,41 +674,21 @@ QVector<RenderCommand *> RenderView::buildDrawRenderCommands(const QVector<Entit
                 // RenderPass { renderStates: [] } will use the states defined by
                 // StateSet in the FrameGraph
                 RenderPass *pass = passData.pass;
-                if (pass->hasRenderStates()) {
-                    command->m_stateSet = new RenderStateSet();
-                    addToRenderStateSet(command->m_stateSet, pass->renderStates(), m_manager->renderStateManager());
-
-                    // Merge per pass stateset with global stateset
-                    // so that the local stateset only overrides
-                    if (m_stateSet != nullptr)
-                        command->m_stateSet->merge(m_stateSet);
-                    command->m_changeCost = m_renderer->defaultRenderState()->changeCost(command->m_stateSet);
-                }
-
-                // Pick which lights to take in to account.
-                // For now decide based on the distance by taking the MAX_LIGHTS closest lights.
-                // Replace with more sophisticated mechanisms later.
-                // Copy vector so that we can sort it concurrently and we only want to sort the one for the current command
-                QVector<LightSource> lightSources = m_lightSources;
-                if (lightSources.size() > 1) {
-                    const Vector3D entityCenter = entity->worldBoundingVolume()->center();
-                    std::sort(lightSources.begin(), lightSources.end(),
-                              [&] (const LightSource &a, const LightSource &b) {
-                        const float distA = entityCenter.distanceToPoint(a.entity->worldBoundingVolume()->center());
-                        const float distB = entityCenter.distanceToPoint(b.entity->worldBoundingVolume()->center());
-                        return distA < distB;
-                    });
-                }
+                if (pass->hasRenderStates())
+                    setRenderStateSet(command, pass->renderStates(), arena);
 
                 ParameterInfoList globalParameters = passData.parameterInfo;
                 // setShaderAndUniforms can initialize a localData
                 // make sure this is cleared before we leave this function
-                setShaderAndUniforms(command,
-                                     pass,
-                                     globalParameters,
-                                     entity,
-                                     lightSources.mid(0, std::max(lightSources.size(), MAX_LIGHTS)),
-                                     m_environmentLight);
+                const int passIndex = commands.size() - firstEntityCommand;
+                if (!setShaderAndUniforms(command,
+                                          pass,
+                                          globalParameters,
+                                          entity,
+                                          lightSourcesForEntity(entity),
+                                          m_environmentLight,
+                                          canBeRetained ? &unlitParameterPacks[passIndex] : nullptr))
+                    canBeRetained = false;
 
                 // Store all necessary information for actual drawing if command is valid
                 command->m_isValid = !command->m_attributes.empty();
@@ -679,10 +733,31 @@ QVector<RenderCommand *> RenderView::buildDrawRenderCommands(const QVector<Entit
                     command->m_firstVertex = geometryRenderer->firstVertex();
                     command->m_indexOffset = geometryRenderer->indexOffset();
                     command->m_verticesPerPatch = geometryRenderer->verticesPerPatch();
+                } else {
+                    // Shader not loaded yet, try again next frame
+                    canBeRetained = false;
                 }
 
                 commands.append(command);
             }
+
+            // Keep a copy of the commands before they get sorted and minified
+            if (canBeRetained) {
+                RetainedEntityCommands &retained = (*rebuiltCommands)[entity];
+                retained.geometryRenderer = geometryRendererHandle;
+                retained.material = materialHandle;
+                retained.revision = revision;
+                retained.commands.resize(commands.size() - firstEntityCommand);
+                for (int i = firstEntityCommand, m = commands.size(); i < m; ++i) {
+                    RetainedRenderCommand &retainedCommand = retained.commands[i - firstEntityCommand];
+                    const RenderCommand *command = commands.at(i);
+                    retainedCommand.command = *command;
+                    retainedCommand.command.m_stateSet = nullptr;
+                    retainedCommand.command.m_parameterPack = unlitParameterPacks.at(i - firstEntityCommand);
+                    if (command->m_stateSet != nullptr)
+                        retainedCommand.renderStates = renderPassData.at(i - firstEntityCommand).pass->renderStates();
+                }
+            }
         }
     }
 
@@ -692,7 +767,7 @@ QVector<RenderCommand *> RenderView::buildDrawRenderCommands(const QVector<Entit
     return commands;
 }
 
-QVector<RenderCommand *> RenderView::buildComputeRenderCommands(const QVector<Entity *> &entities) const
+QVector<RenderCommand *> RenderView::buildComputeRenderCommands(const QVector<Entity *> &entities, RenderCommandArena *arena) const
 {
     // Note: since many threads can be building render commands
     // we need to ensure that the UniformBlockValueBuilder they are using
@@ -724,7 +799,7 @@ QVector<RenderCommand *> RenderView::buildComputeRenderCommands(const QVector<En
                 RenderPass *pass = passData.pass;
                 parametersFromParametersProvider(&globalParameters, m_manager->parameterManager(), pass);
 
-                RenderCommand *command = new RenderCommand();
+                RenderCommand *command = arena->allocateCommand();
                 command->m_type = RenderCommand::Compute;
                 command->m_workGroups[0] = std::max(m_workGroups[0], computeJob->x());
                 command->m_workGroups[1] = std::max(m_workGroups[1], computeJob->y());
@@ -733,7 +808,7 @@ QVector<RenderCommand *> RenderView::buildComputeRenderCommands(const QVector<En
                                      pass,
                                      globalParameters,
                                      entity,
-                                     QVector<LightSource>(),
+                                     LightGrid::LightIndices(),
                                      nullptr);
                 commands.append(command);
             }
@@ -915,12 +990,191 @@ void RenderView::setDefaultUniformBlockShaderDataValue(ShaderParameterPack &unif
     }
 }
 
-void RenderView::setShaderAndUniforms(RenderCommand *command,
+void RenderView::setStandardUniforms(RenderCommand *command, Shader *shader, Entity *entity) const
+{
+    // Set default standard uniforms without bindings
+    const Matrix4x4 worldTransform = *(entity->worldTransform());
+    const QVector<int> uniformNamesIds = shader->uniformsNamesIds();
+    for (const int uniformNameId : uniformNamesIds) {
+        if (ms_standardUniformSetters.contains(uniformNameId))
+            setStandardUniformValue(command->m_parameterPack, uniformNameId, uniformNameId, entity, worldTransform);
+    }
+
+    // With automatic instancing, shaders which can draw several entities at once
+    // read the model matrix from an attribute, unless the geometry provides it
+    if (!m_automaticInstancing) {
+        command->m_instanceModelMatrixLocation = -1;
+        command->m_instanceModelMatrices.clear();
+        return;
+    }
+    if (command->m_instanceModelMatrixLocation < 0
+            && shader->attributeNamesIds().contains(INSTANCE_MODEL_MATRIX_NAME_ID)
+            && !geometryHasInstanceModelMatrix(command->m_geometry)) {
+        const QVector<ShaderAttribute> shaderAttributes = shader->attributes();
+        for (const ShaderAttribute &shaderAttribute : shaderAttributes) {
+            if (shaderAttribute.m_nameId == INSTANCE_MODEL_MATRIX_NAME_ID) {
+                command->m_instanceModelMatrixLocation = shaderAttribute.m_location;
+                break;
+            }
+        }
+    }
+    if (command->m_instanceModelMatrixLocation >= 0) {
+        const QMatrix4x4 modelMatrix = convertToQMatrix4x4(worldTransform);
+        command->m_instanceModelMatrices.resize(16);
+        std::copy(modelMatrix.constData(), modelMatrix.constData() + 16, command->m_instanceModelMatrices.begin());
+    }
+}
+
+bool RenderView::geometryHasInstanceModelMatrix(HGeometry geometryHandle) const
+{
+    const Geometry *geometry = m_manager->data<Geometry, GeometryManager>(geometryHandle);
+    if (geometry == nullptr)
+        return false;
+    const QVector<Qt3DCore::QNodeId> attributeIds = geometry->attributes();
+    for (const Qt3DCore::QNodeId attributeId : attributeIds) {
+        const Attribute *attribute = m_manager->attributeManager()->lookupResource(attributeId);
+        if (attribute != nullptr && attribute->nameId() == INSTANCE_MODEL_MATRIX_NAME_ID)
+            return true;
+    }
+    return false;
+}
+
+void RenderView::setLightUniforms(RenderCommand *command,
+                                  Shader *shader,
+                                  const LightGrid::LightIndices &activeLightSources,
+                                  EnvironmentLight *environmentLight) const
+{
+    int lightIdx = 0;
+    for (const int lightSourceIndex : activeLightSources) {
+        const LightSource &lightSource = m_lightSources.at(lightSourceIndex);
+        if (lightIdx == MAX_LIGHTS)
+            break;
+        Entity *lightEntity = lightSource.entity;
+        const Vector3D worldPos = lightEntity->worldBoundingVolume()->center();
+        for (Light *light : lightSource.lights) {
+            if (!light->isEnabled())
+                continue;
+
+            ShaderData *shaderData = m_manager->shaderDataManager()->lookupResource(light->shaderData());
+            if (!shaderData)
+                continue;
+
+            if (lightIdx == MAX_LIGHTS)
+                break;
+
+            // Note: implicit conversion of values to UniformValue
+            setUniformValue(command->m_parameterPack, LIGHT_POSITION_NAMES[lightIdx], worldPos);
+            setUniformValue(command->m_parameterPack, LIGHT_TYPE_NAMES[lightIdx], int(QAbstractLight::PointLight));
+            setUniformValue(command->m_parameterPack, LIGHT_COLOR_NAMES[lightIdx], Vector3D(1.0f, 1.0f, 1.0f));
+            setUniformValue(command->m_parameterPack, LIGHT_INTENSITY_NAMES[lightIdx], 0.5f);
+
+            // There is no risk in doing that even if multithreaded
+            // since we are sure that a shaderData is unique for a given light
+            // and won't ever be referenced as a Component either
+            Matrix4x4 *worldTransform = lightEntity->worldTransform();
+            if (worldTransform)
+                shaderData->updateWorldTransform(*worldTransform);
+
+            setDefaultUniformBlockShaderDataValue(command->m_parameterPack, shader, shaderData, LIGHT_STRUCT_NAMES[lightIdx]);
+            ++lightIdx;
+        }
+    }
+
+    if (shader->uniformsNamesIds().contains(LIGHT_COUNT_NAME_ID))
+        setUniformValue(command->m_parameterPack, LIGHT_COUNT_NAME_ID, UniformValue(qMax(1, lightIdx)));
+
+    // If no light sources and no environment light, add a default light
+    if (m_lightSources.isEmpty() && !environmentLight) {
+        // Note: implicit conversion of values to UniformValue
+        setUniformValue(command->m_parameterPack, LIGHT_POSITION_NAMES[0], Vector3D(10.0f, 10.0f, 0.0f));
+        setUniformValue(command->m_parameterPack, LIGHT_TYPE_NAMES[0], int(QAbstractLight::PointLight));
+        setUniformValue(command->m_parameterPack, LIGHT_COLOR_NAMES[0], Vector3D(1.0f, 1.0f, 1.0f));
+        setUniformValue(command->m_parameterPack, LIGHT_INTENSITY_NAMES[0], 0.5f);
+    }
+
+    // Environment Light
+    int envLightCount = 0;
+    if (environmentLight && environmentLight->isEnabled()) {
+        ShaderData *shaderData = m_manager->shaderDataManager()->lookupResource(environmentLight->shaderData());
+        if (shaderData) {
+            setDefaultUniformBlockShaderDataValue(command->m_parameterPack, shader, shaderData, QStringLiteral("envLight"));
+            envLightCount = 1;
+        }
+    }
+    setUniformValue(command->m_parameterPack, StringToInt::lookupId(QStringLiteral("envLightCount")), envLightCount);
+}
+
+// Pick which lights to take in to account.
+// For now decide based on the distance by taking the MAX_LIGHTS closest lights.
+// Replace with more sophisticated mechanisms later.
+LightGrid::LightIndices RenderView::lightSourcesForEntity(Entity *entity) const
+{
+    LightGrid::LightIndices lightSourceIndices;
+    m_lightGrid.nearestLights(entity->worldBoundingVolume()->center(), MAX_LIGHTS, &lightSourceIndices);
+    for (int &lightSourceIndex : lightSourceIndices)
+        lightSourceIndex = m_gridLightSources.at(lightSourceIndex);
+    return lightSourceIndices;
+}
+
+// Latest revision of the nodes the draw commands of an entity are built from,
+// apart from the per frame values refreshRetainedRenderCommand updates
+uint RenderView::drawCommandsRevision(Qt3DCore::QNodeId materialId,
+                                      const QVector<RenderPassParameterData> &renderPassData,
+                                      const GeometryRenderer *geometryRenderer,
+                                      const Geometry *geometry) const
+{
+    uint revision = qMax(m_materialRevisions.value(materialId), geometryRenderer->revision());
+    if (geometry != nullptr) {
+        revision = qMax(revision, geometry->revision());
+        const QVector<Qt3DCore::QNodeId> attributeIds = geometry->attributes();
+        for (const Qt3DCore::QNodeId attributeId : attributeIds) {
+            if (const Attribute *attribute = m_manager->attributeManager()->lookupResource(attributeId))
+                revision = qMax(revision, attribute->revision());
+        }
+    }
+    for (const RenderPassParameterData &passData : renderPassData) {
+        for (const ParameterInfo &parameterInfo : passData.parameterInfo) {
+            if (const Parameter *param = m_manager->data<Parameter, ParameterManager>(parameterInfo.handle))
+                revision = qMax(revision, param->valueRevision());
+        }
+    }
+    return revision;
+}
+
+// Commands are built for the shader program a Shader had when they were
+// built, which changes if the Shader is reloaded
+bool RenderView::canReuseRetainedCommands(const RetainedEntityCommands &retained) const
+{
+    for (const RetainedRenderCommand &retainedCommand : retained.commands) {
+        const Shader *shader = m_manager->data<Shader, ShaderManager>(retainedCommand.command.m_shader);
+        if (shader == nullptr || !shader->isLoaded() || shader->dna() != retainedCommand.command.m_shaderDna)
+            return false;
+    }
+    return true;
+}
+
+// Updates the values of a command copied from the RendererCache that depend
+// on the camera, the transforms and the light positions. Retained commands
+// are kept without light uniforms so that no stale light remains set
+void RenderView::refreshRetainedRenderCommand(RenderCommand *command, Entity *entity) const
+{
+    command->m_depth = Vector3D::dotProduct(entity->worldBoundingVolume()->center() - m_data.m_eyePos, m_data.m_eyeViewDir);
+
+    Shader *shader = m_manager->data<Shader, ShaderManager>(command->m_shader);
+    setStandardUniforms(command, shader, entity);
+    setLightUniforms(command, shader, lightSourcesForEntity(entity), m_environmentLight);
+}
+
+// Returns false if some of the uniforms depend on values that
+// refreshRetainedRenderCommand doesn't update. If unlitParameterPack is set,
+// it receives the parameter pack as it is before the light uniforms are set
+bool RenderView::setShaderAndUniforms(RenderCommand *command,
                                       RenderPass *rPass,
                                       ParameterInfoList &parameters,
                                       Entity *entity,
-                                      const QVector<LightSource> &activeLightSources,
-                                      EnvironmentLight *environmentLight) const
+                                      const LightGrid::LightIndices &activeLightSources,
+                                      EnvironmentLight *environmentLight,
+                                      ShaderParameterPack *unlitParameterPack) const
 {
     // The VAO Handle is set directly in the renderer thread so as to avoid having to use a mutex here
     // Set shader, technique, and effect by basically doing :
@@ -932,6 +1186,8 @@ void RenderView::setShaderAndUniforms(RenderCommand *command,
     // For each ParameterBinder in the RenderPass -> create a QUniformPack
     // Once that works, improve that to try and minimize QUniformPack updates
 
+    bool canBeRetained = true;
+
     if (rPass != nullptr) {
         // Index Shader by Shader UUID
         command->m_shader = m_manager->lookupHandle<Shader, ShaderManager, HShader>(rPass->shaderProgram());
@@ -962,12 +1218,7 @@ void RenderView::setShaderAndUniforms(RenderCommand *command,
             if (!uniformNamesIds.isEmpty() || !attributeNamesIds.isEmpty() ||
                     !shaderStorageBlockNamesIds.isEmpty() || !attributeNamesIds.isEmpty()) {
 
-                // Set default standard uniforms without bindings
-                const Matrix4x4 worldTransform = *(entity->worldTransform());
-                for (const int uniformNameId : uniformNamesIds) {
-                    if (ms_standardUniformSetters.contains(uniformNameId))
-                        setStandardUniformValue(command->m_parameterPack, uniformNameId, uniformNameId, entity, worldTransform);
-                }
+                setStandardUniforms(command, shader, entity);
 
                 // Set default attributes
                 for (const int attributeNameId : attributeNamesIds)
@@ -997,6 +1248,8 @@ void RenderView::setShaderAndUniforms(RenderCommand *command,
                                 (shaderData = m_manager->shaderDataManager()->lookupResource(*uniformValue.constData<Qt3DCore::QNodeId>())) != nullptr) {
                             // Try to check if we have a struct or array matching a QShaderData parameter
                             setDefaultUniformBlockShaderDataValue(command->m_parameterPack, shader, shaderData, StringToInt::lookupString(it->nameId));
+                            // Transformed properties depend on the view matrix
+                            canBeRetained = false;
                         }
                         // Otherwise: param unused by current shader
                     }
@@ -1004,64 +1257,9 @@ void RenderView::setShaderAndUniforms(RenderCommand *command,
                 }
 
                 // Lights
-
-                int lightIdx = 0;
-                for (const LightSource &lightSource : activeLightSources) {
-                    if (lightIdx == MAX_LIGHTS)
-                        break;
-                    Entity *lightEntity = lightSource.entity;
-                    const Vector3D worldPos = lightEntity->worldBoundingVolume()->center();
-                    for (Light *light : lightSource.lights) {
-                        if (!light->isEnabled())
-                            continue;
-
-                        ShaderData *shaderData = m_manager->shaderDataManager()->lookupResource(light->shaderData());
-                        if (!shaderData)
-                            continue;
-
-                        if (lightIdx == MAX_LIGHTS)
-                            break;
-
-                        // Note: implicit conversion of values to UniformValue
-                        setUniformValue(command->m_parameterPack, LIGHT_POSITION_NAMES[lightIdx], worldPos);
-                        setUniformValue(command->m_parameterPack, LIGHT_TYPE_NAMES[lightIdx], int(QAbstractLight::PointLight));
-                        setUniformValue(command->m_parameterPack, LIGHT_COLOR_NAMES[lightIdx], Vector3D(1.0f, 1.0f, 1.0f));
-                        setUniformValue(command->m_parameterPack, LIGHT_INTENSITY_NAMES[lightIdx], 0.5f);
-
-                        // There is no risk in doing that even if multithreaded
-                        // since we are sure that a shaderData is unique for a given light
-                        // and won't ever be referenced as a Component either
-                        Matrix4x4 *worldTransform = lightEntity->worldTransform();
-                        if (worldTransform)
-                            shaderData->updateWorldTransform(*worldTransform);
-
-                        setDefaultUniformBlockShaderDataValue(command->m_parameterPack, shader, shaderData, LIGHT_STRUCT_NAMES[lightIdx]);
-                        ++lightIdx;
-                    }
-                }
-
-                if (uniformNamesIds.contains(LIGHT_COUNT_NAME_ID))
-                    setUniformValue(command->m_parameterPack, LIGHT_COUNT_NAME_ID, UniformValue(qMax(1, lightIdx)));
-
-                // If no active light sources and no environment light, add a default light
-                if (activeLightSources.isEmpty() && !environmentLight) {
-                    // Note: implicit conversion of values to UniformValue
-                    setUniformValue(command->m_parameterPack, LIGHT_POSITION_NAMES[0], Vector3D(10.0f, 10.0f, 0.0f));
-                    setUniformValue(command->m_parameterPack, LIGHT_TYPE_NAMES[0], int(QAbstractLight::PointLight));
-                    setUniformValue(command->m_parameterPack, LIGHT_COLOR_NAMES[0], Vector3D(1.0f, 1.0f, 1.0f));
-                    setUniformValue(command->m_parameterPack, LIGHT_INTENSITY_NAMES[0], 0.5f);
-                }
-
-                // Environment Light
-                int envLightCount = 0;
-                if (environmentLight && environmentLight->isEnabled()) {
-                    ShaderData *shaderData = m_manager->shaderDataManager()->lookupResource(environmentLight->shaderData());
-                    if (shaderData) {
-                        setDefaultUniformBlockShaderDataValue(command->m_parameterPack, shader, shaderData, QStringLiteral("envLight"));
-                        envLightCount = 1;
-                    }
-                }
-                setUniformValue(command->m_parameterPack, StringToInt::lookupId(QStringLiteral("envLightCount")), envLightCount);
+                if (unlitParameterPack != nullptr)
+                    *unlitParameterPack = command->m_parameterPack;
+                setLightUniforms(command, shader, activeLightSources, environmentLight);
             }
             // Set frag outputs in the shaders if hash not empty
             if (!fragOutputs.isEmpty())
@@ -1071,6 +1269,7 @@ void RenderView::setShaderAndUniforms(RenderCommand *command,
     else {
         qCWarning(Render::Backend) << Q_FUNC_INFO << "Using default effect as none was provided";
     }
+    return canBeRetained;
 }
 
 bool RenderView::hasBlitFramebufferInfo() const
@@ -62,6 +62,7 @@
 #include <Qt3DRender/private/handle_types_p.h>
 #include <Qt3DRender/private/qsortpolicy_p.h>
 #include <Qt3DRender/private/lightsource_p.h>
+#include <Qt3DRender/private/lightgrid_p.h>
 #include <Qt3DRender/private/qmemorybarrier_p.h>
 #include <Qt3DRender/private/qrendercapture_p.h>
 #include <Qt3DRender/private/qblitframebuffer_p.h>
@@ -86,6 +87,7 @@ class QRenderPass;
 namespace Render {
 
 class Renderer;
+class RenderCommandArena;
 class NodeManagers;
 class RenderCommand;
 class RenderPassFilter;
@@ -93,6 +95,8 @@ class TechniqueFilter;
 class ViewportNode;
 class Effect;
 class RenderPass;
+class Geometry;
+class GeometryRenderer;
 
 typedef QPair<ShaderUniform, QVariant> ActivePropertyContent;
 typedef QPair<QString, ActivePropertyContent > ActiveProperty;
@@ -194,7 +198,15 @@ public:
     inline bool frustumCulling() const Q_DECL_NOTHROW { return m_frustumCulling; }
     void setFrustumCulling(bool frustumCulling) Q_DECL_NOTHROW { m_frustumCulling = frustumCulling; }
 
-    inline void setMaterialParameterTable(const MaterialParameterGathererData &parameters) Q_DECL_NOTHROW { m_parameters = parameters; }
+    inline bool automaticInstancing() const Q_DECL_NOTHROW { return m_automaticInstancing; }
+    void setAutomaticInstancing(bool automaticInstancing) Q_DECL_NOTHROW { m_automaticInstancing = automaticInstancing; }
+
+    void setMaterialParameterTable(const MaterialParameterGathererData &parameters);
+    void setMaterialRevisions(const QHash<Qt3DCore::QNodeId, uint> &revisions) { m_materialRevisions = revisions; }
+    // Shares the RenderStateSets built by setMaterialParameterTable
+    void setRenderStateSet(RenderCommand *command,
+                           const QVector<Qt3DCore::QNodeId> &renderStates,
+                           RenderCommandArena *arena) const;
 
     // TODO: Get rid of this overly complex memory management by splitting out the
     // InnerData as a RenderViewConfig struct. This can be created by setRenderViewConfigFromFrameGraphLeafNode
@@ -219,10 +231,14 @@ public:
 
     RenderPassList passesAndParameters(ParameterInfoList *parameter, Entity *node, bool useDefaultMaterials = true);
 
-    QVector<RenderCommand *> buildDrawRenderCommands(const QVector<Entity *> &entities) const;
-    QVector<RenderCommand *> buildComputeRenderCommands(const QVector<Entity *> &entities) const;
+    QVector<RenderCommand *> buildDrawRenderCommands(const QVector<Entity *> &entities, RenderCommandArena *arena,
+                                                     const RetainedRenderCommands *retainedCommands = nullptr,
+                                                     RetainedRenderCommands *rebuiltCommands = nullptr) const;
+    QVector<RenderCommand *> buildComputeRenderCommands(const QVector<Entity *> &entities, RenderCommandArena *arena) const;
     void setCommands(QVector<RenderCommand *> &commands) Q_DECL_NOTHROW { m_commands = commands; }
     QVector<RenderCommand *> commands() const Q_DECL_NOTHROW { return m_commands; }
+    // The arenas the commands were allocated from, released with the RenderView
+    void addCommandArena(RenderCommandArena *arena) { m_commandArenas.push_back(arena); }
 
     void setAttachmentPack(const AttachmentPack &pack) { m_attachmentPack = pack; }
     const AttachmentPack &attachmentPack() const { return m_attachmentPack; }
@@ -235,7 +251,7 @@ public:
     void setSurface(QSurface *surface) { m_surface = surface; }
     QSurface *surface() const { return m_surface; }
 
-    void setLightSources(const QVector<LightSource> &lightSources) Q_DECL_NOTHROW { m_lightSources = lightSources; }
+    void setLightSources(const QVector<LightSource> &lightSources);
     void setEnvironmentLight(EnvironmentLight *environmentLight) Q_DECL_NOTHROW { m_environmentLight = environmentLight; }
 
     void updateMatrices();
@@ -282,12 +298,29 @@ public:
     void setHasBlitFramebufferInfo(bool hasBlitFramebufferInfo);
 
 private:
-    void setShaderAndUniforms(RenderCommand *command,
+    bool setShaderAndUniforms(RenderCommand *command,
                               RenderPass *pass,
                               ParameterInfoList &parameters,
                               Entity *entity,
-                              const QVector<LightSource> &activeLightSources,
-                              EnvironmentLight *environmentLight) const;
+                              const LightGrid::LightIndices &activeLightSources,
+                              EnvironmentLight *environmentLight,
+                              ShaderParameterPack *unlitParameterPack = nullptr) const;
+    int buildRenderStateSet(RenderStateSet *stateSet, const QVector<Qt3DCore::QNodeId> &renderStates) const;
+    void setStandardUniforms(RenderCommand *command, Shader *shader, Entity *entity) const;
+    bool geometryHasInstanceModelMatrix(HGeometry geometryHandle) const;
+    void setLightUniforms(RenderCommand *command,
+                          Shader *shader,
+                          const LightGrid::LightIndices &activeLightSources,
+                          EnvironmentLight *environmentLight) const;
+    LightGrid::LightIndices lightSourcesForEntity(Entity *entity) const;
+    uint drawCommandsRevision(Qt3DCore::QNodeId materialId,
+                              const QVector<RenderPassParameterData> &renderPassData,
+                              const GeometryRenderer *geometryRenderer,
+                              const Geometry *geometry) const;
+    bool canReuseRetainedCommands(const RetainedEntityCommands &retained) const;
+    void refreshRetainedRenderCommand(RenderCommand *command, Entity *entity) const;
+    void mergeInstancedCommands();
+    static bool canBeDrawnInstanced(const RenderCommand *a, const RenderCommand *b);
     mutable QThreadStorage<UniformBlockValueBuilder*> m_localData;
 
     Qt3DCore::QNodeId m_renderCaptureNodeId;
@@ -318,6 +351,7 @@ private:
     bool m_noDraw:1;
     bool m_compute:1;
     bool m_frustumCulling:1;
+    bool m_automaticInstancing:1;
     int m_workGroups[3];
     QMemoryBarrier::Operations m_memoryBarrier;
 
@@ -325,10 +359,23 @@ private:
     // render aspect is free to change the drawables on the next frame whilst
     // the render thread is submitting these commands.
     QVector<RenderCommand *> m_commands;
-    mutable QVector<LightSource> m_lightSources;
+    QVector<RenderCommandArena *> m_commandArenas;
+    QVector<LightSource> m_lightSources;
+    // Index in m_lightSources of each light of m_lightGrid
+    QVector<int> m_gridLightSources;
+    LightGrid m_lightGrid;
     EnvironmentLight *m_environmentLight;
 
     MaterialParameterGathererData m_parameters;
+    QHash<Qt3DCore::QNodeId, uint> m_materialRevisions;
+
+    struct InternedStateSet
+    {
+        RenderStateSet *stateSet;
+        int changeCost;
+    };
+    // Keyed by the render states of the passes, shared by all their commands
+    QHash<QVector<Qt3DCore::QNodeId>, InternedStateSet> m_internedStateSets;
 
     enum StandardUniform
     {
@@ -359,6 +406,7 @@ private:
     typedef QHash<int, StandardUniform> StandardUniformsNameToTypeHash;
     static StandardUniformsNameToTypeHash ms_standardUniformSetters;
     static StandardUniformsNameToTypeHash initializeStandardUniformSetters();
+    static bool isInstanceableStandardUniform(StandardUniform standardUniform);
 
     UniformValue standardUniformValue(StandardUniform standardUniformType,
                                       Entity *entity,
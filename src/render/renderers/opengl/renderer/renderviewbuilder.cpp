@@ -56,10 +56,12 @@ class SyncRenderViewCommandBuilders
 public:
     explicit SyncRenderViewCommandBuilders(const RenderViewInitializerJobPtr &renderViewJob,
                                            const QVector<RenderViewBuilderJobPtr> &renderViewBuilderJobs,
-                                           Renderer *renderer)
+                                           Renderer *renderer,
+                                           FrameGraphNode *leafNode)
         : m_renderViewJob(renderViewJob)
         , m_renderViewBuilderJobs(renderViewBuilderJobs)
         , m_renderer(renderer)
+        , m_leafNode(leafNode)
     {}
 
     void operator()()
@@ -74,11 +76,26 @@ public:
         QVector<RenderCommand *> commands;
         commands.reserve(totalCommandCount);
 
-        // Reduction
-        for (const auto &renderViewCommandBuilder : qAsConst(m_renderViewBuilderJobs))
+        // Reduction, the RenderView takes ownership of the commands
+        for (const auto &renderViewCommandBuilder : qAsConst(m_renderViewBuilderJobs)) {
             commands += std::move(renderViewCommandBuilder->commands());
+            if (RenderCommandArena *arena = renderViewCommandBuilder->takeCommandArena())
+                rv->addCommandArena(arena);
+        }
         rv->setCommands(commands);
 
+        // Save the commands that had to be rebuilt so that they can be reused next frame
+        {
+            QMutexLocker lock(m_renderer->cache()->mutex());
+            RetainedRenderCommands &retainedCommands = m_renderer->cache()->leafNodeCache[m_leafNode].retainedCommands;
+            for (const auto &renderViewCommandBuilder : qAsConst(m_renderViewBuilderJobs)) {
+                RetainedRenderCommands &rebuiltCommands = renderViewCommandBuilder->rebuiltCommands();
+                for (auto it = rebuiltCommands.cbegin(), end = rebuiltCommands.cend(); it != end; ++it)
+                    retainedCommands.insert(it.key(), it.value());
+                rebuiltCommands.clear();
+            }
+        }
+
         // Sort the commands
         rv->sort();
 
@@ -90,15 +107,18 @@ private:
     RenderViewInitializerJobPtr m_renderViewJob;
     QVector<RenderViewBuilderJobPtr> m_renderViewBuilderJobs;
     Renderer *m_renderer;
+    FrameGraphNode *m_leafNode;
 };
 
 class SyncFrustumCulling
 {
 public:
     explicit SyncFrustumCulling(const RenderViewInitializerJobPtr &renderViewJob,
-                                const FrustumCullingJobPtr &frustumCulling)
+                                const FrustumCullingJobPtr &frustumCulling,
+                                const RenderableEntityFilterPtr &renderableEntityFilterJob)
         : m_renderViewJob(renderViewJob)
         , m_frustumCullingJob(frustumCulling)
+        , m_renderableEntityFilterJob(renderableEntityFilterJob)
     {}
 
     void operator()()
@@ -110,11 +130,14 @@ public:
 
         // Frustum culling
         m_frustumCullingJob->setViewProjection(rv->viewProjectionMatrix());
+        if (m_frustumCullingJob->isActive())
+            m_frustumCullingJob->setEntities(m_renderableEntityFilterJob->filteredEntities());
     }
 
 private:
     RenderViewInitializerJobPtr m_renderViewJob;
     FrustumCullingJobPtr m_frustumCullingJob;
+    RenderableEntityFilterPtr m_renderableEntityFilterJob;
 };
 
 class SyncRenderViewInitialization
@@ -202,8 +225,7 @@ public:
         if (!rv->noDraw()) {
             rv->setEnvironmentLight(m_lightGathererJob->takeEnvironmentLight());
 
-            // We sort the vector so that the removal can then be performed linearly
-
+            // The filtered entities are sorted so that the removal can then be performed linearly
             QVector<Entity *> renderableEntities;
             const bool isDraw = !rv->isCompute();
             if (isDraw)
@@ -212,7 +234,6 @@ public:
                 renderableEntities = std::move(m_computableEntityFilterJob->filteredEntities());
 
             // Filter out entities that weren't selected by the layer filters
-            std::sort(renderableEntities.begin(), renderableEntities.end());
 
             QMutexLocker lock(m_renderer->cache()->mutex());
             const QVector<Entity *> filteredEntities = m_renderer->cache()->leafNodeCache.value(m_leafNode).filterEntitiesByLayer;
@@ -228,6 +249,9 @@ public:
             }
             rv->setLightSources(lightSources);
 
+            // Entities which are culled keep their retained commands
+            const QVector<Entity *> unculledEntities = renderableEntities;
+
             if (isDraw) {
                 // Filter out frustum culled entity for drawable entities
                 if (rv->frustumCulling())
@@ -248,7 +272,28 @@ public:
             m_renderViewBuilderJobs.at(i)->setRenderables(renderableEntities.mid(i * packetSize, packetSize + renderableEntities.size() % (m + 1)));
             {
                 QMutexLocker rendererCacheLock(m_renderer->cache()->mutex());
-                rv->setMaterialParameterTable(m_renderer->cache()->leafNodeCache.value(m_leafNode).materialParameterGatherer);
+                RendererCache::LeafNodeData &dataCacheForLeaf = m_renderer->cache()->leafNodeCache[m_leafNode];
+                rv->setMaterialParameterTable(dataCacheForLeaf.materialParameterGatherer);
+                rv->setMaterialRevisions(dataCacheForLeaf.materialParameterGathererRevisions.materials);
+                if (isDraw) {
+                    // Commands are only retained for renderable entities, drop
+                    // those of entities which were destroyed or filtered out
+                    RetainedRenderCommands &retainedCommands = dataCacheForLeaf.retainedCommands;
+                    if (retainedCommands.size() > unculledEntities.size()) {
+                        QSet<Entity *> entities;
+                        entities.reserve(unculledEntities.size());
+                        for (Entity *entity : unculledEntities)
+                            entities.insert(entity);
+                        for (auto it = retainedCommands.begin(); it != retainedCommands.end();) {
+                            if (!entities.contains(it.key()))
+                                it = retainedCommands.erase(it);
+                            else
+                                ++it;
+                        }
+                    }
+                    for (const auto &renderViewCommandBuilder : qAsConst(m_renderViewBuilderJobs))
+                        renderViewCommandBuilder->setRetainedCommands(retainedCommands);
+                }
             }
         }
     }
@@ -330,10 +375,27 @@ public:
     {
         QMutexLocker lock(m_renderer->cache()->mutex());
         RendererCache::LeafNodeData &dataCacheForLeaf = m_renderer->cache()->leafNodeCache[m_leafNode];
+        const MaterialParameterGathererData previousParameters = std::move(dataCacheForLeaf.materialParameterGatherer);
+        MaterialParameterGathererRevisions &revisions = dataCacheForLeaf.materialParameterGathererRevisions;
         dataCacheForLeaf.materialParameterGatherer.clear();
+        revisions.materials.clear();
 
-        for (const auto &materialGatherer : qAsConst(m_materialParameterGathererJobs))
+        for (const auto &materialGatherer : qAsConst(m_materialParameterGathererJobs)) {
             dataCacheForLeaf.materialParameterGatherer.unite(materialGatherer->materialToPassAndParameter());
+
+            // Materials that didn't change keep what was gathered for them previously
+            const auto unchangedMaterials = materialGatherer->unchangedMaterials();
+            for (const Qt3DCore::QNodeId materialId : unchangedMaterials) {
+                const auto it = previousParameters.constFind(materialId);
+                if (it != previousParameters.cend())
+                    dataCacheForLeaf.materialParameterGatherer.insert(materialId, it.value());
+            }
+
+            const MaterialParameterGathererRevisions &jobRevisions = materialGatherer->revisions();
+            revisions.techniqueFilterId = jobRevisions.techniqueFilterId;
+            revisions.renderPassFilterId = jobRevisions.renderPassFilterId;
+            revisions.materials.unite(jobRevisions.materials);
+        }
     }
 
 private:
@@ -356,7 +418,7 @@ RenderViewBuilder::RenderViewBuilder(Render::FrameGraphNode *leafNode, int rende
     , m_renderableEntityFilterJob(RenderableEntityFilterPtr::create())
     , m_computableEntityFilterJob(ComputableEntityFilterPtr::create())
     , m_frustumCullingJob(new Render::FrustumCullingJob())
-    , m_syncFrustumCullingJob(SynchronizerJobPtr::create(SyncFrustumCulling(m_renderViewJob, m_frustumCullingJob), JobTypes::SyncFrustumCulling))
+    , m_syncFrustumCullingJob(SynchronizerJobPtr::create(SyncFrustumCulling(m_renderViewJob, m_frustumCullingJob, m_renderableEntityFilterJob), JobTypes::SyncFrustumCulling))
     , m_setClearDrawBufferIndexJob(SynchronizerJobPtr::create(SetClearDrawBufferIndex(m_renderViewJob), JobTypes::ClearBufferDrawIndex))
     , m_syncFilterEntityByLayerJob()
     , m_filterProximityJob(Render::FilterProximityDistanceJobPtr::create())
@@ -448,9 +510,11 @@ void RenderViewBuilder::prepareJobs()
     // Init what we can here
     EntityManager *entityManager = m_renderer->nodeManagers()->renderNodesManager();
     m_filterProximityJob->setManager(m_renderer->nodeManagers());
+    m_frustumCullingJob->setBoundingVolumeHierarchy(m_renderer->nodeManagers()->boundingVolumeHierarchy());
     m_renderableEntityFilterJob->setManager(entityManager);
+    m_renderableEntityFilterJob->setEntityTree(m_renderer->nodeManagers()->flattenedEntityTree());
     m_computableEntityFilterJob->setManager(entityManager);
-    m_frustumCullingJob->setRoot(m_renderer->sceneRoot());
+    m_computableEntityFilterJob->setEntityTree(m_renderer->nodeManagers()->flattenedEntityTree());
     m_lightGathererJob->setManager(entityManager);
     m_renderViewJob->setRenderer(m_renderer);
     m_renderViewJob->setFrameGraphLeafNode(m_leafNode);
@@ -471,10 +535,18 @@ void RenderViewBuilder::prepareJobs()
         const QVector<HMaterial> materialHandles = m_renderer->nodeManagers()->materialManager()->activeHandles();
         const int elementsPerJob =  materialHandles.size() / RenderViewBuilder::m_optimalParallelJobCount;
         const int lastRemaingElements = materialHandles.size() % RenderViewBuilder::m_optimalParallelJobCount;
+        MaterialParameterGathererRevisions previousRevisions;
+        {
+            QMutexLocker lock(m_renderer->cache()->mutex());
+            const auto it = m_renderer->cache()->leafNodeCache.constFind(m_leafNode);
+            if (it != m_renderer->cache()->leafNodeCache.cend())
+                previousRevisions = it.value().materialParameterGathererRevisions;
+        }
         m_materialGathererJobs.reserve(RenderViewBuilder::m_optimalParallelJobCount);
         for (auto i = 0; i < RenderViewBuilder::m_optimalParallelJobCount; ++i) {
             auto materialGatherer = Render::MaterialParameterGathererJobPtr::create();
             materialGatherer->setNodeManagers(m_renderer->nodeManagers());
+            materialGatherer->setPreviousRevisions(previousRevisions);
             if (i == RenderViewBuilder::m_optimalParallelJobCount - 1)
                 materialGatherer->setHandles(materialHandles.mid(i * elementsPerJob, elementsPerJob + lastRemaingElements));
             else
@@ -510,7 +582,8 @@ void RenderViewBuilder::prepareJobs()
 
     m_syncRenderViewCommandBuildersJob = SynchronizerJobPtr::create(SyncRenderViewCommandBuilders(m_renderViewJob,
                                                                                                   m_renderViewBuilderJobs,
-                                                                                                  m_renderer),
+                                                                                                  m_renderer,
+                                                                                                  m_leafNode),
                                                                     JobTypes::SyncRenderViewCommandBuilder);
 
     m_syncRenderViewInitializationJob = SynchronizerJobPtr::create(SyncRenderViewInitialization(m_renderViewJob,
@@ -538,6 +611,7 @@ QVector<Qt3DCore::QAspectJobPtr> RenderViewBuilder::buildJobHierachy() const
     m_syncFrustumCullingJob->addDependency(m_renderer->updateWorldTransformJob());
     m_syncFrustumCullingJob->addDependency(m_renderer->updateShaderDataTransformJob());
     m_syncFrustumCullingJob->addDependency(m_syncRenderViewInitializationJob);
+    m_syncFrustumCullingJob->addDependency(m_renderableEntityFilterJob);
 
     m_frustumCullingJob->addDependency(m_renderer->expandBoundingVolumeJob());
     m_frustumCullingJob->addDependency(m_syncFrustumCullingJob);
@@ -660,7 +734,8 @@ QVector<Entity *> RenderViewBuilder::entitiesInSubset(const QVector<Entity *> &e
     intersection.reserve(qMin(entities.size(), subset.size()));
     std::set_intersection(entities.begin(), entities.end(),
                           subset.begin(), subset.end(),
-                          std::back_inserter(intersection));
+                          std::back_inserter(intersection),
+                          &Entity::treeOrderLessThan);
 
     return intersection;
 }
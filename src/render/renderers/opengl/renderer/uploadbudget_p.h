@@ -0,0 +1,174 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QT3DRENDER_RENDER_UPLOADBUDGET_P_H
+#define QT3DRENDER_RENDER_UPLOADBUDGET_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <Qt3DRender/private/qt3drender_global_p.h>
+#include <QElapsedTimer>
+#include <QSet>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+// State of the GPU uploads after a call to Renderer::updateGLResources()
+struct UploadStatistics
+{
+    UploadStatistics()
+        : uploadedBytes(0)
+        , uploadTime(0)
+        , pendingBuffers(0)
+        , pendingBufferBytes(0)
+        , pendingShaders(0)
+        , pendingTextures(0)
+    {}
+
+    qint64 uploadedBytes;
+    qint64 uploadTime; // in nanoseconds
+    int pendingBuffers;
+    qint64 pendingBufferBytes;
+    int pendingShaders;
+    int pendingTextures;
+
+    inline bool hasPendingUploads() const Q_DECL_NOTHROW
+    {
+        return pendingBuffers > 0 || pendingShaders > 0 || pendingTextures > 0;
+    }
+};
+
+// Tracks the bytes uploaded and the time spent uploading during a frame.
+// A budget of 0 means no limit.
+class Q_AUTOTEST_EXPORT UploadBudget
+{
+public:
+    UploadBudget(qint64 byteBudget = 0, qint64 timeBudget = 0);
+
+    void start();
+    void consume(qint64 bytes);
+
+    // Uploads are never split, the last one of a frame can exceed the budget
+    bool isExhausted() const;
+    bool isUnlimited() const Q_DECL_NOTHROW { return m_byteBudget <= 0 && m_timeBudget <= 0; }
+
+    qint64 consumedBytes() const Q_DECL_NOTHROW { return m_consumedBytes; }
+    qint64 elapsedTime() const; // in nanoseconds
+
+private:
+    qint64 m_byteBudget;
+    qint64 m_timeBudget; // in milliseconds
+    qint64 m_consumedBytes;
+    QElapsedTimer m_timer;
+};
+
+// Resources waiting to be uploaded. The gathering jobs rescan every dirty
+// resource, so a resource postponed by the budget and gathered again by a
+// following frame is only queued once.
+template<typename Handle>
+class UploadQueue
+{
+public:
+    UploadQueue()
+        : m_postponedCount(0)
+        , m_postponedBytes(0)
+    {}
+
+    void enqueue(const Handle &handle)
+    {
+        if (m_queued.contains(handle))
+            return;
+        m_queued.insert(handle);
+        m_handles.push_back(handle);
+    }
+
+    // Queues back a resource the budget didn't allow to upload this frame
+    void postpone(const Handle &handle, qint64 bytes = 0)
+    {
+        if (m_queued.contains(handle))
+            return;
+        m_queued.insert(handle);
+        m_handles.push_back(handle);
+        ++m_postponedCount;
+        m_postponedBytes += bytes;
+    }
+
+    // Empties the queue, the handles are unique
+    QVector<Handle> takeHandles()
+    {
+        QVector<Handle> handles;
+        handles.swap(m_handles);
+        m_queued.clear();
+        m_postponedCount = 0;
+        m_postponedBytes = 0;
+        return handles;
+    }
+
+    int size() const Q_DECL_NOTHROW { return m_handles.size(); }
+    bool isEmpty() const Q_DECL_NOTHROW { return m_handles.isEmpty(); }
+    int postponedCount() const Q_DECL_NOTHROW { return m_postponedCount; }
+    qint64 postponedBytes() const Q_DECL_NOTHROW { return m_postponedBytes; }
+
+private:
+    QVector<Handle> m_handles;
+    QSet<Handle> m_queued;
+    int m_postponedCount;
+    qint64 m_postponedBytes;
+};
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
+
+#endif // QT3DRENDER_RENDER_UPLOADBUDGET_P_H
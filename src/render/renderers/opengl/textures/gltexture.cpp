@@ -239,7 +239,7 @@ GLTexture::TextureUpdateInfo GLTexture::createOrUpdateGLTexture()
 
     // need to (re-)upload texture data?
     if (needUpload) {
-        uploadGLTextureData();
+        textureInfo.uploadedBytes = uploadGLTextureData();
         setDirtyFlag(TextureData, false);
     }
 
@@ -447,8 +447,11 @@ static void uploadGLData(QOpenGLTexture *glTex,
     }
 }
 
-void GLTexture::uploadGLTextureData()
+// Returns the number of bytes uploaded
+qint64 GLTexture::uploadGLTextureData()
 {
+    qint64 uploadedBytes = 0;
+
     // Upload all QTexImageData set by the QTextureGenerator
     if (m_textureData) {
         const QVector<QTextureImageDataPtr> imgData = m_textureData->imageData();
@@ -464,6 +467,7 @@ void GLTexture::uploadGLTextureData()
                         uploadGLData(m_gl, level, layer,
                                      static_cast<QOpenGLTexture::CubeMapFace>(QOpenGLTexture::CubeMapPositiveX + face),
                                      bytes, data);
+                        uploadedBytes += bytes.size();
                     }
                 }
             }
@@ -480,7 +484,10 @@ void GLTexture::uploadGLTextureData()
         uploadGLData(m_gl, m_images[i].mipLevel, m_images[i].layer,
                      static_cast<QOpenGLTexture::CubeMapFace>(m_images[i].face),
                      bytes, imgData);
+        uploadedBytes += bytes.size();
     }
+
+    return uploadedBytes;
 }
 
 void GLTexture::updateGLTextureParameters()
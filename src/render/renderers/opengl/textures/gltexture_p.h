@@ -145,6 +145,7 @@ public:
         QOpenGLTexture *texture = nullptr;
         bool wasUpdated = false;
         TextureProperties properties;
+        qint64 uploadedBytes = 0;
     };
 
     TextureUpdateInfo createOrUpdateGLTexture();
@@ -230,7 +231,7 @@ private:
     QOpenGLTexture *buildGLTexture();
     bool loadTextureDataFromGenerator();
     void loadTextureDataFromImages();
-    void uploadGLTextureData();
+    qint64 uploadGLTextureData();
     void updateGLTextureParameters();
     void destroyResources();
 
@@ -23,6 +23,7 @@ qtConfig(private_tests) {
         qframeallocator \
         qtransform \
         threadpooler \
+        workstealingscheduler \
         qpostman \
         vector4d_base \
         vector3d_base
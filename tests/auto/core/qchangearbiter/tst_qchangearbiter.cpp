@@ -27,9 +27,11 @@
 ****************************************************************************/
 
 #include <QtTest/QTest>
+#include <QtCore/QThread>
 #include <Qt3DCore/private/qobserverinterface_p.h>
 #include <Qt3DCore/private/qobservableinterface_p.h>
 #include <Qt3DCore/private/qchangearbiter_p.h>
+#include <Qt3DCore/private/qaspectjobmanager_p.h>
 #include <Qt3DCore/private/qpostman_p.h>
 #include <Qt3DCore/qscenechange.h>
 #include <Qt3DCore/qcomponentaddedchange.h>
@@ -43,11 +45,14 @@
 #include <Qt3DCore/qentity.h>
 #include <Qt3DCore/qcomponent.h>
 #include <Qt3DCore/qbackendnode.h>
+#include <Qt3DCore/qabstractaspect.h>
 #include <Qt3DCore/private/qsceneobserverinterface_p.h>
 #include <Qt3DCore/private/qnode_p.h>
 #include <Qt3DCore/private/qbackendnode_p.h>
+#include <Qt3DCore/private/qtypedpropertyupdatechange_p.h>
 #include <QThread>
 #include <QWaitCondition>
+#include <QVector3D>
 
 class tst_QChangeArbiter : public QObject
 {
@@ -61,6 +66,10 @@ private slots:
     void distributeFrontendChanges();
     void distributePropertyChanges();
     void distributeBackendChanges();
+    void coalesceFrontendChanges();
+    void distributeTypedChanges();
+    void distributeChangesInParallel();
+    void distributeNodeCreationsInBulk();
 };
 
 class AllChangesChange : public Qt3DCore::QSceneChange
@@ -72,6 +81,15 @@ public:
     }
 };
 
+class NodeCreatedChange : public Qt3DCore::QSceneChange
+{
+public:
+    NodeCreatedChange(Qt3DCore::QNodeId subjectId)
+        : Qt3DCore::QSceneChange(Qt3DCore::NodeCreated, subjectId)
+    {
+    }
+};
+
 class tst_Node : public Qt3DCore::QEntity
 {
 public:
@@ -382,6 +400,52 @@ private:
     Qt3DCore::QSceneChangePtr m_lastChange;
 };
 
+class tst_BulkSceneObserver : public Qt3DCore::QSceneObserverInterface
+{
+public:
+    void sceneNodeAdded(Qt3DCore::QSceneChangePtr &e) override
+    {
+        m_runSizes.append(1);
+        m_addedChanges.append(e);
+    }
+
+    void sceneNodeRemoved(Qt3DCore::QSceneChangePtr &e) override
+    {
+        Q_UNUSED(e);
+    }
+
+    void sceneNodesAdded(const QVector<Qt3DCore::QSceneChangePtr> &changes) override
+    {
+        m_runSizes.append(changes.size());
+        m_addedChanges += changes;
+        m_addedThreads.append(QThread::currentThread());
+    }
+
+    void sceneNodesAboutToBeAdded(const QVector<Qt3DCore::QSceneChangePtr> &changes) override
+    {
+        m_preparedRunSizes.append(changes.size());
+    }
+
+    QVector<int> runSizes() const { return m_runSizes; }
+    QVector<int> preparedRunSizes() const { return m_preparedRunSizes; }
+    QVector<Qt3DCore::QSceneChangePtr> addedChanges() const { return m_addedChanges; }
+    QVector<QThread *> addedThreads() const { return m_addedThreads; }
+
+    void clear()
+    {
+        m_runSizes.clear();
+        m_preparedRunSizes.clear();
+        m_addedChanges.clear();
+        m_addedThreads.clear();
+    }
+
+private:
+    QVector<int> m_runSizes;
+    QVector<int> m_preparedRunSizes;
+    QVector<Qt3DCore::QSceneChangePtr> m_addedChanges;
+    QVector<QThread *> m_addedThreads;
+};
+
 void tst_QChangeArbiter::registerObservers()
 {
     // GIVEN
@@ -983,6 +1047,300 @@ void tst_QChangeArbiter::distributeBackendChanges()
     Qt3DCore::QChangeArbiter::destroyThreadLocalChangeQueue(arbiter.data());
 }
 
+namespace {
+
+Qt3DCore::QPropertyUpdatedChangePtr propertyUpdate(Qt3DCore::QNodeId id, const char *name, const QVariant &value)
+{
+    Qt3DCore::QPropertyUpdatedChangePtr change(new Qt3DCore::QPropertyUpdatedChange(id));
+    change->setPropertyName(name);
+    change->setValue(value);
+    return change;
+}
+
+bool mergeStrings(const QVariant &previousValue, QVariant *value)
+{
+    *value = QVariant(previousValue.toString() + value->toString());
+    return true;
+}
+
+} // anonymous
+
+void tst_QChangeArbiter::coalesceFrontendChanges()
+{
+    // GIVEN
+    QScopedPointer<Qt3DCore::QChangeArbiter> arbiter(new Qt3DCore::QChangeArbiter());
+    // Frontend changes are batched into the locking queue of the main thread
+    Qt3DCore::QChangeArbiter::createUnmanagedThreadLocalChangeQueue(arbiter.data());
+    Qt3DCore::QChangeArbiter::registerPropertyChangeMerger(QByteArrayLiteral("mergedProperty"), mergeStrings);
+    Qt3DCore::QChangeArbiter::registerUncoalescedProperty(QByteArrayLiteral("eventProperty"));
+
+    const Qt3DCore::QNodeId id = Qt3DCore::QNodeId::createId();
+    const Qt3DCore::QNodeId otherId = Qt3DCore::QNodeId::createId();
+    tst_SimpleObserver *observer = new tst_SimpleObserver();
+    arbiter->registerObserver(observer, id);
+    arbiter->registerObserver(observer, otherId);
+
+    // THEN
+    QVERIFY(arbiter->isCoalescingEnabled());
+
+    // WHEN
+    arbiter->sceneChangeEventWithLock(Qt3DCore::QSceneChangeList {
+                                          propertyUpdate(id, "prop1", 1),
+                                          propertyUpdate(otherId, "prop1", 10),
+                                          propertyUpdate(id, "prop2", 1.0f),
+                                          propertyUpdate(id, "prop1", 2),
+                                          propertyUpdate(id, "prop1", 3)
+                                      });
+    arbiter->syncChanges();
+
+    // THEN -> last writer wins, other properties and nodes are untouched
+    QCOMPARE(observer->lastChanges().size(), 3);
+    auto change = qSharedPointerCast<Qt3DCore::QPropertyUpdatedChange>(observer->lastChanges().at(0));
+    QCOMPARE(change->subjectId(), otherId);
+    QCOMPARE(change->value().toInt(), 10);
+    change = qSharedPointerCast<Qt3DCore::QPropertyUpdatedChange>(observer->lastChanges().at(1));
+    QCOMPARE(QByteArray(change->propertyName()), QByteArrayLiteral("prop2"));
+    change = qSharedPointerCast<Qt3DCore::QPropertyUpdatedChange>(observer->lastChanges().at(2));
+    QCOMPARE(QByteArray(change->propertyName()), QByteArrayLiteral("prop1"));
+    QCOMPARE(change->value().toInt(), 3);
+    QCOMPARE(arbiter->coalescingStatistics().droppedChanges, quint64(2));
+    QCOMPARE(arbiter->coalescingStatistics().mergedChanges, quint64(0));
+
+    // WHEN
+    observer->clear();
+    arbiter->sceneChangeEventWithLock(Qt3DCore::QSceneChangeList {
+                                          propertyUpdate(id, "mergedProperty", QStringLiteral("a")),
+                                          propertyUpdate(id, "mergedProperty", QStringLiteral("b")),
+                                          propertyUpdate(id, "prop1", 4),
+                                          propertyUpdate(id, "mergedProperty", QStringLiteral("c")),
+                                          propertyUpdate(id, "eventProperty", 1),
+                                          propertyUpdate(id, "eventProperty", 2)
+                                      });
+    arbiter->syncChanges();
+
+    // THEN -> merging doesn't cross other changes of the node, events are all kept
+    QCOMPARE(observer->lastChanges().size(), 5);
+    change = qSharedPointerCast<Qt3DCore::QPropertyUpdatedChange>(observer->lastChanges().at(0));
+    QCOMPARE(change->value().toString(), QStringLiteral("ab"));
+    change = qSharedPointerCast<Qt3DCore::QPropertyUpdatedChange>(observer->lastChanges().at(2));
+    QCOMPARE(change->value().toString(), QStringLiteral("c"));
+    QCOMPARE(arbiter->coalescingStatistics().droppedChanges, quint64(2));
+    QCOMPARE(arbiter->coalescingStatistics().mergedChanges, quint64(1));
+
+    // WHEN
+    observer->clear();
+    arbiter->setCoalescingEnabled(false);
+    arbiter->sceneChangeEventWithLock(Qt3DCore::QSceneChangeList {
+                                          propertyUpdate(id, "prop1", 5),
+                                          propertyUpdate(id, "prop1", 6)
+                                      });
+    arbiter->syncChanges();
+
+    // THEN
+    QCOMPARE(observer->lastChanges().size(), 2);
+    QCOMPARE(arbiter->coalescingStatistics().droppedChanges, quint64(2));
+
+    Qt3DCore::QChangeArbiter::destroyUnmanagedThreadLocalChangeQueue(arbiter.data());
+}
+
+void tst_QChangeArbiter::distributeTypedChanges()
+{
+    // GIVEN
+    QScopedPointer<Qt3DCore::QChangeArbiter> arbiter(new Qt3DCore::QChangeArbiter());
+    Qt3DCore::QChangeArbiter::createUnmanagedThreadLocalChangeQueue(arbiter.data());
+
+    const Qt3DCore::QNodeId id = Qt3DCore::QNodeId::createId();
+    tst_SimpleObserver *observer = new tst_SimpleObserver();
+    arbiter->registerObserver(observer, id);
+
+    const int propertyId = Qt3DCore::QTypedPropertyUpdatedChangeBase::propertyIdForName("typedProperty");
+
+    // THEN
+    QVERIFY(propertyId != 0);
+    QCOMPARE(Qt3DCore::QTypedPropertyUpdatedChangeBase::propertyIdForName("typedProperty"), propertyId);
+    QVERIFY(Qt3DCore::QTypedPropertyUpdatedChangeBase::propertyIdForName("otherTypedProperty") != propertyId);
+
+    // WHEN
+    Qt3DCore::QTypedPropertyUpdatedChange<QVector3D> *sentChange = nullptr;
+    {
+        auto change = Qt3DCore::QTypedPropertyUpdatedChange<QVector3D>::create(id, "typedProperty", propertyId,
+                                                                              QVector3D(1.0f, 2.0f, 3.0f));
+        sentChange = change.data();
+        arbiter->sceneChangeEventWithLock(change);
+    }
+    arbiter->syncChanges();
+
+    // THEN
+    QCOMPARE(observer->lastChanges().size(), 1);
+    const Qt3DCore::QTypedPropertyUpdatedChangeBase *typedChange =
+            Qt3DCore::QTypedPropertyUpdatedChangeBase::fromChange(observer->lastChange());
+    QVERIFY(typedChange != nullptr);
+    QCOMPARE(typedChange->subjectId(), id);
+    QCOMPARE(typedChange->propertyId(), propertyId);
+    QCOMPARE(QByteArray(typedChange->propertyName()), QByteArrayLiteral("typedProperty"));
+    QCOMPARE(typedChange->value<QVector3D>(), QVector3D(1.0f, 2.0f, 3.0f));
+
+    // WHEN -> the last reference is released, the change goes back to the pool
+    observer->clear();
+    auto recycledChange = Qt3DCore::QTypedPropertyUpdatedChange<QVector3D>::create(id, "typedProperty", propertyId,
+                                                                                  QVector3D(4.0f, 5.0f, 6.0f));
+
+    // THEN
+    QCOMPARE(recycledChange.data(), sentChange);
+    QCOMPARE(recycledChange->subjectId(), id);
+    QCOMPARE(recycledChange->propertyId(), propertyId);
+    QCOMPARE(recycledChange->value<QVector3D>(), QVector3D(4.0f, 5.0f, 6.0f));
+
+    // WHEN -> generic changes are left to the name based path
+    arbiter->sceneChangeEventWithLock(propertyUpdate(id, "typedProperty", 1));
+    arbiter->syncChanges();
+
+    // THEN
+    QCOMPARE(observer->lastChanges().size(), 1);
+    QVERIFY(Qt3DCore::QTypedPropertyUpdatedChangeBase::fromChange(observer->lastChange()) == nullptr);
+
+    Qt3DCore::QChangeArbiter::destroyUnmanagedThreadLocalChangeQueue(arbiter.data());
+}
+
+void tst_QChangeArbiter::distributeChangesInParallel()
+{
+    // GIVEN
+    Qt3DCore::QAspectJobManager jobManager;
+    jobManager.initialize();
+    QScopedPointer<Qt3DCore::QChangeArbiter> arbiter(new Qt3DCore::QChangeArbiter());
+    arbiter->initialize(&jobManager);
+    Qt3DCore::QChangeArbiter::createUnmanagedThreadLocalChangeQueue(arbiter.data());
+
+    Qt3DCore::QAbstractAspect aspect1;
+    Qt3DCore::QAbstractAspect aspect2;
+    const Qt3DCore::QNodeId id1 = Qt3DCore::QNodeId::createId();
+    const Qt3DCore::QNodeId id2 = Qt3DCore::QNodeId::createId();
+    QScopedPointer<tst_SimpleObserver> observer1(new tst_SimpleObserver());
+    QScopedPointer<tst_SimpleObserver> observer2(new tst_SimpleObserver());
+    QScopedPointer<tst_SimpleObserver> localObserver(new tst_SimpleObserver());
+    arbiter->registerObserver(observer1.data(), id1, Qt3DCore::AllChanges, &aspect1);
+    arbiter->registerObserver(observer2.data(), id1, Qt3DCore::AllChanges, &aspect2);
+    arbiter->registerObserver(observer2.data(), id2, Qt3DCore::AllChanges, &aspect2);
+    arbiter->registerObserver(localObserver.data(), id2);
+
+    // THEN
+    QVERIFY(arbiter->isParallelDistributionEnabled());
+
+    // WHEN
+    Qt3DCore::QChangeArbiter::registerUncoalescedProperty(QByteArrayLiteral("eventProperty"));
+    const int changeCount = 1000;
+    Qt3DCore::QSceneChangeList changes;
+    for (int i = 0; i < changeCount; ++i)
+        changes.push_back(propertyUpdate(i % 2 == 0 ? id1 : id2, "eventProperty", i));
+    arbiter->sceneChangeEventWithLock(changes);
+    arbiter->syncChanges();
+
+    // THEN -> each observer got the changes of its nodes in order
+    QCOMPARE(arbiter->lastSyncStatistics().processedChanges, quint64(changeCount));
+    QCOMPARE(arbiter->lastSyncStatistics().parallelJobs, 2);
+    QCOMPARE(observer1->lastChanges().size(), changeCount / 2);
+    QCOMPARE(observer2->lastChanges().size(), changeCount);
+    QCOMPARE(localObserver->lastChanges().size(), changeCount / 2);
+    for (int i = 0; i < changeCount; ++i) {
+        const auto change = qSharedPointerCast<Qt3DCore::QPropertyUpdatedChange>(observer2->lastChanges().at(i));
+        QCOMPARE(change->value().toInt(), i);
+    }
+    for (int i = 0; i < changeCount / 2; ++i) {
+        auto change = qSharedPointerCast<Qt3DCore::QPropertyUpdatedChange>(observer1->lastChanges().at(i));
+        QCOMPARE(change->value().toInt(), 2 * i);
+        change = qSharedPointerCast<Qt3DCore::QPropertyUpdatedChange>(localObserver->lastChanges().at(i));
+        QCOMPARE(change->value().toInt(), 2 * i + 1);
+    }
+
+    // WHEN
+    observer1->clear();
+    observer2->clear();
+    localObserver->clear();
+    arbiter->setParallelDistributionEnabled(false);
+    arbiter->sceneChangeEventWithLock(changes);
+    arbiter->syncChanges();
+
+    // THEN
+    QCOMPARE(arbiter->lastSyncStatistics().processedChanges, quint64(changeCount));
+    QCOMPARE(arbiter->lastSyncStatistics().parallelJobs, 0);
+    QCOMPARE(observer2->lastChanges().size(), changeCount);
+
+    // WHEN
+    arbiter->syncChanges();
+
+    // THEN
+    QCOMPARE(arbiter->lastSyncStatistics().processedChanges, quint64(0));
+
+    Qt3DCore::QChangeArbiter::destroyUnmanagedThreadLocalChangeQueue(arbiter.data());
+}
+
+void tst_QChangeArbiter::distributeNodeCreationsInBulk()
+{
+    // GIVEN
+    Qt3DCore::QAspectJobManager jobManager;
+    jobManager.initialize();
+    QScopedPointer<Qt3DCore::QChangeArbiter> arbiter(new Qt3DCore::QChangeArbiter());
+    arbiter->initialize(&jobManager);
+    Qt3DCore::QChangeArbiter::createUnmanagedThreadLocalChangeQueue(arbiter.data());
+
+    QScopedPointer<tst_BulkSceneObserver> sceneObserver1(new tst_BulkSceneObserver());
+    QScopedPointer<tst_BulkSceneObserver> sceneObserver2(new tst_BulkSceneObserver());
+    arbiter->registerSceneObserver(sceneObserver1.data());
+    arbiter->registerSceneObserver(sceneObserver2.data());
+
+    const int firstRunSize = 600;
+    const int secondRunSize = 400;
+    QVector<Qt3DCore::QNodeId> ids;
+    Qt3DCore::QSceneChangeList changes;
+    for (int i = 0; i < firstRunSize + secondRunSize; ++i) {
+        ids.push_back(Qt3DCore::QNodeId::createId());
+        changes.push_back(Qt3DCore::QSceneChangePtr(new NodeCreatedChange(ids.last())));
+    }
+    // Splits the node creations in two runs
+    changes.insert(changes.begin() + firstRunSize, propertyUpdate(ids.first(), "prop1", 1));
+
+    QScopedPointer<tst_SimpleObserver> observer(new tst_SimpleObserver());
+    arbiter->registerObserver(observer.data(), ids.last());
+
+    // WHEN
+    arbiter->sceneChangeEventWithLock(changes);
+    arbiter->syncChanges();
+
+    // THEN -> each scene observer prepared each run from its own job, then
+    // got it at once from the syncing thread
+    QCOMPARE(arbiter->lastSyncStatistics().parallelJobs, 2);
+    for (tst_BulkSceneObserver *sceneObserver : { sceneObserver1.data(), sceneObserver2.data() }) {
+        QCOMPARE(sceneObserver->preparedRunSizes(), QVector<int>() << firstRunSize << secondRunSize);
+        QCOMPARE(sceneObserver->runSizes(), QVector<int>() << firstRunSize << secondRunSize);
+        QCOMPARE(sceneObserver->addedThreads(), QVector<QThread *>() << QThread::currentThread() << QThread::currentThread());
+        QCOMPARE(sceneObserver->addedChanges().size(), ids.size());
+        for (int i = 0; i < ids.size(); ++i)
+            QCOMPARE(sceneObserver->addedChanges().at(i)->subjectId(), ids.at(i));
+    }
+    QCOMPARE(observer->lastChanges().size(), 1);
+    QCOMPARE(observer->lastChange()->type(), Qt3DCore::NodeCreated);
+
+    // WHEN
+    sceneObserver1->clear();
+    sceneObserver2->clear();
+    observer->clear();
+    arbiter->setParallelDistributionEnabled(false);
+    arbiter->sceneChangeEventWithLock(changes);
+    arbiter->syncChanges();
+
+    // THEN
+    QCOMPARE(arbiter->lastSyncStatistics().parallelJobs, 0);
+    QCOMPARE(sceneObserver1->preparedRunSizes(), QVector<int>());
+    QCOMPARE(sceneObserver1->runSizes(), QVector<int>() << firstRunSize << secondRunSize);
+    QCOMPARE(sceneObserver2->preparedRunSizes(), QVector<int>());
+    QCOMPARE(sceneObserver2->runSizes(), QVector<int>() << firstRunSize << secondRunSize);
+    QCOMPARE(observer->lastChanges().size(), 1);
+
+    arbiter->unregisterSceneObserver(sceneObserver1.data());
+    arbiter->unregisterSceneObserver(sceneObserver2.data());
+    Qt3DCore::QChangeArbiter::destroyUnmanagedThreadLocalChangeQueue(arbiter.data());
+}
+
 QTEST_MAIN(tst_QChangeArbiter)
 
 #include "tst_qchangearbiter.moc"
@@ -48,18 +48,22 @@ public:
     NodeChangeReceiver(QNode *parent = nullptr)
         : QNode(parent)
         , m_hasReceivedChange(false)
+        , m_receivedChangeCount(0)
     {}
 
     inline bool hasReceivedChange() const { return m_hasReceivedChange; }
+    inline int receivedChangeCount() const { return m_receivedChangeCount; }
 
 protected:
     void sceneChangeEvent(const QSceneChangePtr &) override
     {
         m_hasReceivedChange = true;
+        ++m_receivedChangeCount;
     }
 
 private:
     bool m_hasReceivedChange;
+    int m_receivedChangeCount;
 };
 
 } // anonymous
@@ -118,6 +122,51 @@ private Q_SLOTS:
         QCOMPARE(receiverNode->hasReceivedChange(), true);
     }
 
+    void checkSceneChangeEventBatching()
+    {
+        // GIVEN
+        QScopedPointer<QScene> scene(new QScene);
+        QPostman postman;
+        TestArbiter arbiter;
+        QNode rootNode;
+        NodeChangeReceiver *receiverNode = new NodeChangeReceiver();
+
+        QNodePrivate::get(&rootNode)->m_scene = scene.data();
+        scene->setArbiter(&arbiter);
+        postman.setScene(scene.data());
+        static_cast<QNode *>(receiverNode)->setParent(&rootNode);
+        QCoreApplication::processEvents();
+
+        // WHEN
+        for (int i = 0; i < 3; ++i) {
+            QPropertyUpdatedChangePtr updateChange(new QPropertyUpdatedChange(receiverNode->id()));
+            updateChange->setValue(i);
+            updateChange->setPropertyName("someName");
+            postman.sceneChangeEvent(updateChange);
+        }
+
+        // THEN -> changes are held until the main thread processes the batch
+        QCOMPARE(receiverNode->receivedChangeCount(), 0);
+        QCOMPARE(int(QPostmanPrivate::get(&postman)->m_frontendBatch.size()), 3);
+
+        // WHEN
+        QCoreApplication::sendPostedEvents(&postman, QEvent::MetaCall);
+
+        // THEN -> a single posted event delivers the whole batch
+        QCOMPARE(receiverNode->receivedChangeCount(), 3);
+        QVERIFY(QPostmanPrivate::get(&postman)->m_frontendBatch.empty());
+
+        // WHEN
+        QPropertyUpdatedChangePtr updateChange(new QPropertyUpdatedChange(receiverNode->id()));
+        updateChange->setValue(3);
+        updateChange->setPropertyName("someName");
+        postman.sceneChangeEvent(updateChange);
+        QCoreApplication::processEvents();
+
+        // THEN -> a new batch is started once the previous one was delivered
+        QCOMPARE(receiverNode->receivedChangeCount(), 4);
+    }
+
     void checkNotifyBackend()
     {
         // GIVEN
@@ -50,6 +50,8 @@ private slots:
     void heavyDutyMultiThreadedAccessRelease();
     void collectResources();
     void activeHandles();
+    void lockFreeLookups();
+    void concurrentLockFreeLookups();
 };
 
 class tst_ArrayResource
@@ -420,10 +422,150 @@ void tst_QResourceManager::activeHandles()
         // THEN
         QVERIFY(manager.activeHandles().empty());
     }
+
+    {
+        // GIVEN
+        QVector<tHandle> handles;
+        for (uint i = 0; i < 10; ++i)
+            handles.push_back(manager.getOrAcquireHandle(i));
+
+        // WHEN
+        manager.releaseResource(0U);
+        manager.releaseResource(5U);
+        manager.releaseResource(9U);
+        manager.release(handles.at(5)); // Already released
+
+        // THEN
+        const QVector<tHandle> activeHandles = manager.activeHandles();
+        QCOMPARE(activeHandles.size(), 7);
+        for (uint i : {1U, 2U, 3U, 4U, 6U, 7U, 8U})
+            QVERIFY(activeHandles.contains(handles.at(i)));
+
+        // WHEN
+        for (uint i : {1U, 2U, 3U, 4U, 6U, 7U, 8U})
+            manager.releaseResource(i);
+
+        // THEN
+        QVERIFY(manager.activeHandles().empty());
+    }
+}
+
+
+void tst_QResourceManager::lockFreeLookups()
+{
+    // GIVEN
+    typedef Qt3DCore::QResourceManager<tst_ArrayResource,
+            uint,
+            Qt3DCore::ObjectLevelLockingPolicy> Manager;
+    Manager manager;
+
+    // WHEN
+    // Enough resources to grow the lookup index several times
+    QVector<tHandle> handles;
+    for (uint i = 0; i < 5000; ++i)
+        handles.push_back(manager.getOrAcquireHandle(i));
+
+    // THEN
+    for (uint i = 0; i < 5000; ++i) {
+        QVERIFY(manager.contains(i));
+        QCOMPARE(manager.lookupHandle(i), handles.at(i));
+        QCOMPARE(manager.getOrAcquireHandle(i), handles.at(i));
+    }
+    QVERIFY(!manager.contains(5000U));
+    QVERIFY(manager.lookupHandle(5000U).isNull());
+    QVERIFY(manager.lookupResource(5000U) == nullptr);
+
+    // WHEN
+    for (uint i = 0; i < 5000; i += 2)
+        manager.releaseResource(i);
+
+    // THEN
+    for (uint i = 0; i < 5000; ++i) {
+        QCOMPARE(manager.contains(i), (i % 2) == 1);
+        QCOMPARE(manager.lookupResource(i) != nullptr, (i % 2) == 1);
+    }
+
+    // WHEN
+    const tHandle newHandle = manager.getOrAcquireHandle(0U);
+
+    // THEN
+    QVERIFY(newHandle != handles.at(0));
+    QCOMPARE(manager.lookupHandle(0U), newHandle);
 }
 
+class tst_LookupThread : public QThread
+{
+    Q_OBJECT
+public:
 
+    typedef Qt3DCore::QResourceManager<tst_ArrayResource,
+    uint,
+    Qt3DCore::ObjectLevelLockingPolicy> Manager;
 
+    tst_LookupThread(Manager *manager, const QVector<tHandle> &handles,
+                     QAtomicInt *stop, QAtomicInt *failures)
+        : QThread()
+        , m_manager(manager)
+        , m_handles(handles)
+        , m_stop(stop)
+        , m_failures(failures)
+    {
+    }
+
+    // QThread interface
+protected:
+    void run()
+    {
+        // Even keys are never released while the thread runs
+        while (!m_stop->load()) {
+            for (int i = 0; i < m_handles.size(); ++i) {
+                if (m_manager->lookupHandle(uint(i * 2)) != m_handles.at(i))
+                    m_failures->fetchAndAddOrdered(1);
+            }
+        }
+    }
+
+    Manager *m_manager;
+    const QVector<tHandle> m_handles;
+    QAtomicInt *m_stop;
+    QAtomicInt *m_failures;
+};
+
+void tst_QResourceManager::concurrentLockFreeLookups()
+{
+    // GIVEN
+    tst_LookupThread::Manager manager;
+    QVector<tHandle> handles;
+    for (uint i = 0; i < 1000; ++i)
+        handles.push_back(manager.getOrAcquireHandle(i * 2));
+
+    QAtomicInt stop(0);
+    QAtomicInt failures(0);
+    QList<tst_LookupThread *> threads;
+    for (int i = 0; i < 4; ++i)
+        threads << new tst_LookupThread(&manager, handles, &stop, &failures);
+    for (tst_LookupThread *thread : qAsConst(threads))
+        thread->start();
+
+    // WHEN
+    // Odd keys are inserted and released while the readers look up, growing
+    // the index and replacing entries underneath them
+    for (int round = 0; round < 20; ++round) {
+        for (uint i = 0; i < 1000; ++i)
+            manager.getOrAcquireHandle(i * 2 + 1 + uint(round) * 2000);
+        for (uint i = 0; i < 1000; i += 2)
+            manager.releaseResource(i * 2 + 1 + uint(round) * 2000);
+    }
+    stop.store(1);
+    for (tst_LookupThread *thread : qAsConst(threads))
+        thread->wait();
+    qDeleteAll(threads);
+
+    // THEN
+    QCOMPARE(failures.load(), 0);
+    for (uint i = 0; i < 1000; ++i)
+        QCOMPARE(manager.lookupHandle(i * 2), handles.at(int(i)));
+}
 
 QTEST_APPLESS_MAIN(tst_QResourceManager)
 
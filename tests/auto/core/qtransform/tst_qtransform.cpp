@@ -31,6 +31,7 @@
 #include <Qt3DCore/qcomponent.h>
 #include <Qt3DCore/private/qtransform_p.h>
 #include <Qt3DCore/private/qnodecreatedchangegenerator_p.h>
+#include <Qt3DCore/private/qtypedpropertyupdatechange_p.h>
 #include <QtCore/qscopedpointer.h>
 #include "testpostmanarbiter.h"
 
@@ -126,11 +127,11 @@ private Q_SLOTS:
         QCoreApplication::processEvents();
 
         // THEN
-        Qt3DCore::QPropertyUpdatedChangePtr change;
+        QSharedPointer<Qt3DCore::QTypedPropertyUpdatedChangeBase> change;
         QCOMPARE(arbiter.events.size(), 1);
-        change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+        change = arbiter.events.first().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
         QCOMPARE(change->propertyName(), "translation");
-        QCOMPARE(change->value().value<QVector3D>(), QVector3D(454.0f, 427.0f, 383.0f));
+        QCOMPARE(change->value<QVector3D>(), QVector3D(454.0f, 427.0f, 383.0f));
 
         arbiter.events.clear();
 
@@ -141,9 +142,9 @@ private Q_SLOTS:
 
         // THEN
         QCOMPARE(arbiter.events.size(), 1);
-        change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+        change = arbiter.events.first().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
         QCOMPARE(change->propertyName(), "rotation");
-        QCOMPARE(change->value().value<QQuaternion>(), q);
+        QCOMPARE(change->value<QQuaternion>(), q);
 
         arbiter.events.clear();
 
@@ -153,9 +154,9 @@ private Q_SLOTS:
 
         // THEN
         QCOMPARE(arbiter.events.size(), 1);
-        change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+        change = arbiter.events.first().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
         QCOMPARE(change->propertyName(), "scale3D");
-        QCOMPARE(change->value().value<QVector3D>(), QVector3D(883.0f, 1200.0f, 1340.0f));
+        QCOMPARE(change->value<QVector3D>(), QVector3D(883.0f, 1200.0f, 1340.0f));
 
         arbiter.events.clear();
 
@@ -168,15 +169,15 @@ private Q_SLOTS:
 
         // THEN
         QCOMPARE(arbiter.events.size(), 3);
-        change = arbiter.events.takeFirst().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+        change = arbiter.events.takeFirst().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
         QCOMPARE(change->propertyName(), "scale3D");
-        QCOMPARE(change->value().value<QVector3D>(), QVector3D(1.0f, 1.0f, 1.0f));
-        change = arbiter.events.takeFirst().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+        QCOMPARE(change->value<QVector3D>(), QVector3D(1.0f, 1.0f, 1.0f));
+        change = arbiter.events.takeFirst().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
         QCOMPARE(change->propertyName(), "rotation");
-        QCOMPARE(change->value().value<QQuaternion>(), QQuaternion());
-        change = arbiter.events.takeFirst().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+        QCOMPARE(change->value<QQuaternion>(), QQuaternion());
+        change = arbiter.events.takeFirst().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
         QCOMPARE(change->propertyName(), "translation");
-        QCOMPARE(change->value().value<QVector3D>(), QVector3D());
+        QCOMPARE(change->value<QVector3D>(), QVector3D());
 
         arbiter.events.clear();
 
@@ -186,9 +187,9 @@ private Q_SLOTS:
 
         // THEN
         QCOMPARE(arbiter.events.size(), 1);
-        change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+        change = arbiter.events.first().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
         QCOMPARE(change->propertyName(), "rotation");
-        QCOMPARE(change->value().value<QQuaternion>().toEulerAngles().x(), 20.0f);
+        QCOMPARE(change->value<QQuaternion>().toEulerAngles().x(), 20.0f);
 
         arbiter.events.clear();
     }
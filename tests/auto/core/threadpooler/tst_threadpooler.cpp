@@ -64,6 +64,8 @@ private Q_SLOTS:
     void defaultAspectQueue();
     void doubleAspectQueue();
     void dependencyAspectQueue();
+    void reusedDependencyAspectQueue();
+    void recreatedDependencyAspectQueue();
     void massTest();
     void perThreadUniqueCall();
 };
@@ -284,6 +286,80 @@ void tst_ThreadPooler::dependencyAspectQueue()
     QVERIFY(value == 8);
 }
 
+/*
+ * The same jobs submitted over several frames reuse the cached job graph,
+ * make sure dependencies are still honored and that topology changes are
+ * picked up.
+ */
+void tst_ThreadPooler::reusedDependencyAspectQueue()
+{
+    // GIVEN
+    QAtomicInt callCounter; // Not used in this test
+    int value = 0;
+    QVector<QSharedPointer<Qt3DCore::QAspectJob> > jobList;
+    QSharedPointer<TestAspectJob> job1(new TestAspectJob(add2, &callCounter, &value));
+    QSharedPointer<TestAspectJob> job2(new TestAspectJob(multiplyBy2, &callCounter, &value));
+    job2->addDependency(job1);
+    jobList << job2 << job1;
+
+    // WHEN
+    for (int frame = 0; frame < 3; ++frame) {
+        value = 2;
+        m_jobManager->enqueueJobs(jobList);
+        m_jobManager->waitForAllJobs();
+
+        // THEN
+        // value should be (2+2)*2 = 8
+        QCOMPARE(value, 8);
+    }
+
+    // WHEN
+    job2->removeDependency(job1);
+    job1->addDependency(job2);
+    for (int frame = 0; frame < 3; ++frame) {
+        value = 2;
+        m_jobManager->enqueueJobs(jobList);
+        m_jobManager->waitForAllJobs();
+
+        // THEN
+        // value should be (2*2)+2 = 6
+        QCOMPARE(value, 6);
+    }
+}
+
+/*
+ * Jobs recreated every frame with the same dependencies between them, as
+ * done by RenderViewBuilder, share the cached job graph since it only depends
+ * on the structure of the queue.
+ */
+void tst_ThreadPooler::recreatedDependencyAspectQueue()
+{
+    // GIVEN
+    QAtomicInt callCounter; // Not used in this test
+    int value = 0;
+
+    for (int frame = 0; frame < 4; ++frame) {
+        // WHEN
+        const bool swapped = frame > 1;
+        QSharedPointer<TestAspectJob> job1(new TestAspectJob(add2, &callCounter, &value));
+        QSharedPointer<TestAspectJob> job2(new TestAspectJob(multiplyBy2, &callCounter, &value));
+        if (swapped)
+            job1->addDependency(job2);
+        else
+            job2->addDependency(job1);
+        QVector<QSharedPointer<Qt3DCore::QAspectJob> > jobList;
+        jobList << job2 << job1;
+
+        value = 2;
+        m_jobManager->enqueueJobs(jobList);
+        m_jobManager->waitForAllJobs();
+
+        // THEN
+        // value should be (2+2)*2 = 8 or (2*2)+2 = 6 once swapped
+        QCOMPARE(value, swapped ? 6 : 8);
+    }
+}
+
 void tst_ThreadPooler::massTest()
 {
     // GIVEN
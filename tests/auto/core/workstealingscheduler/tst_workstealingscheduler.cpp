@@ -0,0 +1,187 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QTest>
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
+#include <QtCore/QThread>
+#include <Qt3DCore/qaspectjob.h>
+#include <Qt3DCore/private/qworkstealingscheduler_p.h>
+
+namespace {
+
+class AppendJob : public Qt3DCore::QAspectJob
+{
+public:
+    AppendJob(int id, QVector<int> *order, QMutex *mutex)
+        : m_id(id)
+        , m_order(order)
+        , m_mutex(mutex)
+    {}
+
+    void run() override
+    {
+        const QMutexLocker lock(m_mutex);
+        m_order->push_back(m_id);
+    }
+
+private:
+    const int m_id;
+    QVector<int> *m_order;
+    QMutex *m_mutex;
+};
+
+struct PerWorkerData
+{
+    QMutex mutex;
+    QSet<QThread *> threads;
+    int callCount = 0;
+};
+
+void recordWorkerThread(void *arg)
+{
+    PerWorkerData *data = static_cast<PerWorkerData *>(arg);
+    const QMutexLocker lock(&data->mutex);
+    data->threads.insert(QThread::currentThread());
+    ++data->callCount;
+}
+
+} // anonymous
+
+class tst_WorkStealingScheduler : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+
+    void checkRunsAllJobs()
+    {
+        // GIVEN
+        Qt3DCore::QWorkStealingScheduler scheduler(4);
+        QVector<int> order;
+        QMutex mutex;
+        QVector<Qt3DCore::QAspectJobPtr> jobs;
+        for (int i = 0; i < 500; ++i)
+            jobs.push_back(Qt3DCore::QAspectJobPtr(new AppendJob(i, &order, &mutex)));
+
+        // WHEN
+        scheduler.schedule(jobs);
+        scheduler.waitForAllJobs();
+
+        // THEN
+        QCOMPARE(order.size(), 500);
+        std::sort(order.begin(), order.end());
+        for (int i = 0; i < 500; ++i)
+            QCOMPARE(order.at(i), i);
+    }
+
+    void checkRespectsDependencies()
+    {
+        // GIVEN
+        Qt3DCore::QWorkStealingScheduler scheduler(4);
+        QVector<int> order;
+        QMutex mutex;
+        QVector<Qt3DCore::QAspectJobPtr> jobs;
+
+        // Diamonds chained one after the other: a -> (b, c) -> d -> ...
+        const int diamondCount = 50;
+        Qt3DCore::QAspectJobPtr previous;
+        for (int i = 0; i < diamondCount; ++i) {
+            Qt3DCore::QAspectJobPtr a(new AppendJob(i * 4, &order, &mutex));
+            Qt3DCore::QAspectJobPtr b(new AppendJob(i * 4 + 1, &order, &mutex));
+            Qt3DCore::QAspectJobPtr c(new AppendJob(i * 4 + 2, &order, &mutex));
+            Qt3DCore::QAspectJobPtr d(new AppendJob(i * 4 + 3, &order, &mutex));
+            if (previous)
+                a->addDependency(previous);
+            b->addDependency(a);
+            c->addDependency(a);
+            d->addDependency(b);
+            d->addDependency(c);
+            // Insert in reverse order to make sure ordering doesn't come from the queue
+            jobs << d << c << b << a;
+            previous = d;
+        }
+
+        // WHEN
+        for (int frame = 0; frame < 3; ++frame) {
+            order.clear();
+            scheduler.schedule(jobs);
+            scheduler.waitForAllJobs();
+
+            // THEN
+            QCOMPARE(order.size(), diamondCount * 4);
+            for (int i = 0; i < diamondCount; ++i) {
+                const int a = order.indexOf(i * 4);
+                const int b = order.indexOf(i * 4 + 1);
+                const int c = order.indexOf(i * 4 + 2);
+                const int d = order.indexOf(i * 4 + 3);
+                QVERIFY(a < b);
+                QVERIFY(a < c);
+                QVERIFY(b < d);
+                QVERIFY(c < d);
+                if (i > 0)
+                    QVERIFY(order.indexOf(i * 4 - 1) < a);
+            }
+        }
+    }
+
+    void checkIgnoresDependenciesOutsideOfQueue()
+    {
+        // GIVEN
+        Qt3DCore::QWorkStealingScheduler scheduler(2);
+        QVector<int> order;
+        QMutex mutex;
+        Qt3DCore::QAspectJobPtr notScheduled(new AppendJob(0, &order, &mutex));
+        Qt3DCore::QAspectJobPtr scheduled(new AppendJob(1, &order, &mutex));
+        scheduled->addDependency(notScheduled);
+
+        // WHEN
+        scheduler.schedule(QVector<Qt3DCore::QAspectJobPtr>() << scheduled);
+        scheduler.waitForAllJobs();
+
+        // THEN
+        QCOMPARE(order, QVector<int>() << 1);
+    }
+
+    void checkRunOnEachWorker()
+    {
+        // GIVEN
+        Qt3DCore::QWorkStealingScheduler scheduler(4);
+        PerWorkerData data;
+
+        // WHEN
+        scheduler.runOnEachWorker(recordWorkerThread, &data);
+
+        // THEN
+        QCOMPARE(data.callCount, scheduler.workerCount());
+        QCOMPARE(data.threads.size(), scheduler.workerCount());
+    }
+};
+
+QTEST_APPLESS_MAIN(tst_WorkStealingScheduler)
+
+#include "tst_workstealingscheduler.moc"
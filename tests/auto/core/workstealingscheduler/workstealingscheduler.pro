@@ -0,0 +1,7 @@
+TARGET = tst_workstealingscheduler
+CONFIG += testcase
+TEMPLATE = app
+
+SOURCES += tst_workstealingscheduler.cpp
+
+QT += testlib 3dcore 3dcore-private
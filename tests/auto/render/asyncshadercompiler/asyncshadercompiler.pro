@@ -0,0 +1,13 @@
+TEMPLATE = app
+
+TARGET = tst_asyncshadercompiler
+
+QT += 3dcore 3dcore-private 3drender 3drender-private testlib
+
+CONFIG += testcase
+
+SOURCES += \
+    tst_asyncshadercompiler.cpp
+
+include(../../core/common/common.pri)
+include(../commons/commons.pri)
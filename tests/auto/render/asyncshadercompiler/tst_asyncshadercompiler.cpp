@@ -0,0 +1,322 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QTest>
+#include <Qt3DRender/private/asyncshadercompiler_p.h>
+#include <Qt3DRender/private/commandthread_p.h>
+#include <Qt3DRender/private/glcommands_p.h>
+#include <Qt3DRender/private/graphicscontext_p.h>
+#include <Qt3DRender/private/offscreensurfacehelper_p.h>
+#include <Qt3DRender/private/shadercache_p.h>
+#include <Qt3DRender/private/shader_p.h>
+#include <QtGui/qoffscreensurface.h>
+#include <QtGui/qopenglcontext.h>
+#include <QtGui/qopenglshaderprogram.h>
+#include "testrenderer.h"
+
+using namespace Qt3DRender;
+using namespace Qt3DRender::Render;
+
+namespace {
+
+const QByteArray vertexShaderCode = QByteArrayLiteral(
+            "attribute vec4 vertexPosition;\n"
+            "void main() { gl_Position = vertexPosition; }\n");
+
+const QByteArray fragmentShaderCode = QByteArrayLiteral(
+            "#ifdef GL_ES\n"
+            "precision mediump float;\n"
+            "#endif\n"
+            "void main() { gl_FragColor = vec4(1.0); }\n");
+
+// Blocks the CommandThread until proceed is released or timeout elapsed
+class BlockingCommand : public GLCommand
+{
+public:
+    explicit BlockingCommand(int timeout = -1)
+        : m_timeout(timeout)
+    {
+    }
+
+    void execute(Renderer *, GraphicsContext *) override
+    {
+        started.release();
+        proceed.tryAcquire(1, m_timeout);
+        executed.storeRelease(1);
+    }
+
+    QSemaphore started;
+    QSemaphore proceed;
+    QAtomicInt executed;
+
+private:
+    const int m_timeout;
+};
+
+} // anonymous
+
+class tst_AsyncShaderCompiler : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init()
+    {
+        m_initializationSuccessful = false;
+
+        m_surface.reset(new QOffscreenSurface);
+        m_surface->setFormat(m_renderer.format());
+        m_surface->create();
+
+        m_glContext.reset(new QOpenGLContext);
+        m_glContext->setFormat(m_renderer.format());
+        if (!m_glContext->create()) {
+            qWarning() << "Failed to create OpenGL context";
+            return;
+        }
+
+        m_graphicsContext.reset(new GraphicsContext);
+        m_graphicsContext->setShaderCache(&m_shaderCache);
+        m_graphicsContext->setOpenGLContext(m_glContext.data());
+        if (!m_graphicsContext->makeCurrent(m_surface.data())) {
+            qWarning() << "Failed to make OpenGL context current";
+            return;
+        }
+
+        m_offscreenSurfaceHelper.reset(new OffscreenSurfaceHelper(&m_renderer));
+        m_offscreenSurfaceHelper->createOffscreenSurface();
+
+        m_commandThread.reset(new CommandThread(nullptr));
+        m_commandThread->setShaderCache(&m_shaderCache);
+        m_commandThread->initialize(m_glContext.data(), m_offscreenSurfaceHelper.data());
+
+        m_shader.setRenderer(&m_renderer);
+        m_shader.setShaderCode(QShaderProgram::Vertex, vertexShaderCode);
+        m_shader.setShaderCode(QShaderProgram::Fragment, fragmentShaderCode);
+
+        m_initializationSuccessful = true;
+    }
+
+    void cleanup()
+    {
+        if (m_commandThread)
+            m_commandThread->shutdown();
+        m_commandThread.reset();
+        if (m_graphicsContext && m_initializationSuccessful)
+            m_graphicsContext->doneCurrent();
+        m_graphicsContext.reset();
+        m_glContext.reset();
+        m_offscreenSurfaceHelper.reset();
+        m_surface.reset();
+    }
+
+    void enqueuedCommandsArePendingUntilExecuted()
+    {
+        if (!m_initializationSuccessful)
+            QSKIP("Initialization failed, OpenGL not available");
+
+        // GIVEN
+        BlockingCommand blocking;
+        BlockingCommand queued(0);
+
+        // WHEN
+        m_commandThread->enqueueCommand(&blocking);
+        m_commandThread->enqueueCommand(&queued);
+        blocking.started.acquire();
+
+        // THEN the executing command can't be dequeued, the pending one can
+        QCOMPARE(m_commandThread->dequeueCommand(&blocking), false);
+        QCOMPARE(m_commandThread->dequeueCommand(&queued), true);
+        QCOMPARE(m_commandThread->dequeueCommand(&queued), false);
+
+        // WHEN
+        m_commandThread->enqueueCommand(&queued);
+        blocking.proceed.release();
+
+        // THEN
+        QVERIFY(queued.started.tryAcquire(1, 5000));
+        QTRY_COMPARE(queued.executed.loadAcquire(), 1);
+        QCOMPARE(blocking.executed.loadAcquire(), 1);
+    }
+
+    void waitForCommandBlocksUntilExecuted()
+    {
+        if (!m_initializationSuccessful)
+            QSKIP("Initialization failed, OpenGL not available");
+
+        // GIVEN
+        BlockingCommand blocking(100);
+        BlockingCommand other(0);
+
+        // WHEN
+        m_commandThread->enqueueCommand(&blocking);
+        blocking.started.acquire();
+
+        // THEN waiting for a command which isn't executing returns immediately
+        m_commandThread->waitForCommand(&other);
+        QCOMPARE(blocking.executed.loadAcquire(), 0);
+
+        // WHEN
+        m_commandThread->waitForCommand(&blocking);
+
+        // THEN
+        QCOMPARE(blocking.executed.loadAcquire(), 1);
+    }
+
+    void compileCompletes()
+    {
+        if (!m_initializationSuccessful)
+            QSKIP("Initialization failed, OpenGL not available");
+
+        // GIVEN
+        AsyncShaderCompiler compiler(m_graphicsContext.data(), m_commandThread.data());
+        const ProgramDNA dna = m_shader.dna();
+
+        // THEN
+        QCOMPARE(compiler.mode(), AsyncShaderCompiler::Unresolved);
+        QCOMPARE(compiler.isRequested(dna), false);
+        QCOMPARE(compiler.isCompleted(dna), false);
+
+        // WHEN
+        compiler.request(&m_shader);
+        compiler.request(&m_shader);
+
+        // THEN
+        QVERIFY(compiler.mode() != AsyncShaderCompiler::Unresolved);
+        QCOMPARE(compiler.isRequested(dna), true);
+        QCOMPARE(compiler.pendingCount(), 1);
+        QTRY_VERIFY(compiler.isCompleted(dna));
+
+        // WHEN
+        QString log;
+        QScopedPointer<QOpenGLShaderProgram> shaderProgram(compiler.takeShaderProgram(dna, &log));
+
+        // THEN
+        QVERIFY2(!shaderProgram.isNull(), qPrintable(log));
+        QVERIFY(shaderProgram->isLinked());
+        QCOMPARE(compiler.isRequested(dna), false);
+        QCOMPARE(compiler.pendingCount(), 0);
+    }
+
+    void compileIsPendingWhileCommandThreadIsBusy()
+    {
+        if (!m_initializationSuccessful)
+            QSKIP("Initialization failed, OpenGL not available");
+
+        // GIVEN
+        AsyncShaderCompiler compiler(m_graphicsContext.data(), m_commandThread.data());
+        const ProgramDNA dna = m_shader.dna();
+        BlockingCommand blocking;
+        m_commandThread->enqueueCommand(&blocking);
+        blocking.started.acquire();
+
+        // WHEN
+        compiler.request(&m_shader);
+        if (compiler.mode() != AsyncShaderCompiler::CompileThread) {
+            blocking.proceed.release();
+            m_commandThread->waitForCommand(&blocking);
+            QSKIP("Programs are built by the driver");
+        }
+
+        // THEN
+        QCOMPARE(compiler.isCompleted(dna), false);
+
+        // WHEN builds no Shader wait for anymore are kept while pending
+        compiler.releaseUnrequested(QSet<ProgramDNA>());
+
+        // THEN
+        QCOMPARE(compiler.isRequested(dna), true);
+
+        // WHEN
+        blocking.proceed.release();
+
+        // THEN
+        QTRY_VERIFY(compiler.isCompleted(dna));
+
+        // WHEN
+        compiler.releaseUnrequested(QSet<ProgramDNA>());
+
+        // THEN
+        QCOMPARE(compiler.isRequested(dna), false);
+        QCOMPARE(compiler.pendingCount(), 0);
+    }
+
+    void releaseWhilePending()
+    {
+        if (!m_initializationSuccessful)
+            QSKIP("Initialization failed, OpenGL not available");
+
+        // GIVEN
+        BlockingCommand blocking;
+        BlockingCommand next(0);
+        m_commandThread->enqueueCommand(&blocking);
+        blocking.started.acquire();
+
+        // WHEN the build is still queued
+        {
+            AsyncShaderCompiler compiler(m_graphicsContext.data(), m_commandThread.data());
+            compiler.request(&m_shader);
+        }
+        m_commandThread->enqueueCommand(&next);
+        blocking.proceed.release();
+
+        // THEN the thread proceeds with the next command, skipping the
+        // released one
+        QVERIFY(next.started.tryAcquire(1, 5000));
+        m_commandThread->waitForCommand(&next);
+
+        // WHEN the build may be executing
+        {
+            AsyncShaderCompiler compiler(m_graphicsContext.data(), m_commandThread.data());
+            compiler.request(&m_shader);
+        }
+
+        // THEN the CommandThread is still usable
+        BlockingCommand last(0);
+        m_commandThread->enqueueCommand(&last);
+        QVERIFY(last.started.tryAcquire(1, 5000));
+        m_commandThread->waitForCommand(&last);
+        QCOMPARE(last.executed.loadAcquire(), 1);
+    }
+
+private:
+    TestRenderer m_renderer;
+    ShaderCache m_shaderCache;
+    Shader m_shader;
+    QScopedPointer<QOffscreenSurface> m_surface;
+    QScopedPointer<QOpenGLContext> m_glContext;
+    QScopedPointer<GraphicsContext> m_graphicsContext;
+    QScopedPointer<OffscreenSurfaceHelper> m_offscreenSurfaceHelper;
+    QScopedPointer<CommandThread> m_commandThread;
+    bool m_initializationSuccessful = false;
+};
+
+QTEST_MAIN(tst_AsyncShaderCompiler)
+
+#include "tst_asyncshadercompiler.moc"
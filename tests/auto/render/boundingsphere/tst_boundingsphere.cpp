@@ -34,6 +34,7 @@
 #include <QtTest/QTest>
 #include <Qt3DCore/qentity.h>
 #include <Qt3DCore/qtransform.h>
+#include <Qt3DCore/qpropertyupdatedchange.h>
 #include <Qt3DCore/private/qnodecreatedchangegenerator_p.h>
 #include <Qt3DCore/private/qaspectjobmanager_p.h>
 #include <QtQuick/qquickwindow.h>
@@ -431,6 +432,81 @@ private Q_SLOTS:
         QVERIFY(int(center.y()) == int(expectedCenter.y()));
         QVERIFY(int(center.z()) == int(expectedCenter.z()));
     }
+
+    void checkPartialTransformUpdate()
+    {
+        // GIVEN
+        QScopedPointer<Qt3DCore::QEntity> root(new Qt3DCore::QEntity());
+        Qt3DCore::QEntity *entityA = new Qt3DCore::QEntity(root.data());
+        Qt3DCore::QEntity *entityB = new Qt3DCore::QEntity(root.data());
+        Qt3DCore::QEntity *entityC = new Qt3DCore::QEntity(entityA);
+        Qt3DCore::QTransform *transformA = new Qt3DCore::QTransform();
+        const QVector<Qt3DCore::QEntity *> entities = { entityA, entityB, entityC };
+        for (Qt3DCore::QEntity *entity : entities) {
+            Qt3DCore::QTransform *transform = (entity == entityA) ? transformA : new Qt3DCore::QTransform();
+            transform->setTranslation(QVector3D(1.0f, 2.0f, 3.0f));
+            entity->addComponent(transform);
+            entity->addComponent(new Qt3DExtras::QSphereMesh());
+        }
+
+        QScopedPointer<Qt3DRender::TestAspect> test(new Qt3DRender::TestAspect(root.data()));
+        runRequiredJobs(test.data());
+
+        Qt3DRender::Render::NodeManagers *managers = test->nodeManagers();
+        Qt3DRender::Render::TransformManager *transformManager = managers->transformManager();
+        Qt3DRender::Render::EntityManager *entityManager = managers->renderNodesManager();
+        Qt3DRender::Render::Entity *backendA = entityManager->lookupResource(entityA->id());
+        Qt3DRender::Render::Entity *backendC = entityManager->lookupResource(entityC->id());
+
+        // Scene creation invalidates the whole hierarchy
+        bool entityHierarchyDirty = false;
+        QVector<Qt3DRender::Render::Entity *> dirtySubtreeRoots = transformManager->takeDirtySubtreeRoots(entityManager, &entityHierarchyDirty);
+        QVERIFY(entityHierarchyDirty);
+        QVERIFY(dirtySubtreeRoots.isEmpty());
+
+        // WHEN
+        const auto change = Qt3DCore::QPropertyUpdatedChangePtr::create(transformA->id());
+        change->setPropertyName("translation");
+        change->setValue(QVariant::fromValue(QVector3D(-50.0f, 0.0f, 10.0f)));
+        transformManager->lookupResource(transformA->id())->sceneChangeEvent(change);
+        dirtySubtreeRoots = transformManager->takeDirtySubtreeRoots(entityManager, &entityHierarchyDirty);
+
+        // THEN
+        QVERIFY(!entityHierarchyDirty);
+        QCOMPARE(dirtySubtreeRoots.size(), 1);
+        QCOMPARE(dirtySubtreeRoots.first(), backendA);
+
+        // WHEN
+        Qt3DRender::Render::UpdateWorldTransformJob updateWorldTransform;
+        updateWorldTransform.setDirtySubtreeRoots(dirtySubtreeRoots);
+        updateWorldTransform.run();
+
+        Qt3DRender::Render::UpdateWorldBoundingVolumeJob updateWorldBVolume;
+        updateWorldBVolume.setManager(entityManager);
+        updateWorldBVolume.setDirtySubtreeRoots(dirtySubtreeRoots);
+        updateWorldBVolume.run();
+
+        Qt3DRender::Render::ExpandBoundingVolumeJob expandBVolume;
+        expandBVolume.setDirtySubtreeRoots(dirtySubtreeRoots);
+        expandBVolume.run();
+
+        const Matrix4x4 partialWorldTransformC = *backendC->worldTransform();
+        const Qt3DRender::Render::Sphere partialSceneSphere = *test->sceneRoot()->worldBoundingVolumeWithChildren();
+
+        // THEN
+        QCOMPARE(convertToQMatrix4x4(partialWorldTransformC).column(3), QVector4D(-49.0f, 2.0f, 13.0f, 1.0f));
+
+        // WHEN
+        runRequiredJobs(test.data());
+
+        // THEN
+        const Qt3DRender::Render::Sphere fullSceneSphere = *test->sceneRoot()->worldBoundingVolumeWithChildren();
+        QCOMPARE(convertToQMatrix4x4(*backendC->worldTransform()), convertToQMatrix4x4(partialWorldTransformC));
+        QCOMPARE(partialSceneSphere.radius(), fullSceneSphere.radius());
+        QCOMPARE(partialSceneSphere.center().x(), fullSceneSphere.center().x());
+        QCOMPARE(partialSceneSphere.center().y(), fullSceneSphere.center().y());
+        QCOMPARE(partialSceneSphere.center().z(), fullSceneSphere.center().z());
+    }
 };
 
 QTEST_MAIN(tst_BoundingSphere)
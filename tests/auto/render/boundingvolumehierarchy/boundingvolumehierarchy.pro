@@ -0,0 +1,13 @@
+TEMPLATE = app
+
+TARGET = tst_boundingvolumehierarchy
+
+QT += core-private 3dcore 3dcore-private 3drender 3drender-private testlib
+
+CONFIG += testcase
+
+SOURCES += tst_boundingvolumehierarchy.cpp
+
+CONFIG += useCommonTestAspect
+
+include(../commons/commons.pri)
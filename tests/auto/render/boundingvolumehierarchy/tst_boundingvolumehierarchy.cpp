@@ -0,0 +1,362 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QTest>
+#include <Qt3DCore/qentity.h>
+#include <Qt3DCore/qtransform.h>
+#include <Qt3DRender/private/nodemanagers_p.h>
+#include <Qt3DRender/private/managers_p.h>
+#include <Qt3DRender/private/entity_p.h>
+#include <Qt3DRender/private/sphere_p.h>
+#include <Qt3DRender/private/qray3d_p.h>
+#include <Qt3DRender/private/renderview_p.h>
+#include <Qt3DRender/private/boundingvolumehierarchy_p.h>
+#include <Qt3DRender/private/frustumcullingjob_p.h>
+#include <Qt3DRender/private/pickboundingvolumeutils_p.h>
+#include <Qt3DRender/private/updatetreeenabledjob_p.h>
+#include <Qt3DRender/private/updateworldtransformjob_p.h>
+#include <Qt3DRender/private/updateworldboundingvolumejob_p.h>
+#include <Qt3DRender/private/calcboundingvolumejob_p.h>
+#include <Qt3DRender/private/expandboundingvolumejob_p.h>
+
+#include <algorithm>
+
+#include "testaspect.h"
+
+using namespace Qt3DRender;
+using namespace Qt3DRender::Render;
+
+namespace {
+
+const int GroupCount = 20;
+const int EntitiesPerGroup = 50;
+
+Qt3DCore::QEntity *buildTestScene()
+{
+    Qt3DCore::QEntity *root = new Qt3DCore::QEntity();
+    for (int i = 0; i < GroupCount; ++i) {
+        Qt3DCore::QEntity *group = new Qt3DCore::QEntity(root);
+        for (int j = 0; j < EntitiesPerGroup; ++j)
+            new Qt3DCore::QEntity(group);
+    }
+    return root;
+}
+
+QVector<Entity *> gatherEntities(Entity *root)
+{
+    QVector<Entity *> entities = { root };
+    for (int i = 0; i < entities.size(); ++i)
+        entities += entities.at(i)->children();
+    std::sort(entities.begin(), entities.end());
+    return entities;
+}
+
+// Spreads the entities over a 200 units wide cube, the children of a group
+// being clustered around it
+void placeEntities(const QVector<Entity *> &entities, float offset)
+{
+    for (int i = 0, m = entities.size(); i < m; ++i) {
+        const float x = std::fmod(i * 37.17f + offset, 200.0f) - 100.0f;
+        const float y = std::fmod(i * 71.93f + 2.0f * offset, 200.0f) - 100.0f;
+        const float z = std::fmod(i * 13.61f, 200.0f) - 100.0f;
+        const float radius = 0.5f + float(i % 5);
+        *entities.at(i)->worldBoundingVolume() = Sphere(Vector3D(x, y, z), radius);
+        *entities.at(i)->worldBoundingVolumeWithChildren() = Sphere(Vector3D(x, y, z), radius);
+    }
+}
+
+Matrix4x4 viewProjection(const QVector3D &eye)
+{
+    QMatrix4x4 projection;
+    projection.perspective(45.0f, 1.0f, 0.1f, 80.0f);
+    QMatrix4x4 view;
+    view.lookAt(eye, QVector3D(), QVector3D(0.0f, 1.0f, 0.0f));
+    return Matrix4x4(projection * view);
+}
+
+QVector<Entity *> sorted(QVector<Entity *> entities)
+{
+    std::sort(entities.begin(), entities.end());
+    return entities;
+}
+
+} // anonymous
+
+class tst_BoundingVolumeHierarchy : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+
+    void checkInitialState()
+    {
+        // GIVEN
+        BoundingVolumeHierarchy hierarchy;
+
+        // THEN
+        QVERIFY(!hierarchy.isValid());
+        QVERIFY(hierarchy.root() == nullptr);
+        QCOMPARE(hierarchy.entityCount(), 0);
+        QCOMPARE(hierarchy.nodeCount(), 0);
+        QVERIFY(hierarchy.rayQuery(RayCasting::QRay3D(Vector3D())).isEmpty());
+        QVERIFY(hierarchy.proximityQuery(Vector3D(), 1000.0f).isEmpty());
+    }
+
+    void checkBuildAndInvalidate()
+    {
+        // GIVEN
+        QScopedPointer<Qt3DCore::QEntity> scene(buildTestScene());
+        QScopedPointer<TestAspect> aspect(new TestAspect(scene.data()));
+        Entity *backendRoot = aspect->nodeManagers()->renderNodesManager()->getOrCreateResource(scene->id());
+        const QVector<Entity *> entities = gatherEntities(backendRoot);
+        placeEntities(entities, 0.0f);
+        BoundingVolumeHierarchy hierarchy;
+
+        // WHEN
+        hierarchy.build(backendRoot);
+
+        // THEN
+        QVERIFY(hierarchy.isValid());
+        QCOMPARE(hierarchy.root(), backendRoot);
+        QCOMPARE(hierarchy.entityCount(), 1 + GroupCount * (1 + EntitiesPerGroup));
+        QVERIFY(hierarchy.nodeCount() > 1);
+        QVERIFY(hierarchy.nodeCount() < 2 * hierarchy.entityCount());
+        QCOMPARE(sorted(hierarchy.proximityQuery(Vector3D(), 1000.0f)), entities);
+        QVector<bool> indexed(hierarchy.entityCount(), false);
+        for (Entity *entity : entities) {
+            const int primitiveIndex = hierarchy.primitiveIndex(entity);
+            QVERIFY(primitiveIndex >= 0 && primitiveIndex < indexed.size());
+            QVERIFY(!indexed.at(primitiveIndex));
+            QCOMPARE(entity->boundingVolumeHierarchyIndex(), primitiveIndex);
+            indexed[primitiveIndex] = true;
+        }
+
+        // WHEN
+        hierarchy.invalidate();
+
+        // THEN
+        QVERIFY(!hierarchy.isValid());
+        QCOMPARE(hierarchy.entityCount(), 0);
+        QCOMPARE(hierarchy.nodeCount(), 0);
+        for (Entity *entity : entities)
+            QCOMPARE(hierarchy.primitiveIndex(entity), -1);
+    }
+
+    void checkFrustumQuery_data()
+    {
+        QTest::addColumn<QVector3D>("eye");
+
+        QTest::newRow("outside") << QVector3D(0.0f, 0.0f, 150.0f);
+        QTest::newRow("inside") << QVector3D(10.0f, 20.0f, 30.0f);
+        QTest::newRow("corner") << QVector3D(-120.0f, 120.0f, -120.0f);
+        QTest::newRow("away") << QVector3D(500.0f, 500.0f, 500.0f);
+    }
+
+    void checkFrustumQuery()
+    {
+        QFETCH(QVector3D, eye);
+
+        // GIVEN
+        QScopedPointer<Qt3DCore::QEntity> scene(buildTestScene());
+        QScopedPointer<TestAspect> aspect(new TestAspect(scene.data()));
+        Entity *backendRoot = aspect->nodeManagers()->renderNodesManager()->getOrCreateResource(scene->id());
+        const QVector<Entity *> entities = gatherEntities(backendRoot);
+        placeEntities(entities, 0.0f);
+        BoundingVolumeHierarchy hierarchy;
+        hierarchy.build(backendRoot);
+
+        FrustumCullingJob cullingJob;
+        cullingJob.setActive(true);
+        cullingJob.setEntities(entities);
+        cullingJob.setViewProjection(viewProjection(eye));
+
+        // WHEN
+        cullingJob.run();
+        const QVector<Entity *> expectedEntities = cullingJob.visibleEntities();
+
+        cullingJob.setBoundingVolumeHierarchy(&hierarchy);
+        cullingJob.run();
+
+        // THEN
+        QCOMPARE(cullingJob.visibleEntities(), expectedEntities);
+    }
+
+    void checkRayAndProximityQueries()
+    {
+        // GIVEN
+        QScopedPointer<Qt3DCore::QEntity> scene(buildTestScene());
+        QScopedPointer<TestAspect> aspect(new TestAspect(scene.data()));
+        Entity *backendRoot = aspect->nodeManagers()->renderNodesManager()->getOrCreateResource(scene->id());
+        const QVector<Entity *> entities = gatherEntities(backendRoot);
+        placeEntities(entities, 0.0f);
+        BoundingVolumeHierarchy hierarchy;
+        hierarchy.build(backendRoot);
+
+        for (int i = 0; i < 20; ++i) {
+            const Vector3D origin(float(i * 10 - 100), 150.0f, float(i * 7 - 70));
+            const Vector3D target(float(50 - i * 5), -100.0f, float(i * 3));
+            const RayCasting::QRay3D ray(origin, (target - origin).normalized(), 1000.0f);
+
+            // WHEN
+            const QVector<Entity *> rayCandidates = hierarchy.rayQuery(ray);
+            const QVector<Entity *> proximityCandidates = hierarchy.proximityQuery(target, 40.0f);
+
+            // THEN
+            for (Entity *entity : entities) {
+                if (entity->worldBoundingVolume()->intersects(ray, nullptr))
+                    QVERIFY(rayCandidates.contains(entity));
+                if ((entity->worldBoundingVolumeWithChildren()->center() - target).lengthSquared() <= 40.0f * 40.0f)
+                    QVERIFY(proximityCandidates.contains(entity));
+            }
+            QVERIFY(rayCandidates.size() < entities.size());
+            QVERIFY(proximityCandidates.size() < entities.size());
+        }
+    }
+
+    void checkPickerUsesHierarchy()
+    {
+        // GIVEN
+        QScopedPointer<Qt3DCore::QEntity> scene(buildTestScene());
+        QScopedPointer<TestAspect> aspect(new TestAspect(scene.data()));
+        NodeManagers *managers = aspect->nodeManagers();
+        Entity *backendRoot = managers->renderNodesManager()->getOrCreateResource(scene->id());
+        const QVector<Entity *> entities = gatherEntities(backendRoot);
+        placeEntities(entities, 0.0f);
+
+        // The scene graph traversal relies on the bounding volumes with children
+        ExpandBoundingVolumeJob expandJob;
+        expandJob.setRoot(backendRoot);
+        expandJob.run();
+
+        const Vector3D origin(-100.0f, 120.0f, 100.0f);
+        const Vector3D target = entities.at(10)->worldBoundingVolume()->center();
+        const RayCasting::QRay3D ray(origin, (target - origin).normalized(), 1000.0f);
+        PickingUtils::HierarchicalEntityPicker picker(ray, false);
+
+        // WHEN
+        managers->boundingVolumeHierarchy()->invalidate();
+        const bool traversalHit = picker.collectHits(managers, backendRoot);
+        const QVector<Entity *> traversalEntities = picker.entities();
+
+        managers->boundingVolumeHierarchy()->build(backendRoot);
+        const bool hierarchyHit = picker.collectHits(managers, backendRoot);
+
+        // THEN
+        QVERIFY(traversalHit);
+        QVERIFY(traversalEntities.contains(entities.at(10)));
+        QCOMPARE(hierarchyHit, traversalHit);
+        QCOMPARE(sorted(picker.entities()), sorted(traversalEntities));
+    }
+
+    void checkRefitThroughExpandJob()
+    {
+        // GIVEN
+        QScopedPointer<Qt3DCore::QEntity> scene(buildTestScene());
+        QScopedPointer<TestAspect> aspect(new TestAspect(scene.data()));
+        Entity *backendRoot = aspect->nodeManagers()->renderNodesManager()->getOrCreateResource(scene->id());
+        const QVector<Entity *> entities = gatherEntities(backendRoot);
+        placeEntities(entities, 0.0f);
+        BoundingVolumeHierarchy hierarchy;
+
+        ExpandBoundingVolumeJob expandJob;
+        expandJob.setBoundingVolumeHierarchy(&hierarchy);
+        expandJob.setRoot(backendRoot);
+
+        // WHEN
+        expandJob.run();
+
+        // THEN
+        QVERIFY(hierarchy.isValid());
+        QCOMPARE(hierarchy.root(), backendRoot);
+
+        // WHEN
+        Entity *group = backendRoot->children().first();
+        const QVector<Entity *> groupEntities = gatherEntities(group);
+        placeEntities(groupEntities, 55.0f);
+        expandJob.setDirtySubtreeRoots({ group });
+        expandJob.run();
+
+        FrustumCullingJob cullingJob;
+        cullingJob.setActive(true);
+        cullingJob.setEntities(entities);
+        cullingJob.setViewProjection(viewProjection(QVector3D(0.0f, 0.0f, 150.0f)));
+        cullingJob.run();
+        const QVector<Entity *> expectedEntities = cullingJob.visibleEntities();
+
+        cullingJob.setBoundingVolumeHierarchy(&hierarchy);
+        cullingJob.run();
+
+        // THEN
+        QCOMPARE(cullingJob.visibleEntities(), expectedEntities);
+        for (Entity *entity : groupEntities) {
+            const Vector3D center = entity->worldBoundingVolume()->center();
+            QVERIFY(hierarchy.proximityQuery(center, 0.0f).contains(entity));
+        }
+    }
+
+    void checkRefitCost()
+    {
+        // GIVEN
+        QScopedPointer<Qt3DCore::QEntity> scene(buildTestScene());
+        QScopedPointer<TestAspect> aspect(new TestAspect(scene.data()));
+        Entity *backendRoot = aspect->nodeManagers()->renderNodesManager()->getOrCreateResource(scene->id());
+        const QVector<Entity *> entities = gatherEntities(backendRoot);
+        placeEntities(entities, 0.0f);
+        BoundingVolumeHierarchy fullRefitHierarchy;
+        BoundingVolumeHierarchy partialRefitHierarchy;
+        fullRefitHierarchy.build(backendRoot);
+        partialRefitHierarchy.build(backendRoot);
+        const float builtCost = fullRefitHierarchy.cost();
+
+        // WHEN -> nothing moved
+        fullRefitHierarchy.refit();
+
+        // THEN
+        QVERIFY(builtCost > 1.0f);
+        QCOMPARE(fullRefitHierarchy.cost(), builtCost);
+
+        // WHEN
+        const QVector<Entity *> groupEntities = gatherEntities(backendRoot->children().first());
+        placeEntities(groupEntities, 55.0f);
+        fullRefitHierarchy.refit();
+        partialRefitHierarchy.refit(groupEntities);
+
+        // THEN -> both only refit the paths of the moved entities
+        QVERIFY(!qFuzzyCompare(fullRefitHierarchy.cost(), builtCost));
+        QCOMPARE(fullRefitHierarchy.cost(), partialRefitHierarchy.cost());
+        QCOMPARE(fullRefitHierarchy.nodeCount(), partialRefitHierarchy.nodeCount());
+        for (Entity *entity : groupEntities) {
+            const Vector3D center = entity->worldBoundingVolume()->center();
+            QVERIFY(fullRefitHierarchy.proximityQuery(center, 0.0f).contains(entity));
+            QVERIFY(partialRefitHierarchy.proximityQuery(center, 0.0f).contains(entity));
+        }
+    }
+};
+
+QTEST_MAIN(tst_BoundingVolumeHierarchy)
+
+#include "tst_boundingvolumehierarchy.moc"
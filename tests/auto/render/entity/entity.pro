@@ -5,6 +5,7 @@ TARGET = tst_entity
 QT += 3dcore 3dcore-private 3drender 3drender-private testlib
 
 CONFIG += testcase
+CONFIG += useCommonTestAspect
 
 SOURCES += tst_entity.cpp
 
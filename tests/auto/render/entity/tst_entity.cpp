@@ -30,6 +30,8 @@
 #include <Qt3DRender/private/entity_p.h>
 #include <Qt3DRender/private/nodemanagers_p.h>
 #include <Qt3DRender/private/managers_p.h>
+#include <Qt3DCore/private/qabstractaspect_p.h>
+#include <Qt3DCore/private/qnodecreatedchangegenerator_p.h>
 
 #include <Qt3DRender/QCameraLens>
 #include <Qt3DCore/QPropertyUpdatedChange>
@@ -49,6 +51,7 @@
 #include <Qt3DCore/QArmature>
 
 #include "testrenderer.h"
+#include "testaspect.h"
 
 typedef Qt3DCore::QNodeId (*UuidMethod)(Qt3DRender::Render::Entity *);
 typedef QVector<Qt3DCore::QNodeId> (*UuidListMethod)(Qt3DRender::Render::Entity *);
@@ -302,8 +305,58 @@ private slots:
 
         qDeleteAll(components);
     }
+
+    void checkBulkCreatedHierarchy()
+    {
+        // GIVEN
+        QScopedPointer<Qt3DCore::QEntity> root(new Qt3DCore::QEntity());
+        QScopedPointer<TestAspect> aspect(new TestAspect(root.data()));
+        Qt3DCore::QAbstractAspectPrivate *aspectPrivate = Qt3DCore::QAbstractAspectPrivate::get(aspect.data());
+        EntityManager *entityManager = aspect->nodeManagers()->renderNodesManager();
+
+        Qt3DCore::QEntity *subtreeRoot = new Qt3DCore::QEntity(root.data());
+        QVector<Qt3DCore::QEntity *> frontendEntities;
+        frontendEntities.push_back(subtreeRoot);
+        for (int i = 0; i < 50; ++i) {
+            Qt3DCore::QEntity *child = new Qt3DCore::QEntity(subtreeRoot);
+            frontendEntities.push_back(child);
+            for (int j = 0; j < 4; ++j)
+                frontendEntities.push_back(new Qt3DCore::QEntity(child));
+        }
+
+        // Children come before their parent, all the backend nodes have to
+        // be created before any of them is initialized
+        const Qt3DCore::QNodeCreatedChangeGenerator generator(subtreeRoot);
+        const QVector<Qt3DCore::QNodeCreatedChangeBasePtr> creationChanges = generator.creationChanges();
+        QVector<Qt3DCore::QSceneChangePtr> changes;
+        for (int i = creationChanges.size() - 1; i >= 0; --i)
+            changes.push_back(creationChanges.at(i));
+
+        // WHEN
+        aspectPrivate->sceneNodesAboutToBeAdded(changes);
+        aspectPrivate->sceneNodesAdded(changes);
+
+        // THEN
+        for (Qt3DCore::QEntity *frontendEntity : qAsConst(frontendEntities)) {
+            Entity *backendEntity = entityManager->lookupResource(frontendEntity->id());
+            QVERIFY(backendEntity != nullptr);
+            QCOMPARE(backendEntity->peerId(), frontendEntity->id());
+
+            Entity *backendParent = backendEntity->parent();
+            QVERIFY(backendParent != nullptr);
+            QCOMPARE(backendParent->peerId(), frontendEntity->parentEntity()->id());
+            QVERIFY(backendParent->children().contains(backendEntity));
+
+            QVector<Qt3DCore::QNodeId> childIds;
+            for (Entity *child : backendEntity->children())
+                childIds.push_back(child->peerId());
+            QCOMPARE(childIds.size(), frontendEntity->childNodes().size());
+            for (Qt3DCore::QNode *child : frontendEntity->childNodes())
+                QVERIFY(childIds.contains(child->id()));
+        }
+    }
 };
 
-QTEST_APPLESS_MAIN(tst_RenderEntity)
+QTEST_MAIN(tst_RenderEntity)
 
 #include "tst_entity.moc"
@@ -34,6 +34,7 @@
 #include <Qt3DRender/private/managers_p.h>
 #include <Qt3DRender/private/entity_p.h>
 #include <Qt3DRender/private/filterentitybycomponentjob_p.h>
+#include <Qt3DRender/private/flattenedentitytree_p.h>
 #include <Qt3DRender/qgeometryrenderer.h>
 #include <Qt3DRender/qcameralens.h>
 #include <Qt3DRender/qmaterial.h>
@@ -124,6 +125,48 @@ private Q_SLOTS:
             QCOMPARE(filterJob.filteredEntities().first()->peerId(), childEntity3->id());
         }
     }
+
+    void filterEntitiesInTreeOrder()
+    {
+        // GIVEN
+        Qt3DCore::QEntity *rootEntity = new Qt3DCore::QEntity();
+        Qt3DCore::QTransform *transform = new Qt3DCore::QTransform(rootEntity);
+        rootEntity->addComponent(transform);
+        for (int i = 0; i < 4; ++i) {
+            Qt3DCore::QEntity *groupEntity = new Qt3DCore::QEntity(rootEntity);
+            for (int j = 0; j < 5; ++j) {
+                Qt3DCore::QEntity *childEntity = new Qt3DCore::QEntity(groupEntity);
+                if ((i + j) % 2 == 0)
+                    childEntity->addComponent(transform);
+            }
+        }
+
+        QScopedPointer<Qt3DRender::TestAspect> aspect(new Qt3DRender::TestAspect(rootEntity));
+        Qt3DRender::Render::EntityManager *entityManager = aspect->nodeManagers()->renderNodesManager();
+
+        // WHEN
+        Qt3DRender::Render::FlattenedEntityTree tree;
+        tree.build(entityManager->lookupResource(rootEntity->id()));
+        tree.indexEntities();
+
+        // Without a tree, the active entities are sorted instead
+        Qt3DRender::Render::FilterEntityByComponentJob<Qt3DRender::Render::Transform> sortedFilterJob;
+        sortedFilterJob.setManager(entityManager);
+        sortedFilterJob.run();
+
+        Qt3DRender::Render::FilterEntityByComponentJob<Qt3DRender::Render::Transform> treeFilterJob;
+        treeFilterJob.setManager(entityManager);
+        treeFilterJob.setEntityTree(&tree);
+        treeFilterJob.run();
+
+        // THEN
+        const QVector<Qt3DRender::Render::Entity *> filteredEntities = treeFilterJob.filteredEntities();
+        QCOMPARE(filteredEntities, sortedFilterJob.filteredEntities());
+        QCOMPARE(filteredEntities.size(), 11);
+        QCOMPARE(filteredEntities.first(), tree.root());
+        for (int i = 1; i < filteredEntities.size(); ++i)
+            QVERIFY(filteredEntities.at(i - 1)->treeIndex() < filteredEntities.at(i)->treeIndex());
+    }
 };
 
 QTEST_MAIN(tst_FilterEntityByComponent)
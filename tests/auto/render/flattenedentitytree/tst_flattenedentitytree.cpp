@@ -0,0 +1,213 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QTest>
+#include <Qt3DCore/qentity.h>
+#include <Qt3DRender/private/nodemanagers_p.h>
+#include <Qt3DRender/private/managers_p.h>
+#include <Qt3DRender/private/entity_p.h>
+#include <Qt3DRender/private/flattenedentitytree_p.h>
+#include <Qt3DRender/private/updatetreeenabledjob_p.h>
+
+#include "testaspect.h"
+
+using namespace Qt3DRender;
+using namespace Qt3DRender::Render;
+
+namespace {
+
+// Uneven hierarchy: the number of children and the depth vary from one
+// branch to the other
+Qt3DCore::QEntity *buildTestScene()
+{
+    Qt3DCore::QEntity *root = new Qt3DCore::QEntity();
+    for (int i = 0; i < 6; ++i) {
+        Qt3DCore::QEntity *group = new Qt3DCore::QEntity(root);
+        group->setEnabled(i != 2);
+        for (int j = 0; j < i; ++j) {
+            Qt3DCore::QEntity *child = new Qt3DCore::QEntity(group);
+            child->setEnabled(j != 1);
+            for (int k = 0; k < j; ++k)
+                new Qt3DCore::QEntity(child);
+        }
+    }
+    return root;
+}
+
+void gatherPreOrder(Entity *entity, QVector<Entity *> &entities)
+{
+    entities.push_back(entity);
+    const QVector<Entity *> children = entity->children();
+    for (Entity *child : children)
+        gatherPreOrder(child, entities);
+}
+
+int subtreeSize(Entity *entity)
+{
+    int size = 1;
+    const QVector<Entity *> children = entity->children();
+    for (Entity *child : children)
+        size += subtreeSize(child);
+    return size;
+}
+
+bool expectedTreeEnabled(Entity *entity)
+{
+    for (; entity != nullptr; entity = entity->parent()) {
+        if (!entity->isEnabled())
+            return false;
+    }
+    return true;
+}
+
+} // anonymous
+
+class tst_FlattenedEntityTree : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+
+    void checkInitialState()
+    {
+        // GIVEN
+        FlattenedEntityTree tree;
+
+        // THEN
+        QVERIFY(tree.isEmpty());
+        QCOMPARE(tree.size(), 0);
+        QVERIFY(tree.root() == nullptr);
+        QCOMPARE(tree.indexOf(nullptr), -1);
+    }
+
+    void checkPreOrderLayout()
+    {
+        // GIVEN
+        QScopedPointer<Qt3DCore::QEntity> scene(buildTestScene());
+        QScopedPointer<TestAspect> aspect(new TestAspect(scene.data()));
+        Entity *backendRoot = aspect->nodeManagers()->renderNodesManager()->getOrCreateResource(scene->id());
+        QVector<Entity *> preOrder;
+        gatherPreOrder(backendRoot, preOrder);
+        FlattenedEntityTree tree;
+
+        // WHEN
+        tree.build(backendRoot);
+
+        // THEN
+        QCOMPARE(tree.size(), preOrder.size());
+        QCOMPARE(tree.root(), backendRoot);
+        QCOMPARE(tree.entities(), preOrder);
+        QCOMPARE(tree.parentIndex(0), -1);
+        QCOMPARE(tree.subtreeEnd(0), tree.size());
+
+        for (int i = 0; i < tree.size(); ++i) {
+            Entity *entity = tree.entity(i);
+            QCOMPARE(tree.indexOf(entity), i);
+            QCOMPARE(tree.subtreeEnd(i) - i, subtreeSize(entity));
+            QCOMPARE(tree.isLeaf(i), !entity->hasChildren());
+            if (i > 0) {
+                QVERIFY(tree.parentIndex(i) < i);
+                QCOMPARE(tree.entity(tree.parentIndex(i)), entity->parent());
+            }
+        }
+
+        // WHEN
+        tree.clear();
+
+        // THEN
+        QVERIFY(tree.isEmpty());
+        QCOMPARE(tree.indexOf(backendRoot), -1);
+    }
+
+    void checkTreeContaining()
+    {
+        // GIVEN
+        QScopedPointer<Qt3DCore::QEntity> scene(buildTestScene());
+        QScopedPointer<TestAspect> aspect(new TestAspect(scene.data()));
+        Entity *backendRoot = aspect->nodeManagers()->renderNodesManager()->getOrCreateResource(scene->id());
+        Entity *group = backendRoot->children().last();
+        FlattenedEntityTree sceneTree;
+        FlattenedEntityTree fallback;
+
+        // WHEN
+        const FlattenedEntityTree *tree = FlattenedEntityTree::treeContaining(nullptr, group, &fallback);
+
+        // THEN -> subtree flattened on its own
+        QCOMPARE(tree, &fallback);
+        QCOMPARE(fallback.root(), group);
+        QCOMPARE(fallback.size(), subtreeSize(group));
+
+        // WHEN
+        sceneTree.build(backendRoot);
+        fallback.clear();
+        tree = FlattenedEntityTree::treeContaining(&sceneTree, group, &fallback);
+
+        // THEN -> shared tree used as is
+        QCOMPARE(tree, &sceneTree);
+        QVERIFY(fallback.isEmpty());
+    }
+
+    void checkUpdateTreeEnabled_data()
+    {
+        QTest::addColumn<bool>("useSceneTree");
+
+        QTest::newRow("sceneTree") << true;
+        QTest::newRow("flattenedOnTheFly") << false;
+    }
+
+    void checkUpdateTreeEnabled()
+    {
+        // GIVEN
+        QFETCH(bool, useSceneTree);
+        QScopedPointer<Qt3DCore::QEntity> scene(buildTestScene());
+        QScopedPointer<TestAspect> aspect(new TestAspect(scene.data()));
+        Entity *backendRoot = aspect->nodeManagers()->renderNodesManager()->getOrCreateResource(scene->id());
+        FlattenedEntityTree sceneTree;
+        sceneTree.build(backendRoot);
+
+        UpdateTreeEnabledJob job;
+        job.setRoot(backendRoot);
+        if (useSceneTree)
+            job.setEntityTree(&sceneTree);
+
+        // WHEN
+        job.run();
+
+        // THEN
+        int treeEnabledCount = 0;
+        for (Entity *entity : sceneTree.entities()) {
+            QCOMPARE(entity->isTreeEnabled(), expectedTreeEnabled(entity));
+            treeEnabledCount += entity->isTreeEnabled();
+        }
+        QVERIFY(treeEnabledCount > 0);
+        QVERIFY(treeEnabledCount < sceneTree.size());
+    }
+};
+
+QTEST_MAIN(tst_FlattenedEntityTree)
+
+#include "tst_flattenedentitytree.moc"
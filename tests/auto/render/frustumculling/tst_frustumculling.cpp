@@ -0,0 +1,207 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QTest>
+#include <Qt3DCore/qentity.h>
+#include <Qt3DRender/private/nodemanagers_p.h>
+#include <Qt3DRender/private/managers_p.h>
+#include <Qt3DRender/private/entity_p.h>
+#include <Qt3DRender/private/sphere_p.h>
+#include <Qt3DRender/private/renderview_p.h>
+#include <Qt3DRender/private/boundingvolumehierarchy_p.h>
+#include <Qt3DRender/private/frustumcullingjob_p.h>
+
+#include <cmath>
+
+#include "testaspect.h"
+
+using namespace Qt3DRender;
+using namespace Qt3DRender::Render;
+
+namespace {
+
+const int GroupCount = 20;
+const int EntitiesPerGroup = 50;
+
+Qt3DCore::QEntity *buildTestScene()
+{
+    Qt3DCore::QEntity *root = new Qt3DCore::QEntity();
+    for (int i = 0; i < GroupCount; ++i) {
+        Qt3DCore::QEntity *group = new Qt3DCore::QEntity(root);
+        for (int j = 0; j < EntitiesPerGroup; ++j)
+            new Qt3DCore::QEntity(group);
+    }
+    return root;
+}
+
+// Pre-order, the order in which the renderable entities reach the culling job
+QVector<Entity *> gatherEntities(Entity *root)
+{
+    QVector<Entity *> entities;
+    QVector<Entity *> stack = { root };
+    while (!stack.isEmpty()) {
+        Entity *entity = stack.takeLast();
+        entities.push_back(entity);
+        const QVector<Entity *> children = entity->children();
+        for (auto it = children.crbegin(), end = children.crend(); it != end; ++it)
+            stack.push_back(*it);
+    }
+    return entities;
+}
+
+void placeEntities(const QVector<Entity *> &entities)
+{
+    for (int i = 0, m = entities.size(); i < m; ++i) {
+        const float x = std::fmod(i * 37.17f, 200.0f) - 100.0f;
+        const float y = std::fmod(i * 71.93f, 200.0f) - 100.0f;
+        const float z = std::fmod(i * 13.61f, 200.0f) - 100.0f;
+        const float radius = 0.5f + float(i % 5);
+        *entities.at(i)->worldBoundingVolume() = Sphere(Vector3D(x, y, z), radius);
+        *entities.at(i)->worldBoundingVolumeWithChildren() = Sphere(Vector3D(x, y, z), radius);
+    }
+}
+
+Matrix4x4 viewProjection(const QVector3D &eye)
+{
+    QMatrix4x4 projection;
+    projection.perspective(45.0f, 1.0f, 0.1f, 80.0f);
+    QMatrix4x4 view;
+    view.lookAt(eye, QVector3D(), QVector3D(0.0f, 1.0f, 0.0f));
+    return Matrix4x4(projection * view);
+}
+
+// One sphere at a time, as the culling job did before testing packets
+QVector<Entity *> scalarVisibleEntities(const QVector<Entity *> &entities, const Matrix4x4 &viewProjection)
+{
+    const Plane planes[6] = {
+        Plane(viewProjection.row(3) + viewProjection.row(0)),
+        Plane(viewProjection.row(3) - viewProjection.row(0)),
+        Plane(viewProjection.row(3) + viewProjection.row(1)),
+        Plane(viewProjection.row(3) - viewProjection.row(1)),
+        Plane(viewProjection.row(3) + viewProjection.row(2)),
+        Plane(viewProjection.row(3) - viewProjection.row(2)),
+    };
+
+    QVector<Entity *> visibleEntities;
+    for (Entity *entity : entities) {
+        const Sphere *s = entity->worldBoundingVolume();
+        const Vector3D center = s->center();
+        bool culled = false;
+        for (int p = 0; p < 6 && !culled; ++p) {
+            const Vector3D &n = planes[p].normal;
+            culled = center.x() * n.x() + center.y() * n.y() + center.z() * n.z() + planes[p].d < -s->radius();
+        }
+        if (!culled)
+            visibleEntities.push_back(entity);
+    }
+    return visibleEntities;
+}
+
+} // anonymous
+
+class tst_FrustumCulling : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+
+    void checkInactiveJob()
+    {
+        // GIVEN
+        FrustumCullingJob cullingJob;
+
+        // WHEN
+        cullingJob.run();
+
+        // THEN
+        QVERIFY(!cullingJob.isActive());
+        QVERIFY(cullingJob.visibleEntities().isEmpty());
+    }
+
+    void checkPacketsMatchScalarCulling_data()
+    {
+        QTest::addColumn<QVector3D>("eye");
+        QTest::addColumn<int>("entityCount");
+
+        // Counts which aren't a multiple of the packet size exercise the padding
+        const int allEntities = 1 + GroupCount * (1 + EntitiesPerGroup);
+        QTest::newRow("outside") << QVector3D(0.0f, 0.0f, 150.0f) << allEntities;
+        QTest::newRow("inside") << QVector3D(10.0f, 20.0f, 30.0f) << allEntities;
+        QTest::newRow("corner") << QVector3D(-120.0f, 120.0f, -120.0f) << allEntities;
+        QTest::newRow("away") << QVector3D(500.0f, 500.0f, 500.0f) << allEntities;
+        QTest::newRow("insideSinglePacket") << QVector3D(10.0f, 20.0f, 30.0f) << 3;
+        QTest::newRow("insidePartialPacket") << QVector3D(10.0f, 20.0f, 30.0f) << 13;
+    }
+
+    void checkPacketsMatchScalarCulling()
+    {
+        QFETCH(QVector3D, eye);
+        QFETCH(int, entityCount);
+
+        // GIVEN
+        QScopedPointer<Qt3DCore::QEntity> scene(buildTestScene());
+        QScopedPointer<TestAspect> aspect(new TestAspect(scene.data()));
+        Entity *backendRoot = aspect->nodeManagers()->renderNodesManager()->getOrCreateResource(scene->id());
+        const QVector<Entity *> allEntities = gatherEntities(backendRoot);
+        placeEntities(allEntities);
+        const QVector<Entity *> entities = allEntities.mid(0, entityCount);
+        const Matrix4x4 matrix = viewProjection(eye);
+        const QVector<Entity *> expectedEntities = scalarVisibleEntities(entities, matrix);
+
+        FrustumCullingJob cullingJob;
+        cullingJob.setActive(true);
+        cullingJob.setEntities(entities);
+        cullingJob.setViewProjection(matrix);
+
+        // WHEN
+        cullingJob.run();
+
+        // THEN
+        QCOMPARE(cullingJob.visibleEntities(), expectedEntities);
+
+        // WHEN
+        BoundingVolumeHierarchy hierarchy;
+        hierarchy.build(backendRoot);
+        cullingJob.setBoundingVolumeHierarchy(&hierarchy);
+        cullingJob.run();
+
+        // THEN
+        QVERIFY(hierarchy.isValid());
+        QCOMPARE(cullingJob.visibleEntities(), expectedEntities);
+
+        // WHEN
+        hierarchy.invalidate();
+        cullingJob.run();
+
+        // THEN
+        QCOMPARE(cullingJob.visibleEntities(), expectedEntities);
+    }
+};
+
+QTEST_MAIN(tst_FrustumCulling)
+
+#include "tst_frustumculling.moc"
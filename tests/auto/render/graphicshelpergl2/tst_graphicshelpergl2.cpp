@@ -926,6 +926,7 @@ private Q_SLOTS:
         SUPPORTS_FEATURE(GraphicsHelperInterface::DrawBuffersBlend, false);
         SUPPORTS_FEATURE(GraphicsHelperInterface::Tessellation, false);
         SUPPORTS_FEATURE(GraphicsHelperInterface::BlitFramebuffer, false);
+        SUPPORTS_FEATURE(GraphicsHelperInterface::InstancedArrays, false);
     }
 
 
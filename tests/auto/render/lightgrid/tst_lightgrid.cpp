@@ -0,0 +1,194 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QTest>
+#include <Qt3DRender/private/lightgrid_p.h>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <numeric>
+
+using namespace Qt3DRender::Render;
+
+namespace {
+
+enum Distribution {
+    Volume,
+    Plane,
+    Line
+};
+
+QVector<Vector3D> generatePositions(QRandomGenerator *generator, int count, Distribution distribution)
+{
+    QVector<Vector3D> positions;
+    positions.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const float x = float(generator->bounded(200.0) - 100.0);
+        const float y = distribution == Line ? 0.0f : float(generator->bounded(200.0) - 100.0);
+        const float z = distribution == Volume ? float(generator->bounded(200.0) - 100.0) : 5.0f;
+        positions.push_back(Vector3D(x, y, z));
+    }
+    return positions;
+}
+
+QVector<int> sortedNearestLights(const QVector<Vector3D> &positions, const Vector3D &point, int count)
+{
+    QVector<int> indices(positions.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::sort(indices.begin(), indices.end(), [&] (int a, int b) {
+        const float distanceA = (positions.at(a) - point).lengthSquared();
+        const float distanceB = (positions.at(b) - point).lengthSquared();
+        return distanceA < distanceB || (distanceA == distanceB && a < b);
+    });
+    indices.resize(std::min(count, positions.size()));
+    return indices;
+}
+
+} // anonymous
+
+class tst_LightGrid : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+
+    void checkInitialState()
+    {
+        // GIVEN
+        LightGrid grid;
+        LightGrid::LightIndices indices;
+
+        // WHEN
+        grid.nearestLights(Vector3D(0.0f, 0.0f, 0.0f), 8, &indices);
+
+        // THEN
+        QCOMPARE(grid.lightCount(), 0);
+        QVERIFY(indices.isEmpty());
+    }
+
+    void checkSingleLight()
+    {
+        // GIVEN
+        LightGrid grid;
+        LightGrid::LightIndices indices;
+
+        // WHEN
+        grid.build(QVector<Vector3D>() << Vector3D(1.0f, 2.0f, 3.0f));
+        grid.nearestLights(Vector3D(-50.0f, 0.0f, 50.0f), 8, &indices);
+
+        // THEN
+        QCOMPARE(grid.lightCount(), 1);
+        QCOMPARE(grid.resolution(0), 1);
+        QCOMPARE(grid.resolution(1), 1);
+        QCOMPARE(grid.resolution(2), 1);
+        QCOMPARE(indices.size(), 1);
+        QCOMPARE(indices.at(0), 0);
+
+        // WHEN
+        grid.clear();
+        grid.nearestLights(Vector3D(-50.0f, 0.0f, 50.0f), 8, &indices);
+
+        // THEN
+        QCOMPARE(grid.lightCount(), 0);
+        QVERIFY(indices.isEmpty());
+    }
+
+    void checkEquidistantLights()
+    {
+        // GIVEN
+        LightGrid grid;
+        LightGrid::LightIndices indices;
+        const QVector<Vector3D> positions = {
+            Vector3D(10.0f, 0.0f, 0.0f),
+            Vector3D(-10.0f, 0.0f, 0.0f),
+            Vector3D(0.0f, 10.0f, 0.0f),
+            Vector3D(0.0f, 0.0f, 20.0f)
+        };
+
+        // WHEN
+        grid.build(positions);
+        grid.nearestLights(Vector3D(0.0f, 0.0f, 0.0f), 3, &indices);
+
+        // THEN -> ties are ordered by index
+        QCOMPARE(indices.size(), 3);
+        QCOMPARE(indices.at(0), 0);
+        QCOMPARE(indices.at(1), 1);
+        QCOMPARE(indices.at(2), 2);
+    }
+
+    void checkMatchesSortedLights_data()
+    {
+        QTest::addColumn<int>("lightCount");
+        QTest::addColumn<int>("distribution");
+
+        QTest::newRow("2 lights") << 2 << int(Volume);
+        QTest::newRow("9 lights") << 9 << int(Volume);
+        QTest::newRow("200 lights") << 200 << int(Volume);
+        QTest::newRow("200 lights on a plane") << 200 << int(Plane);
+        QTest::newRow("200 lights on a line") << 200 << int(Line);
+        QTest::newRow("5000 lights") << 5000 << int(Volume);
+    }
+
+    void checkMatchesSortedLights()
+    {
+        // GIVEN
+        QFETCH(int, lightCount);
+        QFETCH(int, distribution);
+        QRandomGenerator generator(883);
+        const QVector<Vector3D> positions = generatePositions(&generator, lightCount, Distribution(distribution));
+        LightGrid grid;
+
+        // WHEN
+        grid.build(positions);
+
+        // THEN
+        QCOMPARE(grid.lightCount(), lightCount);
+        for (int axis = 0; axis < 3; ++axis) {
+            QVERIFY(grid.resolution(axis) >= 1);
+            QVERIFY(grid.resolution(axis) <= LightGrid::MaxResolution);
+        }
+
+        // WHEN -> query points both inside and outside of the lights bounds
+        for (int i = 0; i < 100; ++i) {
+            const Vector3D point(float(generator.bounded(400.0) - 200.0),
+                                 float(generator.bounded(400.0) - 200.0),
+                                 float(generator.bounded(400.0) - 200.0));
+            LightGrid::LightIndices indices;
+            grid.nearestLights(point, LightGrid::MaxNearestLights, &indices);
+
+            // THEN
+            const QVector<int> expected = sortedNearestLights(positions, point, LightGrid::MaxNearestLights);
+            QCOMPARE(indices.size(), expected.size());
+            for (int j = 0; j < expected.size(); ++j)
+                QCOMPARE(indices.at(j), expected.at(j));
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(tst_LightGrid)
+
+#include "tst_lightgrid.moc"
@@ -29,6 +29,7 @@
 #include <QtTest/QTest>
 #include <Qt3DCore/qentity.h>
 #include <Qt3DCore/qtransform.h>
+#include <Qt3DCore/qpropertyupdatedchange.h>
 #include <Qt3DCore/private/qnodecreatedchangegenerator_p.h>
 #include <Qt3DCore/private/qaspectjobmanager_p.h>
 
@@ -459,6 +460,72 @@ private Q_SLOTS:
         // THEN
         QCOMPARE(gatherer->materialToPassAndParameter().size(), 0);
     }
+
+    void checkRunSkipsUnchangedMaterials()
+    {
+        // GIVEN
+        TestMaterial material;
+        Qt3DRender::QParameter *parameter = new Qt3DRender::QParameter(QStringLiteral("shininess"), 1.0f);
+        material.addParameter(parameter);
+        Qt3DCore::QEntity *sceneRoot = buildScene(viewportFrameGraph(), &material);
+        Qt3DRender::TestAspect testAspect(sceneRoot);
+        const QVector<Qt3DRender::Render::HMaterial> handles = testAspect.nodeManagers()->materialManager()->activeHandles();
+
+        testAspect.initializeRenderer();
+
+        Qt3DRender::Render::MaterialParameterGathererJobPtr gatherer = testAspect.materialGathererJob();
+        gatherer->setHandles(handles);
+        gatherer->run();
+
+        // THEN
+        QCOMPARE(gatherer->materialToPassAndParameter().size(), 1);
+        QCOMPARE(gatherer->revisions().materials.size(), 1);
+        QVERIFY(gatherer->unchangedMaterials().empty());
+
+        // WHEN
+        const Qt3DRender::Render::MaterialParameterGathererRevisions revisions = gatherer->revisions();
+        gatherer = testAspect.materialGathererJob();
+        gatherer->setHandles(handles);
+        gatherer->setPreviousRevisions(revisions);
+        gatherer->run();
+
+        // THEN
+        QCOMPARE(gatherer->materialToPassAndParameter().size(), 0);
+        QCOMPARE(gatherer->unchangedMaterials().size(), 1);
+        QCOMPARE(gatherer->unchangedMaterials().first(), material.id());
+        QCOMPARE(gatherer->revisions().materials, revisions.materials);
+
+        // WHEN
+        Qt3DRender::Render::Parameter *backendParameter = testAspect.nodeManagers()->parameterManager()->lookupResource(parameter->id());
+        Qt3DCore::QPropertyUpdatedChangePtr change(new Qt3DCore::QPropertyUpdatedChange(parameter->id()));
+        change->setPropertyName("value");
+        change->setValue(2.0f);
+        backendParameter->sceneChangeEvent(change);
+
+        gatherer = testAspect.materialGathererJob();
+        gatherer->setHandles(handles);
+        gatherer->setPreviousRevisions(revisions);
+        gatherer->run();
+
+        // THEN -> value changes don't require gathering again
+        QCOMPARE(gatherer->unchangedMaterials().size(), 1);
+
+        // WHEN
+        change.reset(new Qt3DCore::QPropertyUpdatedChange(parameter->id()));
+        change->setPropertyName("name");
+        change->setValue(QStringLiteral("specular"));
+        backendParameter->sceneChangeEvent(change);
+
+        gatherer = testAspect.materialGathererJob();
+        gatherer->setHandles(handles);
+        gatherer->setPreviousRevisions(revisions);
+        gatherer->run();
+
+        // THEN
+        QCOMPARE(gatherer->materialToPassAndParameter().size(), 1);
+        QVERIFY(gatherer->unchangedMaterials().empty());
+        QVERIFY(gatherer->revisions().materials.value(material.id()) > revisions.materials.value(material.id()));
+    }
 };
 
 QTEST_MAIN(tst_MaterialParameterGatherer)
@@ -33,6 +33,7 @@
 #include <Qt3DRender/private/uniform_p.h>
 #include <Qt3DRender/private/stringtoint_p.h>
 #include <Qt3DCore/qpropertyupdatedchange.h>
+#include <Qt3DCore/private/qtypedpropertyupdatechange_p.h>
 #include "qbackendnodetester.h"
 #include "testrenderer.h"
 
@@ -145,6 +146,16 @@ private Q_SLOTS:
             change->setValue(value);
             backendParameter.sceneChangeEvent(change);
 
+            // THEN
+            QCOMPARE(backendParameter.uniformValue(), newValue);
+        }
+        {
+            // WHEN
+            const Qt3DRender::Render::UniformValue newValue(Vector3D(883.0f, 1340.0f, 1584.0f));
+            const auto change = Qt3DCore::QTypedPropertyUpdatedChange<Qt3DRender::Render::UniformValue>::create(
+                        Qt3DCore::QNodeId(), "value", Qt3DCore::QTypedPropertyUpdatedChangeBase::propertyIdForName("value"), newValue);
+            backendParameter.sceneChangeEvent(change);
+
             // THEN
             QCOMPARE(backendParameter.uniformValue(), newValue);
         }
@@ -56,6 +56,8 @@
 #include <Qt3DRender/private/loadbufferjob_p.h>
 #include <Qt3DRender/private/buffermanager_p.h>
 #include <Qt3DRender/private/geometryrenderermanager_p.h>
+#include <Qt3DRender/private/geometryrenderer_p.h>
+#include <Qt3DRender/private/triangleboundingvolumehierarchy_p.h>
 
 #include <private/qpickevent_p.h>
 
@@ -1385,6 +1387,106 @@ private Q_SLOTS:
         arbiter.events.clear();
     }
 
+    void checkTriangleHierarchyMatchesVisitor_data()
+    {
+        QTest::addColumn<bool>("frontFaceRequested");
+        QTest::addColumn<bool>("backFaceRequested");
+
+        QTest::newRow("front") << true << false;
+        QTest::newRow("back") << false << true;
+        QTest::newRow("front and back") << true << true;
+    }
+
+    void checkTriangleHierarchyMatchesVisitor()
+    {
+        // GIVEN
+        QmlSceneReader sceneReader(QUrl("qrc:/testscene_trianglehierarchy.qml"));
+        QScopedPointer<Qt3DCore::QNode> root(qobject_cast<Qt3DCore::QNode *>(sceneReader.root()));
+        QVERIFY(root);
+
+        QScopedPointer<Qt3DRender::TestAspect> test(new Qt3DRender::TestAspect(root.data()));
+        runRequiredJobs(test.data());
+
+        Qt3DRender::Render::NodeManagers *managers = test->nodeManagers();
+        Qt3DRender::Render::GeometryRendererManager *geometryRendererManager = managers->geometryRendererManager();
+        QVector<Qt3DRender::Render::Entity *> entities;
+        const QVector<Qt3DRender::Render::HEntity> entityHandles = managers->renderNodesManager()->activeHandles();
+        for (const Qt3DRender::Render::HEntity &handle : entityHandles) {
+            Qt3DRender::Render::Entity *entity = managers->renderNodesManager()->data(handle);
+            Qt3DRender::Render::GeometryRenderer *geometryRenderer = entity->renderComponent<Qt3DRender::Render::GeometryRenderer>();
+            if (geometryRenderer != nullptr) {
+                QVERIFY(geometryRenderer->triangleHierarchy());
+                QVERIFY(geometryRenderer->triangleHierarchy()->triangleCount() > 0);
+                QVERIFY(geometryRendererManager->isGeometryRendererScheduledForTriangleDataRefresh(geometryRenderer->peerId()));
+                entities.push_back(entity);
+            }
+        }
+        QCOMPARE(entities.size(), 2);
+
+        QFETCH(bool, frontFaceRequested);
+        QFETCH(bool, backFaceRequested);
+        Qt3DRender::Render::PickingUtils::TriangleCollisionGathererFunctor gatherer;
+        gatherer.m_objectPickersRequired = false;
+        gatherer.m_manager = managers;
+        gatherer.m_frontFaceRequested = frontFaceRequested;
+        gatherer.m_backFaceRequested = backFaceRequested;
+
+        // Rays going through both tori, their holes and around them
+        QVector<Qt3DRender::RayCasting::QRay3D> rays;
+        for (int i = 0; i < 41; ++i) {
+            for (int j = 0; j < 21; ++j) {
+                const Vector3D origin(-14.0f + 0.7f * i, -7.0f + 0.7f * j, -40.0f);
+                const Vector3D direction = Vector3D(0.002f * (i - 20), 0.001f * (j - 10), 1.0f).normalized();
+                rays.push_back(Qt3DRender::RayCasting::QRay3D(origin, direction, 80.0f));
+            }
+        }
+
+        auto collectHits = [&] () {
+            QVector<Qt3DRender::Render::PickingUtils::HitList> hits;
+            for (const Qt3DRender::RayCasting::QRay3D &ray : qAsConst(rays)) {
+                gatherer.m_ray = ray;
+                Qt3DRender::Render::PickingUtils::HitList rayHits;
+                for (Qt3DRender::Render::Entity *entity : qAsConst(entities))
+                    rayHits += gatherer.pick(entity);
+                std::sort(rayHits.begin(), rayHits.end(), [] (const Qt3DRender::RayCasting::QCollisionQueryResult::Hit &a,
+                                                               const Qt3DRender::RayCasting::QCollisionQueryResult::Hit &b) {
+                    return a.m_entityId == b.m_entityId ? a.m_primitiveIndex < b.m_primitiveIndex
+                                                        : a.m_entityId < b.m_entityId;
+                });
+                hits.push_back(rayHits);
+            }
+            return hits;
+        };
+
+        // WHEN -> triangle data refresh pending, all triangles are visited
+        const QVector<Qt3DRender::Render::PickingUtils::HitList> visitorHits = collectHits();
+
+        // WHEN -> refresh done, the triangle hierarchies are queried
+        geometryRendererManager->geometryRenderersRequiringTriangleDataRefresh();
+        const QVector<Qt3DRender::Render::PickingUtils::HitList> hierarchyHits = collectHits();
+
+        // THEN
+        int hitCount = 0;
+        QCOMPARE(hierarchyHits.size(), visitorHits.size());
+        for (int i = 0, m = visitorHits.size(); i < m; ++i) {
+            QCOMPARE(hierarchyHits.at(i).size(), visitorHits.at(i).size());
+            for (int j = 0, n = visitorHits.at(i).size(); j < n; ++j) {
+                const Qt3DRender::RayCasting::QCollisionQueryResult::Hit &expected = visitorHits.at(i).at(j);
+                const Qt3DRender::RayCasting::QCollisionQueryResult::Hit &actual = hierarchyHits.at(i).at(j);
+                QCOMPARE(actual.m_type, expected.m_type);
+                QCOMPARE(actual.m_entityId, expected.m_entityId);
+                QCOMPARE(actual.m_primitiveIndex, expected.m_primitiveIndex);
+                for (int v = 0; v < 3; ++v)
+                    QCOMPARE(actual.m_vertexIndex[v], expected.m_vertexIndex[v]);
+                QVERIFY(qAbs(actual.m_distance - expected.m_distance) < 0.001f);
+                QVERIFY((actual.m_intersection - expected.m_intersection).length() < 0.001f);
+                QVERIFY((actual.m_uvw - expected.m_uvw).length() < 0.001f);
+                ++hitCount;
+            }
+        }
+        QVERIFY(hitCount > 0);
+    }
+
 };
 
 QTEST_MAIN(tst_PickBoundingVolumeJob)
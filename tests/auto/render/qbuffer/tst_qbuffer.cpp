@@ -30,6 +30,7 @@
 #include <Qt3DCore/private/qnode_p.h>
 #include <Qt3DCore/private/qscene_p.h>
 #include <Qt3DCore/private/qnodecreatedchangegenerator_p.h>
+#include <Qt3DCore/private/qtypedpropertyupdatechange_p.h>
 
 #include <Qt3DRender/qbuffer.h>
 #include <Qt3DRender/private/qbuffer_p.h>
@@ -158,9 +159,9 @@ private Q_SLOTS:
 
         // THEN
         QCOMPARE(arbiter.events.size(), 1);
-        change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
-        QCOMPARE(change->propertyName(), "data");
-        QCOMPARE(change->value().value<QByteArray>(), QByteArrayLiteral("Z28"));
+        auto dataChange = arbiter.events.first().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
+        QCOMPARE(dataChange->propertyName(), "data");
+        QCOMPARE(dataChange->value<QByteArray>(), QByteArrayLiteral("Z28"));
 
         arbiter.events.clear();
 
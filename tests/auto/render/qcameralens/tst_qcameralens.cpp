@@ -33,6 +33,7 @@
 #include <QObject>
 #include <QSignalSpy>
 #include <Qt3DCore/qpropertyupdatedchange.h>
+#include <Qt3DCore/private/qtypedpropertyupdatechange_p.h>
 #include <Qt3DCore/private/qnodecreatedchangegenerator_p.h>
 #include <Qt3DCore/qnodecreatedchange.h>
 #include "testpostmanarbiter.h"
@@ -424,7 +425,7 @@ private Q_SLOTS:
 
             // THEN
             QCOMPARE(arbiter.events.size(), 1);
-            auto change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+            auto change = arbiter.events.first().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
             QCOMPARE(change->propertyName(), "projectionMatrix");
             QCOMPARE(change->type(), Qt3DCore::PropertyUpdated);
 
@@ -456,7 +457,7 @@ private Q_SLOTS:
 
             // THEN
             QCOMPARE(arbiter.events.size(), 1);
-            auto change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+            auto change = arbiter.events.first().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
             QCOMPARE(change->propertyName(), "projectionMatrix");
             QCOMPARE(change->type(), Qt3DCore::PropertyUpdated);
 
@@ -488,7 +489,7 @@ private Q_SLOTS:
 
             // THEN
             QCOMPARE(arbiter.events.size(), 1);
-            auto change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+            auto change = arbiter.events.first().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
             QCOMPARE(change->propertyName(), "projectionMatrix");
             QCOMPARE(change->type(), Qt3DCore::PropertyUpdated);
 
@@ -520,7 +521,7 @@ private Q_SLOTS:
 
             // THEN
             QCOMPARE(arbiter.events.size(), 1);
-            auto change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+            auto change = arbiter.events.first().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
             QCOMPARE(change->propertyName(), "projectionMatrix");
             QCOMPARE(change->type(), Qt3DCore::PropertyUpdated);
 
@@ -552,7 +553,7 @@ private Q_SLOTS:
 
             // THEN
             QCOMPARE(arbiter.events.size(), 1);
-            auto change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+            auto change = arbiter.events.first().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
             QCOMPARE(change->propertyName(), "projectionMatrix");
             QCOMPARE(change->type(), Qt3DCore::PropertyUpdated);
 
@@ -584,7 +585,7 @@ private Q_SLOTS:
 
             // THEN
             QCOMPARE(arbiter.events.size(), 1);
-            auto change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+            auto change = arbiter.events.first().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
             QCOMPARE(change->propertyName(), "projectionMatrix");
             QCOMPARE(change->type(), Qt3DCore::PropertyUpdated);
 
@@ -616,7 +617,7 @@ private Q_SLOTS:
 
             // THEN
             QCOMPARE(arbiter.events.size(), 1);
-            auto change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+            auto change = arbiter.events.first().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
             QCOMPARE(change->propertyName(), "projectionMatrix");
             QCOMPARE(change->type(), Qt3DCore::PropertyUpdated);
 
@@ -648,7 +649,7 @@ private Q_SLOTS:
 
             // THEN
             QCOMPARE(arbiter.events.size(), 1);
-            auto change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+            auto change = arbiter.events.first().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
             QCOMPARE(change->propertyName(), "projectionMatrix");
             QCOMPARE(change->type(), Qt3DCore::PropertyUpdated);
 
@@ -680,7 +681,7 @@ private Q_SLOTS:
 
             // THEN
             QCOMPARE(arbiter.events.size(), 1);
-            auto change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+            auto change = arbiter.events.first().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
             QCOMPARE(change->propertyName(), "projectionMatrix");
             QCOMPARE(change->type(), Qt3DCore::PropertyUpdated);
 
@@ -712,7 +713,7 @@ private Q_SLOTS:
 
             // THEN
             QCOMPARE(arbiter.events.size(), 1);
-            auto change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+            auto change = arbiter.events.first().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
             QCOMPARE(change->propertyName(), "exposure");
             QCOMPARE(change->type(), Qt3DCore::PropertyUpdated);
 
@@ -747,9 +748,9 @@ private Q_SLOTS:
 
             // THEN
             QCOMPARE(arbiter.events.size(), 1);
-            auto change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+            auto change = arbiter.events.first().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
             QCOMPARE(change->propertyName(), "projectionMatrix");
-            QCOMPARE(change->value().value<QMatrix4x4>(), m);
+            QCOMPARE(change->value<QMatrix4x4>(), m);
             QCOMPARE(change->type(), Qt3DCore::PropertyUpdated);
 
             arbiter.events.clear();
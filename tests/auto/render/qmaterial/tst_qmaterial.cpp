@@ -31,6 +31,7 @@
 #include <Qt3DCore/qpropertynodeaddedchange.h>
 #include <Qt3DCore/qpropertynoderemovedchange.h>
 #include <Qt3DCore/private/qnode_p.h>
+#include <Qt3DCore/private/qtypedpropertyupdatechange_p.h>
 #include <Qt3DCore/private/qscene_p.h>
 #include <Qt3DRender/private/qrenderstate_p.h>
 #include <Qt3DCore/private/qnodecreatedchangegenerator_p.h>
@@ -257,9 +258,9 @@ private Q_SLOTS:
 
         // THEN
         QCOMPARE(arbiter.events.size(), 1);
-        Qt3DCore::QPropertyUpdatedChangePtr change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+        auto change = arbiter.events.first().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
         QCOMPARE(change->propertyName(), "effect");
-        QCOMPARE(change->value().value<Qt3DCore::QNodeId>(), effect.id());
+        QCOMPARE(change->value<Qt3DCore::QNodeId>(), effect.id());
         QCOMPARE(change->type(), Qt3DCore::PropertyUpdated);
 
         arbiter.events.clear();
@@ -280,9 +281,9 @@ private Q_SLOTS:
         // THEN
         qDebug() << Q_FUNC_INFO << arbiter2.events.size();
         QCOMPARE(arbiter2.events.size(), 1);
-        change = arbiter2.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+        change = arbiter2.events.first().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
         QCOMPARE(change->propertyName(), "effect");
-        QCOMPARE(change->value().value<Qt3DCore::QNodeId>(), effect.id());
+        QCOMPARE(change->value<Qt3DCore::QNodeId>(), effect.id());
         QCOMPARE(change->type(), Qt3DCore::PropertyUpdated);
     }
 
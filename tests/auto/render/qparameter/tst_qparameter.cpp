@@ -33,6 +33,8 @@
 #include <QSignalSpy>
 #include <Qt3DCore/qpropertyupdatedchange.h>
 #include <Qt3DCore/private/qnodecreatedchangegenerator_p.h>
+#include <Qt3DCore/private/qtypedpropertyupdatechange_p.h>
+#include <Qt3DRender/private/uniform_p.h>
 #include <Qt3DCore/qnodecreatedchange.h>
 #include <Qt3DCore/qentity.h>
 #include "testpostmanarbiter.h"
@@ -200,9 +202,9 @@ private Q_SLOTS:
 
             // THEN
             QCOMPARE(arbiter.events.size(), 1);
-            auto change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+            auto change = arbiter.events.first().staticCast<Qt3DCore::QTypedPropertyUpdatedChangeBase>();
             QCOMPARE(change->propertyName(), "value");
-            QCOMPARE(change->value().value<QVariant>(), parameter.value());
+            QCOMPARE(change->value<Qt3DRender::Render::UniformValue>(), Qt3DRender::Render::UniformValue(383.0f));
             QCOMPARE(change->type(), Qt3DCore::PropertyUpdated);
 
             arbiter.events.clear();
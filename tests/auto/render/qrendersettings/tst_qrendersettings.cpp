@@ -65,6 +65,9 @@ private Q_SLOTS:
         QCOMPARE(renderSettings.pickingSettings()->pickMethod(), Qt3DRender::QPickingSettings::BoundingVolumePicking);
         QCOMPARE(renderSettings.pickingSettings()->pickResultMode(), Qt3DRender::QPickingSettings::NearestPick);
         QCOMPARE(renderSettings.pickingSettings()->faceOrientationPickingMode(), Qt3DRender::QPickingSettings::FrontFace);
+        QCOMPARE(renderSettings.automaticInstancing(), false);
+        QCOMPARE(renderSettings.uploadByteBudget(), 0);
+        QCOMPARE(renderSettings.uploadTimeBudget(), 0);
     }
 
     void checkPropertyChanges()
@@ -92,6 +95,63 @@ private Q_SLOTS:
             QCOMPARE(renderSettings.renderPolicy(), newValue);
             QCOMPARE(spy.count(), 0);
         }
+        {
+            // WHEN
+            QSignalSpy spy(&renderSettings, SIGNAL(automaticInstancingChanged(bool)));
+            const bool newValue = true;
+            renderSettings.setAutomaticInstancing(newValue);
+
+            // THEN
+            QVERIFY(spy.isValid());
+            QCOMPARE(renderSettings.automaticInstancing(), newValue);
+            QCOMPARE(spy.count(), 1);
+
+            // WHEN
+            spy.clear();
+            renderSettings.setAutomaticInstancing(newValue);
+
+            // THEN
+            QCOMPARE(renderSettings.automaticInstancing(), newValue);
+            QCOMPARE(spy.count(), 0);
+        }
+        {
+            // WHEN
+            QSignalSpy spy(&renderSettings, SIGNAL(uploadByteBudgetChanged(int)));
+            const int newValue = 4 * 1024 * 1024;
+            renderSettings.setUploadByteBudget(newValue);
+
+            // THEN
+            QVERIFY(spy.isValid());
+            QCOMPARE(renderSettings.uploadByteBudget(), newValue);
+            QCOMPARE(spy.count(), 1);
+
+            // WHEN
+            spy.clear();
+            renderSettings.setUploadByteBudget(newValue);
+
+            // THEN
+            QCOMPARE(renderSettings.uploadByteBudget(), newValue);
+            QCOMPARE(spy.count(), 0);
+        }
+        {
+            // WHEN
+            QSignalSpy spy(&renderSettings, SIGNAL(uploadTimeBudgetChanged(int)));
+            const int newValue = 4;
+            renderSettings.setUploadTimeBudget(newValue);
+
+            // THEN
+            QVERIFY(spy.isValid());
+            QCOMPARE(renderSettings.uploadTimeBudget(), newValue);
+            QCOMPARE(spy.count(), 1);
+
+            // WHEN
+            spy.clear();
+            renderSettings.setUploadTimeBudget(newValue);
+
+            // THEN
+            QCOMPARE(renderSettings.uploadTimeBudget(), newValue);
+            QCOMPARE(spy.count(), 0);
+        }
         {
             // WHEN
             QSignalSpy spy(&renderSettings, SIGNAL(activeFrameGraphChanged(QFrameGraphNode *)));
@@ -181,6 +241,9 @@ private Q_SLOTS:
 
         renderSettings.setRenderPolicy(Qt3DRender::QRenderSettings::OnDemand);
         renderSettings.setActiveFrameGraph(&frameGraphRoot);
+        renderSettings.setAutomaticInstancing(true);
+        renderSettings.setUploadByteBudget(1024);
+        renderSettings.setUploadTimeBudget(2);
         pickingSettings->setPickMethod(Qt3DRender::QPickingSettings::TrianglePicking);
         pickingSettings->setPickResultMode(Qt3DRender::QPickingSettings::AllPicks);
         pickingSettings->setFaceOrientationPickingMode(Qt3DRender::QPickingSettings::FrontAndBackFace);
@@ -206,6 +269,9 @@ private Q_SLOTS:
             QCOMPARE(renderSettings.pickingSettings()->faceOrientationPickingMode(), cloneData.faceOrientationPickingMode);
             QCOMPARE(renderSettings.pickingSettings()->worldSpaceTolerance(), cloneData.pickWorldSpaceTolerance);
             QCOMPARE(renderSettings.renderPolicy(), cloneData.renderPolicy);
+            QCOMPARE(renderSettings.automaticInstancing(), cloneData.automaticInstancing);
+            QCOMPARE(renderSettings.uploadByteBudget(), cloneData.uploadByteBudget);
+            QCOMPARE(renderSettings.uploadTimeBudget(), cloneData.uploadTimeBudget);
             QCOMPARE(renderSettings.activeFrameGraph()->id(), cloneData.activeFrameGraphId);
             QCOMPARE(renderSettings.id(), creationChangeData->subjectId());
             QCOMPARE(renderSettings.isEnabled(), true);
@@ -232,6 +298,9 @@ private Q_SLOTS:
             QCOMPARE(renderSettings.pickingSettings()->pickResultMode(), cloneData.pickResultMode);
             QCOMPARE(renderSettings.pickingSettings()->faceOrientationPickingMode(), cloneData.faceOrientationPickingMode);
             QCOMPARE(renderSettings.renderPolicy(), cloneData.renderPolicy);
+            QCOMPARE(renderSettings.automaticInstancing(), cloneData.automaticInstancing);
+            QCOMPARE(renderSettings.uploadByteBudget(), cloneData.uploadByteBudget);
+            QCOMPARE(renderSettings.uploadTimeBudget(), cloneData.uploadTimeBudget);
             QCOMPARE(renderSettings.activeFrameGraph()->id(), cloneData.activeFrameGraphId);
             QCOMPARE(renderSettings.id(), creationChangeData->subjectId());
             QCOMPARE(renderSettings.isEnabled(), false);
@@ -273,6 +342,105 @@ private Q_SLOTS:
 
     }
 
+    void checkAutomaticInstancingUpdate()
+    {
+        // GIVEN
+        TestArbiter arbiter;
+        Qt3DRender::QRenderSettings renderSettings;
+        arbiter.setArbiterOnNode(&renderSettings);
+
+        {
+            // WHEN
+            renderSettings.setAutomaticInstancing(true);
+            QCoreApplication::processEvents();
+
+            // THEN
+            QCOMPARE(arbiter.events.size(), 1);
+            auto change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+            QCOMPARE(change->propertyName(), "automaticInstancing");
+            QCOMPARE(change->value().toBool(), renderSettings.automaticInstancing());
+            QCOMPARE(change->type(), Qt3DCore::PropertyUpdated);
+
+            arbiter.events.clear();
+        }
+
+        {
+            // WHEN
+            renderSettings.setAutomaticInstancing(true);
+            QCoreApplication::processEvents();
+
+            // THEN
+            QCOMPARE(arbiter.events.size(), 0);
+        }
+
+    }
+
+    void checkUploadByteBudgetUpdate()
+    {
+        // GIVEN
+        TestArbiter arbiter;
+        Qt3DRender::QRenderSettings renderSettings;
+        arbiter.setArbiterOnNode(&renderSettings);
+
+        {
+            // WHEN
+            renderSettings.setUploadByteBudget(1024);
+            QCoreApplication::processEvents();
+
+            // THEN
+            QCOMPARE(arbiter.events.size(), 1);
+            auto change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+            QCOMPARE(change->propertyName(), "uploadByteBudget");
+            QCOMPARE(change->value().toInt(), renderSettings.uploadByteBudget());
+            QCOMPARE(change->type(), Qt3DCore::PropertyUpdated);
+
+            arbiter.events.clear();
+        }
+
+        {
+            // WHEN
+            renderSettings.setUploadByteBudget(1024);
+            QCoreApplication::processEvents();
+
+            // THEN
+            QCOMPARE(arbiter.events.size(), 0);
+        }
+
+    }
+
+    void checkUploadTimeBudgetUpdate()
+    {
+        // GIVEN
+        TestArbiter arbiter;
+        Qt3DRender::QRenderSettings renderSettings;
+        arbiter.setArbiterOnNode(&renderSettings);
+
+        {
+            // WHEN
+            renderSettings.setUploadTimeBudget(8);
+            QCoreApplication::processEvents();
+
+            // THEN
+            QCOMPARE(arbiter.events.size(), 1);
+            auto change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+            QCOMPARE(change->propertyName(), "uploadTimeBudget");
+            QCOMPARE(change->value().toInt(), renderSettings.uploadTimeBudget());
+            QCOMPARE(change->type(), Qt3DCore::PropertyUpdated);
+
+            arbiter.events.clear();
+        }
+
+        {
+            // WHEN
+            renderSettings.setUploadTimeBudget(8);
+            QCoreApplication::processEvents();
+
+            // THEN
+            QCOMPARE(arbiter.events.size(), 0);
+        }
+
+    }
+
     void checkActiveFrameGraphUpdate()
     {
         // GIVEN
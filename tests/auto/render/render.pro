@@ -98,7 +98,8 @@ qtConfig(private_tests) {
         raycaster \
         qscreenraycaster \
         raycastingjob \
-        qcamera
+        qcamera \
+        lightgrid
 
     QT_FOR_CONFIG = 3dcore-private
     # TO DO: These could be restored to be executed in all cases
@@ -130,7 +131,13 @@ qtConfig(qt3d-opengl-renderer):qtConfig(private_tests) {
         renderviews \
         renderqueue \
         renderviewbuilder \
-        sendrendercapturejob
+        sendrendercapturejob \
+        boundingvolumehierarchy \
+        triangleboundingvolumehierarchy \
+        frustumculling \
+        flattenedentitytree \
+        uploadbudget \
+        asyncshadercompiler
 
     qtConfig(qt3d-extras) {
         SUBDIRS += \
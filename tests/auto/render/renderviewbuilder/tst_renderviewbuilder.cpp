@@ -289,8 +289,9 @@ private Q_SLOTS:
             QCOMPARE(renderViewBuilder.setClearDrawBufferIndexJob()->dependencies().size(), 1);
             QCOMPARE(renderViewBuilder.setClearDrawBufferIndexJob()->dependencies().first().data(), renderViewBuilder.syncRenderViewInitializationJob().data());
 
-            QCOMPARE(renderViewBuilder.syncFrustumCullingJob()->dependencies().size(), 3);
+            QCOMPARE(renderViewBuilder.syncFrustumCullingJob()->dependencies().size(), 4);
             QVERIFY(renderViewBuilder.syncFrustumCullingJob()->dependencies().contains(renderViewBuilder.syncRenderViewInitializationJob()));
+            QVERIFY(renderViewBuilder.syncFrustumCullingJob()->dependencies().contains(renderViewBuilder.renderableEntityFilterJob()));
             QVERIFY(renderViewBuilder.syncFrustumCullingJob()->dependencies().contains(testAspect.renderer()->updateWorldTransformJob()));
             QVERIFY(renderViewBuilder.syncFrustumCullingJob()->dependencies().contains(testAspect.renderer()->updateShaderDataTransformJob()));
 
@@ -367,8 +368,9 @@ private Q_SLOTS:
             QCOMPARE(renderViewBuilder.setClearDrawBufferIndexJob()->dependencies().size(), 1);
             QCOMPARE(renderViewBuilder.setClearDrawBufferIndexJob()->dependencies().first().data(), renderViewBuilder.syncRenderViewInitializationJob().data());
 
-            QCOMPARE(renderViewBuilder.syncFrustumCullingJob()->dependencies().size(), 3);
+            QCOMPARE(renderViewBuilder.syncFrustumCullingJob()->dependencies().size(), 4);
             QVERIFY(renderViewBuilder.syncFrustumCullingJob()->dependencies().contains(renderViewBuilder.syncRenderViewInitializationJob()));
+            QVERIFY(renderViewBuilder.syncFrustumCullingJob()->dependencies().contains(renderViewBuilder.renderableEntityFilterJob()));
             QVERIFY(renderViewBuilder.syncFrustumCullingJob()->dependencies().contains(testAspect.renderer()->updateWorldTransformJob()));
             QVERIFY(renderViewBuilder.syncFrustumCullingJob()->dependencies().contains(testAspect.renderer()->updateShaderDataTransformJob()));
 
@@ -612,8 +614,6 @@ private Q_SLOTS:
         QCOMPARE(renderableEntity.size(), 200);
         QCOMPARE(filteredEntity.size(), 100);
 
-        std::sort(renderableEntity.begin(), renderableEntity.end());
-
         // WHEN
         renderableEntity = Qt3DRender::Render::RenderViewBuilder::entitiesInSubset(renderableEntity, filteredEntity);
 
@@ -624,6 +624,52 @@ private Q_SLOTS:
         }
     }
 
+    void checkRetainedCommandsOfFilteredOutEntitiesAreDropped()
+    {
+        // GIVEN
+        Qt3DRender::QViewport *viewport = new Qt3DRender::QViewport();
+        Qt3DRender::QClearBuffers *clearBuffer = new Qt3DRender::QClearBuffers(viewport);
+        Qt3DRender::QLayerFilter *layerFilter = new Qt3DRender::QLayerFilter(clearBuffer);
+        Qt3DRender::QLayer *layer = new Qt3DRender::QLayer();
+        layerFilter->addLayer(layer);
+        Qt3DRender::TestAspect testAspect(buildEntityFilterTestScene(viewport, layer));
+
+        // THEN
+        Qt3DRender::Render::FrameGraphNode *leafNode = testAspect.nodeManagers()->frameGraphManager()->lookupNode(layerFilter->id());
+        QVERIFY(leafNode != nullptr);
+
+        // WHEN
+        Qt3DRender::Render::RenderViewBuilder renderViewBuilder(leafNode, 0, testAspect.renderer());
+        renderViewBuilder.setLayerCacheNeedsToBeRebuilt(true);
+        renderViewBuilder.prepareJobs();
+        renderViewBuilder.buildJobHierachy();
+
+        renderViewBuilder.renderViewJob()->run();
+        renderViewBuilder.renderableEntityFilterJob()->run();
+        renderViewBuilder.syncRenderViewInitializationJob()->run();
+        renderViewBuilder.filterEntityByLayerJob()->run();
+        renderViewBuilder.syncFilterEntityByLayerJob()->run();
+        renderViewBuilder.lightGathererJob()->run();
+        renderViewBuilder.filterProximityJob()->run();
+
+        // Commands retained while all entities were selected by the layer filter
+        Qt3DRender::Render::RendererCache *cache = testAspect.renderer()->cache();
+        const QVector<Qt3DRender::Render::Entity *> renderableEntities = renderViewBuilder.renderableEntityFilterJob()->filteredEntities();
+        QCOMPARE(renderableEntities.size(), 200);
+        for (Qt3DRender::Render::Entity *entity : renderableEntities)
+            cache->leafNodeCache[leafNode].retainedCommands.insert(entity, Qt3DRender::Render::RetainedEntityCommands());
+
+        renderViewBuilder.syncRenderCommandBuildingJob()->run();
+
+        // THEN -> only the entities selected by the layer filter keep theirs
+        const QVector<Qt3DRender::Render::Entity *> filteredEntities = renderViewBuilder.filterEntityByLayerJob()->filteredEntities();
+        const Qt3DRender::Render::RetainedRenderCommands retainedCommands = cache->leafNodeCache.value(leafNode).retainedCommands;
+        QCOMPARE(filteredEntities.size(), 100);
+        QCOMPARE(retainedCommands.size(), 100);
+        for (Qt3DRender::Render::Entity *entity : filteredEntities)
+            QVERIFY(retainedCommands.contains(entity));
+    }
+
 };
 
 QTEST_MAIN(tst_RenderViewBuilder)
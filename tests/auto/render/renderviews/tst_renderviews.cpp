@@ -34,6 +34,32 @@
 #include <private/memorybarrier_p.h>
 #include <private/renderviewjobutils_p.h>
 #include <private/rendercommand_p.h>
+#include <private/rendercommandarena_p.h>
+#include <private/rendercommandsorter_p.h>
+#include <private/stringtoint_p.h>
+#include <private/nodemanagers_p.h>
+#include <private/managers_p.h>
+#include <private/renderpass_p.h>
+#include <private/renderstatenode_p.h>
+#include <private/renderstateset_p.h>
+#include <private/entity_p.h>
+#include <private/material_p.h>
+#include <private/geometryrenderer_p.h>
+#include <private/geometry_p.h>
+#include <private/attribute_p.h>
+#include <private/shader_p.h>
+#include <private/parameter_p.h>
+#include <Qt3DCore/qentity.h>
+#include <Qt3DCore/qpropertyupdatedchange.h>
+#include <Qt3DRender/qrenderpass.h>
+#include <Qt3DRender/qdepthtest.h>
+#include <Qt3DRender/qcullface.h>
+#include <Qt3DRender/qmaterial.h>
+#include <Qt3DRender/qgeometryrenderer.h>
+#include <Qt3DRender/qgeometry.h>
+#include <Qt3DRender/qattribute.h>
+#include <Qt3DRender/qshaderprogram.h>
+#include <Qt3DRender/qparameter.h>
 #include <testpostmanarbiter.h>
 
 QT_BEGIN_NAMESPACE
@@ -135,13 +161,15 @@ private Q_SLOTS:
     {
         // GIVEN
         RenderView renderView;
+        RenderCommandArena *arena = new RenderCommandArena();
+        renderView.addCommandArena(arena);
         QVector<RenderCommand *> rawCommands;
         QVector<QSortPolicy::SortType> sortTypes;
 
         sortTypes.push_back(QSortPolicy::BackToFront);
 
         for (int i = 0; i < 200; ++i) {
-            RenderCommand *c = new RenderCommand();
+            RenderCommand *c = arena->allocateCommand();
             c->m_depth = float(i);
             rawCommands.push_back(c);
         }
@@ -157,13 +185,15 @@ private Q_SLOTS:
         for (int j = 1; j < sortedCommands.size(); ++j)
             QVERIFY(sortedCommands.at(j - 1)->m_depth > sortedCommands.at(j)->m_depth);
 
-        // RenderCommands are deleted by RenderView dtor
+        // RenderCommands are destroyed with their arena by RenderView dtor
     }
 
     void checkRenderCommandMaterialSorting()
     {
         // GIVEN
         RenderView renderView;
+        RenderCommandArena *arena = new RenderCommandArena();
+        renderView.addCommandArena(arena);
         QVector<RenderCommand *> rawCommands;
         QVector<QSortPolicy::SortType> sortTypes;
 
@@ -178,7 +208,7 @@ private Q_SLOTS:
         };
 
         for (int i = 0; i < 20; ++i) {
-            RenderCommand *c = new RenderCommand();
+            RenderCommand *c = arena->allocateCommand();
             c->m_shaderDna = dnas[i % 5];
             rawCommands.push_back(c);
         }
@@ -203,7 +233,7 @@ private Q_SLOTS:
             QCOMPARE(targetDNA, sortedCommands.at(j)->m_shaderDna);
         }
 
-        // RenderCommands are deleted by RenderView dtor
+        // RenderCommands are destroyed with their arena by RenderView dtor
     }
 
     void checkRenderViewUniformMinification_data()
@@ -244,10 +274,12 @@ private Q_SLOTS:
         QFETCH(QVector<ShaderParameterPack>, expectedMinimizedParameters);
 
         RenderView renderView;
+        RenderCommandArena *arena = new RenderCommandArena();
+        renderView.addCommandArena(arena);
         QVector<RenderCommand *> rawCommands;
 
         for (int i = 0, m = programDNAs.size(); i < m; ++i) {
-            RenderCommand *c = new RenderCommand();
+            RenderCommand *c = arena->allocateCommand();
             c->m_shaderDna = programDNAs.at(i);
             c->m_parameterPack = rawParameters.at(i);
             rawCommands.push_back(c);
@@ -273,13 +305,15 @@ private Q_SLOTS:
     {
         // GIVEN
         RenderView renderView;
+        RenderCommandArena *arena = new RenderCommandArena();
+        renderView.addCommandArena(arena);
         QVector<RenderCommand *> rawCommands;
         QVector<QSortPolicy::SortType> sortTypes;
 
         sortTypes.push_back(QSortPolicy::FrontToBack);
 
         for (int i = 0; i < 200; ++i) {
-            RenderCommand *c = new RenderCommand();
+            RenderCommand *c = arena->allocateCommand();
             c->m_depth = float(i);
             rawCommands.push_back(c);
         }
@@ -295,20 +329,22 @@ private Q_SLOTS:
         for (int j = 1; j < sortedCommands.size(); ++j)
             QVERIFY(sortedCommands.at(j - 1)->m_depth < sortedCommands.at(j)->m_depth);
 
-        // RenderCommands are deleted by RenderView dtor
+        // RenderCommands are destroyed with their arena by RenderView dtor
     }
 
     void checkRenderCommandStateCostSorting()
     {
         // GIVEN
         RenderView renderView;
+        RenderCommandArena *arena = new RenderCommandArena();
+        renderView.addCommandArena(arena);
         QVector<RenderCommand *> rawCommands;
         QVector<QSortPolicy::SortType> sortTypes;
 
         sortTypes.push_back(QSortPolicy::StateChangeCost);
 
         for (int i = 0; i < 200; ++i) {
-            RenderCommand *c = new RenderCommand();
+            RenderCommand *c = arena->allocateCommand();
             c->m_changeCost = i;
             rawCommands.push_back(c);
         }
@@ -324,13 +360,15 @@ private Q_SLOTS:
         for (int j = 1; j < sortedCommands.size(); ++j)
             QVERIFY(sortedCommands.at(j - 1)->m_changeCost > sortedCommands.at(j)->m_changeCost);
 
-        // RenderCommands are deleted by RenderView dtor
+        // RenderCommands are destroyed with their arena by RenderView dtor
     }
 
     void checkRenderCommandCombinedStateMaterialDepthSorting()
     {
         // GIVEN
         RenderView renderView;
+        RenderCommandArena *arena = new RenderCommandArena();
+        renderView.addCommandArena(arena);
         QVector<RenderCommand *> rawCommands;
         QVector<QSortPolicy::SortType> sortTypes;
 
@@ -356,8 +394,8 @@ private Q_SLOTS:
             200
         };
 
-        auto buildRC = [] (ProgramDNA dna, float depth, int changeCost) {
-            RenderCommand *c = new RenderCommand();
+        auto buildRC = [arena] (ProgramDNA dna, float depth, int changeCost) {
+            RenderCommand *c = arena->allocateCommand();
             c->m_shaderDna = dna;
             c->m_depth = depth;
             c->m_changeCost = changeCost;
@@ -403,7 +441,475 @@ private Q_SLOTS:
         QCOMPARE(c7, sortedCommands.at(8));
         QCOMPARE(c9, sortedCommands.at(6));
 
-        // RenderCommands are deleted by RenderView dtor
+        // RenderCommands are destroyed with their arena by RenderView dtor
+    }
+
+    void checkRenderCommandSortKeys()
+    {
+        // GIVEN
+        RenderCommandArena arena;
+        QVector<RenderCommand *> commands;
+        for (int i = 0; i < 100; ++i) {
+            RenderCommand *c = arena.allocateCommand();
+            c->m_shaderDna = ProgramDNA(250 * (i % 4));
+            c->m_depth = float(i % 10) - 5.0f;
+            c->m_changeCost = i % 3;
+            commands.push_back(c);
+        }
+        RenderCommandSorter sorter;
+
+        // WHEN
+        sorter.buildKeys(commands, { QSortPolicy::BackToFront });
+
+        // THEN -> full precision depth
+        QCOMPARE(sorter.keyBits(), 32);
+
+        // WHEN
+        sorter.buildKeys(commands, { QSortPolicy::StateChangeCost, QSortPolicy::Material,
+                                     QSortPolicy::FrontToBack, QSortPolicy::BackToFront });
+
+        // THEN -> 3 costs, 4 shaders, a single material and the depth
+        QCOMPARE(sorter.keyBits(), 2 + 2 + 32);
+
+        // WHEN
+        sorter.sortKeys();
+
+        // THEN
+        const QVector<quint64> keys = sorter.keys();
+        const QVector<int> indices = sorter.indices();
+        QCOMPARE(indices.size(), commands.size());
+        for (int i = 1; i < keys.size(); ++i) {
+            QVERIFY(keys.at(i - 1) <= keys.at(i));
+            // Stable: equal keys keep the order of the commands
+            if (keys.at(i - 1) == keys.at(i))
+                QVERIFY(indices.at(i - 1) < indices.at(i));
+        }
+
+        const RenderCommand *first = commands.at(indices.first());
+        const RenderCommand *last = commands.at(indices.last());
+        QCOMPARE(first->m_changeCost, 2);
+        QCOMPARE(last->m_changeCost, 0);
+        QVERIFY(first->m_shaderDna >= commands.at(indices.at(1))->m_shaderDna);
+    }
+
+    void checkRenderCommandArenaRecycling()
+    {
+        // GIVEN
+        RenderCommandArena arena;
+
+        // THEN
+        QVERIFY(arena.isEmpty());
+
+        // WHEN
+        QSet<void *> firstFrameAddresses;
+        for (int i = 0; i < 500; ++i) {
+            RenderCommand *command = arena.allocateCommand();
+            command->m_stateSet = arena.allocateStateSet();
+            command->m_attributes.push_back(i);
+            firstFrameAddresses.insert(command);
+            firstFrameAddresses.insert(command->m_stateSet);
+        }
+
+        // THEN
+        QCOMPARE(arena.commandCount(), 500);
+        QCOMPARE(arena.stateSetCount(), 500);
+        QCOMPARE(firstFrameAddresses.size(), 1000);
+
+        // WHEN
+        arena.clear();
+
+        // THEN
+        QVERIFY(arena.isEmpty());
+
+        // WHEN
+        int reusedAddresses = 0;
+        for (int i = 0; i < 500; ++i) {
+            RenderCommand *command = arena.allocateCommand();
+            // THEN -> objects are freshly constructed
+            QVERIFY(command->m_attributes.isEmpty());
+            QVERIFY(command->m_stateSet == nullptr);
+            reusedAddresses += firstFrameAddresses.contains(command);
+        }
+
+        // THEN -> the memory of the previous frame was recycled
+        QCOMPARE(arena.commandCount(), 500);
+        QCOMPARE(arena.stateSetCount(), 0);
+        QCOMPARE(reusedAddresses, 500);
+    }
+
+    void checkInstancedCommandMerging()
+    {
+        // GIVEN
+        RenderView renderView;
+        RenderCommandArena *arena = new RenderCommandArena();
+        renderView.addCommandArena(arena);
+        renderView.setAutomaticInstancing(true);
+        const int modelMatrixNameId = StringToInt::lookupId(QLatin1String("modelMatrix"));
+        const int colorNameId = StringToInt::lookupId(QLatin1String("color"));
+
+        auto buildInstancedRC = [arena, modelMatrixNameId, colorNameId] (float x, float color) {
+            RenderCommand *c = arena->allocateCommand();
+            c->m_shaderDna = ProgramDNA(883);
+            c->m_isValid = true;
+            c->m_primitiveCount = 36;
+            c->m_instanceCount = 1;
+            c->m_instanceModelMatrixLocation = 3;
+            QMatrix4x4 modelMatrix;
+            modelMatrix.translate(x, 0.0f, 0.0f);
+            c->m_instanceModelMatrices = QVector<float>(16);
+            std::copy(modelMatrix.constData(), modelMatrix.constData() + 16, c->m_instanceModelMatrices.begin());
+            c->m_parameterPack.setUniform(modelMatrixNameId, UniformValue(modelMatrix));
+            c->m_parameterPack.setUniform(colorNameId, UniformValue(color));
+            return c;
+        };
+
+        RenderCommand *c0 = buildInstancedRC(0.0f, 1.0f);
+        RenderCommand *c1 = buildInstancedRC(1.0f, 1.0f);
+        RenderCommand *c2 = buildInstancedRC(2.0f, 1.0f);
+        RenderCommand *c3 = buildInstancedRC(3.0f, 0.5f);
+        RenderCommand *c4 = buildInstancedRC(4.0f, 0.5f);
+        RenderCommand *c5 = arena->allocateCommand();
+        c5->m_shaderDna = ProgramDNA(883);
+        c5->m_isValid = true;
+        c5->m_primitiveCount = 36;
+        c5->m_instanceCount = 1;
+
+        // WHEN
+        QVector<RenderCommand *> commands = { c0, c1, c2, c3, c4, c5 };
+        renderView.setCommands(commands);
+        renderView.sort();
+
+        // THEN -> only the standard uniforms may differ and the
+        // commands without an instance attribute are left untouched
+        const QVector<RenderCommand *> mergedCommands = renderView.commands();
+        QCOMPARE(mergedCommands.size(), 3);
+        QCOMPARE(mergedCommands.at(0), c0);
+        QCOMPARE(mergedCommands.at(1), c3);
+        QCOMPARE(mergedCommands.at(2), c5);
+        QCOMPARE(c0->m_instanceModelMatrices.size(), 3 * 16);
+        QCOMPARE(c3->m_instanceModelMatrices.size(), 2 * 16);
+        QVERIFY(c5->m_instanceModelMatrices.isEmpty());
+        for (int i = 0; i < 3; ++i) // Translation of each entity
+            QCOMPARE(c0->m_instanceModelMatrices.at(i * 16 + 12), float(i));
+
+        // WHEN
+        renderView.setAutomaticInstancing(false);
+        commands = { c1, c2 };
+        renderView.setCommands(commands);
+        renderView.sort();
+
+        // THEN
+        QCOMPARE(renderView.commands().size(), 2);
+    }
+
+    void checkNonInstanceableCommandsAreNotMerged_data()
+    {
+        QTest::addColumn<QString>("uniformName");
+        QTest::addColumn<int>("expectedCommandCount");
+
+        QTest::newRow("viewMatrix") << QStringLiteral("viewMatrix") << 1;
+        QTest::newRow("mvp") << QStringLiteral("mvp") << 1;
+        QTest::newRow("skinningPalette") << QStringLiteral("skinningPalette[0]") << 2;
+        QTest::newRow("modelNormalMatrix") << QStringLiteral("modelNormalMatrix") << 2;
+        QTest::newRow("inverseModelMatrix") << QStringLiteral("inverseModelMatrix") << 2;
+    }
+
+    void checkNonInstanceableCommandsAreNotMerged()
+    {
+        QFETCH(QString, uniformName);
+        QFETCH(int, expectedCommandCount);
+
+        // GIVEN
+        RenderView renderView;
+        RenderCommandArena *arena = new RenderCommandArena();
+        renderView.addCommandArena(arena);
+        renderView.setAutomaticInstancing(true);
+        const int uniformNameId = StringToInt::lookupId(uniformName);
+
+        auto buildInstancedRC = [arena, uniformNameId] (float x) {
+            RenderCommand *c = arena->allocateCommand();
+            c->m_shaderDna = ProgramDNA(883);
+            c->m_isValid = true;
+            c->m_primitiveCount = 36;
+            c->m_instanceCount = 1;
+            c->m_instanceModelMatrixLocation = 3;
+            QMatrix4x4 modelMatrix;
+            modelMatrix.translate(x, 0.0f, 0.0f);
+            c->m_instanceModelMatrices = QVector<float>(16);
+            std::copy(modelMatrix.constData(), modelMatrix.constData() + 16, c->m_instanceModelMatrices.begin());
+            // Same value for both commands, only its kind matters
+            c->m_parameterPack.setUniform(uniformNameId, UniformValue(QMatrix4x4()));
+            return c;
+        };
+
+        // WHEN
+        QVector<RenderCommand *> commands = { buildInstancedRC(0.0f), buildInstancedRC(1.0f) };
+        renderView.setCommands(commands);
+        renderView.sort();
+
+        // THEN
+        QCOMPARE(renderView.commands().size(), expectedCommandCount);
+    }
+
+    void checkRenderStateSetInterning()
+    {
+        // GIVEN
+        Renderer renderer(QRenderAspect::Synchronous);
+        NodeManagers nodeManagers;
+        renderer.setNodeManagers(&nodeManagers);
+
+        QRenderPass frontendPass1;
+        QRenderPass frontendPass2;
+        QRenderPass frontendPass3;
+        QDepthTest *frontendDepthTest = new QDepthTest(&frontendPass1);
+        QCullFace *frontendCullFace = new QCullFace(&frontendPass3);
+        frontendPass1.addRenderState(frontendDepthTest);
+        frontendPass2.addRenderState(frontendDepthTest);
+        frontendPass3.addRenderState(frontendCullFace);
+
+        RenderStateNode *backendDepthTest = nodeManagers.renderStateManager()->getOrCreateResource(frontendDepthTest->id());
+        simulateInitialization(frontendDepthTest, backendDepthTest);
+        RenderStateNode *backendCullFace = nodeManagers.renderStateManager()->getOrCreateResource(frontendCullFace->id());
+        simulateInitialization(frontendCullFace, backendCullFace);
+
+        RenderPass *backendPass1 = nodeManagers.renderPassManager()->getOrCreateResource(frontendPass1.id());
+        simulateInitialization(&frontendPass1, backendPass1);
+        RenderPass *backendPass2 = nodeManagers.renderPassManager()->getOrCreateResource(frontendPass2.id());
+        simulateInitialization(&frontendPass2, backendPass2);
+        RenderPass *backendPass3 = nodeManagers.renderPassManager()->getOrCreateResource(frontendPass3.id());
+        simulateInitialization(&frontendPass3, backendPass3);
+
+        MaterialParameterGathererData parameters;
+        parameters.insert(Qt3DCore::QNodeId::createId(), { RenderPassParameterData { backendPass1, {} },
+                                                           RenderPassParameterData { backendPass3, {} } });
+        parameters.insert(Qt3DCore::QNodeId::createId(), { RenderPassParameterData { backendPass2, {} } });
+
+        RenderView renderView;
+        renderView.setRenderer(&renderer);
+        RenderCommandArena *arena = new RenderCommandArena();
+        renderView.addCommandArena(arena);
+
+        // WHEN
+        renderView.setMaterialParameterTable(parameters);
+        RenderCommand *c1 = arena->allocateCommand();
+        RenderCommand *c2 = arena->allocateCommand();
+        RenderCommand *c3 = arena->allocateCommand();
+        renderView.setRenderStateSet(c1, backendPass1->renderStates(), arena);
+        renderView.setRenderStateSet(c2, backendPass2->renderStates(), arena);
+        renderView.setRenderStateSet(c3, backendPass3->renderStates(), arena);
+
+        // THEN -> passes with the same render states share their state set
+        QVERIFY(c1->m_stateSet != nullptr);
+        QVERIFY(c3->m_stateSet != nullptr);
+        QCOMPARE(c1->m_stateSet, c2->m_stateSet);
+        QVERIFY(c1->m_stateSet != c3->m_stateSet);
+        QCOMPARE(c1->m_stateSet->states().size(), 1);
+        QCOMPARE(c3->m_stateSet->states().size(), 1);
+        QCOMPARE(c1->m_changeCost, renderer.defaultRenderState()->changeCost(c1->m_stateSet));
+        QCOMPARE(c3->m_changeCost, renderer.defaultRenderState()->changeCost(c3->m_stateSet));
+        QCOMPARE(arena->stateSetCount(), 0);
+
+        // WHEN -> render states which weren't gathered
+        RenderCommand *c4 = arena->allocateCommand();
+        const QVector<Qt3DCore::QNodeId> unknownRenderStates = { frontendCullFace->id(), frontendDepthTest->id() };
+        renderView.setRenderStateSet(c4, unknownRenderStates, arena);
+
+        // THEN
+        QVERIFY(c4->m_stateSet != nullptr);
+        QCOMPARE(c4->m_stateSet->states().size(), 2);
+        QCOMPARE(arena->stateSetCount(), 1);
+    }
+
+    void checkRetainedCommandsInvalidation()
+    {
+        // GIVEN
+        Renderer renderer(QRenderAspect::Synchronous);
+        NodeManagers nodeManagers;
+        renderer.setNodeManagers(&nodeManagers);
+
+        Qt3DCore::QEntity frontendEntity;
+        QMaterial *frontendMaterial = new QMaterial(&frontendEntity);
+        QGeometryRenderer *frontendGeometryRenderer = new QGeometryRenderer(&frontendEntity);
+        QGeometry *frontendGeometry = new QGeometry(frontendGeometryRenderer);
+        QAttribute *frontendAttribute = new QAttribute(frontendGeometry);
+        frontendAttribute->setName(QStringLiteral("vertexPosition"));
+        frontendAttribute->setCount(36);
+        frontendGeometry->addAttribute(frontendAttribute);
+        frontendGeometryRenderer->setGeometry(frontendGeometry);
+        frontendEntity.addComponent(frontendMaterial);
+        frontendEntity.addComponent(frontendGeometryRenderer);
+        QRenderPass frontendPass;
+        QShaderProgram *frontendShader = new QShaderProgram(&frontendPass);
+        frontendPass.setShaderProgram(frontendShader);
+        QParameter frontendParameter(QStringLiteral("color"), 1.0f);
+
+        Material *backendMaterial = nodeManagers.materialManager()->getOrCreateResource(frontendMaterial->id());
+        backendMaterial->setRenderer(&renderer);
+        simulateInitialization(frontendMaterial, backendMaterial);
+        GeometryRenderer *backendGeometryRenderer = nodeManagers.geometryRendererManager()->getOrCreateResource(frontendGeometryRenderer->id());
+        backendGeometryRenderer->setRenderer(&renderer);
+        backendGeometryRenderer->setManager(nodeManagers.geometryRendererManager());
+        simulateInitialization(frontendGeometryRenderer, backendGeometryRenderer);
+        Geometry *backendGeometry = nodeManagers.geometryManager()->getOrCreateResource(frontendGeometry->id());
+        backendGeometry->setRenderer(&renderer);
+        simulateInitialization(frontendGeometry, backendGeometry);
+        Attribute *backendAttribute = nodeManagers.attributeManager()->getOrCreateResource(frontendAttribute->id());
+        backendAttribute->setRenderer(&renderer);
+        simulateInitialization(frontendAttribute, backendAttribute);
+        RenderPass *backendPass = nodeManagers.renderPassManager()->getOrCreateResource(frontendPass.id());
+        backendPass->setRenderer(&renderer);
+        simulateInitialization(&frontendPass, backendPass);
+        Parameter *backendParameter = nodeManagers.parameterManager()->getOrCreateResource(frontendParameter.id());
+        backendParameter->setRenderer(&renderer);
+        simulateInitialization(&frontendParameter, backendParameter);
+        Entity *backendEntity = nodeManagers.renderNodesManager()->getOrCreateResource(frontendEntity.id());
+        backendEntity->setRenderer(&renderer);
+        backendEntity->setNodeManagers(&nodeManagers);
+        simulateInitialization(&frontendEntity, backendEntity);
+
+        // Shader as introspected once loaded
+        Shader *backendShader = nodeManagers.shaderManager()->getOrCreateResource(frontendShader->id());
+        backendShader->setRenderer(&renderer);
+        simulateInitialization(frontendShader, backendShader);
+        ShaderAttribute positionAttribute;
+        positionAttribute.m_name = QStringLiteral("vertexPosition");
+        backendShader->initializeAttributes({ positionAttribute });
+        ShaderUniform colorUniform;
+        colorUniform.m_name = QStringLiteral("color");
+        ShaderUniform modelMatrixUniform;
+        modelMatrixUniform.m_name = QStringLiteral("modelMatrix");
+        backendShader->initializeUniforms({ colorUniform, modelMatrixUniform });
+        backendShader->setLoaded(true);
+
+        const int colorNameId = StringToInt::lookupId(QLatin1String("color"));
+        const int modelMatrixNameId = StringToInt::lookupId(QLatin1String("modelMatrix"));
+        const int envLightCountNameId = StringToInt::lookupId(QLatin1String("envLightCount"));
+
+        // As gathered by the MaterialParameterGathererJob
+        MaterialParameterGathererData parameters;
+        const HParameter parameterHandle = nodeManagers.parameterManager()->lookupHandle(frontendParameter.id());
+        parameters.insert(frontendMaterial->id(), { RenderPassParameterData { backendPass, { ParameterInfo(colorNameId, parameterHandle) } } });
+
+        RenderView renderView;
+        renderView.setRenderer(&renderer);
+        renderView.setMaterialParameterTable(parameters);
+        renderView.setMaterialRevisions({ { frontendMaterial->id(), backendMaterial->revision() } });
+        RenderCommandArena *arena = new RenderCommandArena();
+        renderView.addCommandArena(arena);
+
+        RetainedRenderCommands retainedCommands;
+        const QVector<Entity *> entities = { backendEntity };
+        auto buildFrame = [&] (bool *rebuilt) {
+            RetainedRenderCommands rebuiltCommands;
+            const QVector<RenderCommand *> commands = renderView.buildDrawRenderCommands(entities, arena,
+                                                                                         &retainedCommands,
+                                                                                         &rebuiltCommands);
+            for (auto it = rebuiltCommands.cbegin(), end = rebuiltCommands.cend(); it != end; ++it)
+                retainedCommands.insert(it.key(), it.value());
+            *rebuilt = rebuiltCommands.contains(backendEntity);
+            return commands;
+        };
+        bool rebuilt = false;
+
+        // WHEN
+        QVector<RenderCommand *> commands = buildFrame(&rebuilt);
+
+        // THEN -> retained without the light uniforms, which are set each frame
+        QVERIFY(rebuilt);
+        QCOMPARE(commands.size(), 1);
+        QVERIFY(commands.first()->m_isValid);
+        QCOMPARE(commands.first()->m_primitiveCount, 36U);
+        QVERIFY(commands.first()->m_parameterPack.uniforms().contains(envLightCountNameId));
+        QCOMPARE(retainedCommands.size(), 1);
+        QCOMPARE(retainedCommands.value(backendEntity).commands.size(), 1);
+        QVERIFY(!retainedCommands.value(backendEntity).commands.first().command.m_parameterPack.uniforms().contains(envLightCountNameId));
+
+        // WHEN -> transform only
+        QMatrix4x4 worldTransform;
+        worldTransform.translate(5.0f, 0.0f, 0.0f);
+        *backendEntity->worldTransform() = Matrix4x4(worldTransform);
+        commands = buildFrame(&rebuilt);
+
+        // THEN -> retained, with the standard and light uniforms refreshed
+        QVERIFY(!rebuilt);
+        QCOMPARE(commands.size(), 1);
+        QCOMPARE(commands.first()->m_parameterPack.uniform(modelMatrixNameId).constData<float>()[12], 5.0f);
+        QVERIFY(commands.first()->m_parameterPack.uniforms().contains(envLightCountNameId));
+
+        // WHEN -> parameter value
+        {
+            Qt3DCore::QPropertyUpdatedChangePtr change(new Qt3DCore::QPropertyUpdatedChange(frontendParameter.id()));
+            change->setPropertyName("value");
+            change->setValue(0.5f);
+            backendParameter->sceneChangeEvent(change);
+        }
+        commands = buildFrame(&rebuilt);
+
+        // THEN
+        QVERIFY(rebuilt);
+        QCOMPARE(commands.first()->m_parameterPack.uniform(colorNameId).constData<float>()[0], 0.5f);
+
+        // WHEN -> nothing changed
+        commands = buildFrame(&rebuilt);
+
+        // THEN
+        QVERIFY(!rebuilt);
+        QCOMPARE(commands.first()->m_parameterPack.uniform(colorNameId).constData<float>()[0], 0.5f);
+
+        // WHEN -> material, its revisions being gathered again
+        {
+            Qt3DCore::QPropertyUpdatedChangePtr change(new Qt3DCore::QPropertyUpdatedChange(frontendMaterial->id()));
+            change->setPropertyName("effect");
+            change->setValue(QVariant::fromValue(Qt3DCore::QNodeId::createId()));
+            backendMaterial->sceneChangeEvent(change);
+        }
+        renderView.setMaterialRevisions({ { frontendMaterial->id(), backendMaterial->revision() } });
+        commands = buildFrame(&rebuilt);
+
+        // THEN
+        QVERIFY(rebuilt);
+
+        // WHEN -> geometry renderer
+        {
+            Qt3DCore::QPropertyUpdatedChangePtr change(new Qt3DCore::QPropertyUpdatedChange(frontendGeometryRenderer->id()));
+            change->setPropertyName("instanceCount");
+            change->setValue(2);
+            backendGeometryRenderer->sceneChangeEvent(change);
+        }
+        commands = buildFrame(&rebuilt);
+
+        // THEN
+        QVERIFY(rebuilt);
+        QCOMPARE(commands.first()->m_instanceCount, 2);
+
+        // WHEN -> attribute
+        {
+            Qt3DCore::QPropertyUpdatedChangePtr change(new Qt3DCore::QPropertyUpdatedChange(frontendAttribute->id()));
+            change->setPropertyName("count");
+            change->setValue(24);
+            backendAttribute->sceneChangeEvent(change);
+        }
+        commands = buildFrame(&rebuilt);
+
+        // THEN
+        QVERIFY(rebuilt);
+        QCOMPARE(commands.first()->m_primitiveCount, 24U);
+
+        // WHEN -> shader reloaded with other code
+        backendShader->setShaderCode(QShaderProgram::Vertex, QByteArrayLiteral("void main() {}"));
+        backendShader->setLoaded(true);
+        commands = buildFrame(&rebuilt);
+
+        // THEN
+        QVERIFY(rebuilt);
+        QCOMPARE(commands.first()->m_shaderDna, backendShader->dna());
+
+        // WHEN -> nothing changed
+        commands = buildFrame(&rebuilt);
+
+        // THEN
+        QVERIFY(!rebuilt);
+        QCOMPARE(commands.size(), 1);
     }
 
 private:
@@ -32,6 +32,9 @@
 #include <QtGui/qopenglshaderprogram.h>
 #include <QtCore/qobject.h>
 #include <QtCore/qpointer.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qtemporarydir.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -51,6 +54,10 @@ private Q_SLOTS:
     void removeRef();
     void purge();
     void destruction();
+    void statistics();
+    void programBinaryRoundTrip();
+    void programBinaryValidation();
+    void programBinaryRejection();
 };
 
 void tst_ShaderCache::insert()
@@ -283,6 +290,158 @@ void tst_ShaderCache::destruction()
     QCOMPARE(progPointerB.isNull(), true);
 }
 
+void tst_ShaderCache::statistics()
+{
+    // GIVEN
+    ShaderCache cache;
+    auto dna = ProgramDNA(12345);
+    auto nodeId = QNodeId::createId();
+
+    // THEN
+    QCOMPARE(cache.statistics().hits, 0);
+    QCOMPARE(cache.statistics().misses, 0);
+
+    // WHEN
+    cache.getShaderProgramAndAddRef(dna, nodeId);
+
+    // THEN
+    QCOMPARE(cache.statistics().hits, 0);
+    QCOMPARE(cache.statistics().misses, 1);
+
+    // WHEN
+    cache.insert(dna, nodeId, new QOpenGLShaderProgram);
+    cache.getShaderProgramAndAddRef(dna, nodeId);
+    cache.getShaderProgramAndAddRef(dna, QNodeId::createId());
+
+    // THEN
+    QCOMPARE(cache.statistics().hits, 2);
+    QCOMPARE(cache.statistics().misses, 1);
+    QCOMPARE(cache.statistics().diskHits, 0);
+    QCOMPARE(cache.statistics().diskMisses, 0);
+}
+
+void tst_ShaderCache::programBinaryRoundTrip()
+{
+    // GIVEN
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    ShaderCache cache;
+    auto dna = ProgramDNA(12345);
+    const QByteArray driverKey = QByteArrayLiteral("Vendor\nRenderer\n4.5");
+    const QByteArray sourceDigest = QByteArrayLiteral("digest");
+    ShaderCache::ProgramBinary binary;
+    binary.format = 0x1234;
+    binary.data = QByteArrayLiteral("program binary blob");
+
+    // THEN
+    QCOMPARE(cache.isDiskCacheEnabled(), false);
+    QCOMPARE(cache.saveProgramBinary(dna, driverKey, sourceDigest, binary), false);
+
+    // WHEN
+    cache.setDiskCachePath(dir.path() + QLatin1String("/programs"));
+
+    // THEN
+    QCOMPARE(cache.isDiskCacheEnabled(), true);
+    ShaderCache::ProgramBinary loaded;
+    QCOMPARE(cache.loadProgramBinary(dna, driverKey, sourceDigest, &loaded), false);
+    QCOMPARE(cache.statistics().diskMisses, 1);
+
+    // WHEN
+    QCOMPARE(cache.saveProgramBinary(dna, driverKey, sourceDigest, binary), true);
+
+    // THEN a new cache, as used by a following run, finds it
+    ShaderCache otherCache;
+    otherCache.setDiskCachePath(dir.path() + QLatin1String("/programs"));
+    QCOMPARE(otherCache.loadProgramBinary(dna, driverKey, sourceDigest, &loaded), true);
+    QCOMPARE(loaded.format, binary.format);
+    QCOMPARE(loaded.data, binary.data);
+    QCOMPARE(otherCache.statistics().diskHits, 1);
+    QCOMPARE(otherCache.statistics().diskMisses, 0);
+}
+
+void tst_ShaderCache::programBinaryValidation()
+{
+    // GIVEN
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    ShaderCache cache;
+    cache.setDiskCachePath(dir.path());
+    auto dna = ProgramDNA(12345);
+    const QByteArray driverKey = QByteArrayLiteral("Vendor\nRenderer\n4.5");
+    const QByteArray sourceDigest = QByteArrayLiteral("digest");
+    ShaderCache::ProgramBinary binary;
+    binary.format = 0x1234;
+    binary.data = QByteArrayLiteral("program binary blob");
+    ShaderCache::ProgramBinary loaded;
+
+    // WHEN the driver changed
+    QVERIFY(cache.saveProgramBinary(dna, driverKey, sourceDigest, binary));
+
+    // THEN
+    QCOMPARE(cache.loadProgramBinary(dna, QByteArrayLiteral("Vendor\nRenderer\n4.6"), sourceDigest, &loaded), false);
+    QCOMPARE(cache.loadProgramBinary(dna, driverKey, sourceDigest, &loaded), true);
+
+    // WHEN the sources behind the dna differ
+    // THEN the stale entry is dropped
+    QCOMPARE(cache.loadProgramBinary(dna, driverKey, QByteArrayLiteral("other digest"), &loaded), false);
+    QCOMPARE(cache.loadProgramBinary(dna, driverKey, sourceDigest, &loaded), false);
+
+    // WHEN the file is corrupted
+    QVERIFY(cache.saveProgramBinary(dna, driverKey, sourceDigest, binary));
+    const QStringList files = QDir(dir.path()).entryList(QDir::Files);
+    QCOMPARE(files.size(), 1);
+    QFile file(dir.path() + QLatin1Char('/') + files.first());
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    file.seek(file.size() - 4);
+    file.write("XX");
+    file.close();
+
+    // THEN
+    QCOMPARE(cache.loadProgramBinary(dna, driverKey, sourceDigest, &loaded), false);
+    QCOMPARE(QFile::exists(file.fileName()), false);
+
+    // WHEN a byte of the binary itself is corrupted
+    QVERIFY(cache.saveProgramBinary(dna, driverKey, sourceDigest, binary));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QByteArray content = file.readAll();
+    const int blobOffset = content.indexOf(binary.data);
+    QVERIFY(blobOffset > 0);
+    content[blobOffset + 3] = content.at(blobOffset + 3) ^ 0x01;
+    file.seek(0);
+    file.write(content);
+    file.close();
+
+    // THEN
+    QCOMPARE(cache.loadProgramBinary(dna, driverKey, sourceDigest, &loaded), false);
+    QCOMPARE(QFile::exists(file.fileName()), false);
+    QCOMPARE(cache.statistics().diskHits, 1);
+    QCOMPARE(cache.statistics().diskMisses, 5);
+}
+
+void tst_ShaderCache::programBinaryRejection()
+{
+    // GIVEN
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    ShaderCache cache;
+    cache.setDiskCachePath(dir.path());
+    auto dna = ProgramDNA(12345);
+    const QByteArray driverKey = QByteArrayLiteral("Vendor\nRenderer\n4.5");
+    const QByteArray sourceDigest = QByteArrayLiteral("digest");
+    ShaderCache::ProgramBinary binary;
+    binary.format = 0x1234;
+    binary.data = QByteArrayLiteral("program binary blob");
+    QVERIFY(cache.saveProgramBinary(dna, driverKey, sourceDigest, binary));
+
+    // WHEN
+    cache.rejectProgramBinary(dna, driverKey);
+
+    // THEN
+    ShaderCache::ProgramBinary loaded;
+    QCOMPARE(cache.loadProgramBinary(dna, driverKey, sourceDigest, &loaded), false);
+    QCOMPARE(cache.statistics().diskRejects, 1);
+}
+
 } // namespace Render
 } // namespace Qt3DRender
 
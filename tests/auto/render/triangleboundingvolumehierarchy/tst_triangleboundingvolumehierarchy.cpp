@@ -0,0 +1,166 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QTest>
+#include <Qt3DRender/private/triangleboundingvolumehierarchy_p.h>
+#include <Qt3DRender/private/triangleboundingvolume_p.h>
+#include <Qt3DRender/private/qray3d_p.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Qt3DRender;
+using namespace Qt3DRender::Render;
+
+namespace {
+
+typedef TriangleBoundingVolumeHierarchy::Triangle Triangle;
+
+const int TriangleCount = 2000;
+
+// Small triangles spread over a 100 units wide cube
+QVector<Triangle> buildTriangles()
+{
+    QVector<Triangle> triangles(TriangleCount);
+    for (int i = 0; i < TriangleCount; ++i) {
+        Triangle &triangle = triangles[i];
+        const float center[3] = {
+            std::fmod(i * 37.17f, 100.0f) - 50.0f,
+            std::fmod(i * 71.93f, 100.0f) - 50.0f,
+            std::fmod(i * 13.61f, 100.0f) - 50.0f
+        };
+        const float size = 0.5f + float(i % 7);
+        for (int v = 0; v < 3; ++v) {
+            for (int axis = 0; axis < 3; ++axis)
+                triangle.vertices[v][axis] = center[axis] + (v == axis ? size : -0.25f * size);
+            triangle.vertexIndices[v] = uint(3 * i + v);
+        }
+    }
+    return triangles;
+}
+
+Vector3D vertex(const Triangle &triangle, int v)
+{
+    return Vector3D(triangle.vertices[v][0], triangle.vertices[v][1], triangle.vertices[v][2]);
+}
+
+bool segmentIntersectsTriangle(const RayCasting::QRay3D &segment, const Triangle &triangle)
+{
+    Vector3D uvw;
+    float t = 0.0f;
+    return intersectsSegmentTriangle(segment, vertex(triangle, 0), vertex(triangle, 1), vertex(triangle, 2), uvw, t)
+            || intersectsSegmentTriangle(segment, vertex(triangle, 2), vertex(triangle, 1), vertex(triangle, 0), uvw, t);
+}
+
+} // anonymous
+
+class tst_TriangleBoundingVolumeHierarchy : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+
+    void checkInitialState()
+    {
+        // GIVEN
+        TriangleBoundingVolumeHierarchy hierarchy;
+
+        // THEN
+        QCOMPARE(hierarchy.triangleCount(), 0);
+        QCOMPARE(hierarchy.nodeCount(), 0);
+        QVERIFY(hierarchy.segmentQuery(Vector3D(), Vector3D(1.0f, 1.0f, 1.0f)).isEmpty());
+    }
+
+    void checkBuild()
+    {
+        // GIVEN
+        const QVector<Triangle> triangles = buildTriangles();
+        TriangleBoundingVolumeHierarchy hierarchy;
+
+        // WHEN
+        hierarchy.build(triangles);
+
+        // THEN
+        QCOMPARE(hierarchy.triangleCount(), TriangleCount);
+        QVERIFY(hierarchy.nodeCount() > 1);
+        QVector<bool> seen(TriangleCount, false);
+        for (int i = 0; i < TriangleCount; ++i) {
+            const uint index = hierarchy.triangleIndex(i);
+            QVERIFY(index < uint(TriangleCount));
+            QVERIFY(!seen.at(int(index)));
+            seen[int(index)] = true;
+            QCOMPARE(hierarchy.triangle(i).vertexIndices[0], triangles.at(int(index)).vertexIndices[0]);
+        }
+    }
+
+    void checkSegmentQuery_data()
+    {
+        QTest::addColumn<QVector3D>("start");
+        QTest::addColumn<QVector3D>("end");
+
+        QTest::newRow("diagonal") << QVector3D(-60.0f, -60.0f, -60.0f) << QVector3D(60.0f, 60.0f, 60.0f);
+        QTest::newRow("alongX") << QVector3D(-60.0f, 1.5f, -2.0f) << QVector3D(60.0f, 1.5f, -2.0f);
+        QTest::newRow("alongZ") << QVector3D(10.0f, -20.0f, 60.0f) << QVector3D(10.0f, -20.0f, -60.0f);
+        QTest::newRow("short") << QVector3D(-5.0f, 3.0f, 7.0f) << QVector3D(4.0f, -2.0f, 9.0f);
+        QTest::newRow("outside") << QVector3D(70.0f, 70.0f, 70.0f) << QVector3D(90.0f, 60.0f, 80.0f);
+    }
+
+    void checkSegmentQuery()
+    {
+        // GIVEN
+        QFETCH(QVector3D, start);
+        QFETCH(QVector3D, end);
+        const QVector<Triangle> triangles = buildTriangles();
+        TriangleBoundingVolumeHierarchy hierarchy;
+        hierarchy.build(triangles);
+        const RayCasting::QRay3D segment(Vector3D(start), Vector3D(end - start).normalized(), (end - start).length());
+
+        // WHEN
+        const QVector<int> candidates = hierarchy.segmentQuery(Vector3D(start), Vector3D(end));
+
+        // THEN
+        QVector<uint> hits;
+        for (const int candidate : candidates) {
+            if (segmentIntersectsTriangle(segment, hierarchy.triangle(candidate)))
+                hits.push_back(hierarchy.triangleIndex(candidate));
+        }
+        std::sort(hits.begin(), hits.end());
+
+        QVector<uint> bruteForceHits;
+        for (int i = 0; i < TriangleCount; ++i) {
+            if (segmentIntersectsTriangle(segment, triangles.at(i)))
+                bruteForceHits.push_back(uint(i));
+        }
+
+        QCOMPARE(hits, bruteForceHits);
+        QVERIFY(candidates.size() < TriangleCount);
+    }
+};
+
+QTEST_APPLESS_MAIN(tst_TriangleBoundingVolumeHierarchy)
+
+#include "tst_triangleboundingvolumehierarchy.moc"
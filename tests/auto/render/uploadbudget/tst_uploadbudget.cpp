@@ -0,0 +1,225 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QTest>
+#include <Qt3DRender/private/uploadbudget_p.h>
+
+using namespace Qt3DRender::Render;
+
+class tst_UploadBudget : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+
+    void checkInitialState()
+    {
+        // GIVEN
+        UploadBudget budget;
+        UploadStatistics statistics;
+
+        // THEN
+        QVERIFY(budget.isUnlimited());
+        QVERIFY(!budget.isExhausted());
+        QCOMPARE(budget.consumedBytes(), qint64(0));
+        QCOMPARE(budget.elapsedTime(), qint64(0));
+        QVERIFY(!statistics.hasPendingUploads());
+        QCOMPARE(statistics.uploadedBytes, qint64(0));
+        QCOMPARE(statistics.pendingBufferBytes, qint64(0));
+    }
+
+    void checkUnlimitedBudget()
+    {
+        // GIVEN
+        UploadBudget budget;
+
+        // WHEN
+        budget.start();
+        budget.consume(1024 * 1024 * 1024);
+
+        // THEN
+        QVERIFY(!budget.isExhausted());
+        QCOMPARE(budget.consumedBytes(), qint64(1024 * 1024 * 1024));
+    }
+
+    void checkByteBudget()
+    {
+        // GIVEN
+        UploadBudget budget(1024);
+
+        // WHEN
+        budget.start();
+
+        // THEN
+        QVERIFY(!budget.isUnlimited());
+        QVERIFY(!budget.isExhausted());
+
+        // WHEN
+        budget.consume(1000);
+
+        // THEN
+        QVERIFY(!budget.isExhausted());
+
+        // WHEN -> the last upload can go over the budget
+        budget.consume(4096);
+
+        // THEN
+        QVERIFY(budget.isExhausted());
+        QCOMPARE(budget.consumedBytes(), qint64(5096));
+
+        // WHEN -> next frame
+        budget.start();
+
+        // THEN
+        QVERIFY(!budget.isExhausted());
+        QCOMPARE(budget.consumedBytes(), qint64(0));
+    }
+
+    void checkTimeBudget()
+    {
+        // GIVEN
+        UploadBudget budget(0, 5);
+
+        // WHEN
+        budget.start();
+
+        // THEN
+        QVERIFY(!budget.isUnlimited());
+        QVERIFY(!budget.isExhausted());
+
+        // WHEN
+        QTest::qSleep(20);
+
+        // THEN
+        QVERIFY(budget.isExhausted());
+        QVERIFY(budget.elapsedTime() >= 5 * 1000 * 1000);
+    }
+
+    void checkPendingUploads()
+    {
+        // GIVEN
+        UploadStatistics statistics;
+
+        // WHEN
+        statistics.pendingTextures = 1;
+
+        // THEN
+        QVERIFY(statistics.hasPendingUploads());
+
+        // WHEN
+        statistics.pendingTextures = 0;
+        statistics.pendingShaders = 2;
+
+        // THEN
+        QVERIFY(statistics.hasPendingUploads());
+    }
+
+    void checkUploadQueue()
+    {
+        // GIVEN
+        UploadQueue<int> queue;
+
+        // THEN
+        QVERIFY(queue.isEmpty());
+        QCOMPARE(queue.postponedCount(), 0);
+        QCOMPARE(queue.postponedBytes(), qint64(0));
+
+        // WHEN
+        queue.enqueue(1);
+        queue.enqueue(2);
+        queue.enqueue(1);
+
+        // THEN
+        QCOMPARE(queue.size(), 2);
+        QCOMPARE(queue.postponedCount(), 0);
+
+        // WHEN
+        const QVector<int> handles = queue.takeHandles();
+
+        // THEN
+        QCOMPARE(handles, QVector<int>() << 1 << 2);
+        QVERIFY(queue.isEmpty());
+
+        // WHEN
+        queue.postpone(2, 512);
+        queue.postpone(2, 512);
+
+        // THEN
+        QCOMPARE(queue.size(), 1);
+        QCOMPARE(queue.postponedCount(), 1);
+        QCOMPARE(queue.postponedBytes(), qint64(512));
+    }
+
+    void checkPostponedUploadsAcrossFrames()
+    {
+        // GIVEN
+        const qint64 bufferSize = 1000;
+        QVector<int> dirtyBuffers;
+        for (int i = 0; i < 6; ++i)
+            dirtyBuffers.push_back(i);
+        UploadQueue<int> queue;
+
+        // Each frame uploads two buffers before exhausting the budget
+        for (int frame = 0; frame < 3; ++frame) {
+            // WHEN -> BuffersDirty frame, every dirty buffer is gathered
+            // again, including the ones postponed by the previous frame
+            for (const int handle : qAsConst(dirtyBuffers))
+                queue.enqueue(handle);
+
+            UploadBudget budget(1024);
+            UploadStatistics statistics;
+            budget.start();
+            const QVector<int> handles = queue.takeHandles();
+
+            // THEN
+            QCOMPARE(handles.size(), dirtyBuffers.size());
+
+            // WHEN
+            for (const int handle : handles) {
+                if (budget.isExhausted()) {
+                    queue.postpone(handle, bufferSize);
+                    continue;
+                }
+                dirtyBuffers.removeOne(handle);
+                budget.consume(bufferSize);
+            }
+            statistics.pendingBuffers = queue.postponedCount();
+            statistics.pendingBufferBytes = queue.postponedBytes();
+
+            // THEN
+            QCOMPARE(statistics.pendingBuffers, 4 - 2 * frame);
+            QCOMPARE(statistics.pendingBufferBytes, (4 - 2 * frame) * bufferSize);
+            QCOMPARE(statistics.hasPendingUploads(), frame < 2);
+            QCOMPARE(queue.size(), dirtyBuffers.size());
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(tst_UploadBudget)
+
+#include "tst_uploadbudget.moc"
@@ -0,0 +1,124 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <Qt3DCore/qaspectjob.h>
+#include <Qt3DCore/private/qaspectjobmanager_p.h>
+
+namespace {
+
+class EmptyJob : public Qt3DCore::QAspectJob
+{
+public:
+    explicit EmptyJob(QAtomicInt *counter)
+        : m_counter(counter)
+    {}
+
+    void run() override
+    {
+        m_counter->ref();
+    }
+
+private:
+    QAtomicInt *m_counter;
+};
+
+// Builds a deterministic DAG resembling a Qt3D frame: a few independent
+// roots, then jobs depending on up to 3 jobs among the previous 64 ones
+QVector<Qt3DCore::QAspectJobPtr> buildJobGraph(int jobCount, QAtomicInt *counter)
+{
+    QVector<Qt3DCore::QAspectJobPtr> jobs;
+    jobs.reserve(jobCount);
+    quint32 seed = 1234;
+    const auto random = [&seed] {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+
+    for (int i = 0; i < jobCount; ++i) {
+        Qt3DCore::QAspectJobPtr job(new EmptyJob(counter));
+        if (i >= 16) {
+            const int dependencyCount = 1 + random() % 3;
+            const int window = qMin(i, 64);
+            for (int j = 0; j < dependencyCount; ++j)
+                job->addDependency(jobs.at(i - 1 - int(random() % window)));
+        }
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
+} // anonymous
+
+class tst_BenchAspectJobManager : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void scheduleJobGraph_data();
+    void scheduleJobGraph();
+};
+
+void tst_BenchAspectJobManager::scheduleJobGraph_data()
+{
+    QTest::addColumn<QByteArray>("scheduler");
+    QTest::addColumn<int>("jobCount");
+
+    QTest::newRow("threadpooler-1000") << QByteArray("threadpool") << 1000;
+    QTest::newRow("workstealing-1000") << QByteArray("workstealing") << 1000;
+}
+
+void tst_BenchAspectJobManager::scheduleJobGraph()
+{
+    // GIVEN
+    QFETCH(QByteArray, scheduler);
+    QFETCH(int, jobCount);
+
+    qputenv("QT3D_SCHEDULER", scheduler);
+    Qt3DCore::QAspectJobManager manager;
+    qunsetenv("QT3D_SCHEDULER");
+
+    QAtomicInt counter(0);
+    const QVector<Qt3DCore::QAspectJobPtr> jobs = buildJobGraph(jobCount, &counter);
+
+    // WHEN
+    // Jobs don't do any real work, each iteration measures the scheduling
+    // overhead of a single frame
+    int frameCount = 0;
+    QBENCHMARK {
+        manager.enqueueJobs(jobs);
+        manager.waitForAllJobs();
+        ++frameCount;
+    }
+
+    // THEN
+    QCOMPARE(counter.load(), frameCount * jobCount);
+}
+
+QTEST_APPLESS_MAIN(tst_BenchAspectJobManager)
+
+#include "tst_bench_aspectjobmanager.moc"
@@ -3,4 +3,6 @@ TEMPLATE = subdirs
 !wince*: SUBDIRS += \
     qcircularbuffer \
     qresourcesmanager \
-    qframeallocator
+    qframeallocator \
+    aspectjobmanager \
+    propertychanges
@@ -0,0 +1,6 @@
+TARGET = tst_bench_propertychanges
+
+TEMPLATE = app
+QT += testlib 3dcore 3dcore-private
+
+SOURCES += tst_bench_propertychanges.cpp
@@ -0,0 +1,144 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <Qt3DCore/qpropertyupdatedchange.h>
+#include <Qt3DCore/private/qchangearbiter_p.h>
+#include <Qt3DCore/private/qobserverinterface_p.h>
+#include <Qt3DCore/private/qtypedpropertyupdatechange_p.h>
+#include <QVector3D>
+
+namespace {
+
+const int translationId = Qt3DCore::QTypedPropertyUpdatedChangeBase::propertyIdForName("translation");
+
+// Dispatches the changes the way a backend node does, by id when the change
+// carries one and by name otherwise
+class TransformObserver : public Qt3DCore::QObserverInterface
+{
+public:
+    void sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e) override
+    {
+        if (const Qt3DCore::QTypedPropertyUpdatedChangeBase *typedChange = Qt3DCore::QTypedPropertyUpdatedChangeBase::fromChange(e)) {
+            if (typedChange->propertyId() == translationId)
+                m_translation = typedChange->value<QVector3D>();
+        } else if (e->type() == Qt3DCore::PropertyUpdated) {
+            const auto change = qSharedPointerCast<Qt3DCore::QPropertyUpdatedChange>(e);
+            if (change->propertyName() == QByteArrayLiteral("translation"))
+                m_translation = change->value().value<QVector3D>();
+        }
+        ++m_changeCount;
+    }
+
+    int changeCount() const { return m_changeCount; }
+    QVector3D translation() const { return m_translation; }
+
+private:
+    int m_changeCount = 0;
+    QVector3D m_translation;
+};
+
+} // anonymous
+
+class tst_BenchPropertyChanges : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void distributeChanges_data();
+    void distributeChanges();
+};
+
+void tst_BenchPropertyChanges::distributeChanges_data()
+{
+    QTest::addColumn<bool>("typed");
+    QTest::addColumn<int>("nodeCount");
+
+    QTest::newRow("generic-1000") << false << 1000;
+    QTest::newRow("typed-1000") << true << 1000;
+    QTest::newRow("generic-10000") << false << 10000;
+    QTest::newRow("typed-10000") << true << 10000;
+}
+
+void tst_BenchPropertyChanges::distributeChanges()
+{
+    // GIVEN
+    QFETCH(bool, typed);
+    QFETCH(int, nodeCount);
+
+    QScopedPointer<Qt3DCore::QChangeArbiter> arbiter(new Qt3DCore::QChangeArbiter());
+    Qt3DCore::QChangeArbiter::createUnmanagedThreadLocalChangeQueue(arbiter.data());
+
+    QVector<Qt3DCore::QNodeId> ids;
+    ids.reserve(nodeCount);
+    TransformObserver observer;
+    for (int i = 0; i < nodeCount; ++i) {
+        ids.push_back(Qt3DCore::QNodeId::createId());
+        arbiter->registerObserver(&observer, ids.last());
+    }
+
+    // WHEN
+    // Each iteration is a frame where every node had its translation changed
+    // once: creating the changes, queuing them and distributing them
+    int frameCount = 0;
+    QElapsedTimer timer;
+    timer.start();
+    QBENCHMARK {
+        Qt3DCore::QSceneChangeList changes;
+        changes.reserve(nodeCount);
+        const QVector3D translation(float(frameCount), 0.0f, 0.0f);
+        for (const Qt3DCore::QNodeId id : qAsConst(ids)) {
+            if (typed) {
+                changes.push_back(Qt3DCore::QTypedPropertyUpdatedChange<QVector3D>::create(id, "translation",
+                                                                                           translationId,
+                                                                                           translation));
+            } else {
+                auto change = Qt3DCore::QPropertyUpdatedChangePtr::create(id);
+                change->setPropertyName("translation");
+                change->setValue(QVariant::fromValue(translation));
+                changes.push_back(change);
+            }
+        }
+        arbiter->sceneChangeEventWithLock(changes);
+        arbiter->syncChanges();
+        ++frameCount;
+    }
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    // THEN
+    QCOMPARE(observer.changeCount(), frameCount * nodeCount);
+    QCOMPARE(observer.translation(), QVector3D(float(frameCount - 1), 0.0f, 0.0f));
+    if (elapsed > 0)
+        qDebug() << "changes per second:" << qRound64(double(observer.changeCount()) * 1e9 / double(elapsed));
+
+    Qt3DCore::QChangeArbiter::destroyUnmanagedThreadLocalChangeQueue(arbiter.data());
+}
+
+QTEST_APPLESS_MAIN(tst_BenchPropertyChanges)
+
+#include "tst_bench_propertychanges.moc"
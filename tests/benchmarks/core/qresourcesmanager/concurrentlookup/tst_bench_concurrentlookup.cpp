@@ -0,0 +1,177 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QThread>
+#include <Qt3DCore/private/qresourcemanager_p.h>
+
+namespace {
+
+class Resource
+{
+public:
+    Resource() : m_value(0)
+    {}
+
+    int m_value;
+};
+
+// Same locking as ObjectLevelLockingPolicy but lookups take the read lock
+template <class Host>
+class ReadLockedLookupPolicy : public Qt3DCore::ObjectLevelLockingPolicy<Host>
+{
+public:
+    enum {
+        LockFreeLookups = false
+    };
+};
+
+typedef Qt3DCore::QResourceManager<Resource, uint, Qt3DCore::ObjectLevelLockingPolicy> LockFreeManager;
+typedef Qt3DCore::QResourceManager<Resource, uint, ReadLockedLookupPolicy> ReadLockedManager;
+
+const uint InitialResourceCount = 50000;
+const uint InsertedResourceCount = 20000;
+const int LookupsPerThread = 500000;
+
+template<typename Manager>
+class LookupThread : public QThread
+{
+public:
+    LookupThread(Manager *manager, uint seed)
+        : m_manager(manager)
+        , m_seed(seed)
+        , m_found(0)
+    {}
+
+    void run() override
+    {
+        uint seed = m_seed;
+        for (int i = 0; i < LookupsPerThread; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            if (m_manager->lookupResource((seed >> 8) % InitialResourceCount) != nullptr)
+                ++m_found;
+        }
+    }
+
+    int found() const { return m_found; }
+
+private:
+    Manager *m_manager;
+    const uint m_seed;
+    int m_found;
+};
+
+template<typename Manager>
+class InsertThread : public QThread
+{
+public:
+    explicit InsertThread(Manager *manager)
+        : m_manager(manager)
+    {}
+
+    void run() override
+    {
+        for (uint i = 0; i < InsertedResourceCount; ++i)
+            m_manager->getOrCreateResource(InitialResourceCount + i);
+    }
+
+private:
+    Manager *m_manager;
+};
+
+template<typename Manager>
+void benchmarkConcurrentLookups(int readerCount)
+{
+    QBENCHMARK {
+        // GIVEN
+        Manager manager;
+        for (uint i = 0; i < InitialResourceCount; ++i)
+            manager.getOrCreateResource(i);
+
+        QVector<LookupThread<Manager> *> readers;
+        for (int i = 0; i < readerCount; ++i)
+            readers.push_back(new LookupThread<Manager>(&manager, uint(i + 1)));
+        InsertThread<Manager> writer(&manager);
+
+        // WHEN
+        writer.start();
+        for (LookupThread<Manager> *reader : qAsConst(readers))
+            reader->start();
+        writer.wait();
+        for (LookupThread<Manager> *reader : qAsConst(readers))
+            reader->wait();
+
+        // THEN
+        for (LookupThread<Manager> *reader : qAsConst(readers))
+            QCOMPARE(reader->found(), LookupsPerThread);
+        QCOMPARE(manager.count(), int(InitialResourceCount + InsertedResourceCount));
+        qDeleteAll(readers);
+    }
+}
+
+} // anonymous
+
+class tst_BenchConcurrentLookup : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void readLockedLookups_data();
+    void readLockedLookups();
+    void lockFreeLookups_data();
+    void lockFreeLookups();
+};
+
+void tst_BenchConcurrentLookup::readLockedLookups_data()
+{
+    QTest::addColumn<int>("readerCount");
+
+    QTest::newRow("1 reader") << 1;
+    QTest::newRow("4 readers") << 4;
+    QTest::newRow("ideal readers") << qMax(1, QThread::idealThreadCount() - 1);
+}
+
+void tst_BenchConcurrentLookup::readLockedLookups()
+{
+    QFETCH(int, readerCount);
+    benchmarkConcurrentLookups<ReadLockedManager>(readerCount);
+}
+
+void tst_BenchConcurrentLookup::lockFreeLookups_data()
+{
+    readLockedLookups_data();
+}
+
+void tst_BenchConcurrentLookup::lockFreeLookups()
+{
+    QFETCH(int, readerCount);
+    benchmarkConcurrentLookups<LockFreeManager>(readerCount);
+}
+
+QTEST_APPLESS_MAIN(tst_BenchConcurrentLookup)
+
+#include "tst_bench_concurrentlookup.moc"
@@ -2,4 +2,5 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
         arraypolicy \
-        qresourcesmanager
+        qresourcesmanager \
+        concurrentlookup
@@ -43,12 +43,14 @@ private Q_SLOTS:
     void benchmarRandomAccessSmallResources();
     void benchmarkRandomLookupSmallResources();
     void benchmarkReleaseSmallResources();
+    void benchmarkMassReleaseSmallResources();
     void benchmarkAllocateBigResources();
     void benchmarkAccessBigResources();
     void benchmarRandomAccessBigResources();
     void benchmarkLookupBigResources();
     void benchmarkRandomLookupBigResources();
     void benchmarkReleaseBigResources();
+    void benchmarkMassReleaseBigResources();
 };
 
 class tst_SmallArrayResource
@@ -170,6 +172,28 @@ void benchmarkReleaseResources()
     }
 }
 
+template<typename Resource>
+void benchmarkMassReleaseResources()
+{
+    // Tearing down a big subtree releases a large number of resources in an
+    // order which is unrelated to the allocation order
+    Qt3DCore::QResourceManager<Resource, int> manager;
+    const int max = 200000;
+    QVector<int> resourcesIndices(max);
+    for (int i = 0; i < max; i++) {
+        manager.getOrCreateResource(i);
+        resourcesIndices[i] = i;
+    }
+    std::srand(std::time(0));
+    std::random_shuffle(resourcesIndices.begin(), resourcesIndices.end());
+
+    QBENCHMARK_ONCE {
+        for (int i = 0; i < max; i++)
+            manager.releaseResource(resourcesIndices.at(i));
+    }
+    QCOMPARE(manager.count(), 0);
+}
+
 void tst_QResourceManager::benchmarkAllocateSmallResources()
 {
     benchmarkAllocateResources<tst_SmallArrayResource>();
@@ -200,6 +224,11 @@ void tst_QResourceManager::benchmarkReleaseSmallResources()
     benchmarkReleaseResources<tst_SmallArrayResource>();
 }
 
+void tst_QResourceManager::benchmarkMassReleaseSmallResources()
+{
+    benchmarkMassReleaseResources<tst_SmallArrayResource>();
+}
+
 void tst_QResourceManager::benchmarkAllocateBigResources()
 {
     benchmarkAllocateResources<tst_BigArrayResource>();
@@ -230,6 +259,11 @@ void tst_QResourceManager::benchmarkReleaseBigResources()
     benchmarkReleaseResources<tst_BigArrayResource>();
 }
 
+void tst_QResourceManager::benchmarkMassReleaseBigResources()
+{
+    benchmarkMassReleaseResources<tst_BigArrayResource>();
+}
+
 QTEST_APPLESS_MAIN(tst_QResourceManager)
 
 #include "tst_bench_qresourcesmanager.moc"
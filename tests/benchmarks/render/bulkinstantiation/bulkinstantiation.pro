@@ -0,0 +1,7 @@
+TARGET = tst_bench_bulkinstantiation
+
+TEMPLATE = app
+
+QT += testlib gui 3dcore 3drender 3dextras
+
+SOURCES += tst_bench_bulkinstantiation.cpp
@@ -0,0 +1,137 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <Qt3DCore/QEntity>
+#include <Qt3DCore/QTransform>
+#include <Qt3DRender/QCamera>
+#include <Qt3DRender/QRenderCapture>
+#include <Qt3DExtras/QCuboidMesh>
+#include <Qt3DExtras/QPhongMaterial>
+#include <Qt3DExtras/Qt3DWindow>
+
+namespace {
+
+const int captureTimeout = 120000;
+
+// Entities sharing a mesh and a material with a transform of their own, like
+// the instances of a loaded scene
+Qt3DCore::QEntity *createSubtree(int entityCount, Qt3DRender::QGeometryRenderer *mesh,
+                                 Qt3DRender::QMaterial *material)
+{
+    Qt3DCore::QEntity *subtreeRoot = new Qt3DCore::QEntity;
+    for (int i = 0; i < entityCount; ++i) {
+        Qt3DCore::QEntity *entity = new Qt3DCore::QEntity(subtreeRoot);
+        Qt3DCore::QTransform *transform = new Qt3DCore::QTransform;
+        transform->setTranslation(QVector3D(i % 100, (i / 100) % 100, -(i / 10000)) * 2.0f);
+        entity->addComponent(transform);
+        entity->addComponent(mesh);
+        entity->addComponent(material);
+    }
+    return subtreeRoot;
+}
+
+// Returns once the frame rendered for the capture request is available
+bool waitForCapture(Qt3DRender::QRenderCaptureReply *reply)
+{
+    if (!reply->isComplete()) {
+        QEventLoop loop;
+        QObject::connect(reply, &Qt3DRender::QRenderCaptureReply::completed, &loop, &QEventLoop::quit);
+        QTimer::singleShot(captureTimeout, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+    return reply->isComplete();
+}
+
+} // anonymous
+
+class tst_BulkInstantiation : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void subtreeToFirstFrame_data()
+    {
+        QTest::addColumn<int>("entityCount");
+
+        QTest::newRow("1000") << 1000;
+        QTest::newRow("10000") << 10000;
+        QTest::newRow("100000") << 100000;
+    }
+
+    void subtreeToFirstFrame()
+    {
+        // GIVEN
+        QFETCH(int, entityCount);
+
+        Qt3DExtras::Qt3DWindow view;
+        view.resize(1024, 768);
+
+        Qt3DCore::QEntity *root = new Qt3DCore::QEntity;
+        Qt3DExtras::QCuboidMesh *mesh = new Qt3DExtras::QCuboidMesh(root);
+        Qt3DExtras::QPhongMaterial *material = new Qt3DExtras::QPhongMaterial(root);
+
+        Qt3DRender::QCamera *camera = view.camera();
+        camera->lens()->setPerspectiveProjection(45.0f, 4.0f / 3.0f, 0.1f, 1000.0f);
+        camera->setPosition(QVector3D(100.0f, 100.0f, 300.0f));
+        camera->setViewCenter(QVector3D(100.0f, 100.0f, 0.0f));
+
+        Qt3DRender::QRenderCapture *capture = new Qt3DRender::QRenderCapture;
+        view.activeFrameGraph()->setParent(capture);
+        view.setActiveFrameGraph(capture);
+        view.setRootEntity(root);
+        view.show();
+
+        if (!QTest::qWaitForWindowExposed(&view))
+            QSKIP("Window could not be exposed");
+
+        // Make sure the renderer is up and running before adding the subtree
+        QScopedPointer<Qt3DRender::QRenderCaptureReply> initialReply(capture->requestCapture());
+        if (!waitForCapture(initialReply.data()))
+            QSKIP("No frame could be rendered");
+
+        Qt3DCore::QEntity *subtree = createSubtree(entityCount, mesh, material);
+        QScopedPointer<Qt3DRender::QRenderCaptureReply> reply;
+        bool rendered = false;
+
+        // WHEN
+        QBENCHMARK_ONCE {
+            subtree->setParent(root);
+            reply.reset(capture->requestCapture());
+            rendered = waitForCapture(reply.data());
+        }
+
+        // THEN
+        QVERIFY(rendered);
+    }
+};
+
+QTEST_MAIN(tst_BulkInstantiation)
+
+#include "tst_bench_bulkinstantiation.moc"
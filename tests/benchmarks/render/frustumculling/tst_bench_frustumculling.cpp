@@ -0,0 +1,179 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <Qt3DCore/qentity.h>
+#include <Qt3DCore/private/qnodecreatedchangegenerator_p.h>
+#include <Qt3DCore/private/qaspectjobmanager_p.h>
+
+#include <Qt3DRender/private/nodemanagers_p.h>
+#include <Qt3DRender/private/managers_p.h>
+#include <Qt3DRender/private/entity_p.h>
+#include <Qt3DRender/private/sphere_p.h>
+#include <Qt3DRender/qrenderaspect.h>
+#include <Qt3DRender/private/qrenderaspect_p.h>
+#include <Qt3DRender/private/frustumcullingjob_p.h>
+#include <Qt3DRender/private/boundingvolumehierarchy_p.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+class TestAspect : public Qt3DRender::QRenderAspect
+{
+public:
+    TestAspect(Qt3DCore::QNode *root)
+        : Qt3DRender::QRenderAspect(Qt3DRender::QRenderAspect::Synchronous)
+        , m_jobManager(new Qt3DCore::QAspectJobManager())
+    {
+        Qt3DCore::QAbstractAspectPrivate::get(this)->m_jobManager = m_jobManager.data();
+        QRenderAspect::onRegistered();
+
+        const Qt3DCore::QNodeCreatedChangeGenerator generator(root);
+        const QVector<Qt3DCore::QNodeCreatedChangeBasePtr> creationChanges = generator.creationChanges();
+
+        for (const Qt3DCore::QNodeCreatedChangeBasePtr change : creationChanges)
+            d_func()->createBackendNode(change);
+    }
+
+    ~TestAspect()
+    {
+        QRenderAspect::onUnregistered();
+    }
+
+    Qt3DRender::Render::NodeManagers *nodeManagers() const
+    {
+        return d_func()->m_renderer->nodeManagers();
+    }
+
+    void onRegistered() { QRenderAspect::onRegistered(); }
+    void onUnregistered() { QRenderAspect::onUnregistered(); }
+
+private:
+    QScopedPointer<Qt3DCore::QAspectJobManager> m_jobManager;
+};
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
+
+namespace {
+
+Qt3DCore::QEntity *buildTestScene(int entityCount)
+{
+    Qt3DCore::QEntity *root = new Qt3DCore::QEntity();
+    for (int i = 0; i < entityCount; ++i)
+        new Qt3DCore::QEntity(root);
+    return root;
+}
+
+// Scatters the world bounding spheres in a 200 units wide cube centered on
+// the camera and returns the entities sorted by address
+QVector<Qt3DRender::Render::Entity *> placeEntities(Qt3DRender::Render::EntityManager *manager)
+{
+    QRandomGenerator generator(1337);
+    QVector<Qt3DRender::Render::Entity *> entities;
+    const QVector<Qt3DRender::Render::HEntity> handles = manager->activeHandles();
+    entities.reserve(handles.size());
+    for (const Qt3DRender::Render::HEntity &handle : handles) {
+        Qt3DRender::Render::Entity *entity = manager->data(handle);
+        Qt3DRender::Render::Sphere *sphere = entity->worldBoundingVolume();
+        sphere->setCenter(Vector3D(generator.bounded(200.0) - 100.0,
+                                   generator.bounded(200.0) - 100.0,
+                                   generator.bounded(200.0) - 100.0));
+        sphere->setRadius(1.0f + generator.bounded(4.0));
+        *entity->worldBoundingVolumeWithChildren() = *sphere;
+        entities.push_back(entity);
+    }
+    std::sort(entities.begin(), entities.end(), &Qt3DRender::Render::Entity::treeOrderLessThan);
+    return entities;
+}
+
+} // anonymous
+
+class tst_BenchFrustumCulling : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+
+    void cullEntities_data()
+    {
+        QTest::addColumn<Qt3DCore::QEntity *>("entitySubtree");
+        QTest::addColumn<bool>("useHierarchy");
+
+        QTest::newRow("1000Entities") << buildTestScene(1000) << false;
+        QTest::newRow("10000Entities") << buildTestScene(10000) << false;
+        QTest::newRow("100000Entities") << buildTestScene(100000) << false;
+        QTest::newRow("1000EntitiesHierarchy") << buildTestScene(1000) << true;
+        QTest::newRow("10000EntitiesHierarchy") << buildTestScene(10000) << true;
+        QTest::newRow("100000EntitiesHierarchy") << buildTestScene(100000) << true;
+    }
+
+    void cullEntities()
+    {
+        QFETCH(Qt3DCore::QEntity *, entitySubtree);
+        QFETCH(bool, useHierarchy);
+
+        // GIVEN
+        QScopedPointer<Qt3DRender::TestAspect> aspect(new Qt3DRender::TestAspect(entitySubtree));
+        const QVector<Qt3DRender::Render::Entity *> entities = placeEntities(aspect->nodeManagers()->renderNodesManager());
+
+        QMatrix4x4 projection;
+        projection.perspective(45.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+        QMatrix4x4 view;
+        view.lookAt(QVector3D(0.0f, 0.0f, 0.0f), QVector3D(0.0f, 0.0f, -1.0f), QVector3D(0.0f, 1.0f, 0.0f));
+
+        // WHEN
+        Qt3DRender::Render::FrustumCullingJob cullingJob;
+        cullingJob.setEntities(entities);
+        cullingJob.setViewProjection(Matrix4x4(projection * view));
+        cullingJob.setActive(true);
+
+        Qt3DRender::Render::BoundingVolumeHierarchy hierarchy;
+        if (useHierarchy) {
+            hierarchy.build(aspect->nodeManagers()->renderNodesManager()->lookupResource(entitySubtree->id()));
+            cullingJob.setBoundingVolumeHierarchy(&hierarchy);
+        }
+
+        QBENCHMARK {
+            cullingJob.run();
+        }
+
+        // THEN
+        const QVector<Qt3DRender::Render::Entity *> visibleEntities = cullingJob.visibleEntities();
+        QVERIFY(!visibleEntities.isEmpty());
+        QVERIFY(visibleEntities.size() < entities.size());
+        QVERIFY(std::is_sorted(visibleEntities.begin(), visibleEntities.end()));
+    }
+};
+
+QTEST_MAIN(tst_BenchFrustumCulling)
+
+#include "tst_bench_frustumculling.moc"
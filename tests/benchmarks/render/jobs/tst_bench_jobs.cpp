@@ -215,16 +215,54 @@ Qt3DCore::QEntity *buildBigScene()
     return root;
 }
 
+Qt3DCore::QTransform *createTransform(int i)
+{
+    Qt3DCore::QTransform *transform = new Qt3DCore::QTransform();
+    transform->setTranslation(QVector3D(0.01f * i, 1.0f, -0.5f));
+    transform->setRotationY(0.1f * i);
+    return transform;
+}
+
+// count entities with a transform directly under the root
+Qt3DCore::QEntity *buildWideTransformScene(int count)
+{
+    Qt3DCore::QEntity *root = new Qt3DCore::QEntity();
+    for (int i = 0; i < count; i++) {
+        Qt3DCore::QEntity *e = new Qt3DCore::QEntity(root);
+        e->addComponent(createTransform(i));
+    }
+    return root;
+}
+
+// chainCount chains of chainLength entities with a transform each
+Qt3DCore::QEntity *buildDeepTransformScene(int chainCount, int chainLength)
+{
+    Qt3DCore::QEntity *root = new Qt3DCore::QEntity();
+    for (int i = 0; i < chainCount; i++) {
+        Qt3DCore::QEntity *parent = root;
+        for (int j = 0; j < chainLength; j++) {
+            Qt3DCore::QEntity *e = new Qt3DCore::QEntity(parent);
+            e->addComponent(createTransform(j));
+            parent = e;
+        }
+    }
+    return root;
+}
+
 class tst_benchJobs : public QObject
 {
     Q_OBJECT
 
 private:
     Qt3DCore::QEntity *m_bigSceneRoot;
+    Qt3DCore::QEntity *m_wideTransformSceneRoot;
+    Qt3DCore::QEntity *m_deepTransformSceneRoot;
 
 public:
     tst_benchJobs()
         : m_bigSceneRoot(buildBigScene())
+        , m_wideTransformSceneRoot(buildWideTransformScene(50000))
+        , m_deepTransformSceneRoot(buildDeepTransformScene(32, 1000))
     {}
 
 private Q_SLOTS:
@@ -233,6 +271,8 @@ private Q_SLOTS:
     {
         QTest::addColumn<Qt3DCore::QEntity*>("rootEntity");
         QTest::newRow("bigscene") << m_bigSceneRoot;
+        QTest::newRow("wide_50k_transforms") << m_wideTransformSceneRoot;
+        QTest::newRow("deep_32x1k_transforms") << m_deepTransformSceneRoot;
     }
 
     void updateTransformJob()
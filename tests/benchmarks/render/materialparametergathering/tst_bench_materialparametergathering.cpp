@@ -28,6 +28,7 @@
 
 #include <QtTest/QTest>
 #include <Qt3DCore/qentity.h>
+#include <Qt3DCore/qpropertyupdatedchange.h>
 #include <Qt3DCore/private/qnodecreatedchangegenerator_p.h>
 #include <Qt3DCore/private/qaspectjobmanager_p.h>
 
@@ -133,6 +134,43 @@ private Q_SLOTS:
 
         QVERIFY(!gatheringJob->materialToPassAndParameter().empty());
     }
+
+    void singleParameterChange()
+    {
+        // GIVEN
+        QScopedPointer<Qt3DRender::TestAspect> aspect(new Qt3DRender::TestAspect(buildTestScene(2000)));
+        const QVector<Qt3DRender::Render::HMaterial> handles = aspect->nodeManagers()->materialManager()->activeHandles();
+
+        Qt3DRender::Render::MaterialParameterGathererJobPtr initialJob = aspect->materialGathererJob();
+        initialJob->setHandles(handles);
+        initialJob->run();
+        Qt3DRender::Render::MaterialParameterGathererRevisions revisions = initialJob->revisions();
+
+        // Rename one of the effect parameters of a single material
+        Qt3DRender::Render::Material *material = aspect->nodeManagers()->materialManager()->data(handles.first());
+        Qt3DRender::Render::Effect *effect = aspect->nodeManagers()->effectManager()->lookupResource(material->effect());
+        Qt3DRender::Render::Parameter *parameter = aspect->nodeManagers()->parameterManager()->lookupResource(effect->parameters().first());
+        const QString parameterName = parameter->name();
+        int changeCount = 0;
+
+        // WHEN
+        QBENCHMARK {
+            Qt3DCore::QPropertyUpdatedChangePtr change(new Qt3DCore::QPropertyUpdatedChange(parameter->peerId()));
+            change->setPropertyName("name");
+            change->setValue(parameterName + QString::number(++changeCount));
+            parameter->sceneChangeEvent(change);
+
+            Qt3DRender::Render::MaterialParameterGathererJobPtr gatheringJob = aspect->materialGathererJob();
+            gatheringJob->setHandles(handles);
+            gatheringJob->setPreviousRevisions(revisions);
+            gatheringJob->run();
+            revisions = gatheringJob->revisions();
+
+            // THEN
+            QCOMPARE(gatheringJob->materialToPassAndParameter().size(), 1);
+            QCOMPARE(gatheringJob->unchangedMaterials().size(), handles.size() - 1);
+        }
+    }
 };
 
 QTEST_MAIN(tst_BenchMaterialParameterGathering)
@@ -2,6 +2,10 @@ TEMPLATE=subdirs
 
 qtConfig(private_tests) {
     SUBDIRS += jobs \
+               bulkinstantiation \
                layerfiltering \
-               materialparametergathering
+               frustumculling \
+               materialparametergathering \
+               rendercommandallocation \
+               rendercommandsorting
 }
@@ -0,0 +1,9 @@
+TEMPLATE = app
+
+TARGET = tst_bench_rendercommandallocation
+
+QT += core-private 3dcore 3dcore-private 3drender 3drender-private testlib concurrent
+
+CONFIG += testcase
+
+SOURCES += tst_bench_rendercommandallocation.cpp
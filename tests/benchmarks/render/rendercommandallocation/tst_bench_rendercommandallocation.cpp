@@ -0,0 +1,160 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtConcurrent>
+#include <Qt3DRender/private/rendercommand_p.h>
+#include <Qt3DRender/private/rendercommandarena_p.h>
+#include <Qt3DRender/private/renderstateset_p.h>
+
+#include <memory>
+#include <vector>
+
+using namespace Qt3DRender::Render;
+
+namespace {
+
+// Fills a command with roughly what RenderView::buildDrawRenderCommands sets
+void fillCommand(RenderCommand *command, int i)
+{
+    command->m_depth = float(i);
+    for (int a = 0; a < 3; ++a)
+        command->m_attributes.push_back(a);
+    for (int u = 0; u < 4; ++u)
+        command->m_parameterPack.setUniform(u, UniformValue(float(i)));
+}
+
+// Commands built by one thread for one frame, one out of two having its own state set
+struct HeapFrame
+{
+    void build(int commandCount)
+    {
+        commands.reserve(commandCount);
+        for (int i = 0; i < commandCount; ++i) {
+            RenderCommand *command = new RenderCommand();
+            if (i % 2 == 0)
+                command->m_stateSet = new RenderStateSet();
+            fillCommand(command, i);
+            commands.push_back(command);
+        }
+    }
+
+    void release()
+    {
+        for (RenderCommand *command : qAsConst(commands)) {
+            delete command->m_stateSet;
+            delete command;
+        }
+        commands.clear();
+    }
+
+    QVector<RenderCommand *> commands;
+};
+
+struct ArenaFrame
+{
+    void build(int commandCount)
+    {
+        commands.reserve(commandCount);
+        for (int i = 0; i < commandCount; ++i) {
+            RenderCommand *command = arena.allocateCommand();
+            if (i % 2 == 0)
+                command->m_stateSet = arena.allocateStateSet();
+            fillCommand(command, i);
+            commands.push_back(command);
+        }
+    }
+
+    void release()
+    {
+        commands.clear();
+        arena.clear();
+    }
+
+    RenderCommandArena arena;
+    QVector<RenderCommand *> commands;
+};
+
+template<typename Frame>
+void buildAndReleaseFrames(int commandCount, int threadCount)
+{
+    std::vector<std::unique_ptr<Frame>> frames;
+    for (int i = 0; i < threadCount; ++i)
+        frames.emplace_back(new Frame());
+    const int commandsPerThread = commandCount / threadCount;
+
+    QBENCHMARK {
+        QtConcurrent::blockingMap(frames, [commandsPerThread] (std::unique_ptr<Frame> &frame) {
+            frame->build(commandsPerThread);
+        });
+        // Frame cleanup
+        for (const std::unique_ptr<Frame> &frame : frames)
+            frame->release();
+    }
+}
+
+} // anonymous
+
+class tst_BenchRenderCommandAllocation : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void buildCommands_data()
+    {
+        QTest::addColumn<int>("commandCount");
+        QTest::addColumn<int>("threadCount");
+        QTest::addColumn<bool>("useArena");
+
+        const int idealThreadCount = std::max(QThread::idealThreadCount(), 2);
+        for (const int commandCount : { 1000, 20000 }) {
+            for (const int threadCount : { 1, idealThreadCount }) {
+                const QByteArray suffix = QByteArray::number(commandCount) + "-" + QByteArray::number(threadCount) + "Threads";
+                QTest::newRow(QByteArray("Heap-" + suffix).constData()) << commandCount << threadCount << false;
+                QTest::newRow(QByteArray("Arena-" + suffix).constData()) << commandCount << threadCount << true;
+            }
+        }
+    }
+
+    void buildCommands()
+    {
+        QFETCH(int, commandCount);
+        QFETCH(int, threadCount);
+        QFETCH(bool, useArena);
+
+        if (useArena)
+            buildAndReleaseFrames<ArenaFrame>(commandCount, threadCount);
+        else
+            buildAndReleaseFrames<HeapFrame>(commandCount, threadCount);
+    }
+};
+
+QTEST_MAIN(tst_BenchRenderCommandAllocation)
+
+#include "tst_bench_rendercommandallocation.moc"
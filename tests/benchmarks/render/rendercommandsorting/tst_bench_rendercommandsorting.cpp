@@ -0,0 +1,164 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <Qt3DRender/private/rendercommand_p.h>
+#include <Qt3DRender/private/rendercommandarena_p.h>
+#include <Qt3DRender/private/rendercommandsorter_p.h>
+
+#include <algorithm>
+#include <random>
+
+using namespace Qt3DRender;
+using namespace Qt3DRender::Render;
+
+Q_DECLARE_METATYPE(QVector<QSortPolicy::SortType>)
+
+namespace {
+
+bool lessThan(QSortPolicy::SortType sortType, const RenderCommand *a, const RenderCommand *b)
+{
+    switch (sortType) {
+    case QSortPolicy::StateChangeCost:
+        return a->m_changeCost > b->m_changeCost;
+    case QSortPolicy::BackToFront:
+        return a->m_depth > b->m_depth;
+    case QSortPolicy::Material:
+        return a->m_shaderDna > b->m_shaderDna;
+    case QSortPolicy::FrontToBack:
+        return a->m_depth < b->m_depth;
+    default:
+        Q_UNREACHABLE();
+        return false;
+    }
+}
+
+// Comparison based sorting RenderView::sort() used to perform: one
+// std::stable_sort per sort type, each applied to the ranges of commands
+// equal for the previous sort types
+void stableSortLevels(QVector<RenderCommand *> &commands, int begin, int end, int level,
+                      const QVector<QSortPolicy::SortType> &sortTypes)
+{
+    if (level >= sortTypes.size())
+        return;
+
+    const QSortPolicy::SortType sortType = sortTypes.at(level);
+    const auto less = [sortType] (const RenderCommand *a, const RenderCommand *b) {
+        return lessThan(sortType, a, b);
+    };
+    const auto equal = [sortType] (const RenderCommand *a, const RenderCommand *b) {
+        return !lessThan(sortType, a, b) && !lessThan(sortType, b, a);
+    };
+
+    std::stable_sort(commands.begin() + begin, commands.begin() + end, less);
+
+    for (int rangeBegin = begin; rangeBegin != end;) {
+        int rangeEnd = rangeBegin + 1;
+        while (rangeEnd < end && equal(commands.at(rangeBegin), commands.at(rangeEnd)))
+            ++rangeEnd;
+        if (sortType == QSortPolicy::Material) {
+            std::stable_sort(commands.begin() + rangeBegin, commands.begin() + rangeEnd,
+                             [] (const RenderCommand *a, const RenderCommand *b) {
+                return a->m_material.handle() < b->m_material.handle();
+            });
+        }
+        stableSortLevels(commands, rangeBegin, rangeEnd, level + 1, sortTypes);
+        rangeBegin = rangeEnd;
+    }
+}
+
+// Commands as gathered for a scene with a few dozen shaders
+void fillCommands(RenderCommandArena &arena, QVector<RenderCommand *> &commands, int commandCount)
+{
+    std::mt19937 generator(commandCount);
+    std::uniform_real_distribution<float> depths(0.1f, 1000.0f);
+    for (int i = 0; i < commandCount; ++i) {
+        RenderCommand *command = arena.allocateCommand();
+        command->m_shaderDna = ProgramDNA(generator() % 48) * 2654435761u;
+        command->m_depth = depths(generator);
+        command->m_changeCost = int(generator() % 12);
+        commands.push_back(command);
+    }
+}
+
+} // anonymous
+
+class tst_BenchRenderCommandSorting : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void sortCommands_data()
+    {
+        QTest::addColumn<int>("commandCount");
+        QTest::addColumn<QVector<QSortPolicy::SortType>>("sortTypes");
+        QTest::addColumn<bool>("useSortKeys");
+
+        const QVector<QSortPolicy::SortType> opaque = { QSortPolicy::StateChangeCost, QSortPolicy::Material, QSortPolicy::FrontToBack };
+        const QVector<QSortPolicy::SortType> transparent = { QSortPolicy::BackToFront };
+
+        for (const int commandCount : { 10000, 50000, 100000 }) {
+            const QByteArray count = QByteArray::number(commandCount);
+            QTest::newRow(QByteArray("StableSort-Opaque-" + count).constData()) << commandCount << opaque << false;
+            QTest::newRow(QByteArray("SortKeys-Opaque-" + count).constData()) << commandCount << opaque << true;
+            QTest::newRow(QByteArray("StableSort-Transparent-" + count).constData()) << commandCount << transparent << false;
+            QTest::newRow(QByteArray("SortKeys-Transparent-" + count).constData()) << commandCount << transparent << true;
+        }
+    }
+
+    void sortCommands()
+    {
+        QFETCH(int, commandCount);
+        QFETCH(QVector<QSortPolicy::SortType>, sortTypes);
+        QFETCH(bool, useSortKeys);
+
+        RenderCommandArena arena;
+        QVector<RenderCommand *> unsortedCommands;
+        fillCommands(arena, unsortedCommands, commandCount);
+        RenderCommandSorter sorter;
+
+        QVector<RenderCommand *> commands;
+        QBENCHMARK {
+            commands = unsortedCommands;
+            if (useSortKeys)
+                sorter.sort(commands, sortTypes);
+            else
+                stableSortLevels(commands, 0, commands.size(), 0, sortTypes);
+        }
+
+        // Both approaches give the same order
+        QVector<RenderCommand *> expectedCommands = unsortedCommands;
+        stableSortLevels(expectedCommands, 0, expectedCommands.size(), 0, sortTypes);
+        QCOMPARE(commands, expectedCommands);
+    }
+};
+
+QTEST_MAIN(tst_BenchRenderCommandSorting)
+
+#include "tst_bench_rendercommandsorting.moc"
@@ -0,0 +1,15 @@
+#version 330 core
+
+uniform vec3 kd;
+
+in vec3 position;
+in vec3 normal;
+
+out vec4 fragColor;
+
+void main()
+{
+    vec3 s = normalize(-position);
+    float diffuse = max(dot(s, normalize(normal)), 0.0);
+    fragColor = vec4(kd * (0.2 + 0.8 * diffuse), 1.0);
+}
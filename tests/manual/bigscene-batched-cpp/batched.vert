@@ -0,0 +1,20 @@
+#version 330 core
+
+in vec3 vertexPosition;
+in vec3 vertexNormal;
+// Filled by the renderer with the world matrices of the merged entities
+in mat4 instanceModelMatrix;
+
+out vec3 position;
+out vec3 normal;
+
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+
+void main()
+{
+    vec4 eyePosition = viewMatrix * instanceModelMatrix * vec4(vertexPosition, 1.0);
+    position = eyePosition.xyz;
+    normal = normalize(mat3(viewMatrix) * mat3(instanceModelMatrix) * vertexNormal);
+    gl_Position = projectionMatrix * eyePosition;
+}
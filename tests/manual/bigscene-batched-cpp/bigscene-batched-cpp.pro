@@ -0,0 +1,11 @@
+!include( ../manual.pri ) {
+    error( "Couldn't find the manual.pri file!" )
+}
+
+QT += 3dcore 3drender 3dinput 3dlogic 3dextras
+
+SOURCES += \
+    main.cpp
+
+RESOURCES += \
+    bigscene-batched-cpp.qrc
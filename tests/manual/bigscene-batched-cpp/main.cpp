@@ -0,0 +1,191 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** BSD License Usage
+** Alternatively, you may use this file under the terms of the BSD license
+** as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QGuiApplication>
+
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QUrl>
+#include <Qt3DCore/QEntity>
+#include <Qt3DCore/QTransform>
+#include <Qt3DLogic/QFrameAction>
+#include <Qt3DRender/QCamera>
+#include <Qt3DRender/QEffect>
+#include <Qt3DRender/QFilterKey>
+#include <Qt3DRender/QGraphicsApiFilter>
+#include <Qt3DRender/QMaterial>
+#include <Qt3DRender/QParameter>
+#include <Qt3DRender/QRenderPass>
+#include <Qt3DRender/QRenderSettings>
+#include <Qt3DRender/QShaderProgram>
+#include <Qt3DRender/QTechnique>
+#include <Qt3DExtras/QCylinderMesh>
+#include <Qt3DExtras/QForwardRenderer>
+#include <Qt3DExtras/qt3dwindow.h>
+#include <Qt3DExtras/qfirstpersoncameracontroller.h>
+#include <qmath.h>
+
+using namespace Qt3DCore;
+using namespace Qt3DRender;
+
+// Builds a material whose vertex shader declares the instanceModelMatrix
+// attribute, which is what allows the renderer to merge the draw calls
+// of all the entities sharing it when automatic instancing is enabled.
+// The renderer only fills that attribute in this case, otherwise the
+// shader reads the usual model view matrix uniforms
+static QMaterial *createBatchableMaterial(QNode *parent, bool batched)
+{
+    const QString vertexShader = batched ? QStringLiteral("qrc:/batched.vert")
+                                         : QStringLiteral("qrc:/unbatched.vert");
+    auto *shader = new QShaderProgram();
+    shader->setVertexShaderCode(QShaderProgram::loadSource(QUrl(vertexShader)));
+    shader->setFragmentShaderCode(QShaderProgram::loadSource(QUrl(QStringLiteral("qrc:/batched.frag"))));
+
+    auto *renderPass = new QRenderPass();
+    renderPass->setShaderProgram(shader);
+
+    auto *filterKey = new QFilterKey();
+    filterKey->setName(QStringLiteral("renderingStyle"));
+    filterKey->setValue(QStringLiteral("forward"));
+
+    auto *technique = new QTechnique();
+    technique->graphicsApiFilter()->setApi(QGraphicsApiFilter::OpenGL);
+    technique->graphicsApiFilter()->setProfile(QGraphicsApiFilter::CoreProfile);
+    technique->graphicsApiFilter()->setMajorVersion(3);
+    technique->graphicsApiFilter()->setMinorVersion(3);
+    technique->addFilterKey(filterKey);
+    technique->addRenderPass(renderPass);
+
+    auto *effect = new QEffect();
+    effect->addTechnique(technique);
+
+    auto *material = new QMaterial(parent);
+    material->setEffect(effect);
+    material->addParameter(new QParameter(QStringLiteral("kd"), QColor(255, 204, 75)));
+    return material;
+}
+
+int main(int ac, char **av)
+{
+    QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+    format.setVersion(3, 3);
+    format.setProfile(QSurfaceFormat::CoreProfile);
+    QSurfaceFormat::setDefaultFormat(format);
+
+    QGuiApplication app(ac, av);
+    const bool batched = !app.arguments().contains(QStringLiteral("--no-batching"));
+
+    Qt3DExtras::Qt3DWindow view;
+    view.defaultFrameGraph()->setClearColor(Qt::black);
+    view.renderSettings()->setAutomaticInstancing(batched);
+
+    QEntity *root = new QEntity();
+
+    // Mesh and material shared by all the entities
+    auto *mesh = new Qt3DExtras::QCylinderMesh(root);
+    mesh->setRings(10);
+    mesh->setSlices(16);
+    mesh->setRadius(1.0f);
+    mesh->setLength(3.0f);
+
+    QMaterial *material = createBatchableMaterial(root, batched);
+
+    // Camera
+    QCamera *cameraEntity = view.camera();
+    cameraEntity->lens()->setPerspectiveProjection(45.0f, 16.0f/9.0f, 0.1f, 1000.0f);
+    cameraEntity->setPosition(QVector3D(0, 0, 250.0f));
+    cameraEntity->setUpVector(QVector3D(0, 1, 0));
+    cameraEntity->setViewCenter(QVector3D(0, 0, 0));
+
+    // For camera controls
+    Qt3DExtras::QFirstPersonCameraController *camController = new Qt3DExtras::QFirstPersonCameraController(root);
+    camController->setCamera(cameraEntity);
+
+    // Scene
+    const int side = 70;
+    for (int i = 0; i < side * side; ++i) {
+        QEntity *e = new QEntity(root);
+        QTransform *transform = new QTransform();
+        transform->setTranslation(QVector3D(3.0f * float(i % side - side / 2),
+                                            3.0f * float(i / side - side / 2),
+                                            0.0f));
+        transform->setRotationX(float(i % 360));
+        e->addComponent(mesh);
+        e->addComponent(material);
+        e->addComponent(transform);
+    }
+
+    // Report the average frame time every few seconds, rendering with
+    // QT_LOGGING_RULES="Qt3D.Renderer.Rendering.debug=true" additionally
+    // shows the number of submitted commands and the submission time
+    QElapsedTimer reportTimer;
+    reportTimer.start();
+    int frameCount = 0;
+    auto *frameAction = new Qt3DLogic::QFrameAction(root);
+    QObject::connect(frameAction, &Qt3DLogic::QFrameAction::triggered, [&] {
+        ++frameCount;
+        if (reportTimer.elapsed() < 5000)
+            return;
+        qInfo() << (batched ? "Batched:" : "Not batched:")
+                << side * side << "entities,"
+                << double(reportTimer.elapsed()) / frameCount << "ms per frame";
+        frameCount = 0;
+        reportTimer.restart();
+    });
+    root->addComponent(frameAction);
+
+    view.setRootEntity(root);
+    view.show();
+
+    if (app.arguments().contains(QStringLiteral("--bench")))
+        QTimer::singleShot(25 * 1000, &app, &QCoreApplication::quit);
+
+    return app.exec();
+}
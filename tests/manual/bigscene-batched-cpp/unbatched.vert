@@ -0,0 +1,19 @@
+#version 330 core
+
+in vec3 vertexPosition;
+in vec3 vertexNormal;
+
+out vec3 position;
+out vec3 normal;
+
+uniform mat4 modelViewMatrix;
+uniform mat3 modelViewNormal;
+uniform mat4 projectionMatrix;
+
+void main()
+{
+    vec4 eyePosition = modelViewMatrix * vec4(vertexPosition, 1.0);
+    position = eyePosition.xyz;
+    normal = normalize(modelViewNormal * vertexNormal);
+    gl_Position = projectionMatrix * eyePosition;
+}
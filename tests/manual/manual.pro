@@ -3,6 +3,7 @@ TEMPLATE = subdirs
 SUBDIRS += \
     assimp \
     bigscene-cpp \
+    bigscene-batched-cpp \
     bigmodel-qml \
     bigscene-instanced-qml \
     clip-planes-qml \